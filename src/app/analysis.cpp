@@ -0,0 +1,85 @@
+#include <QtCore>
+
+#include "analysis.h"
+#include "vjassscanner.h"
+#include "vjassparser.h"
+#include "pjass.h"
+#include "jasshelper.h"
+
+namespace Analysis {
+
+HighLightInfo* scanAndParse(const QString &input, int syntaxChecker, bool analyzeMemoryLeaks, const QSharedPointer<const VJassSymbolTable> &previousSymbolTable) {
+    VJassScanner scanner;
+    VJassParser parser;
+    BracketPairIndex bracketPairIndex;
+    FoldRangeIndex foldRangeIndex;
+    QSharedPointer<VJassSymbolTable> symbolTable(new VJassSymbolTable());
+    QList<VJassToken> tokens = scanner.scan(input, true, &bracketPairIndex);
+    qDebug() << "Tokens after scanning" << tokens.size();
+    VJassAst *ast = parser.parse(tokens, &foldRangeIndex, symbolTable.data());
+
+    QList<VJassParseError> parseErrors;
+
+    // pjass syntax check
+    if (syntaxChecker == 1) {
+        PJass pjass;
+        int pjassExitCode = pjass.run(input);
+
+        QString jassStandardOutput = pjass.getStandardOutput();
+        QString pjassErrorOutput = pjass.getStandardError();
+        qDebug() << "Using pjass and getting exit code" << pjassExitCode;
+
+        parseErrors = PJass::outputToParseErrors(jassStandardOutput);
+    // JassHelper syntax check
+    } else if (syntaxChecker == 2) {
+        JassHelper jassHelper;
+        int jassHelperExitCode = jassHelper.run(input);
+
+        QString jassHelperStandardOutput = jassHelper.getStandardOutput();
+        QString jassHelperErrorOutput = jassHelper.getStandardError();
+        qDebug() << "Using JassHelper and getting exit code" << jassHelperExitCode;
+
+        parseErrors = JassHelper::outputToParseErrors(jassHelperStandardOutput);
+    // vjasside syntax check
+    } else {
+        parseErrors = ast->getAllParseErrors();
+        // pjass and JassHelper report unmatched brackets on their own
+        parseErrors.append(bracketPairIndex.toParseErrors());
+    }
+
+    // this stores also the required highlighting information
+    HighLightInfo *results = new HighLightInfo(input, tokens, ast, parseErrors, true, false, analyzeMemoryLeaks);
+    // the hashes of the lines are compared instead of the tokens to find the unchanged functions
+    symbolTable->resolveTokens(tokens, previousSymbolTable.data(), results->getLineHashes());
+    results->setBracketPairIndex(bracketPairIndex);
+    results->setFoldRangeIndex(foldRangeIndex);
+    results->setCompletionUnits(CompletionIndex::unitsFromAst(ast));
+    results->setSymbols(SymbolIndex::symbolsFromAst(ast));
+    results->setSignatures(SignatureIndex::signaturesFromAst(ast));
+    results->setSymbolTable(symbolTable);
+
+    return results;
+}
+
+SymbolIndex::Symbols scanAndParseSymbols(const QString &filePath, VJassSymbolTable::Units &units, SignatureIndex::Signatures &signatures) {
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return SymbolIndex::Symbols();
+    }
+
+    VJassScanner scanner;
+    VJassParser parser;
+    VJassSymbolTable symbolTable;
+    const QList<VJassToken> tokens = scanner.scan(QString::fromUtf8(file.readAll()));
+    VJassAst *ast = parser.parse(tokens, nullptr, &symbolTable);
+    symbolTable.resolveTokens(tokens);
+    units = symbolTable.getUnits();
+    signatures = SignatureIndex::signaturesFromAst(ast);
+    const SymbolIndex::Symbols result = SymbolIndex::symbolsFromAst(ast);
+    delete ast;
+
+    return result;
+}
+
+}
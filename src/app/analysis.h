@@ -0,0 +1,31 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <QString>
+#include <QSharedPointer>
+
+#include "highlightinfo.h"
+
+/**
+ * @brief The analysis of scripts which is run outside of the GUI thread.
+ *
+ * The main window runs it in the threads of its analysis pool and the tests run it directly to get the same results.
+ */
+namespace Analysis {
+
+/**
+ * Scans and parses the text and checks its syntax.
+ * The functions whose lines have not been changed since the previous symbol table reuse its semantic runs.
+ * @param syntaxChecker 1 for pjass, 2 for JassHelper and any other value for the syntax check of vjasside.
+ * @return Returns the results which are owned by the caller.
+ */
+HighLightInfo* scanAndParse(const QString &input, int syntaxChecker, bool analyzeMemoryLeaks, const QSharedPointer<const VJassSymbolTable> &previousSymbolTable);
+
+/**
+ * Parses a standard script for its declarations, its references and the signatures of its natives and functions.
+ */
+SymbolIndex::Symbols scanAndParseSymbols(const QString &filePath, VJassSymbolTable::Units &units, SignatureIndex::Signatures &signatures);
+
+}
+
+#endif // ANALYSIS_H
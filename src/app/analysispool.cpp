@@ -0,0 +1,194 @@
+#include <QtCore>
+
+#include "analysispool.h"
+
+AnalysisPool::AnalysisPool(int maxThreadCount, QObject *parent)
+    : QObject(parent)
+    , priorityQueue(0)
+    , maxThreadCount(maxThreadCount > 0 ? maxThreadCount : qMax(1, QThread::idealThreadCount() - 1))
+    , idleThreadCount(0)
+    , stopping(false)
+{
+}
+
+AnalysisPool::~AnalysisPool() {
+    shutdown();
+}
+
+void AnalysisPool::enqueue(quintptr queueId, const Job &job) {
+    QMutexLocker locker(&mutex);
+
+    if (stopping) {
+        return;
+    }
+
+    QQueue<Job> &queue = queues[queueId];
+    queue.enqueue(job);
+
+    if (!queueOrder.contains(queueId)) {
+        queueOrder.push_back(queueId);
+    }
+
+    // threads are only started when none is waiting for a job
+    if (idleThreadCount == 0 && threads.size() < maxThreadCount) {
+        QThread *thread = QThread::create([this]() { run(); });
+        threads.push_back(thread);
+        thread->start(QThread::LowestPriority);
+    } else {
+        jobsAvailable.wakeOne();
+    }
+}
+
+void AnalysisPool::clear(quintptr queueId) {
+    QMutexLocker locker(&mutex);
+
+    queues.remove(queueId);
+    queueOrder.removeAll(queueId);
+
+    if (runningQueues.isEmpty() && queues.isEmpty()) {
+        jobsDone.wakeAll();
+    }
+}
+
+void AnalysisPool::setPriorityQueue(quintptr queueId) {
+    QMutexLocker locker(&mutex);
+
+    priorityQueue = queueId;
+}
+
+quintptr AnalysisPool::getPriorityQueue() const {
+    QMutexLocker locker(&mutex);
+
+    return priorityQueue;
+}
+
+int AnalysisPool::getMaxThreadCount() const {
+    return maxThreadCount;
+}
+
+int AnalysisPool::getThreadCount() const {
+    QMutexLocker locker(&mutex);
+
+    return threads.size();
+}
+
+int AnalysisPool::getPendingJobsCount() const {
+    QMutexLocker locker(&mutex);
+    int result = 0;
+
+    for (const QQueue<Job> &queue : queues) {
+        result += queue.size();
+    }
+
+    return result;
+}
+
+int AnalysisPool::getPendingJobsCount(quintptr queueId) const {
+    QMutexLocker locker(&mutex);
+
+    return queues.value(queueId).size();
+}
+
+int AnalysisPool::getRunningJobsCount() const {
+    QMutexLocker locker(&mutex);
+
+    return runningQueues.size();
+}
+
+bool AnalysisPool::waitForDone(int msecs) {
+    QDeadlineTimer deadline(msecs < 0 ? QDeadlineTimer::Forever : msecs);
+    QMutexLocker locker(&mutex);
+
+    while (!queues.isEmpty() || !runningQueues.isEmpty()) {
+        if (!jobsDone.wait(&mutex, deadline)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void AnalysisPool::shutdown() {
+    QList<QThread*> threads;
+
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        queues.clear();
+        queueOrder.clear();
+        threads = this->threads;
+        this->threads.clear();
+        jobsAvailable.wakeAll();
+    }
+
+    for (QThread *thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+void AnalysisPool::run() {
+    QMutexLocker locker(&mutex);
+
+    while (!stopping) {
+        quintptr queueId = 0;
+        Job job;
+
+        if (takeNextJob(queueId, job)) {
+            runningQueues.insert(queueId);
+            locker.unlock();
+
+            job();
+            // the captures of the job are released outside of the lock
+            job = nullptr;
+
+            locker.relock();
+            runningQueues.remove(queueId);
+
+            if (queues.isEmpty() && runningQueues.isEmpty()) {
+                jobsDone.wakeAll();
+            // the next job of the same queue might be waiting for this one
+            } else if (queues.contains(queueId)) {
+                jobsAvailable.wakeOne();
+            }
+        } else {
+            idleThreadCount++;
+            jobsAvailable.wait(&mutex);
+            idleThreadCount--;
+        }
+    }
+}
+
+bool AnalysisPool::takeNextJob(quintptr &queueId, Job &job) {
+    int index = -1;
+
+    // the active document comes first
+    if (priorityQueue != 0 && !runningQueues.contains(priorityQueue) && queues.contains(priorityQueue)) {
+        index = queueOrder.indexOf(priorityQueue);
+    } else {
+        for (int i = 0; i < queueOrder.size(); i++) {
+            if (!runningQueues.contains(queueOrder.at(i))) {
+                index = i;
+
+                break;
+            }
+        }
+    }
+
+    if (index == -1) {
+        return false;
+    }
+
+    queueId = queueOrder.takeAt(index);
+    QQueue<Job> &queue = queues[queueId];
+    job = queue.dequeue();
+
+    // the queue is served again after all other queues
+    if (queue.isEmpty()) {
+        queues.remove(queueId);
+    } else {
+        queueOrder.push_back(queueId);
+    }
+
+    return true;
+}
@@ -0,0 +1,81 @@
+#ifndef ANALYSISPOOL_H
+#define ANALYSISPOOL_H
+
+#include <functional>
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+
+/**
+ * @brief A bounded number of threads which run the analysis jobs of all open documents.
+ *
+ * Every document has its own queue of jobs which are run in order and never concurrently.
+ * The jobs of the priority queue (the active document) are always taken first. The queues of all other documents are served in turns when there is no priority job.
+ * The threads are only started when there are jobs, so many open documents do not require more threads.
+ */
+class AnalysisPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * @param maxThreadCount If it is 0 or less, one thread less than the ideal thread count is used, so the GUI thread keeps one core.
+     */
+    AnalysisPool(int maxThreadCount = 0, QObject *parent = nullptr);
+    virtual ~AnalysisPool();
+
+    void enqueue(quintptr queueId, const Job &job);
+    /**
+     * @brief Removes all pending jobs of the queue. A running job is finished.
+     */
+    void clear(quintptr queueId);
+    void setPriorityQueue(quintptr queueId);
+    quintptr getPriorityQueue() const;
+
+    int getMaxThreadCount() const;
+    int getThreadCount() const;
+    int getPendingJobsCount() const;
+    int getPendingJobsCount(quintptr queueId) const;
+    int getRunningJobsCount() const;
+
+    /**
+     * @brief Waits until all pending and running jobs have been finished.
+     * @return Returns false if the time out has been reached.
+     */
+    bool waitForDone(int msecs = -1);
+    /**
+     * @brief Removes all pending jobs and stops all threads after their running jobs.
+     */
+    void shutdown();
+
+private:
+    void run();
+    /**
+     * @brief Has to be called with the locked mutex.
+     * @return Returns false if there is no job which can be run.
+     */
+    bool takeNextJob(quintptr &queueId, Job &job);
+
+    mutable QMutex mutex;
+    QWaitCondition jobsAvailable;
+    QWaitCondition jobsDone;
+    QHash<quintptr, QQueue<Job>> queues;
+    // the queues with pending jobs in the order they are served
+    QList<quintptr> queueOrder;
+    QSet<quintptr> runningQueues;
+    quintptr priorityQueue;
+    QList<QThread*> threads;
+    int maxThreadCount;
+    int idleThreadCount;
+    bool stopping;
+};
+
+#endif // ANALYSISPOOL_H
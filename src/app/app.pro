@@ -11,16 +11,39 @@ CONFIG += file_copies
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    analysis.cpp \
+    analysispool.cpp \
+    astspanindex.cpp \
     autocompletionpopup.cpp \
+    bracketpairindex.cpp \
+    callgraph.cpp \
+    completioncontext.cpp \
+    completionindex.cpp \
+    completionmodel.cpp \
+    crossreferenceindex.cpp \
+    diagnosticsindex.cpp \
+    diagnosticsmodel.cpp \
+    fileloader.cpp \
+    findengine.cpp \
+    findinfiles.cpp \
+    foldrangeindex.cpp \
     finddialog.cpp \
     highlightinfo.cpp \
     jasshelper.cpp \
     linenumbers.cpp \
     memoryleakanalyzer.cpp \
+    outlinerfiltermodel.cpp \
+    outlinermodel.cpp \
+    overviewruler.cpp \
     pjass.cpp \
+    scriptviewer.cpp \
+    signatureindex.cpp \
+    symbolindex.cpp \
+    symbolpalette.cpp \
     textedit.cpp \
     main.cpp \
     mainwindow.cpp \
+    mappedscript.cpp \
     syntaxhighlighter.cpp \
     vjassast.cpp \
     vjassexpression.cpp \
@@ -36,19 +59,44 @@ SOURCES += \
     vjassscanner.cpp \
     vjasssetstatement.cpp \
     vjassstatement.cpp \
+    vjasssymboltable.cpp \
     vjasstoken.cpp \
     vjasstype.cpp
 
 HEADERS += \
+    analysis.h \
+    analysispool.h \
+    astspanindex.h \
     autocompletionpopup.h \
+    bracketpairindex.h \
+    callgraph.h \
+    completioncontext.h \
+    completionindex.h \
+    completionmodel.h \
+    crossreferenceindex.h \
+    diagnosticsindex.h \
+    diagnosticsmodel.h \
+    fileloader.h \
+    findengine.h \
+    findinfiles.h \
+    foldrangeindex.h \
     finddialog.h \
     highlightinfo.h \
     jasshelper.h \
     linenumbers.h \
     memoryleakanalyzer.h \
+    outlinerfiltermodel.h \
+    outlinermodel.h \
+    overviewruler.h \
     pjass.h \
+    scriptviewer.h \
+    signatureindex.h \
+    symbolindex.h \
+    symbolpalette.h \
+    rowdiff.h \
     textedit.h \
     mainwindow.h \
+    mappedscript.h \
     syntaxhighlighter.h \
     version.h \
     vjassast.h \
@@ -65,12 +113,12 @@ HEADERS += \
     vjassscanner.h \
     vjasssetstatement.h \
     vjassstatement.h \
+    vjasssymboltable.h \
     vjasstoken.h \
     vjasstype.h
 
 FORMS += \
     finddialog.ui \
-    linenumbers.ui \
     mainwindow.ui
 
 COPIES += wc3reforgedscripts pjass jasshelper
@@ -0,0 +1,104 @@
+#include <QtCore>
+
+#include "astspanindex.h"
+
+bool AstSpanIndex::Span::contains(int line, int column) const {
+    const bool afterStart = line > this->line || (line == this->line && column >= this->column);
+    const bool beforeEnd = line < this->endLine || (line == this->endLine && column < this->endColumn);
+
+    return afterStart && beforeEnd;
+}
+
+AstSpanIndex::AstSpanIndex() {
+}
+
+AstSpanIndex::AstSpanIndex(VJassAst *ast) {
+    if (ast == nullptr) {
+        return;
+    }
+
+    QStack<VJassAst*> stack;
+
+    for (VJassAst *child : ast->getChildren()) {
+        stack.push_back(child);
+    }
+
+    while (!stack.isEmpty()) {
+        VJassAst *a = stack.pop();
+        Span span;
+        span.line = a->getLine();
+        span.column = a->getColumn();
+        span.endLine = a->getEndLine();
+        span.endColumn = a->getEndColumn();
+        span.enclosingIndex = -1;
+        span.ast = a;
+        spans.push_back(span);
+
+        for (VJassAst *child : a->getChildren()) {
+            stack.push_back(child);
+        }
+    }
+
+    // outer spans come before inner spans with the same start
+    std::sort(spans.begin(), spans.end(), [](const Span &s1, const Span &s2) {
+        if (s1.line != s2.line) {
+            return s1.line < s2.line;
+        }
+
+        if (s1.column != s2.column) {
+            return s1.column < s2.column;
+        }
+
+        return s1.endLine > s2.endLine || (s1.endLine == s2.endLine && s1.endColumn > s2.endColumn);
+    });
+
+    // the stack contains all spans which enclose the start of the current span
+    QStack<int> enclosing;
+
+    for (int i = 0; i < spans.size(); i++) {
+        Span &span = spans[i];
+
+        while (!enclosing.isEmpty() && !spans.at(enclosing.top()).contains(span.line, span.column)) {
+            enclosing.pop();
+        }
+
+        span.enclosingIndex = enclosing.isEmpty() ? -1 : enclosing.top();
+        enclosing.push(i);
+    }
+}
+
+int AstSpanIndex::size() const {
+    return spans.size();
+}
+
+int AstSpanIndex::findInnermostIndex(int line, int column) const {
+    // the first span which starts after the position
+    const auto it = std::upper_bound(spans.constBegin(), spans.constEnd(), qMakePair(line, column), [](const QPair<int, int> &position, const Span &span) {
+        return position.first < span.line || (position.first == span.line && position.second < span.column);
+    });
+    int index = static_cast<int>(it - spans.constBegin()) - 1;
+
+    while (index != -1 && !spans.at(index).contains(line, column)) {
+        index = spans.at(index).enclosingIndex;
+    }
+
+    return index;
+}
+
+VJassAst* AstSpanIndex::getInnermost(int line, int column) const {
+    const int index = findInnermostIndex(line, column);
+
+    return index != -1 ? spans.at(index).ast : nullptr;
+}
+
+QList<VJassAst*> AstSpanIndex::getEnclosing(int line, int column) const {
+    QList<VJassAst*> result;
+
+    for (int index = findInnermostIndex(line, column); index != -1; index = spans.at(index).enclosingIndex) {
+        if (spans.at(index).contains(line, column)) {
+            result.push_back(spans.at(index).ast);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,54 @@
+#ifndef ASTSPANINDEX_H
+#define ASTSPANINDEX_H
+
+#include <QVector>
+#include <QList>
+
+#include "vjassast.h"
+
+/**
+ * @brief Maps source positions to AST elements by their spans.
+ *
+ * The spans of all elements are stored in one array sorted by their start positions.
+ * Every span stores the index of the nearest previous span which encloses its start.
+ * The innermost element at a position is found by a binary search for the last span starting before the position and following the enclosing spans until one contains the position.
+ * This takes O(log n) plus the nesting depth which is small for JASS code.
+ */
+class AstSpanIndex
+{
+public:
+    AstSpanIndex();
+    /**
+     * @brief Indexes all descendants of the given AST but not the AST itself since it spans the whole text.
+     */
+    explicit AstSpanIndex(VJassAst *ast);
+
+    int size() const;
+
+    /**
+     * @return Returns the innermost element which contains the position or nullptr if there is none.
+     */
+    VJassAst* getInnermost(int line, int column) const;
+    /**
+     * @return Returns all elements which contain the position starting with the innermost element.
+     */
+    QList<VJassAst*> getEnclosing(int line, int column) const;
+
+private:
+    struct Span {
+        int line;
+        int column;
+        int endLine;
+        int endColumn;
+        int enclosingIndex;
+        VJassAst *ast;
+
+        bool contains(int line, int column) const;
+    };
+
+    int findInnermostIndex(int line, int column) const;
+
+    QVector<Span> spans;
+};
+
+#endif // ASTSPANINDEX_H
@@ -2,42 +2,56 @@
 
 #include "autocompletionpopup.h"
 
-AutoCompletionPopup::AutoCompletionPopup()
+AutoCompletionPopup::AutoCompletionPopup() : completionModel(new CompletionModel(this))
 {
-    this->headerItem()->setText(0, tr("Auto Completion"));
+    this->setModel(completionModel);
+    this->setRootIsDecorated(false);
+    this->setUniformRowHeights(true);
     this->setMinimumSize(QSize(128, 128));
     //this->setWindowFlags(Qt::Popup);
     this->setWindowFlags(Qt::FramelessWindowHint | Qt::Tool);
     this->setFocusPolicy(Qt::NoFocus);
 }
 
+CompletionModel* AutoCompletionPopup::getCompletionModel() const {
+    return completionModel;
+}
+
+void AutoCompletionPopup::setEntries(const CompletionIndex::Entries &entries) {
+    completionModel->setEntries(entries);
+
+    // preselect first entry
+    if (!entries.isEmpty()) {
+        setCurrentIndex(completionModel->index(0, 0));
+    }
+}
+
 void AutoCompletionPopup::keyPressEvent(QKeyEvent *event) {
     if (event->key() == Qt::Key_Escape) {
         this->close();
     } else if (event->key() == Qt::Key_Enter) {
         qDebug() << "Pressed Enter!";
 
-        QTreeWidgetItem *item = currentItem();
+        const QModelIndex index = currentIndex();
 
-        if (item != nullptr) {
+        if (index.isValid()) {
             qDebug() << "Item selected on pressing enter";
 
-            // TODO click the item
-            emit itemClicked(item, 0);
+            emit clicked(index);
         } else {
             qDebug() << "No item selected on pressing enter!";
         }
     }
 
-    QTreeWidget::keyPressEvent(event);
+    QTreeView::keyPressEvent(event);
 }
 
 void AutoCompletionPopup::mousePressEvent(QMouseEvent *event) {
     //this->close();
-    QTreeWidget::mousePressEvent(event);
+    QTreeView::mousePressEvent(event);
 }
 
 void AutoCompletionPopup::focusOutEvent(QFocusEvent *event) {
     //this->close();
-    QTreeWidget::focusOutEvent(event);
+    QTreeView::focusOutEvent(event);
 }
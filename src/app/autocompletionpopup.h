@@ -1,17 +1,31 @@
 #ifndef AUTOCOMPLETIONPOPUP_H
 #define AUTOCOMPLETIONPOPUP_H
 
-#include <QTreeWidget>
+#include <QTreeView>
 
-class AutoCompletionPopup : public QTreeWidget
+#include "completionmodel.h"
+
+/**
+ * @brief Shows the entries of a completion model. Filtering the entries only replaces the rows of the model instead of creating new items.
+ */
+class AutoCompletionPopup : public QTreeView
 {
 public:
     AutoCompletionPopup();
 
+    CompletionModel* getCompletionModel() const;
+    /**
+     * @brief Shows the entries and selects the first one.
+     */
+    void setEntries(const CompletionIndex::Entries &entries);
+
 protected:
     virtual void keyPressEvent(QKeyEvent *event) override;
     virtual void mousePressEvent(QMouseEvent *event) override;
     virtual void focusOutEvent(QFocusEvent *event) override;
+
+private:
+    CompletionModel *completionModel;
 };
 
 #endif // AUTOCOMPLETIONPOPUP_H
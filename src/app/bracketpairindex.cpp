@@ -0,0 +1,74 @@
+#include <QtCore>
+
+#include "bracketpairindex.h"
+
+BracketPairIndex::BracketPairIndex() : matchedCount(0) {
+}
+
+void BracketPairIndex::clear() {
+    brackets.clear();
+    bracketsByPosition.clear();
+    openingBrackets.clear();
+    matchedCount = 0;
+}
+
+void BracketPairIndex::addOpeningBracket(int line, int column, bool square) {
+    const int index = brackets.size();
+    brackets.push_back(Bracket(line, column, true, square));
+    bracketsByPosition.insert(positionKey(line, column), index);
+    openingBrackets.push_back(index);
+}
+
+void BracketPairIndex::addClosingBracket(int line, int column, bool square) {
+    const int index = brackets.size();
+    brackets.push_back(Bracket(line, column, false, square));
+    bracketsByPosition.insert(positionKey(line, column), index);
+
+    // "(]" leaves both unmatched but still allows closing the round bracket later
+    if (!openingBrackets.isEmpty() && brackets.at(openingBrackets.last()).square == square) {
+        const int openingIndex = openingBrackets.takeLast();
+        brackets[openingIndex].matchIndex = index;
+        brackets[index].matchIndex = openingIndex;
+        matchedCount += 2;
+    }
+}
+
+int BracketPairIndex::size() const {
+    return brackets.size();
+}
+
+const BracketPairIndex::Bracket& BracketPairIndex::at(int index) const {
+    return brackets.at(index);
+}
+
+int BracketPairIndex::indexOf(int line, int column) const {
+    return bracketsByPosition.value(positionKey(line, column), -1);
+}
+
+int BracketPairIndex::matchOf(int line, int column) const {
+    const int index = indexOf(line, column);
+
+    return index != -1 ? brackets.at(index).matchIndex : -1;
+}
+
+int BracketPairIndex::getUnmatchedCount() const {
+    return brackets.size() - matchedCount;
+}
+
+QList<VJassParseError> BracketPairIndex::toParseErrors() const {
+    QList<VJassParseError> result;
+
+    for (const Bracket &bracket : brackets) {
+        if (bracket.matchIndex == -1) {
+            const QString value = bracket.opening ? (bracket.square ? "[" : "(") : (bracket.square ? "]" : ")");
+
+            result.push_back(VJassParseError(bracket.line, bracket.column, 1, QObject::tr("Unmatched bracket %1").arg(value)));
+        }
+    }
+
+    return result;
+}
+
+quint64 BracketPairIndex::positionKey(int line, int column) {
+    return (static_cast<quint64>(static_cast<quint32>(line)) << 32) | static_cast<quint32>(column);
+}
@@ -0,0 +1,69 @@
+#ifndef BRACKETPAIRINDEX_H
+#define BRACKETPAIRINDEX_H
+
+#include <QVector>
+#include <QHash>
+#include <QList>
+
+#include "vjassparseerror.h"
+
+/**
+ * @brief Pairs the round and square brackets of a whole text.
+ *
+ * The scanner adds every bracket in the order of the text. Opening brackets are kept on a stack until their closing brackets are found.
+ * Every bracket stores the index of its matching bracket, so the matching bracket of any bracket is found in constant time even if it is in another line.
+ * Brackets without a matching bracket keep -1 as their match index.
+ */
+class BracketPairIndex
+{
+public:
+    struct Bracket {
+        int line;
+        int column;
+        bool opening;
+        bool square;
+        int matchIndex; // -1 if the bracket is unmatched
+
+        Bracket() : line(0), column(0), opening(false), square(false), matchIndex(-1) {
+        }
+
+        Bracket(int line, int column, bool opening, bool square) : line(line), column(column), opening(opening), square(square), matchIndex(-1) {
+        }
+    };
+
+    BracketPairIndex();
+
+    void clear();
+    void addOpeningBracket(int line, int column, bool square);
+    /**
+     * @brief Pairs the closing bracket with the last opening bracket if it has the same kind. Otherwise, the closing bracket stays unmatched.
+     */
+    void addClosingBracket(int line, int column, bool square);
+
+    int size() const;
+    const Bracket& at(int index) const;
+    /**
+     * @return Returns the index of the bracket at the given position or -1 if there is none.
+     */
+    int indexOf(int line, int column) const;
+    /**
+     * @return Returns the index of the matching bracket of the bracket at the given position or -1 if there is no matched bracket.
+     */
+    int matchOf(int line, int column) const;
+    int getUnmatchedCount() const;
+
+    /**
+     * @return Returns one error for every unmatched bracket.
+     */
+    QList<VJassParseError> toParseErrors() const;
+
+private:
+    static quint64 positionKey(int line, int column);
+
+    QVector<Bracket> brackets;
+    QHash<quint64, int> bracketsByPosition;
+    QVector<int> openingBrackets; // indices of opening brackets which have not been closed yet
+    int matchedCount;
+};
+
+#endif // BRACKETPAIRINDEX_H
@@ -0,0 +1,247 @@
+#include <QtCore>
+
+#include "callgraph.h"
+
+CallGraph::CallGraph() : edgesCount(0) {
+}
+
+int CallGraph::setUnits(const VJassSymbolTable::Units &units) {
+    QSet<int> newFunctions;
+    int changedFunctions = 0;
+
+    for (const VJassSymbolTable::Unit &unit : units) {
+        if (!unit.key.startsWith(QLatin1String("function "))) {
+            continue;
+        }
+
+        const int id = intern(unit.key.mid(9));
+
+        // redeclared functions are reported by the parser, the first one is enough
+        if (newFunctions.contains(id)) {
+            continue;
+        }
+
+        newFunctions.insert(id);
+        Node &node = nodes[id];
+        node.line = unit.startLine;
+
+        // the calls of moved functions have not changed
+        if (node.declared && node.tokensHash == unit.tokensHash) {
+            continue;
+        }
+
+        node.declared = true;
+        node.tokensHash = unit.tokensHash;
+
+        QVector<int> callees;
+        callees.reserve(unit.callees.size());
+
+        for (const QString &callee : unit.callees) {
+            callees.push_back(intern(callee));
+        }
+
+        setCallees(id, callees);
+        changedFunctions++;
+    }
+
+    for (int id : functions) {
+        if (!newFunctions.contains(id)) {
+            setCallees(id, QVector<int>());
+            nodes[id].declared = false;
+            nodes[id].tokensHash = 0;
+            changedFunctions++;
+        }
+    }
+
+    functions = newFunctions;
+
+    return changedFunctions;
+}
+
+int CallGraph::getId(const QString &name) const {
+    return ids.value(name, -1);
+}
+
+const QString& CallGraph::getName(int id) const {
+    return nodes.at(id).name;
+}
+
+int CallGraph::size() const {
+    return nodes.size();
+}
+
+bool CallGraph::isDeclared(int id) const {
+    return nodes.at(id).declared;
+}
+
+int CallGraph::getLine(int id) const {
+    return nodes.at(id).line;
+}
+
+int CallGraph::getFunctionsCount() const {
+    return functions.size();
+}
+
+int CallGraph::getEdgesCount() const {
+    return edgesCount;
+}
+
+const QVector<int>& CallGraph::getCallees(int id) const {
+    return nodes.at(id).callees;
+}
+
+const QVector<int>& CallGraph::getCallers(int id) const {
+    return nodes.at(id).callers;
+}
+
+QVector<int> CallGraph::findUnreachable(const QStringList &roots) const {
+    QVector<bool> reached(nodes.size(), false);
+    QVector<int> stack;
+
+    for (const QString &root : roots) {
+        const int id = getId(root);
+
+        if (id != -1 && !reached.at(id)) {
+            reached[id] = true;
+            stack.push_back(id);
+        }
+    }
+
+    while (!stack.isEmpty()) {
+        const int id = stack.takeLast();
+
+        for (int callee : nodes.at(id).callees) {
+            if (!reached.at(callee)) {
+                reached[callee] = true;
+                stack.push_back(callee);
+            }
+        }
+    }
+
+    QVector<int> result;
+
+    for (int id : functions) {
+        if (!reached.at(id)) {
+            result.push_back(id);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+QVector<QVector<int>> CallGraph::findRecursions() const {
+    // Tarjan's algorithm with an explicit stack since long call chains would overflow the call stack
+    QVector<QVector<int>> result;
+    QVector<int> indices(nodes.size(), -1);
+    QVector<int> lowLinks(nodes.size(), 0);
+    QVector<bool> onStack(nodes.size(), false);
+    QVector<int> stack;
+    // every frame is a node and the index of its next callee
+    QVector<QPair<int, int>> frames;
+    int index = 0;
+
+    for (int root = 0; root < nodes.size(); root++) {
+        if (indices.at(root) != -1 || !nodes.at(root).declared) {
+            continue;
+        }
+
+        frames.push_back(qMakePair(root, 0));
+
+        while (!frames.isEmpty()) {
+            const int id = frames.last().first;
+
+            if (frames.last().second == 0 && indices.at(id) == -1) {
+                indices[id] = index;
+                lowLinks[id] = index;
+                index++;
+                stack.push_back(id);
+                onStack[id] = true;
+            }
+
+            const QVector<int> &callees = nodes.at(id).callees;
+
+            if (frames.last().second < callees.size()) {
+                const int callee = callees.at(frames.last().second);
+                frames.last().second++;
+
+                if (indices.at(callee) == -1) {
+                    frames.push_back(qMakePair(callee, 0));
+                } else if (onStack.at(callee)) {
+                    lowLinks[id] = qMin(lowLinks.at(id), indices.at(callee));
+                }
+
+                continue;
+            }
+
+            frames.removeLast();
+
+            if (!frames.isEmpty()) {
+                const int caller = frames.last().first;
+                lowLinks[caller] = qMin(lowLinks.at(caller), lowLinks.at(id));
+            }
+
+            if (lowLinks.at(id) == indices.at(id)) {
+                QVector<int> component;
+                int member = -1;
+
+                do {
+                    member = stack.takeLast();
+                    onStack[member] = false;
+                    component.push_back(member);
+                } while (member != id);
+
+                const bool callsItself = std::binary_search(callees.cbegin(), callees.cend(), id);
+
+                if (component.size() > 1 || callsItself) {
+                    std::sort(component.begin(), component.end());
+                    result.push_back(component);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+int CallGraph::intern(const QString &name) {
+    auto iterator = ids.constFind(name);
+
+    if (iterator != ids.cend()) {
+        return iterator.value();
+    }
+
+    const int id = nodes.size();
+    nodes.push_back(Node());
+    nodes[id].name = name;
+    ids.insert(name, id);
+
+    return id;
+}
+
+void CallGraph::setCallees(int id, const QVector<int> &callees) {
+    // only the edges of this function are touched
+    for (int callee : nodes.at(id).callees) {
+        QVector<int> &callers = nodes[callee].callers;
+        auto iterator = std::lower_bound(callers.begin(), callers.end(), id);
+
+        if (iterator != callers.end() && *iterator == id) {
+            callers.erase(iterator);
+        }
+    }
+
+    edgesCount -= nodes.at(id).callees.size();
+
+    QVector<int> sortedCallees = callees;
+    std::sort(sortedCallees.begin(), sortedCallees.end());
+    sortedCallees.erase(std::unique(sortedCallees.begin(), sortedCallees.end()), sortedCallees.end());
+
+    for (int callee : sortedCallees) {
+        QVector<int> &callers = nodes[callee].callers;
+        callers.insert(std::lower_bound(callers.begin(), callers.end(), id), id);
+    }
+
+    edgesCount += sortedCallees.size();
+    nodes[id].callees = sortedCallees;
+}
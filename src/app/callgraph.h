@@ -0,0 +1,88 @@
+#ifndef CALLGRAPH_H
+#define CALLGRAPH_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+
+#include "vjasssymboltable.h"
+
+/**
+ * @brief Stores which functions call which functions and natives of a script.
+ *
+ * Every name is interned to an ID once and keeps it, so the adjacency lists only store IDs. Passing a function as code like "function Foo" counts as call.
+ * The callees of a function are taken from its unit of the symbol table. Updating the graph only replaces the edges of functions whose tokens have been changed.
+ */
+class CallGraph
+{
+public:
+    CallGraph();
+
+    /**
+     * @brief Replaces the functions and their calls by the function units. Units of other top level lines are ignored.
+     * @return Returns the number of functions whose edges have been replaced or removed.
+     */
+    int setUnits(const VJassSymbolTable::Units &units);
+
+    /**
+     * @return Returns the ID of the name or -1 if it has never been used.
+     */
+    int getId(const QString &name) const;
+    const QString& getName(int id) const;
+    /**
+     * @return Returns the number of all interned names including the called natives.
+     */
+    int size() const;
+    /**
+     * @return Returns true if the ID belongs to a function of the script. Natives and unknown functions have no declaration.
+     */
+    bool isDeclared(int id) const;
+    /**
+     * @return Returns the line of the declaration of the function.
+     */
+    int getLine(int id) const;
+    int getFunctionsCount() const;
+    int getEdgesCount() const;
+
+    /**
+     * @return Returns the sorted IDs of the functions and natives called by the function.
+     */
+    const QVector<int>& getCallees(int id) const;
+    /**
+     * @return Returns the sorted IDs of the functions which call the function.
+     */
+    const QVector<int>& getCallers(int id) const;
+
+    /**
+     * @return Returns the sorted IDs of all functions which cannot be reached from the given functions. The game calls main and config, so they are the default roots.
+     */
+    QVector<int> findUnreachable(const QStringList &roots = QStringList() << "main" << "config") const;
+    /**
+     * @return Returns the functions of every cycle of calls. A function which calls itself is a cycle on its own.
+     */
+    QVector<QVector<int>> findRecursions() const;
+
+private:
+    struct Node {
+        QString name;
+        int line;
+        uint tokensHash;
+        bool declared;
+        QVector<int> callees;
+        QVector<int> callers;
+
+        Node() : line(0), tokensHash(0), declared(false) {
+        }
+    };
+
+    int intern(const QString &name);
+    void setCallees(int id, const QVector<int> &callees);
+
+    QVector<Node> nodes;
+    QHash<QString, int> ids;
+    QSet<int> functions;
+    int edgesCount;
+};
+
+#endif // CALLGRAPH_H
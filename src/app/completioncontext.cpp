@@ -0,0 +1,187 @@
+#include <QtCore>
+
+#include "completioncontext.h"
+#include "vjassscanner.h"
+
+CompletionContext::CompletionContext() : kinds(0), returnValue(false), statementStart(false) {
+}
+
+CompletionContext::CompletionContext(const QString &line, int column) : kinds(0), returnValue(false), statementStart(false) {
+    column = qBound(0, column, line.size());
+    int start = column;
+
+    while (start > 0 && (line.at(start - 1).isLetterOrNumber() || line.at(start - 1) == '_')) {
+        start--;
+    }
+
+    prefix = line.mid(start, column - start);
+
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(line.left(column));
+
+    if (!tokens.isEmpty()) {
+        const VJassToken &last = tokens.last();
+        const bool endsAtCursor = last.getColumn() + last.getLength() >= column;
+
+        // nothing is completed in comments and unterminated strings
+        if (endsAtCursor && (last.getType() == VJassToken::Comment || (last.getType() == VJassToken::StringLiteral && (last.getLength() < 2 || !last.getValue().endsWith('"'))))) {
+            return;
+        }
+
+        // the prefix itself might have been scanned as keyword
+        if (!prefix.isEmpty() && last.getColumn() == start) {
+            tokens.removeLast();
+        }
+    }
+
+    if (tokens.isEmpty()) {
+        // statements and global declarations start with keywords or types
+        setKinds({CompletionIndex::Keyword, CompletionIndex::Type});
+        statementStart = true;
+
+        return;
+    }
+
+    const VJassToken::Type first = tokens.first().getType();
+    const VJassToken &previous = tokens.last();
+    bool isExpression = false;
+
+    switch (previous.getType()) {
+        case VJassToken::CallKeyword: {
+            setKinds({CompletionIndex::Function, CompletionIndex::Native});
+
+            break;
+        }
+
+        case VJassToken::SetKeyword: {
+            setKinds({CompletionIndex::Global, CompletionIndex::Local, CompletionIndex::Parameter});
+
+            break;
+        }
+
+        case VJassToken::LocalKeyword:
+        case VJassToken::TakesKeyword:
+        case VJassToken::ReturnsKeyword:
+        case VJassToken::ExtendsKeyword:
+        case VJassToken::ConstantKeyword: {
+            setKinds({CompletionIndex::Type});
+
+            break;
+        }
+
+        // a new name is declared
+        case VJassToken::Text:
+        case VJassToken::ArrayKeyword:
+        case VJassToken::NativeKeyword:
+        case VJassToken::TypeKeyword: {
+            break;
+        }
+
+        case VJassToken::FunctionKeyword: {
+            // a code value refers to a function but a declaration introduces a new name
+            if (tokens.size() > 1 && !(tokens.size() == 2 && first == VJassToken::ConstantKeyword)) {
+                setKinds({CompletionIndex::Function});
+            }
+
+            break;
+        }
+
+        case VJassToken::Separator: {
+            bool isParameterList = false;
+
+            for (const VJassToken &token : tokens) {
+                if (token.getType() == VJassToken::TakesKeyword) {
+                    isParameterList = true;
+                } else if (token.getType() == VJassToken::ReturnsKeyword) {
+                    isParameterList = false;
+                }
+            }
+
+            if (isParameterList) {
+                setKinds({CompletionIndex::Type});
+            } else {
+                isExpression = true;
+            }
+
+            break;
+        }
+
+        default: {
+            isExpression = true;
+
+            break;
+        }
+    }
+
+    if (!isExpression) {
+        return;
+    }
+
+    setKinds({CompletionIndex::Keyword, CompletionIndex::Function, CompletionIndex::Native, CompletionIndex::Constant, CompletionIndex::Global, CompletionIndex::Local, CompletionIndex::Parameter});
+    returnValue = first == VJassToken::ReturnKeyword;
+
+    // the type of the assigned variable is expected
+    for (int i = 0; i < tokens.size(); i++) {
+        if (tokens.at(i).getType() == VJassToken::AssignmentOperator) {
+            if (first == VJassToken::SetKeyword && tokens.size() > 1 && tokens.at(1).getType() == VJassToken::Text) {
+                assignedVariable = tokens.at(1).getValue();
+            } else if (i >= 2 && tokens.at(i - 2).getType() == VJassToken::Text) {
+                expectedType = tokens.at(i - 2).getValue();
+            }
+
+            break;
+        }
+    }
+}
+
+const QString& CompletionContext::getPrefix() const {
+    return prefix;
+}
+
+bool CompletionContext::isEnabled() const {
+    return kinds != 0;
+}
+
+bool CompletionContext::isStatementStart() const {
+    return statementStart;
+}
+
+bool CompletionContext::acceptsKind(CompletionIndex::Kind kind) const {
+    return (kinds & (1 << kind)) != 0;
+}
+
+bool CompletionContext::accepts(const CompletionIndex::Entry &entry) const {
+    return acceptsKind(entry.kind) && (entry.scope.isEmpty() || entry.scope == function);
+}
+
+const QString& CompletionContext::getAssignedVariable() const {
+    return assignedVariable;
+}
+
+bool CompletionContext::isReturnValue() const {
+    return returnValue;
+}
+
+void CompletionContext::setFunction(const QString &function) {
+    this->function = function;
+}
+
+const QString& CompletionContext::getFunction() const {
+    return function;
+}
+
+void CompletionContext::setExpectedType(const QString &expectedType) {
+    this->expectedType = expectedType;
+}
+
+const QString& CompletionContext::getExpectedType() const {
+    return expectedType;
+}
+
+void CompletionContext::setKinds(std::initializer_list<CompletionIndex::Kind> kinds) {
+    this->kinds = 0;
+
+    for (CompletionIndex::Kind kind : kinds) {
+        this->kinds |= 1 << kind;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef COMPLETIONCONTEXT_H
+#define COMPLETIONCONTEXT_H
+
+#include <QString>
+
+#include "completionindex.h"
+
+/**
+ * @brief Describes which declarations can be completed at the cursor.
+ *
+ * Only the line up to the cursor is scanned, so the context is available immediately after a keystroke without waiting for the analysis of the whole text.
+ * The enclosing function and the expected type can be added from the results of the last analysis.
+ */
+class CompletionContext
+{
+public:
+    CompletionContext();
+    /**
+     * @param column The column of the cursor in the line.
+     */
+    CompletionContext(const QString &line, int column);
+
+    /**
+     * @return Returns the part of the identifier in front of the cursor.
+     */
+    const QString& getPrefix() const;
+    /**
+     * @return Returns false in comments, strings and where a new name is declared.
+     */
+    bool isEnabled() const;
+    /**
+     * @return Returns true if there is nothing but white spaces in front of the prefix.
+     */
+    bool isStatementStart() const;
+    bool acceptsKind(CompletionIndex::Kind kind) const;
+    /**
+     * @return Returns true if the entry can be used here. Local variables and parameters can only be used in their own function.
+     */
+    bool accepts(const CompletionIndex::Entry &entry) const;
+
+    /**
+     * @return Returns the name of the variable of a set statement if the cursor is behind its assignment operator.
+     */
+    const QString& getAssignedVariable() const;
+    /**
+     * @return Returns true if the cursor is behind a return keyword.
+     */
+    bool isReturnValue() const;
+
+    void setFunction(const QString &function);
+    const QString& getFunction() const;
+    /**
+     * @brief Entries with the expected type are shown first.
+     */
+    void setExpectedType(const QString &expectedType);
+    const QString& getExpectedType() const;
+
+private:
+    void setKinds(std::initializer_list<CompletionIndex::Kind> kinds);
+
+    QString prefix;
+    int kinds; // one bit for every accepted kind
+    QString assignedVariable;
+    bool returnValue;
+    bool statementStart;
+    QString function;
+    QString expectedType;
+};
+
+#endif // COMPLETIONCONTEXT_H
@@ -0,0 +1,271 @@
+#include <QtCore>
+
+#include "completionindex.h"
+#include "completioncontext.h"
+#include "vjasstoken.h"
+#include "vjassnative.h"
+#include "vjassfunction.h"
+#include "vjassglobals.h"
+#include "vjassglobal.h"
+#include "vjasslocalstatement.h"
+#include "vjasstype.h"
+
+namespace {
+
+bool entryLessThan(const CompletionIndex::Entry &e1, const CompletionIndex::Entry &e2) {
+    return e1.key < e2.key || (e1.key == e2.key && e1.name < e2.name);
+}
+
+/**
+ * @return Returns the first entry whose key is not less than the lower case prefix. All matching entries follow it.
+ */
+CompletionIndex::Entries::const_iterator lowerBound(const CompletionIndex::Entries &entries, const QString &prefix) {
+    return std::lower_bound(entries.cbegin(), entries.cend(), prefix, [](const CompletionIndex::Entry &entry, const QString &prefix) {
+        return entry.key < prefix;
+    });
+}
+
+void addBuiltinEntries(CompletionIndex::Entries &entries, const QSet<QString> &names, CompletionIndex::Kind kind) {
+    for (const QString &name : names) {
+        entries.push_back(CompletionIndex::Entry(name, kind));
+    }
+}
+
+}
+
+CompletionIndex::CompletionIndex() {
+}
+
+int CompletionIndex::setUnits(const Units &units) {
+    int changedUnits = 0;
+
+    // removed or changed units
+    for (auto iterator = this->units.cbegin(); iterator != this->units.cend(); ++iterator) {
+        auto newIterator = units.constFind(iterator.key());
+
+        if (newIterator == units.cend() || newIterator.value() != iterator.value()) {
+            for (const Entry &entry : iterator.value()) {
+                removeEntry(entry);
+            }
+
+            changedUnits++;
+        }
+    }
+
+    // added or changed units
+    for (auto iterator = units.cbegin(); iterator != units.cend(); ++iterator) {
+        auto oldIterator = this->units.constFind(iterator.key());
+
+        if (oldIterator == this->units.cend() || oldIterator.value() != iterator.value()) {
+            for (const Entry &entry : iterator.value()) {
+                insertEntry(entry);
+            }
+
+            if (oldIterator == this->units.cend()) {
+                changedUnits++;
+            }
+        }
+    }
+
+    this->units = units;
+
+    return changedUnits;
+}
+
+const CompletionIndex::Units& CompletionIndex::getUnits() const {
+    return units;
+}
+
+int CompletionIndex::getUserEntriesCount() const {
+    return userEntries.size();
+}
+
+CompletionIndex::Entries CompletionIndex::find(const QString &prefix, int maxResults) const {
+    const QString key = prefix.toLower();
+    const Entries &builtinEntries = getBuiltinEntries();
+    auto builtinIterator = lowerBound(builtinEntries, key);
+    auto userIterator = lowerBound(userEntries, key);
+    Entries result;
+
+    // merges both sorted ranges and stops at the first entry which does not match anymore, so only the results are visited
+    while (result.size() < maxResults) {
+        const bool builtinMatches = builtinIterator != builtinEntries.cend() && builtinIterator->key.startsWith(key);
+        const bool userMatches = userIterator != userEntries.cend() && userIterator->key.startsWith(key);
+
+        if (userMatches && (!builtinMatches || !entryLessThan(*builtinIterator, *userIterator))) {
+            result.push_back(*userIterator);
+            ++userIterator;
+        } else if (builtinMatches) {
+            result.push_back(*builtinIterator);
+            ++builtinIterator;
+        } else {
+            break;
+        }
+    }
+
+    return result;
+}
+
+CompletionIndex::Entries CompletionIndex::find(const CompletionContext &context, int maxResults) const {
+    const QString key = context.getPrefix().toLower();
+    const Entries &builtinEntries = getBuiltinEntries();
+    Entries expected;
+    Entries others;
+
+    if (!context.isEnabled()) {
+        return expected;
+    }
+
+    // both ranges are visited until enough entries of the expected type have been found, since they might be behind rejected ones
+    for (const Entries *entries : {&userEntries, &builtinEntries}) {
+        for (auto iterator = lowerBound(*entries, key); iterator != entries->cend() && iterator->key.startsWith(key) && expected.size() < maxResults; ++iterator) {
+            if (!context.accepts(*iterator)) {
+                continue;
+            }
+
+            if (!context.getExpectedType().isEmpty() && iterator->detail == context.getExpectedType()) {
+                expected.push_back(*iterator);
+            } else if (others.size() < maxResults) {
+                others.push_back(*iterator);
+            } else if (context.getExpectedType().isEmpty()) {
+                break;
+            }
+        }
+    }
+
+    std::stable_sort(expected.begin(), expected.end(), entryLessThan);
+    std::stable_sort(others.begin(), others.end(), entryLessThan);
+
+    for (int i = 0; i < others.size() && expected.size() < maxResults; i++) {
+        expected.push_back(others.at(i));
+    }
+
+    return expected;
+}
+
+const CompletionIndex::Entry* CompletionIndex::findDeclaration(const QString &name, const QString &function) const {
+    const Entry *result = nullptr;
+
+    for (auto iterator = lowerBound(userEntries, name.toLower()); iterator != userEntries.cend() && iterator->key.size() == name.size() && iterator->key.startsWith(name.toLower()); ++iterator) {
+        if (iterator->name != name) {
+            continue;
+        }
+
+        if (iterator->scope.isEmpty()) {
+            if (result == nullptr) {
+                result = &(*iterator);
+            }
+        } else if (iterator->scope == function) {
+            return &(*iterator);
+        }
+    }
+
+    return result;
+}
+
+CompletionIndex::Units CompletionIndex::unitsFromAst(const VJassAst *ast) {
+    Units result;
+
+    if (ast == nullptr) {
+        return result;
+    }
+
+    int globalsBlocks = 0;
+
+    for (const VJassAst *child : ast->getChildren()) {
+        const VJassNative *vjassNative = dynamic_cast<const VJassNative*>(child);
+
+        if (vjassNative != nullptr) {
+            if (vjassNative->getIdentifier().isEmpty()) {
+                continue;
+            }
+
+            const bool isFunction = dynamic_cast<const VJassFunction*>(child) != nullptr;
+            Entries &entries = result[(isFunction ? QString("function ") : QString("native ")) + vjassNative->getIdentifier()];
+            entries.push_back(Entry(vjassNative->getIdentifier(), isFunction ? Function : Native, vjassNative->getReturnType()));
+
+            for (const VJassFunctionParameter &parameter : vjassNative->getParameters()) {
+                entries.push_back(Entry(parameter.getName(), Parameter, parameter.getType(), vjassNative->getIdentifier()));
+            }
+
+            if (isFunction) {
+                for (const VJassAst *statement : child->getChildren()) {
+                    const VJassLocalStatement *localStatement = dynamic_cast<const VJassLocalStatement*>(statement);
+
+                    if (localStatement != nullptr && !localStatement->getVariableName().isEmpty()) {
+                        entries.push_back(Entry(localStatement->getVariableName(), Local, localStatement->getType(), vjassNative->getIdentifier()));
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        // the blocks are numbered since their lines change with every edit above them
+        if (dynamic_cast<const VJassGlobals*>(child) != nullptr) {
+            Entries &entries = result[QString("globals %1").arg(globalsBlocks++)];
+
+            for (const VJassAst *declaration : child->getChildren()) {
+                const VJassGlobal *global = dynamic_cast<const VJassGlobal*>(declaration);
+
+                if (global != nullptr && !global->getName().isEmpty()) {
+                    entries.push_back(Entry(global->getName(), global->getIsConstant() ? Constant : Global, global->getType()));
+                }
+            }
+
+            continue;
+        }
+
+        const VJassType *vjassType = dynamic_cast<const VJassType*>(child);
+
+        if (vjassType != nullptr && !vjassType->getIdentifier().isEmpty()) {
+            result[QString("type ") + vjassType->getIdentifier()].push_back(Entry(vjassType->getIdentifier(), Type, vjassType->getParent()));
+        }
+    }
+
+    return result;
+}
+
+const CompletionIndex::Entries& CompletionIndex::getBuiltinEntries() {
+    // built only once and shared by all threads
+    static const Entries entries = []() {
+        Entries result;
+
+        for (const QString &keyword : VJassToken::KEYWRODS_ALL) {
+            result.push_back(Entry(keyword, Keyword));
+        }
+
+        addBuiltinEntries(result, VJassToken::COMMONJ_TYPES_ALL, Type);
+        addBuiltinEntries(result, VJassToken::COMMONJ_NATIVES_ALL, Native);
+        addBuiltinEntries(result, VJassToken::COMMONJ_CONSTANTS_ALL, Constant);
+        addBuiltinEntries(result, VJassToken::BLIZZARDJ_CONSTANTS_ALL, Constant);
+        addBuiltinEntries(result, VJassToken::BLIZZARDJ_GLOBALS_ALL, Global);
+        addBuiltinEntries(result, VJassToken::BLIZZARDJ_FUNCTIONS_ALL, Function);
+        addBuiltinEntries(result, VJassToken::COMMONAI_NATIVES_ALL, Native);
+        addBuiltinEntries(result, VJassToken::COMMONAI_CONSTANTS_ALL, Constant);
+        addBuiltinEntries(result, VJassToken::COMMONAI_GLOBALS_ALL, Global);
+        addBuiltinEntries(result, VJassToken::COMMONAI_FUNCTIONS_ALL, Function);
+        std::sort(result.begin(), result.end(), entryLessThan);
+
+        return result;
+    }();
+
+    return entries;
+}
+
+void CompletionIndex::insertEntry(const Entry &entry) {
+    auto iterator = std::upper_bound(userEntries.begin(), userEntries.end(), entry, entryLessThan);
+    userEntries.insert(iterator, entry);
+}
+
+void CompletionIndex::removeEntry(const Entry &entry) {
+    auto range = std::equal_range(userEntries.begin(), userEntries.end(), entry, entryLessThan);
+
+    for (auto iterator = range.first; iterator != range.second; ++iterator) {
+        if (*iterator == entry) {
+            userEntries.erase(iterator);
+
+            break;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef COMPLETIONINDEX_H
+#define COMPLETIONINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+#include "vjassast.h"
+
+class CompletionContext;
+
+/**
+ * @brief Finds the declared symbols which start with a prefix for the code completion.
+ *
+ * All keywords and symbols of common.j, Blizzard.j and common.ai are stored once in a sorted array which is shared by all indices.
+ * The declarations of the user are stored in a second sorted array. The matches of a prefix form a range in both arrays which is found by a binary search.
+ * The declarations of the user are grouped into units like functions or globals blocks. Only the entries of changed units are removed and inserted again.
+ */
+class CompletionIndex
+{
+public:
+    enum Kind : quint8 {
+        Keyword,
+        Type,
+        Native,
+        Function,
+        Constant,
+        Global,
+        Local,
+        Parameter
+    };
+
+    struct Entry {
+        QString name;
+        // the lower case name which the entries are sorted by
+        QString key;
+        // the type of a variable or the return type of a function
+        QString detail;
+        // the function of a local variable or a parameter
+        QString scope;
+        Kind kind;
+
+        Entry() : kind(Keyword) {
+        }
+
+        Entry(const QString &name, Kind kind, const QString &detail = QString(), const QString &scope = QString())
+            : name(name)
+            , key(name.toLower())
+            , detail(detail)
+            , scope(scope)
+            , kind(kind) {
+        }
+    };
+
+    using Entries = QVector<Entry>;
+    /**
+     * The entries of all units by the keys of the units.
+     */
+    using Units = QHash<QString, Entries>;
+
+    CompletionIndex();
+
+    /**
+     * @brief Replaces the declarations of the user. Units which have not changed keep their entries.
+     * @return Returns the number of units which have been removed, inserted or replaced.
+     */
+    int setUnits(const Units &units);
+    const Units& getUnits() const;
+    int getUserEntriesCount() const;
+
+    /**
+     * @return Returns up to maxResults entries which start with the prefix ignoring the case. They are sorted by their names and the declarations of the user come first for equal names.
+     */
+    Entries find(const QString &prefix, int maxResults) const;
+    /**
+     * @return Returns up to maxResults entries which start with the prefix of the context and are accepted by it. Entries of the expected type come first.
+     */
+    Entries find(const CompletionContext &context, int maxResults) const;
+    /**
+     * @return Returns the declaration of the user with exactly the given name or nullptr. Local variables and parameters of the given function hide globals.
+     */
+    const Entry* findDeclaration(const QString &name, const QString &function) const;
+
+    /**
+     * @brief Groups the declarations of the AST into units. Every function, native and type is one unit and every globals block is one unit.
+     */
+    static Units unitsFromAst(const VJassAst *ast);
+    /**
+     * @return Returns the sorted entries of all keywords and the symbols of the standard scripts.
+     */
+    static const Entries& getBuiltinEntries();
+
+private:
+    void insertEntry(const Entry &entry);
+    void removeEntry(const Entry &entry);
+
+    Entries userEntries;
+    Units units;
+};
+
+inline bool operator==(const CompletionIndex::Entry &e1, const CompletionIndex::Entry &e2) {
+    return e1.kind == e2.kind
+            && e1.name == e2.name
+            && e1.detail == e2.detail
+            && e1.scope == e2.scope;
+}
+
+#endif // COMPLETIONINDEX_H
@@ -0,0 +1,98 @@
+#include <QtCore>
+
+#include "completionmodel.h"
+
+CompletionModel::CompletionModel(QObject *parent) : QAbstractTableModel(parent) {
+}
+
+int CompletionModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : entries.size();
+}
+
+int CompletionModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : 2;
+}
+
+QVariant CompletionModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= entries.size()) {
+        return QVariant();
+    }
+
+    const CompletionIndex::Entry &entry = entries.at(index.row());
+
+    switch (role) {
+        case Qt::DisplayRole: {
+            if (index.column() == 0) {
+                return entry.name;
+            }
+
+            return entry.detail.isEmpty() ? kindName(entry.kind) : tr("%1 %2").arg(kindName(entry.kind)).arg(entry.detail);
+        }
+
+        case KindRole: {
+            return static_cast<int>(entry.kind);
+        }
+
+        default: {
+            break;
+        }
+    }
+
+    return QVariant();
+}
+
+QVariant CompletionModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        return section == 0 ? tr("Auto Completion") : tr("Kind");
+    }
+
+    return QVariant();
+}
+
+void CompletionModel::setEntries(const CompletionIndex::Entries &entries) {
+    beginResetModel();
+    this->entries = entries;
+    endResetModel();
+}
+
+const CompletionIndex::Entries& CompletionModel::getEntries() const {
+    return entries;
+}
+
+QString CompletionModel::kindName(CompletionIndex::Kind kind) {
+    switch (kind) {
+        case CompletionIndex::Keyword: {
+            return tr("keyword");
+        }
+
+        case CompletionIndex::Type: {
+            return tr("type");
+        }
+
+        case CompletionIndex::Native: {
+            return tr("native");
+        }
+
+        case CompletionIndex::Function: {
+            return tr("function");
+        }
+
+        case CompletionIndex::Constant: {
+            return tr("constant");
+        }
+
+        case CompletionIndex::Global: {
+            return tr("global");
+        }
+
+        case CompletionIndex::Local: {
+            return tr("local");
+        }
+
+        case CompletionIndex::Parameter: {
+            return tr("parameter");
+        }
+    }
+
+    return QString();
+}
@@ -0,0 +1,38 @@
+#ifndef COMPLETIONMODEL_H
+#define COMPLETIONMODEL_H
+
+#include <QAbstractTableModel>
+
+#include "completionindex.h"
+
+/**
+ * @brief Shows the entries of the completion index in the popup.
+ *
+ * The entries are replaced at once whenever the prefix changes, so the view only has to request the data of its visible rows again.
+ */
+class CompletionModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        KindRole = Qt::UserRole
+    };
+
+    CompletionModel(QObject *parent = nullptr);
+
+    virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    virtual int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setEntries(const CompletionIndex::Entries &entries);
+    const CompletionIndex::Entries& getEntries() const;
+
+    static QString kindName(CompletionIndex::Kind kind);
+
+private:
+    CompletionIndex::Entries entries;
+};
+
+#endif // COMPLETIONMODEL_H
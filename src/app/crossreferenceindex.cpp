@@ -0,0 +1,360 @@
+#include <QtCore>
+
+#include "crossreferenceindex.h"
+
+namespace {
+
+// identifiers cannot end with an underscore
+const QRegularExpression IDENTIFIER_REGEX = QRegularExpression("^[a-zA-Z]([a-zA-Z0-9_]*[a-zA-Z0-9])?$");
+
+}
+
+CrossReferenceIndex::CrossReferenceIndex() : referencesCount(0) {
+}
+
+int CrossReferenceIndex::setUnits(const QString &source, const VJassSymbolTable::Units &units) {
+    QHash<QString, int> oldIds = sources.value(source);
+    QHash<QString, int> newIds;
+    int changedUnits = 0;
+
+    for (const VJassSymbolTable::Unit &unit : units) {
+        // redeclared functions are reported by the parser, the first one is enough
+        if (newIds.contains(unit.key)) {
+            continue;
+        }
+
+        auto iterator = oldIds.find(unit.key);
+
+        if (iterator != oldIds.end()) {
+            Entry &entry = entries[iterator.value()];
+
+            // the names and therefore the postings have not changed
+            if (entry.tokensHash == unit.tokensHash && entry.endLine - entry.startLine == unit.endLine - unit.startLine) {
+                entry.startLine = unit.startLine;
+                entry.endLine = unit.endLine;
+                // the kinds of unresolved names might have been changed by other declarations
+                entry.references = unit.references;
+                newIds.insert(unit.key, iterator.value());
+                oldIds.erase(iterator);
+
+                continue;
+            }
+
+            removeUnit(iterator.value());
+            oldIds.erase(iterator);
+            changedUnits++;
+        }
+
+        newIds.insert(unit.key, insertUnit(source, unit));
+        changedUnits++;
+    }
+
+    for (int id : oldIds) {
+        removeUnit(id);
+        changedUnits++;
+    }
+
+    if (newIds.isEmpty()) {
+        sources.remove(source);
+        unitsByLine.remove(source);
+    } else {
+        QVector<int> ids;
+        ids.reserve(newIds.size());
+
+        for (int id : newIds) {
+            ids.push_back(id);
+        }
+
+        std::sort(ids.begin(), ids.end(), [this](int id1, int id2) {
+            return entries.at(id1).startLine < entries.at(id2).startLine;
+        });
+
+        sources.insert(source, newIds);
+        unitsByLine.insert(source, ids);
+    }
+
+    return changedUnits;
+}
+
+void CrossReferenceIndex::removeSource(const QString &source) {
+    setUnits(source, VJassSymbolTable::Units());
+}
+
+bool CrossReferenceIndex::hasSource(const QString &source) const {
+    return sources.contains(source);
+}
+
+void CrossReferenceIndex::setSecondarySources(const QStringList &sources) {
+    secondarySources.clear();
+
+    for (const QString &source : sources) {
+        secondarySources.insert(source);
+    }
+}
+
+int CrossReferenceIndex::getUnitsCount() const {
+    return entries.size() - freeIds.size();
+}
+
+int CrossReferenceIndex::getReferencesCount() const {
+    return referencesCount;
+}
+
+int CrossReferenceIndex::unitAt(const QString &source, int line) const {
+    auto iterator = unitsByLine.constFind(source);
+
+    if (iterator == unitsByLine.cend()) {
+        return -1;
+    }
+
+    const QVector<int> &ids = iterator.value();
+    auto idIterator = std::upper_bound(ids.cbegin(), ids.cend(), line, [this](int line, int id) {
+        return line < entries.at(id).startLine;
+    });
+
+    if (idIterator == ids.cbegin()) {
+        return -1;
+    }
+
+    --idIterator;
+
+    return line <= entries.at(*idIterator).endLine ? *idIterator : -1;
+}
+
+bool CrossReferenceIndex::isLocal(int unit, const QString &name) const {
+    if (unit < 0 || unit >= entries.size()) {
+        return false;
+    }
+
+    for (const VJassSymbolTable::Reference &reference : entries.at(unit).references) {
+        if (reference.name == name) {
+            return isLocalKind(reference.kind);
+        }
+    }
+
+    return false;
+}
+
+bool CrossReferenceIndex::findDeclaration(const QString &source, int line, const QString &name, Location &location) const {
+    const int unit = unitAt(source, line);
+
+    if (isLocal(unit, name)) {
+        for (const VJassSymbolTable::Reference &reference : entries.at(unit).references) {
+            if (reference.isDeclaration && reference.name == name && isLocalKind(reference.kind)) {
+                location = this->location(unit, reference);
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    auto iterator = declarations.constFind(name);
+
+    if (iterator == declarations.cend() || iterator.value().isEmpty()) {
+        return false;
+    }
+
+    // the declarations of a unit are appended again whenever it is changed, so the first one depends on the order of the edits
+    const Declaration *declaration = &iterator.value().first();
+
+    for (const Declaration &otherDeclaration : iterator.value()) {
+        if (precedes(otherDeclaration, *declaration, source)) {
+            declaration = &otherDeclaration;
+        }
+    }
+
+    location = this->location(declaration->unit, entries.at(declaration->unit).references.at(declaration->reference));
+
+    return true;
+}
+
+QVector<int> CrossReferenceIndex::candidates(const QString &source, int line, const QString &name) const {
+    const int unit = unitAt(source, line);
+
+    if (isLocal(unit, name)) {
+        return QVector<int>() << unit;
+    }
+
+    return postings.value(name);
+}
+
+int CrossReferenceIndex::findReferences(const QVector<int> &candidates, int from, int count, const QString &name, bool isLocal, Locations &locations) const {
+    const int to = qMin(candidates.size(), from + count);
+
+    for (int i = from; i < to; i++) {
+        const int id = candidates.at(i);
+
+        // the units might have been updated since the candidates have been found
+        if (id >= entries.size() || entries.at(id).removed) {
+            continue;
+        }
+
+        for (const VJassSymbolTable::Reference &reference : entries.at(id).references) {
+            if (reference.name == name && isLocalKind(reference.kind) == isLocal) {
+                locations.push_back(location(id, reference));
+            }
+        }
+    }
+
+    return to;
+}
+
+CrossReferenceIndex::Locations CrossReferenceIndex::findReferences(const QString &source, int line, const QString &name) const {
+    const QVector<int> ids = candidates(source, line, name);
+    Locations result;
+    findReferences(ids, 0, ids.size(), name, isLocal(unitAt(source, line), name), result);
+
+    return result;
+}
+
+QString CrossReferenceIndex::renameConflict(const QString &source, int line, const QString &name, const QString &newName) const {
+    // the symbols of the standard scripts are known by the scanner even if the scripts have not been indexed yet
+    if (!IDENTIFIER_REGEX.match(newName).hasMatch() || VJassToken::KEYWRODS_ALL.contains(newName)) {
+        return QObject::tr("%1 is no valid identifier.").arg(newName);
+    }
+
+    if (VJassToken(newName, 0, 0, VJassToken::Text).highlight()) {
+        return QObject::tr("%1 is declared by a standard script.").arg(newName);
+    }
+
+    const int unit = unitAt(source, line);
+
+    if (isLocal(unit, name)) {
+        for (const VJassSymbolTable::Reference &reference : entries.at(unit).references) {
+            if (reference.name == newName) {
+                return QObject::tr("%1 is already used by the function.").arg(newName);
+            }
+        }
+
+        return QString();
+    }
+
+    if (postings.contains(newName)) {
+        return QObject::tr("%1 is already used.").arg(newName);
+    }
+
+    for (int id : postings.value(name)) {
+        if (isLocal(id, newName)) {
+            return QObject::tr("%1 would be hidden by a local variable or parameter of the function in line %2.").arg(newName).arg(entries.at(id).startLine + 1);
+        }
+    }
+
+    return QString();
+}
+
+int CrossReferenceIndex::insertUnit(const QString &source, const VJassSymbolTable::Unit &unit) {
+    int id = entries.size();
+
+    if (freeIds.isEmpty()) {
+        entries.push_back(Entry());
+    } else {
+        id = freeIds.takeLast();
+    }
+
+    Entry &entry = entries[id];
+    entry.source = source;
+    entry.key = unit.key;
+    entry.startLine = unit.startLine;
+    entry.endLine = unit.endLine;
+    entry.tokensHash = unit.tokensHash;
+    entry.references = unit.references;
+    entry.removed = false;
+    referencesCount += unit.references.size();
+
+    for (int i = 0; i < unit.references.size(); i++) {
+        const VJassSymbolTable::Reference &reference = unit.references.at(i);
+
+        if (isLocalKind(reference.kind)) {
+            continue;
+        }
+
+        // reused IDs have to be inserted at their sorted positions
+        QVector<int> &ids = postings[reference.name];
+        auto idIterator = std::lower_bound(ids.begin(), ids.end(), id);
+
+        if (idIterator == ids.end() || *idIterator != id) {
+            ids.insert(idIterator, id);
+        }
+
+        if (reference.isDeclaration) {
+            declarations[reference.name].push_back(Declaration(id, i));
+        }
+    }
+
+    return id;
+}
+
+void CrossReferenceIndex::removeUnit(int id) {
+    Entry &entry = entries[id];
+    referencesCount -= entry.references.size();
+
+    for (const VJassSymbolTable::Reference &reference : entry.references) {
+        if (isLocalKind(reference.kind)) {
+            continue;
+        }
+
+        auto iterator = postings.find(reference.name);
+
+        if (iterator != postings.end()) {
+            QVector<int> &ids = iterator.value();
+            auto idIterator = std::lower_bound(ids.begin(), ids.end(), id);
+
+            if (idIterator != ids.end() && *idIterator == id) {
+                ids.erase(idIterator);
+            }
+
+            if (ids.isEmpty()) {
+                postings.erase(iterator);
+            }
+        }
+
+        if (reference.isDeclaration) {
+            auto declarationIterator = declarations.find(reference.name);
+
+            if (declarationIterator != declarations.end()) {
+                QVector<Declaration> &unitDeclarations = declarationIterator.value();
+                unitDeclarations.erase(std::remove_if(unitDeclarations.begin(), unitDeclarations.end(), [id](const Declaration &declaration) {
+                    return declaration.unit == id;
+                }), unitDeclarations.end());
+
+                if (unitDeclarations.isEmpty()) {
+                    declarations.erase(declarationIterator);
+                }
+            }
+        }
+    }
+
+    entry = Entry();
+    freeIds.push_back(id);
+}
+
+CrossReferenceIndex::Location CrossReferenceIndex::location(int id, const VJassSymbolTable::Reference &reference) const {
+    const Entry &entry = entries.at(id);
+
+    return Location(entry.source, entry.startLine + reference.line, reference.column, reference.length, reference.isDeclaration);
+}
+
+bool CrossReferenceIndex::precedes(const Declaration &declaration1, const Declaration &declaration2, const QString &source) const {
+    const Entry &entry1 = entries.at(declaration1.unit);
+    const Entry &entry2 = entries.at(declaration2.unit);
+
+    if ((entry1.source == source) != (entry2.source == source)) {
+        return entry1.source == source;
+    }
+
+    if (secondarySources.contains(entry1.source) != secondarySources.contains(entry2.source)) {
+        return !secondarySources.contains(entry1.source);
+    }
+
+    if (entry1.source != entry2.source) {
+        return entry1.source < entry2.source;
+    }
+
+    return entry1.startLine + entry1.references.at(declaration1.reference).line < entry2.startLine + entry2.references.at(declaration2.reference).line;
+}
+
+bool CrossReferenceIndex::isLocalKind(VJassSymbolTable::Kind kind) {
+    return kind == VJassSymbolTable::Local || kind == VJassSymbolTable::Parameter;
+}
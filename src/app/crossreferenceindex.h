@@ -0,0 +1,147 @@
+#ifndef CROSSREFERENCEINDEX_H
+#define CROSSREFERENCEINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+#include "vjasssymboltable.h"
+
+/**
+ * @brief Maps every symbol of all open documents and the standard scripts to its declaration and its references.
+ *
+ * The references of a source are stored in the units of its symbol table. Updating a source only removes and inserts the units whose tokens have been changed. Units which have only moved keep their references.
+ * The declarations of global names are hashed by their names, so the declaration of a symbol is found in constant time.
+ * The references of a global name are found by visiting only the units which refer to it. They can be visited in slices, so the results are shown while the remaining units are visited.
+ * Local variables and parameters are only referenced by their own function.
+ */
+class CrossReferenceIndex
+{
+public:
+    struct Location {
+        QString source;
+        int line;
+        int column;
+        int length;
+        bool isDeclaration;
+
+        Location() : line(0), column(0), length(0), isDeclaration(false) {
+        }
+
+        Location(const QString &source, int line, int column, int length, bool isDeclaration)
+            : source(source)
+            , line(line)
+            , column(column)
+            , length(length)
+            , isDeclaration(isDeclaration) {
+        }
+    };
+
+    using Locations = QVector<Location>;
+
+    CrossReferenceIndex();
+
+    /**
+     * @brief Replaces the units of the source. Units with the same key and tokens only get their new lines.
+     * @return Returns the number of units which have been removed or inserted.
+     */
+    int setUnits(const QString &source, const VJassSymbolTable::Units &units);
+    void removeSource(const QString &source);
+    bool hasSource(const QString &source) const;
+    /**
+     * @brief Declarations of secondary sources like the standard scripts are only found if no other source declares the name.
+     */
+    void setSecondarySources(const QStringList &sources);
+    int getUnitsCount() const;
+    int getReferencesCount() const;
+
+    /**
+     * @return Returns the unit ID of the source which contains the line or -1.
+     */
+    int unitAt(const QString &source, int line) const;
+    /**
+     * @return Returns true if the name refers to a local variable or parameter in the given unit.
+     */
+    bool isLocal(int unit, const QString &name) const;
+    /**
+     * @brief Finds the declaration of the name used in the line of the source. Local variables and parameters hide global declarations.
+     * If multiple sources declare the name, the declaration of the source itself is preferred to the ones of other sources and secondary sources come last.
+     * @return Returns false if there is no declaration.
+     */
+    bool findDeclaration(const QString &source, int line, const QString &name, Location &location) const;
+
+    /**
+     * @return Returns the sorted IDs of all units which refer to the name used in the line of the source.
+     */
+    QVector<int> candidates(const QString &source, int line, const QString &name) const;
+    /**
+     * @brief Appends the references to the name of count candidates from the given index on to locations. They are sorted by their positions for every unit.
+     * @param isLocal If it is true, only references to a local variable or parameter are added. Otherwise, only references to globals are added.
+     * @return Returns the index of the next candidate.
+     */
+    int findReferences(const QVector<int> &candidates, int from, int count, const QString &name, bool isLocal, Locations &locations) const;
+    /**
+     * @return Returns all references to the name used in the line of the source.
+     */
+    Locations findReferences(const QString &source, int line, const QString &name) const;
+    /**
+     * @brief Checks if the symbol with the name used in the line of the source can be renamed without changing the meaning of any reference.
+     * A local variable or parameter cannot get a name which its function uses already. A global symbol cannot get a name which is used anywhere or which would be hidden by a local variable or parameter of a function referring to it.
+     * @return Returns the reason why it cannot be renamed or an empty string.
+     */
+    QString renameConflict(const QString &source, int line, const QString &name, const QString &newName) const;
+
+private:
+    struct Entry {
+        QString source;
+        QString key;
+        int startLine;
+        int endLine;
+        uint tokensHash;
+        VJassSymbolTable::References references;
+        bool removed;
+
+        Entry() : startLine(0), endLine(0), tokensHash(0), removed(true) {
+        }
+    };
+
+    /**
+     * @brief The declaration of a global name is the reference with the given index in the unit with the given ID.
+     */
+    struct Declaration {
+        int unit;
+        int reference;
+
+        Declaration() : unit(-1), reference(-1) {
+        }
+
+        Declaration(int unit, int reference) : unit(unit), reference(reference) {
+        }
+    };
+
+    int insertUnit(const QString &source, const VJassSymbolTable::Unit &unit);
+    void removeUnit(int id);
+    Location location(int id, const VJassSymbolTable::Reference &reference) const;
+    /**
+     * @return Returns true if the first declaration is preferred to the second one for the name used in the source. The order does not depend on the order of their insertion.
+     */
+    bool precedes(const Declaration &declaration1, const Declaration &declaration2, const QString &source) const;
+    static bool isLocalKind(VJassSymbolTable::Kind kind);
+
+    QVector<Entry> entries;
+    QVector<int> freeIds;
+    // the IDs of the units of every source by their keys
+    QHash<QString, QHash<QString, int>> sources;
+    // the IDs of the units of every source sorted by their start lines
+    QHash<QString, QVector<int>> unitsByLine;
+    // the declarations of every global name in the order of their insertion
+    QHash<QString, QVector<Declaration>> declarations;
+    // sorted IDs of all units which refer to a global name
+    QHash<QString, QVector<int>> postings;
+    QSet<QString> secondarySources;
+    int referencesCount;
+};
+
+#endif // CROSSREFERENCEINDEX_H
@@ -0,0 +1,104 @@
+#include <QtCore>
+
+#include "diagnosticsindex.h"
+
+DiagnosticsIndex::DiagnosticsIndex() : errorsCount(0) {
+}
+
+DiagnosticsIndex::DiagnosticsIndex(const QList<VJassParseError> &parseErrors, int lineCount) : errorsCount(parseErrors.size()) {
+    for (const VJassParseError &parseError : parseErrors) {
+        lineCount = qMax(lineCount, qMax(parseError.getLine(), parseError.getEndLine()) + 1);
+    }
+
+    // count the ranges of every line first, so all ranges can be placed into one array without sorting them
+    QVector<int> rangesCountByLine(lineCount, 0);
+
+    for (const VJassParseError &parseError : parseErrors) {
+        for (int line = qMax(0, parseError.getLine()); line <= qMax(parseError.getLine(), parseError.getEndLine()); line++) {
+            rangesCountByLine[line]++;
+        }
+    }
+
+    rangesBeginByLine.resize(lineCount + 1);
+    rangesBeginByLine[0] = 0;
+
+    for (int line = 0; line < lineCount; line++) {
+        rangesBeginByLine[line + 1] = rangesBeginByLine[line] + rangesCountByLine.at(line);
+    }
+
+    ranges.resize(rangesBeginByLine.at(lineCount));
+    QVector<int> nextRangeByLine = rangesBeginByLine;
+
+    for (int i = 0; i < parseErrors.size(); i++) {
+        const VJassParseError &parseError = parseErrors.at(i);
+        const int firstLine = qMax(0, parseError.getLine());
+        const int lastLine = qMax(parseError.getLine(), parseError.getEndLine());
+
+        for (int line = firstLine; line <= lastLine; line++) {
+            Range range;
+
+            if (firstLine == lastLine) {
+                range = Range(parseError.getColumn(), parseError.getLength(), i);
+            } else if (line == firstLine) {
+                range = Range(parseError.getColumn(), -1, i);
+            } else if (line == lastLine) {
+                range = Range(0, parseError.getEndColumn(), i);
+            } else {
+                range = Range(0, -1, i);
+            }
+
+            ranges[nextRangeByLine[line]++] = range;
+        }
+    }
+}
+
+int DiagnosticsIndex::getLineCount() const {
+    return qMax(0, rangesBeginByLine.size() - 1);
+}
+
+int DiagnosticsIndex::getErrorsCount() const {
+    return errorsCount;
+}
+
+int DiagnosticsIndex::getRangesCount() const {
+    return ranges.size();
+}
+
+int DiagnosticsIndex::getRangesBegin(int line) const {
+    if (line < 0 || line >= getLineCount()) {
+        return 0;
+    }
+
+    return rangesBeginByLine.at(line);
+}
+
+int DiagnosticsIndex::getRangesEnd(int line) const {
+    if (line < 0 || line >= getLineCount()) {
+        return 0;
+    }
+
+    return rangesBeginByLine.at(line + 1);
+}
+
+const DiagnosticsIndex::Range& DiagnosticsIndex::getRange(int index) const {
+    return ranges.at(index);
+}
+
+int DiagnosticsIndex::countRanges(int firstLine, int lastLine) const {
+    firstLine = qMax(0, firstLine);
+    lastLine = qMin(getLineCount() - 1, lastLine);
+
+    if (firstLine > lastLine) {
+        return 0;
+    }
+
+    return rangesBeginByLine.at(lastLine + 1) - rangesBeginByLine.at(firstLine);
+}
+
+bool DiagnosticsIndex::hasDiagnostics(int firstLine, int lastLine) const {
+    return countRanges(firstLine, lastLine) > 0;
+}
+
+bool DiagnosticsIndex::hasDiagnostics(int line) const {
+    return countRanges(line, line) > 0;
+}
@@ -0,0 +1,64 @@
+#ifndef DIAGNOSTICSINDEX_H
+#define DIAGNOSTICSINDEX_H
+
+#include <QVector>
+#include <QList>
+
+#include "vjassparseerror.h"
+
+/**
+ * @brief Indexes parse errors by line.
+ *
+ * All ranges are stored in one array sorted by their lines. A second array stores the index of the first range of every line.
+ * Hence, the ranges of one line can be found in constant time and checking a range of lines for errors takes constant time, too.
+ * Errors spanning multiple lines have one range per line.
+ */
+class DiagnosticsIndex
+{
+public:
+    /**
+     * @brief The part of an error inside of one line.
+     */
+    struct Range {
+        int column;
+        int length; // -1 means until the end of the line
+        int errorIndex; // the index of the error in the list the index has been created from
+
+        Range() : column(0), length(0), errorIndex(-1) {
+        }
+
+        Range(int column, int length, int errorIndex) : column(column), length(length), errorIndex(errorIndex) {
+        }
+    };
+
+    DiagnosticsIndex();
+    /**
+     * @param lineCount The number of lines of the text. Errors after the last line extend the index.
+     */
+    DiagnosticsIndex(const QList<VJassParseError> &parseErrors, int lineCount);
+
+    int getLineCount() const;
+    int getErrorsCount() const;
+    int getRangesCount() const;
+
+    /**
+     * @return Returns the index of the first range of the line. All ranges up to getRangesEnd() belong to the line.
+     */
+    int getRangesBegin(int line) const;
+    int getRangesEnd(int line) const;
+    const Range& getRange(int index) const;
+
+    /**
+     * @return Returns the number of ranges in the lines from firstLine to lastLine (inclusive).
+     */
+    int countRanges(int firstLine, int lastLine) const;
+    bool hasDiagnostics(int firstLine, int lastLine) const;
+    bool hasDiagnostics(int line) const;
+
+private:
+    QVector<int> rangesBeginByLine; // has one more element than lines
+    QVector<Range> ranges;
+    int errorsCount;
+};
+
+#endif // DIAGNOSTICSINDEX_H
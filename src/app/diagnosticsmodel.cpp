@@ -0,0 +1,399 @@
+#include <QtCore>
+#include <QtGui>
+
+#include "diagnosticsmodel.h"
+#include "vjassfunction.h"
+#include "rowdiff.h"
+
+bool operator==(const DiagnosticsModel::Key &k1, const DiagnosticsModel::Key &k2) {
+    return k1.relativeLine == k2.relativeLine
+            && k1.column == k2.column
+            && k1.message == k2.message
+            && k1.function == k2.function;
+}
+
+uint qHash(const DiagnosticsModel::Key &key, uint seed) {
+    return static_cast<uint>(qHash(key.message, seed) ^ qHash(key.function, seed) ^ qHash(key.relativeLine, seed) ^ qHash(key.column << 16, seed));
+}
+
+DiagnosticsModel::DiagnosticsModel(QObject *parent) : QAbstractItemModel(parent), grouping(NoGrouping), nextGroupId(1) {
+}
+
+QModelIndex DiagnosticsModel::index(int row, int column, const QModelIndex &parent) const {
+    if (row < 0 || column < 0 || column >= ColumnCount) {
+        return QModelIndex();
+    }
+
+    // group rows have the internal ID 0 and error rows store the ID of their group
+    if (!parent.isValid()) {
+        if (isGrouped()) {
+            return row < groups.size() ? createIndex(row, column, quintptr(0)) : QModelIndex();
+        }
+
+        return !groups.isEmpty() && row < groups.at(0).entries.size() ? createIndex(row, column, groups.at(0).id) : QModelIndex();
+    }
+
+    if (isGrouped() && parent.internalId() == 0 && parent.row() < groups.size() && row < groups.at(parent.row()).entries.size()) {
+        return createIndex(row, column, groups.at(parent.row()).id);
+    }
+
+    return QModelIndex();
+}
+
+QModelIndex DiagnosticsModel::parent(const QModelIndex &index) const {
+    if (!index.isValid() || index.internalId() == 0 || !isGrouped()) {
+        return QModelIndex();
+    }
+
+    const int row = groupRow(index.internalId());
+
+    return row != -1 ? createIndex(row, 0, quintptr(0)) : QModelIndex();
+}
+
+int DiagnosticsModel::rowCount(const QModelIndex &parent) const {
+    if (!parent.isValid()) {
+        if (isGrouped()) {
+            return groups.size();
+        }
+
+        return groups.isEmpty() ? 0 : groups.at(0).entries.size();
+    }
+
+    if (isGrouped() && parent.internalId() == 0 && parent.column() == 0 && parent.row() < groups.size()) {
+        return groups.at(parent.row()).entries.size();
+    }
+
+    return 0;
+}
+
+int DiagnosticsModel::columnCount(const QModelIndex &parent) const {
+    Q_UNUSED(parent)
+
+    return ColumnCount;
+}
+
+QVariant DiagnosticsModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    if (isGrouped() && index.internalId() == 0) {
+        const Group &group = groups.at(index.row());
+
+        if (role == SortRole) {
+            return group.sortOrder;
+        } else if (role == Qt::DisplayRole && index.column() == MessageColumn) {
+            QString title;
+
+            if (grouping == GroupBySeverity) {
+                title = group.key.toInt() == VJassParseError::Warning ? tr("Warnings") : tr("Errors");
+            } else {
+                title = group.key.isEmpty() ? tr("Outside of functions") : VJassToken::KEYWORD_FUNCTION + " " + group.key;
+            }
+
+            return tr("%1 (%2)").arg(title).arg(group.entries.size());
+        }
+
+        return QVariant();
+    }
+
+    const int row = groupRow(index.internalId());
+
+    if (row == -1 || index.row() >= groups.at(row).entries.size()) {
+        return QVariant();
+    }
+
+    // the texts are only created for rows which are shown
+    const Entry &entry = groups.at(row).entries.at(index.row());
+    const VJassParseError &parseError = entry.parseError;
+
+    switch (role) {
+        case Qt::DisplayRole:
+        case SortRole: {
+            switch (index.column()) {
+                case MessageColumn: {
+                    return parseError.getError();
+                }
+
+                case LineColumn: {
+                    return parseError.getLine() + 1;
+                }
+
+                case ColumnColumn: {
+                    return parseError.getColumn() + 1;
+                }
+
+                case FunctionColumn: {
+                    return entry.function;
+                }
+            }
+
+            break;
+        }
+
+        case Qt::ToolTipRole: {
+            return tr("Syntax error at line %1 and column %2: %3").arg(parseError.getLine() + 1).arg(parseError.getColumn() + 1).arg(parseError.getError());
+        }
+
+        case PositionRole: {
+            return QPoint(parseError.getLine(), parseError.getColumn());
+        }
+    }
+
+    return QVariant();
+}
+
+QVariant DiagnosticsModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (section) {
+        case MessageColumn: {
+            return tr("Message");
+        }
+
+        case LineColumn: {
+            return tr("Line");
+        }
+
+        case ColumnColumn: {
+            return tr("Column");
+        }
+
+        case FunctionColumn: {
+            return tr("Function");
+        }
+    }
+
+    return QVariant();
+}
+
+void DiagnosticsModel::setResults(const QSharedPointer<HighLightInfo> &results) {
+    QVector<Entry> newEntries;
+
+    if (results != nullptr) {
+        const AstSpanIndex &astSpanIndex = results->getAstSpanIndex();
+        newEntries.reserve(results->getParseErrors().size());
+
+        for (const VJassParseError &parseError : results->getParseErrors()) {
+            // the outermost element is the top level declaration
+            const QList<VJassAst*> enclosing = astSpanIndex.getEnclosing(parseError.getLine(), parseError.getColumn());
+            const VJassFunction *function = enclosing.isEmpty() ? nullptr : dynamic_cast<const VJassFunction*>(enclosing.last());
+
+            Entry entry;
+            entry.parseError = parseError;
+            entry.function = function != nullptr ? function->getIdentifier() : QString();
+            entry.key.message = parseError.getError();
+            entry.key.function = entry.function;
+            // inserting lines before the function does not change the identity
+            entry.key.relativeLine = function != nullptr ? parseError.getLine() - function->getLine() : parseError.getLine();
+            entry.key.column = parseError.getColumn();
+            newEntries.push_back(entry);
+        }
+    }
+
+    allEntries = newEntries;
+
+    if (isGrouped()) {
+        QVector<Group> newGroups = createGroups(newEntries);
+        mergeGroups(newGroups);
+    } else {
+        if (groups.isEmpty()) {
+            Group group;
+            group.id = nextGroupId++;
+            group.sortOrder = 0;
+            groups.push_back(group);
+            updateGroupRows();
+        }
+
+        mergeEntries(QModelIndex(), groups[0].entries, newEntries);
+    }
+}
+
+void DiagnosticsModel::setGrouping(Grouping grouping) {
+    if (this->grouping == grouping) {
+        return;
+    }
+
+    // changing the grouping changes the structure of the whole model
+    beginResetModel();
+    this->grouping = grouping;
+
+    if (isGrouped()) {
+        groups = createGroups(allEntries);
+    } else {
+        groups.clear();
+
+        Group group;
+        group.sortOrder = 0;
+        group.entries = allEntries;
+        groups.push_back(group);
+    }
+
+    for (Group &group : groups) {
+        group.id = nextGroupId++;
+    }
+
+    updateGroupRows();
+    endResetModel();
+}
+
+DiagnosticsModel::Grouping DiagnosticsModel::getGrouping() const {
+    return grouping;
+}
+
+int DiagnosticsModel::getErrorsCount() const {
+    return allEntries.size();
+}
+
+bool DiagnosticsModel::isGrouped() const {
+    return grouping != NoGrouping;
+}
+
+int DiagnosticsModel::groupRow(quintptr id) const {
+    return groupRowsById.value(id, -1);
+}
+
+void DiagnosticsModel::updateGroupRows() {
+    groupRowsById.clear();
+
+    for (int i = 0; i < groups.size(); i++) {
+        groupRowsById.insert(groups.at(i).id, i);
+    }
+}
+
+QString DiagnosticsModel::groupKey(const Entry &entry) const {
+    return grouping == GroupBySeverity ? QString::number(entry.parseError.getSeverity()) : entry.function;
+}
+
+QVector<DiagnosticsModel::Group> DiagnosticsModel::createGroups(const QVector<Entry> &entries) const {
+    QVector<Group> result;
+    QHash<QString, int> groupsByKey;
+
+    for (const Entry &entry : entries) {
+        const QString key = groupKey(entry);
+        QHash<QString, int>::const_iterator it = groupsByKey.constFind(key);
+
+        if (it == groupsByKey.constEnd()) {
+            Group group;
+            group.id = 0;
+            group.key = key;
+            // functions are ordered by their first error and severities by their importance
+            group.sortOrder = grouping == GroupBySeverity ? entry.parseError.getSeverity() : result.size();
+            it = groupsByKey.insert(key, result.size());
+            result.push_back(group);
+        }
+
+        result[it.value()].entries.push_back(entry);
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const Group &g1, const Group &g2) {
+        return g1.sortOrder < g2.sortOrder;
+    });
+
+    return result;
+}
+
+void DiagnosticsModel::mergeGroups(QVector<Group> &newGroups) {
+    int row = 0;
+    int j = 0;
+
+    for (const RowDiff::Edit &edit : RowDiff::diff(groups, newGroups, [](const Group &group) -> const QString& { return group.key; })) {
+        switch (edit.type) {
+            case RowDiff::Edit::Keep: {
+                for (int i = 0; i < edit.count; i++) {
+                    const QModelIndex groupIndex = createIndex(row, 0, quintptr(0));
+                    groups[row].sortOrder = newGroups.at(j).sortOrder;
+                    mergeEntries(groupIndex, groups[row].entries, newGroups.at(j).entries);
+                    // the title contains the number of errors
+                    emit dataChanged(groupIndex, groupIndex);
+                    row++;
+                    j++;
+                }
+
+                break;
+            }
+
+            case RowDiff::Edit::Remove: {
+                beginRemoveRows(QModelIndex(), row, row + edit.count - 1);
+                groups.erase(groups.begin() + row, groups.begin() + row + edit.count);
+                updateGroupRows();
+                endRemoveRows();
+
+                break;
+            }
+
+            case RowDiff::Edit::Insert: {
+                for (int i = j; i < j + edit.count; i++) {
+                    newGroups[i].id = nextGroupId++;
+                }
+
+                beginInsertRows(QModelIndex(), row, row + edit.count - 1);
+                RowDiff::insertRows(groups, row, newGroups, j, edit.count);
+                updateGroupRows();
+                endInsertRows();
+
+                row += edit.count;
+                j += edit.count;
+
+                break;
+            }
+        }
+    }
+}
+
+void DiagnosticsModel::mergeEntries(const QModelIndex &parent, QVector<Entry> &rows, const QVector<Entry> &newRows) {
+    // kept errors which have moved are reported as one changed range, rows are only inserted or removed after it
+    int firstChangedRow = -1;
+    int lastChangedRow = -1;
+    int row = 0;
+    int j = 0;
+
+    // the keys are stored in the rows, so only the keys of the new errors have been computed
+    for (const RowDiff::Edit &edit : RowDiff::diff(rows, newRows, [](const Entry &entry) -> const Key& { return entry.key; })) {
+        switch (edit.type) {
+            case RowDiff::Edit::Keep: {
+                for (int i = 0; i < edit.count; i++) {
+                    const VJassParseError &parseError = rows.at(row).parseError;
+                    const VJassParseError &newParseError = newRows.at(j).parseError;
+
+                    if (parseError.getLine() != newParseError.getLine() || parseError.getColumn() != newParseError.getColumn() || parseError.getSeverity() != newParseError.getSeverity()) {
+                        rows[row] = newRows.at(j);
+                        firstChangedRow = firstChangedRow == -1 ? row : firstChangedRow;
+                        lastChangedRow = row;
+                    }
+
+                    row++;
+                    j++;
+                }
+
+                break;
+            }
+
+            case RowDiff::Edit::Remove: {
+                beginRemoveRows(parent, row, row + edit.count - 1);
+                rows.erase(rows.begin() + row, rows.begin() + row + edit.count);
+                endRemoveRows();
+
+                break;
+            }
+
+            case RowDiff::Edit::Insert: {
+                beginInsertRows(parent, row, row + edit.count - 1);
+                RowDiff::insertRows(rows, row, newRows, j, edit.count);
+                endInsertRows();
+
+                row += edit.count;
+                j += edit.count;
+
+                break;
+            }
+        }
+    }
+
+    if (firstChangedRow != -1) {
+        const quintptr id = parent.isValid() ? groups.at(parent.row()).id : groups.at(0).id;
+        emit dataChanged(createIndex(firstChangedRow, 0, id), createIndex(lastChangedRow, ColumnCount - 1, id));
+    }
+}
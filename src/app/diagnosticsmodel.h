@@ -0,0 +1,102 @@
+#ifndef DIAGNOSTICSMODEL_H
+#define DIAGNOSTICSMODEL_H
+
+#include <QAbstractItemModel>
+#include <QSharedPointer>
+#include <QVector>
+#include <QHash>
+
+#include "highlightinfo.h"
+
+/**
+ * @brief Lists the parse errors of the results of an analysis, optionally grouped by their functions or their severities.
+ *
+ * The texts are only formatted in data(), so only rows which are shown create strings.
+ * Every error is identified by its message, its function and its position relative to the start of its function.
+ * Hence, an error keeps its identity when lines are inserted or removed before its function.
+ * New results are compared to the current rows by this identity and only errors which have appeared or disappeared are inserted or removed.
+ */
+class DiagnosticsModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Grouping {
+        NoGrouping,
+        GroupByFunction,
+        GroupBySeverity
+    };
+
+    enum Column {
+        MessageColumn,
+        LineColumn,
+        ColumnColumn,
+        FunctionColumn,
+        ColumnCount
+    };
+
+    enum Roles {
+        // the position as QPoint with the line as x and the column as y like in the other lists
+        PositionRole = Qt::UserRole,
+        // numbers are sorted as numbers and groups keep their order
+        SortRole
+    };
+
+    DiagnosticsModel(QObject *parent = nullptr);
+
+    virtual QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    virtual QModelIndex parent(const QModelIndex &index) const override;
+    virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    virtual int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Replaces the errors by the errors of the results. Errors with the same identity keep their rows.
+     */
+    void setResults(const QSharedPointer<HighLightInfo> &results);
+    void setGrouping(Grouping grouping);
+    Grouping getGrouping() const;
+
+    int getErrorsCount() const;
+
+private:
+    struct Key {
+        QString message;
+        QString function;
+        int relativeLine;
+        int column;
+    };
+
+    struct Entry {
+        VJassParseError parseError;
+        QString function;
+        Key key;
+    };
+
+    struct Group {
+        quintptr id; // stable as long as the group exists since it is stored in the indices of the children
+        QString key;
+        int sortOrder;
+        QVector<Entry> entries;
+    };
+
+    friend bool operator==(const Key &k1, const Key &k2);
+    friend uint qHash(const Key &key, uint seed);
+
+    bool isGrouped() const;
+    int groupRow(quintptr id) const;
+    void updateGroupRows();
+    QString groupKey(const Entry &entry) const;
+    QVector<Group> createGroups(const QVector<Entry> &entries) const;
+    void mergeGroups(QVector<Group> &newGroups);
+    void mergeEntries(const QModelIndex &parent, QVector<Entry> &rows, const QVector<Entry> &newRows);
+
+    Grouping grouping;
+    QVector<Entry> allEntries; // sorted by position
+    QVector<Group> groups; // without grouping there is exactly one group whose entries are the top level rows
+    QHash<quintptr, int> groupRowsById;
+    quintptr nextGroupId;
+};
+
+#endif // DIAGNOSTICSMODEL_H
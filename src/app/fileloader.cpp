@@ -0,0 +1,132 @@
+#include <QtCore>
+
+#include "fileloader.h"
+
+FileLoader::FileLoader(QObject *parent)
+    : QObject(parent)
+    , bytesTotal(0)
+    , thread(nullptr)
+    , stop(0)
+    , generation(0)
+    , loading(false)
+{
+}
+
+FileLoader::~FileLoader() {
+    stopThread();
+}
+
+bool FileLoader::load(const QString &filePath) {
+    cancel();
+
+    // report errors before starting the thread
+    QFile f(filePath);
+
+    if (!f.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    this->filePath = filePath;
+    this->bytesTotal = f.size();
+    f.close();
+
+    generation++;
+    loading = true;
+    stop.storeRelease(0);
+
+    const int generation = this->generation;
+
+    thread = QThread::create([this, filePath, generation]() {
+        QFile f(filePath);
+
+        if (!f.open(QIODevice::ReadOnly)) {
+            QMetaObject::invokeMethod(this, [this, generation]() { receiveFinished(generation, false); }, Qt::QueuedConnection);
+
+            return;
+        }
+
+        QByteArray remainder;
+        qint64 bytesRead = 0;
+
+        while (stop.loadAcquire() == 0) {
+            QByteArray data = remainder + f.read(CHUNK_SIZE);
+            const bool atEnd = f.atEnd();
+            remainder.clear();
+
+            if (data.isEmpty() && atEnd) {
+                break;
+            }
+
+            // keep the incomplete last line for the next chunk
+            if (!atEnd) {
+                const int lastNewLine = data.lastIndexOf('\n');
+
+                if (lastNewLine != -1) {
+                    remainder = data.mid(lastNewLine + 1);
+                    data.truncate(lastNewLine + 1);
+                } else {
+                    remainder = data;
+
+                    continue;
+                }
+            }
+
+            bytesRead += data.size();
+            const QString text = QString::fromUtf8(data);
+
+            QMetaObject::invokeMethod(this, [this, generation, text, bytesRead]() { receiveChunk(generation, text, bytesRead); }, Qt::QueuedConnection);
+
+            if (atEnd) {
+                break;
+            }
+        }
+
+        const bool success = stop.loadAcquire() == 0;
+        QMetaObject::invokeMethod(this, [this, generation, success]() { receiveFinished(generation, success); }, Qt::QueuedConnection);
+    });
+    thread->start(QThread::LowPriority);
+
+    return true;
+}
+
+void FileLoader::cancel() {
+    stopThread();
+    // the chunks which are still queued belong to the cancelled loading
+    generation++;
+    loading = false;
+}
+
+bool FileLoader::isLoading() const {
+    return loading;
+}
+
+const QString& FileLoader::getFilePath() const {
+    return filePath;
+}
+
+qint64 FileLoader::getBytesTotal() const {
+    return bytesTotal;
+}
+
+void FileLoader::stopThread() {
+    if (thread != nullptr) {
+        stop.storeRelease(1);
+        thread->wait();
+        delete thread;
+        thread = nullptr;
+    }
+}
+
+void FileLoader::receiveChunk(int generation, const QString &text, qint64 bytesRead) {
+    if (generation == this->generation) {
+        emit chunkLoaded(text, bytesRead, bytesTotal);
+    }
+}
+
+void FileLoader::receiveFinished(int generation, bool success) {
+    if (generation == this->generation) {
+        loading = false;
+        stopThread();
+        emit finished(success);
+    }
+}
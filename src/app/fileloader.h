@@ -0,0 +1,54 @@
+#ifndef FILELOADER_H
+#define FILELOADER_H
+
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QAtomicInt>
+
+/**
+ * @brief Reads and decodes a text file in a separate thread and delivers its content in chunks to the thread of the loader.
+ *
+ * Every chunk ends with a complete line, so it can be appended to a text document and no UTF-8 sequence is split.
+ * Chunks of a previous or cancelled loading are discarded.
+ */
+class FileLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const qint64 CHUNK_SIZE = 256 * 1024;
+
+    FileLoader(QObject *parent = nullptr);
+    virtual ~FileLoader();
+
+    /**
+     * @brief Starts loading the file and cancels any previous loading.
+     * @return Returns false if the file cannot be opened. In this case no signal is emitted.
+     */
+    bool load(const QString &filePath);
+    void cancel();
+    bool isLoading() const;
+
+    const QString& getFilePath() const;
+    qint64 getBytesTotal() const;
+
+signals:
+    void chunkLoaded(const QString &text, qint64 bytesRead, qint64 bytesTotal);
+    void finished(bool success);
+
+private:
+    void stopThread();
+    void receiveChunk(int generation, const QString &text, qint64 bytesRead);
+    void receiveFinished(int generation, bool success);
+
+    QString filePath;
+    qint64 bytesTotal;
+    QThread *thread;
+    QAtomicInt stop;
+    // incremented with every loading to ignore the queued chunks of previous ones
+    int generation;
+    bool loading;
+};
+
+#endif // FILELOADER_H
@@ -4,21 +4,41 @@
 #include "finddialog.h"
 #include "ui_finddialog.h"
 
+namespace {
+
+// wait for the user to stop typing before searching the whole document again
+const int SEARCH_DELAY_MS = 300;
+
+}
+
 FindDialog::FindDialog(QPlainTextEdit *plainTextEdit, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::FindDialog),
-    plainTextEdit(plainTextEdit)
+    plainTextEdit(plainTextEdit),
+    findEngine(new FindEngine(this)),
+    searchedDocument(nullptr),
+    searchedRevision(-1),
+    matchesAreCurrent(false),
+    pendingDirection(0),
+    currentMatchIndex(-1),
+    timerIdSearch(0)
 {
     ui->setupUi(this);
 
     connect(ui->buttonBox->button(QDialogButtonBox::Close), &QPushButton::pressed, this, &FindDialog::close);
 
-    connect(ui->lineEditSearchExpression, &QLineEdit::textChanged, this, &FindDialog::setSearchExpression);
+    connect(ui->lineEditSearchExpression, &QLineEdit::textChanged, this, &FindDialog::startSearch);
+    connect(ui->checkBoxCaseSensitive, &QCheckBox::toggled, this, &FindDialog::startSearch);
+    connect(ui->checkBoxRegex, &QCheckBox::toggled, this, &FindDialog::startSearch);
+    connect(ui->checkBoxIdentifiersOnly, &QCheckBox::toggled, this, &FindDialog::startSearch);
     connect(ui->pushButtonFindNext, &QPushButton::pressed, this, &FindDialog::findNext);
     connect(ui->pushButtonFindPrevious, &QPushButton::pressed, this, &FindDialog::findPrevious);
 
     connect(ui->pushButtonReplaceNext, &QPushButton::pressed, this, &FindDialog::replaceNext);
     connect(ui->pushButtonReplaceAll, &QPushButton::pressed, this, &FindDialog::replaceAll);
+
+    connect(plainTextEdit, &QPlainTextEdit::textChanged, this, &FindDialog::scheduleSearch);
+    connect(findEngine, &FindEngine::finished, this, &FindDialog::receiveMatches);
 }
 
 FindDialog::~FindDialog()
@@ -34,43 +54,95 @@ bool FindDialog::isRegularExpression() const {
     return ui->checkBoxRegex->isChecked();
 }
 
+bool FindDialog::isIdentifiersOnly() const {
+    return ui->checkBoxIdentifiersOnly->isChecked();
+}
+
+FindEngine::Options FindDialog::getOptions() const {
+    FindEngine::Options options = FindEngine::NoOptions;
+
+    if (isCaseSensitive()) {
+        options |= FindEngine::CaseSensitive;
+    }
+
+    if (isRegularExpression()) {
+        options |= FindEngine::RegularExpression;
+    }
+
+    if (isIdentifiersOnly()) {
+        options |= FindEngine::IdentifiersOnly;
+    }
+
+    return options;
+}
+
+FindEngine* FindDialog::getFindEngine() const {
+    return findEngine;
+}
+
+bool FindDialog::hasCurrentMatches() const {
+    return matchesAreCurrent && searchedDocument == plainTextEdit->document() && searchedRevision == plainTextEdit->document()->revision();
+}
+
+const FindEngine::Matches& FindDialog::getMatches() const {
+    return matches;
+}
+
+int FindDialog::getCurrentMatchIndex() const {
+    return currentMatchIndex;
+}
+
 void FindDialog::setSearchExpression(const QString &expression) {
     QSignalBlocker signalBlocker(ui->lineEditSearchExpression);
 
     ui->lineEditSearchExpression->setText(expression);
+    startSearch();
 }
 
-bool FindDialog::find(bool forward) {
-    QString expression = ui->lineEditSearchExpression->text();
+void FindDialog::setCaseSensitive(bool caseSensitive) {
+    ui->checkBoxCaseSensitive->setChecked(caseSensitive);
+}
 
-    qDebug() << "Search for" << expression;
+void FindDialog::setRegularExpression(bool regularExpression) {
+    ui->checkBoxRegex->setChecked(regularExpression);
+}
 
-    QTextDocument::FindFlags options = QTextDocument::FindFlags();
+void FindDialog::setIdentifiersOnly(bool identifiersOnly) {
+    ui->checkBoxIdentifiersOnly->setChecked(identifiersOnly);
+}
 
-    if (isCaseSensitive()) {
-        options |= QTextDocument::FindCaseSensitively;
-    }
+void FindDialog::setReplacementText(const QString &replacementText) {
+    ui->lineEditReplacementText->setText(replacementText);
+}
 
-    if (!forward) {
-        options |= QTextDocument::FindBackward;
+void FindDialog::startSearch() {
+    if (timerIdSearch != 0) {
+        killTimer(timerIdSearch);
+        timerIdSearch = 0;
     }
 
-    bool result = false;
+    searchedDocument = plainTextEdit->document();
+    searchedRevision = searchedDocument->revision();
+    matchesAreCurrent = false;
+    currentMatchIndex = -1;
 
-    if (isRegularExpression()) {
-        QRegularExpression regularExpression;
-        regularExpression.setPattern(expression);
+    findEngine->find(plainTextEdit->toPlainText(), ui->lineEditSearchExpression->text(), getOptions());
+    updateMatchesLabel();
+}
 
-        result = plainTextEdit->find(regularExpression, options);
-    } else {
-        result = plainTextEdit->find(expression, options);
-    }
+bool FindDialog::find(bool forward) {
+    if (!hasCurrentMatches()) {
+        pendingDirection = forward ? 1 : -1;
+
+        // the running search might have been started before the text or the document has changed
+        if (!findEngine->isSearching() || searchedDocument != plainTextEdit->document() || searchedRevision != plainTextEdit->document()->revision()) {
+            startSearch();
+        }
 
-    if (!result) {
-        QMessageBox::information(this, tr("Nothing found"), tr("Found no matching result."));
+        return false;
     }
 
-    return result;
+    return selectMatch(forward);
 }
 
 bool FindDialog::findNext() {
@@ -82,73 +154,177 @@ bool FindDialog::findPrevious() {
 }
 
 int FindDialog::replace(int startPosition, int maxMatches) {
-    const QString searchExpression = ui->lineEditSearchExpression->text();
-    const int searchExpressionLength = searchExpression.size();
-    const QString replacementText = ui->lineEditReplacementText->text();
-    const bool regex = isRegularExpression();
-    const bool caseSensitive = isCaseSensitive();
+    if (!FindEngine::isValidExpression(ui->lineEditSearchExpression->text(), getOptions())) {
+        updateMatchesLabel();
 
-    QRegularExpression regularExpression;
+        return 0;
+    }
 
-    if (regex) {
-        regularExpression.setPattern(searchExpression);
+    updateMatches();
 
-        if (!regularExpression.isValid()) {
-            QMessageBox::warning(this, tr("Error"), tr("Invalid regular expression."));
+    const QString replacementText = ui->lineEditReplacementText->text();
+    auto first = std::lower_bound(matches.cbegin(), matches.cend(), startPosition, [](const FindEngine::Match &match, int position) {
+        return match.position < position;
+    });
+    auto last = matches.cend();
 
-            return 0;
-        }
+    if (maxMatches > 0 && last - first > maxMatches) {
+        last = first + maxMatches;
     }
 
-    QTextCursor textCursor = plainTextEdit->textCursor();
-    textCursor.setPosition(startPosition);
-    int matches = 0;
-
-    while (!textCursor.atEnd() && (maxMatches == 0 || matches < maxMatches)) {
-        if (regex) {
-            QRegularExpressionMatch match = regularExpression.match(plainTextEdit->document()->toPlainText().mid(textCursor.position()));
-
-            if (match.hasMatch()) {
-                textCursor.movePosition(QTextCursor::NextCharacter, QTextCursor::KeepAnchor, match.capturedLength());
-                textCursor.removeSelectedText();
-                textCursor.insertText(replacementText);
-                textCursor.setPosition(textCursor.selectionEnd());
-                matches++;
-            } else {
-                textCursor.movePosition(QTextCursor::NextCharacter, QTextCursor::MoveAnchor);
-            }
-
-            QTextCursor plainTextEditCursor = plainTextEdit->textCursor();
-            plainTextEditCursor.setPosition(textCursor.position());
-        } else {
-            textCursor.movePosition(QTextCursor::NextCharacter, QTextCursor::KeepAnchor, searchExpressionLength);
-            QString compareTo = textCursor.selectedText();
-
-            if ((caseSensitive && searchExpression == compareTo) || (!caseSensitive && searchExpression.toLower() == compareTo.toLower())) {
-                textCursor.removeSelectedText();
-                textCursor.insertText(replacementText);
-                textCursor.setPosition(textCursor.selectionEnd());
-                matches++;
-            } else {
-                textCursor.movePosition(QTextCursor::NextCharacter, QTextCursor::MoveAnchor);
-                QTextCursor plainTextEditCursor = plainTextEdit->textCursor();
-                plainTextEditCursor.setPosition(textCursor.position());
-            }
-
-            QTextCursor plainTextEditCursor = plainTextEdit->textCursor();
-            plainTextEditCursor.setPosition(textCursor.position());
+    const int replaced = last - first;
+
+    if (replaced > 0) {
+        QTextCursor textCursor(plainTextEdit->document());
+        textCursor.beginEditBlock();
+
+        // replacing from the end to the start keeps the positions of the remaining matches valid
+        for (auto iterator = last; iterator != first; ) {
+            --iterator;
+            textCursor.setPosition(iterator->position);
+            textCursor.setPosition(iterator->position + iterator->length, QTextCursor::KeepAnchor);
+            textCursor.insertText(replacementText);
         }
+
+        textCursor.endEditBlock();
+
+        // the cursor is placed behind the first replacement
+        plainTextEdit->setTextCursor(textCursor);
     }
 
-    QMessageBox::information(this, tr("Replaced"), tr("Replaced %1 times.").arg(matches));
+    startSearch();
+    ui->labelMatches->setText(tr("Replaced %1 times.").arg(replaced));
 
-    return matches;
+    return replaced;
 }
 
 int FindDialog::replaceNext() {
-    return replace(plainTextEdit->textCursor().position(), 1);
+    return replace(plainTextEdit->textCursor().selectionStart(), 1);
 }
 
 int FindDialog::replaceAll() {
     return replace(0, 0);
 }
+
+void FindDialog::showEvent(QShowEvent *event) {
+    QDialog::showEvent(event);
+
+    if (!hasCurrentMatches()) {
+        startSearch();
+    }
+}
+
+void FindDialog::timerEvent(QTimerEvent *event) {
+    if (event->timerId() == timerIdSearch) {
+        startSearch();
+    } else {
+        QDialog::timerEvent(event);
+    }
+}
+
+void FindDialog::receiveMatches(const FindEngine::Matches &matches) {
+    this->matches = matches;
+    matchesAreCurrent = true;
+    currentMatchIndex = -1;
+
+    // the text has changed during the search
+    if (!hasCurrentMatches()) {
+        startSearch();
+
+        return;
+    }
+
+    updateMatchesLabel();
+
+    if (pendingDirection != 0) {
+        const bool forward = pendingDirection > 0;
+        pendingDirection = 0;
+        selectMatch(forward);
+    }
+}
+
+void FindDialog::scheduleSearch() {
+    // the matches are only shown while the dialog is visible and it searches again when it is shown
+    if (isVisible() && !ui->lineEditSearchExpression->text().isEmpty()) {
+        if (timerIdSearch != 0) {
+            killTimer(timerIdSearch);
+        }
+
+        timerIdSearch = startTimer(SEARCH_DELAY_MS);
+    }
+}
+
+void FindDialog::updateMatches() {
+    if (!hasCurrentMatches()) {
+        findEngine->cancel();
+        searchedDocument = plainTextEdit->document();
+        searchedRevision = searchedDocument->revision();
+        matches = FindEngine::findMatches(plainTextEdit->toPlainText(), ui->lineEditSearchExpression->text(), getOptions());
+        matchesAreCurrent = true;
+        currentMatchIndex = -1;
+    }
+}
+
+bool FindDialog::selectMatch(bool forward) {
+    if (matches.isEmpty()) {
+        currentMatchIndex = -1;
+        updateMatchesLabel();
+
+        return false;
+    }
+
+    const QTextCursor textCursor = plainTextEdit->textCursor();
+    int index = 0;
+
+    if (forward) {
+        const int position = textCursor.selectionEnd();
+        // the first match which starts at or after the end of the selection
+        index = std::lower_bound(matches.cbegin(), matches.cend(), position, [](const FindEngine::Match &match, int position) {
+            return match.position < position;
+        }) - matches.cbegin();
+
+        if (index == matches.size()) {
+            index = 0;
+        }
+    } else {
+        const int position = textCursor.selectionStart();
+        // the last match which starts before the start of the selection
+        index = int(std::lower_bound(matches.cbegin(), matches.cend(), position, [](const FindEngine::Match &match, int position) {
+            return match.position < position;
+        }) - matches.cbegin()) - 1;
+
+        if (index < 0) {
+            index = matches.size() - 1;
+        }
+    }
+
+    const FindEngine::Match &match = matches.at(index);
+    QTextCursor matchCursor(plainTextEdit->document());
+    matchCursor.setPosition(match.position);
+    matchCursor.setPosition(match.position + match.length, QTextCursor::KeepAnchor);
+    plainTextEdit->setTextCursor(matchCursor);
+    plainTextEdit->ensureCursorVisible();
+
+    currentMatchIndex = index;
+    updateMatchesLabel();
+
+    return true;
+}
+
+void FindDialog::updateMatchesLabel() {
+    const QString expression = ui->lineEditSearchExpression->text();
+
+    if (expression.isEmpty()) {
+        ui->labelMatches->clear();
+    } else if (!FindEngine::isValidExpression(expression, getOptions())) {
+        ui->labelMatches->setText(tr("Invalid regular expression."));
+    } else if (!matchesAreCurrent) {
+        ui->labelMatches->setText(tr("Searching..."));
+    } else if (matches.isEmpty()) {
+        ui->labelMatches->setText(tr("No matches"));
+    } else if (currentMatchIndex == -1) {
+        ui->labelMatches->setText(tr("%n match(es)", "", matches.size()));
+    } else {
+        ui->labelMatches->setText(tr("%1 of %2").arg(currentMatchIndex + 1).arg(matches.size()));
+    }
+}
@@ -4,10 +4,18 @@
 #include <QDialog>
 #include <QPlainTextEdit>
 
+#include "findengine.h"
+
 namespace Ui {
 class FindDialog;
 }
 
+/**
+ * @brief Finds and replaces text in the document of a text edit.
+ *
+ * The document is searched by a FindEngine in the background whenever the search expression, the options or the text change.
+ * Jumping to the next or previous match only looks up the matches of the last search.
+ */
 class FindDialog : public QDialog
 {
     Q_OBJECT
@@ -18,21 +26,74 @@ public:
 
     bool isCaseSensitive() const;
     bool isRegularExpression() const;
+    bool isIdentifiersOnly() const;
+    FindEngine::Options getOptions() const;
+
+    FindEngine* getFindEngine() const;
+    /**
+     * @return Returns true if the matches of the last search belong to the current text of the document.
+     */
+    bool hasCurrentMatches() const;
+    const FindEngine::Matches& getMatches() const;
+    /**
+     * @return Returns the index of the selected match or -1 if no match is selected.
+     */
+    int getCurrentMatchIndex() const;
 
 public slots:
     void setSearchExpression(const QString &expression);
+    void setCaseSensitive(bool caseSensitive);
+    void setRegularExpression(bool regularExpression);
+    void setIdentifiersOnly(bool identifiersOnly);
+    void setReplacementText(const QString &replacementText);
+    /**
+     * @brief Starts searching a snapshot of the document in the background.
+     */
+    void startSearch();
 
+    /**
+     * @brief Selects the next or previous match from the cursor on and wraps around at the end of the document.
+     * If the matches are not up to date yet, the match is selected as soon as the search has finished.
+     */
     bool find(bool next);
     bool findNext();
     bool findPrevious();
 
+    /**
+     * @brief Replaces all matches from the start position on as one edit block which can be undone at once.
+     * @param maxMatches The maximum number of replaced matches. 0 means no limit.
+     * @return Returns the number of replaced matches.
+     */
     int replace(int startPosition, int maxMatches);
     int replaceNext();
     int replaceAll();
 
+protected:
+    virtual void showEvent(QShowEvent *event) override;
+    virtual void timerEvent(QTimerEvent *event) override;
+
 private:
+    void receiveMatches(const FindEngine::Matches &matches);
+    void scheduleSearch();
+    /**
+     * @brief Searches the document in the calling thread if the matches of the last search are not up to date.
+     */
+    void updateMatches();
+    bool selectMatch(bool forward);
+    void updateMatchesLabel();
+
     Ui::FindDialog *ui;
     QPlainTextEdit *plainTextEdit;
+    FindEngine *findEngine;
+    FindEngine::Matches matches;
+    // the document and its revision the current search or the matches belong to
+    QTextDocument *searchedDocument;
+    int searchedRevision;
+    bool matchesAreCurrent;
+    // 1 for the next and -1 for the previous match which is selected when the current search has finished
+    int pendingDirection;
+    int currentMatchIndex;
+    int timerIdSearch;
 };
 
 #endif // FINDDIALOG_H
@@ -0,0 +1,248 @@
+#include <QtCore>
+
+#include "findengine.h"
+#include "vjassscanner.h"
+
+namespace {
+
+// check the stop flag only every few matches since it is an atomic access
+const int STOP_CHECK_INTERVAL = 256;
+
+bool isStopped(const QAtomicInt *stop) {
+    return stop != nullptr && stop->loadAcquire() != 0;
+}
+
+/**
+ * @return Returns the start and end positions of all block comments of the text which are not part of line comments or strings.
+ */
+QVector<QPair<int, int>> blockCommentRanges(const QString &text) {
+    QVector<QPair<int, int>> result;
+
+    if (!text.contains(QLatin1String("/*"))) {
+        return result;
+    }
+
+    for (int i = 0; i < text.size(); ) {
+        const QChar c = text.at(i);
+
+        if (c == '"') {
+            for (i++; i < text.size() && text.at(i) != '"'; i++) {
+                if (text.at(i) == '\\') {
+                    i++;
+                }
+            }
+
+            i++;
+        } else if (c == '/' && i + 1 < text.size() && text.at(i + 1) == '/') {
+            i = text.indexOf('\n', i);
+
+            if (i == -1) {
+                break;
+            }
+        } else if (c == '/' && i + 1 < text.size() && text.at(i + 1) == '*') {
+            const int end = text.indexOf(QLatin1String("*/"), i + 2);
+            const int rangeEnd = end == -1 ? text.size() : end + 2;
+            result.push_back(qMakePair(i, rangeEnd));
+            i = rangeEnd;
+        } else {
+            i++;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @return Returns the start and end positions of all identifier tokens of the lines with matches sorted by their positions.
+ * Scanning the whole text takes much longer than scanning only these lines, so only block comments which span multiple lines are detected beforehand.
+ */
+QVector<QPair<int, int>> identifierRanges(const QString &text, const FindEngine::Matches &matches) {
+    const QVector<QPair<int, int>> blockComments = blockCommentRanges(text);
+    QVector<QPair<int, int>> result;
+    VJassScanner scanner;
+    int lineEnd = -1;
+
+    for (const FindEngine::Match &match : matches) {
+        // the line has already been scanned
+        if (match.position < lineEnd) {
+            continue;
+        }
+
+        int lineStart = match.position == 0 ? 0 : text.lastIndexOf('\n', match.position - 1) + 1;
+        lineEnd = text.indexOf('\n', match.position);
+
+        if (lineEnd == -1) {
+            lineEnd = text.size();
+        }
+
+        // skip the part of a block comment which started in one of the previous lines
+        auto blockComment = std::upper_bound(blockComments.cbegin(), blockComments.cend(), lineStart, [](int position, const QPair<int, int> &range) {
+            return position < range.first;
+        });
+
+        if (blockComment != blockComments.cbegin() && (blockComment - 1)->second > lineStart) {
+            lineStart = (blockComment - 1)->second;
+        }
+
+        if (lineStart >= lineEnd) {
+            continue;
+        }
+
+        for (const VJassToken &token : scanner.scan(text.mid(lineStart, lineEnd - lineStart))) {
+            if (token.getType() == VJassToken::Text) {
+                const int start = lineStart + token.getColumn();
+                result.push_back(qMakePair(start, start + token.getLength()));
+            }
+        }
+    }
+
+    return result;
+}
+
+bool isInsideOfRange(const QVector<QPair<int, int>> &ranges, const FindEngine::Match &match) {
+    // the last range which starts before or at the match
+    auto iterator = std::upper_bound(ranges.cbegin(), ranges.cend(), match.position, [](int position, const QPair<int, int> &range) {
+        return position < range.first;
+    });
+
+    if (iterator == ranges.cbegin()) {
+        return false;
+    }
+
+    --iterator;
+
+    return match.position + match.length <= iterator->second;
+}
+
+}
+
+FindEngine::FindEngine(QObject *parent)
+    : QObject(parent)
+    , thread(nullptr)
+    , stop(0)
+    , generation(0)
+    , searching(false)
+{
+}
+
+FindEngine::~FindEngine() {
+    stopThread();
+}
+
+void FindEngine::find(const QString &text, const QString &expression, Options options) {
+    cancel();
+
+    generation++;
+    searching = true;
+    stop.storeRelease(0);
+
+    const int generation = this->generation;
+
+    thread = QThread::create([this, text, expression, options, generation]() {
+        const Matches matches = findMatches(text, expression, options, &stop);
+
+        if (stop.loadAcquire() == 0) {
+            QMetaObject::invokeMethod(this, [this, generation, matches]() { receiveMatches(generation, matches); }, Qt::QueuedConnection);
+        }
+    });
+    thread->start(QThread::LowPriority);
+}
+
+void FindEngine::cancel() {
+    stopThread();
+    // the matches which are still queued belong to the cancelled search
+    generation++;
+    searching = false;
+}
+
+bool FindEngine::isSearching() const {
+    return searching;
+}
+
+const FindEngine::Matches& FindEngine::getMatches() const {
+    return matches;
+}
+
+FindEngine::Matches FindEngine::findMatches(const QString &text, const QString &expression, Options options, const QAtomicInt *stop) {
+    Matches result;
+
+    if (expression.isEmpty() || !isValidExpression(expression, options)) {
+        return result;
+    }
+
+    const Qt::CaseSensitivity caseSensitivity = options.testFlag(CaseSensitive) ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    if (options.testFlag(RegularExpression)) {
+        QRegularExpression regularExpression(expression, caseSensitivity == Qt::CaseSensitive ? QRegularExpression::NoPatternOption : QRegularExpression::CaseInsensitiveOption);
+        QRegularExpressionMatchIterator iterator = regularExpression.globalMatch(text);
+
+        while (iterator.hasNext()) {
+            const QRegularExpressionMatch match = iterator.next();
+
+            // empty matches cannot be selected nor replaced
+            if (match.capturedLength() > 0) {
+                result.push_back(Match(match.capturedStart(), match.capturedLength()));
+            }
+
+            if (result.size() % STOP_CHECK_INTERVAL == 0 && isStopped(stop)) {
+                return Matches();
+            }
+        }
+    } else {
+        const int length = expression.size();
+        QStringMatcher matcher(expression, caseSensitivity);
+        int position = matcher.indexIn(text);
+
+        while (position != -1) {
+            result.push_back(Match(position, length));
+
+            if (result.size() % STOP_CHECK_INTERVAL == 0 && isStopped(stop)) {
+                return Matches();
+            }
+
+            position = matcher.indexIn(text, position + length);
+        }
+    }
+
+    if (options.testFlag(IdentifiersOnly) && !result.isEmpty()) {
+        const QVector<QPair<int, int>> ranges = identifierRanges(text, result);
+
+        if (isStopped(stop)) {
+            return Matches();
+        }
+
+        Matches filtered;
+
+        for (const Match &match : result) {
+            if (isInsideOfRange(ranges, match)) {
+                filtered.push_back(match);
+            }
+        }
+
+        result = filtered;
+    }
+
+    return result;
+}
+
+bool FindEngine::isValidExpression(const QString &expression, Options options) {
+    return !options.testFlag(RegularExpression) || QRegularExpression(expression).isValid();
+}
+
+void FindEngine::stopThread() {
+    if (thread != nullptr) {
+        stop.storeRelease(1);
+        thread->wait();
+        delete thread;
+        thread = nullptr;
+    }
+}
+
+void FindEngine::receiveMatches(int generation, const Matches &matches) {
+    if (generation == this->generation) {
+        searching = false;
+        stopThread();
+        this->matches = matches;
+        emit finished(this->matches);
+    }
+}
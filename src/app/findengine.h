@@ -0,0 +1,84 @@
+#ifndef FINDENGINE_H
+#define FINDENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QThread>
+#include <QAtomicInt>
+
+/**
+ * @brief Searches a snapshot of a text in a separate thread and delivers all matches sorted by their positions to the thread of the engine.
+ *
+ * The results of a previous or cancelled search are discarded.
+ */
+class FindEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Option {
+        NoOptions = 0x0,
+        CaseSensitive = 0x1,
+        RegularExpression = 0x2,
+        /**
+         * Only matches which lie inside of identifier tokens are reported. Occurrences in comments, strings and keywords are skipped.
+         */
+        IdentifiersOnly = 0x4
+    };
+    Q_DECLARE_FLAGS(Options, Option)
+
+    struct Match {
+        int position;
+        int length;
+
+        Match() : position(0), length(0) {
+        }
+
+        Match(int position, int length) : position(position), length(length) {
+        }
+    };
+
+    using Matches = QVector<Match>;
+
+    FindEngine(QObject *parent = nullptr);
+    virtual ~FindEngine();
+
+    /**
+     * @brief Starts searching the text and cancels any previous search.
+     */
+    void find(const QString &text, const QString &expression, Options options);
+    void cancel();
+    bool isSearching() const;
+
+    /**
+     * @return Returns the matches of the last finished search.
+     */
+    const Matches& getMatches() const;
+
+    /**
+     * @brief Searches the text in the calling thread.
+     * @param stop If not nullptr, the search is aborted as soon as it is set to a value other than 0.
+     * @return Returns all non-overlapping matches sorted by their positions. An empty or invalid expression has no matches.
+     */
+    static Matches findMatches(const QString &text, const QString &expression, Options options, const QAtomicInt *stop = nullptr);
+    static bool isValidExpression(const QString &expression, Options options);
+
+signals:
+    void finished(const FindEngine::Matches &matches);
+
+private:
+    void stopThread();
+    void receiveMatches(int generation, const Matches &matches);
+
+    Matches matches;
+    QThread *thread;
+    QAtomicInt stop;
+    // incremented with every search to ignore the queued matches of previous ones
+    int generation;
+    bool searching;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(FindEngine::Options)
+
+#endif // FINDENGINE_H
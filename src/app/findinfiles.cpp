@@ -0,0 +1,225 @@
+#include <functional>
+
+#include <QtCore>
+
+#include "findinfiles.h"
+
+namespace {
+
+class FunctionRunnable : public QRunnable
+{
+public:
+    FunctionRunnable(const std::function<void()> &function) : function(function) {
+    }
+
+    virtual void run() override {
+        function();
+    }
+
+private:
+    std::function<void()> function;
+};
+
+/**
+ * @return Returns false if the bytes cannot contain any match. This avoids decoding most of the files for rare expressions.
+ */
+bool mightContain(const uchar *data, qint64 size, const QString &expression, FindEngine::Options options) {
+    // the bytes of a regular expression or a case insensitive expression are not known
+    if (options.testFlag(FindEngine::RegularExpression) || !options.testFlag(FindEngine::CaseSensitive)) {
+        return true;
+    }
+
+    const QByteArray bytes = expression.toUtf8();
+
+    if (size > std::numeric_limits<int>::max()) {
+        return true;
+    }
+
+    return QByteArrayMatcher(bytes).indexIn(reinterpret_cast<const char*>(data), int(size)) != -1;
+}
+
+}
+
+struct FindInFiles::Search {
+    QStringList filePaths;
+    QString expression;
+    FindEngine::Options options;
+    QAtomicInt nextFile;
+    QAtomicInt stop;
+};
+
+FindInFiles::FindInFiles(int maxThreadCount, QObject *parent)
+    : QObject(parent)
+    , filesCount(0)
+    , searchedFilesCount(0)
+    , resultsCount(0)
+    , generation(0)
+    , searching(false)
+{
+    threadPool.setMaxThreadCount(maxThreadCount > 0 ? maxThreadCount : QThread::idealThreadCount());
+}
+
+FindInFiles::~FindInFiles() {
+    cancel();
+    threadPool.waitForDone();
+}
+
+void FindInFiles::find(const QStringList &folderPaths, const QString &expression, FindEngine::Options options) {
+    cancel();
+
+    search.reset(new Search);
+
+    for (const QString &folderPath : folderPaths) {
+        search->filePaths.append(scriptFiles(folderPath));
+    }
+
+    search->expression = expression;
+    search->options = options;
+
+    generation++;
+    searching = true;
+    filesCount = search->filePaths.size();
+    searchedFilesCount = 0;
+    resultsCount = 0;
+
+    if (filesCount == 0 || expression.isEmpty()) {
+        searching = false;
+        emit finished(true);
+
+        return;
+    }
+
+    const int generation = this->generation;
+    const QSharedPointer<Search> search = this->search;
+    const int threadCount = qMin(threadPool.maxThreadCount(), filesCount);
+
+    // every thread takes the next file until all files have been searched
+    for (int i = 0; i < threadCount; i++) {
+        threadPool.start(new FunctionRunnable([this, search, generation]() {
+            for (int fileIndex = search->nextFile.fetchAndAddOrdered(1); fileIndex < search->filePaths.size() && search->stop.loadAcquire() == 0; fileIndex = search->nextFile.fetchAndAddOrdered(1)) {
+                const Results results = findInFile(search->filePaths.at(fileIndex), search->expression, search->options, &search->stop);
+
+                QMetaObject::invokeMethod(this, [this, generation, results]() { receiveResults(generation, results); }, Qt::QueuedConnection);
+            }
+        }));
+    }
+}
+
+void FindInFiles::cancel() {
+    if (!search.isNull()) {
+        search->stop.storeRelease(1);
+        search.reset();
+    }
+
+    // the threads stop after their current file and do not have to be waited for
+    threadPool.clear();
+    // the results which are still queued belong to the cancelled search
+    generation++;
+
+    if (searching) {
+        searching = false;
+        emit finished(false);
+    }
+}
+
+bool FindInFiles::isSearching() const {
+    return searching;
+}
+
+int FindInFiles::getMaxThreadCount() const {
+    return threadPool.maxThreadCount();
+}
+
+int FindInFiles::getFilesCount() const {
+    return filesCount;
+}
+
+int FindInFiles::getSearchedFilesCount() const {
+    return searchedFilesCount;
+}
+
+int FindInFiles::getResultsCount() const {
+    return resultsCount;
+}
+
+QStringList FindInFiles::scriptFiles(const QString &folderPath) {
+    QStringList result;
+
+    for (QDirIterator it(folderPath, QStringList() << "*.j" << "*.ai", QDir::Files, QDirIterator::Subdirectories); it.hasNext(); ) {
+        result.push_back(it.next());
+    }
+
+    return result;
+}
+
+FindInFiles::Results FindInFiles::findInFile(const QString &filePath, const QString &expression, FindEngine::Options options, const QAtomicInt *stop) {
+    Results result;
+    QFile f(filePath);
+
+    if (f.size() == 0 || !f.open(QIODevice::ReadOnly)) {
+        return result;
+    }
+
+    const uchar *data = f.map(0, f.size());
+    QString text;
+
+    if (data != nullptr) {
+        if (!mightContain(data, f.size(), expression, options)) {
+            return result;
+        }
+
+        text = QString::fromUtf8(reinterpret_cast<const char*>(data), int(f.size()));
+        f.unmap(const_cast<uchar*>(data));
+    // some file systems cannot be mapped
+    } else {
+        text = QString::fromUtf8(f.readAll());
+    }
+
+    const FindEngine::Matches matches = FindEngine::findMatches(text, expression, options, stop);
+    int line = 0;
+    int lineStart = 0;
+    int position = 0;
+
+    // the matches are sorted, so the lines are counted only once
+    for (const FindEngine::Match &match : matches) {
+        for ( ; position < match.position; position++) {
+            if (text.at(position) == '\n') {
+                line++;
+                lineStart = position + 1;
+            }
+        }
+
+        int lineEnd = text.indexOf('\n', lineStart);
+
+        if (lineEnd == -1) {
+            lineEnd = text.size();
+        }
+
+        if (lineEnd > lineStart && text.at(lineEnd - 1) == '\r') {
+            lineEnd--;
+        }
+
+        result.push_back(Result(filePath, line, match.position - lineStart, match.length, text.mid(lineStart, qMin(lineEnd - lineStart, MAX_LINE_TEXT_LENGTH))));
+    }
+
+    return result;
+}
+
+void FindInFiles::receiveResults(int generation, const Results &results) {
+    if (generation == this->generation) {
+        searchedFilesCount++;
+        resultsCount += results.size();
+
+        if (!results.isEmpty()) {
+            emit resultsFound(results);
+        }
+
+        emit progress(searchedFilesCount, filesCount);
+
+        if (searchedFilesCount == filesCount) {
+            searching = false;
+            search.reset();
+            emit finished(true);
+        }
+    }
+}
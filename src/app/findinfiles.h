@@ -0,0 +1,104 @@
+#ifndef FINDINFILES_H
+#define FINDINFILES_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QThreadPool>
+#include <QSharedPointer>
+
+#include "findengine.h"
+
+/**
+ * @brief Searches all JASS and AI scripts of folder trees in parallel and delivers the matches file by file to the thread of the searcher.
+ *
+ * Every file is mapped into memory and searched by one thread of a thread pool.
+ * The results of a previous or cancelled search are discarded.
+ */
+class FindInFiles : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Longer lines are cut off in the results.
+     */
+    static const int MAX_LINE_TEXT_LENGTH = 200;
+
+    struct Result {
+        QString filePath;
+        int line;
+        int column;
+        int length;
+        // the text of the line of the match
+        QString lineText;
+
+        Result() : line(0), column(0), length(0) {
+        }
+
+        Result(const QString &filePath, int line, int column, int length, const QString &lineText)
+            : filePath(filePath)
+            , line(line)
+            , column(column)
+            , length(length)
+            , lineText(lineText) {
+        }
+    };
+
+    using Results = QVector<Result>;
+
+    /**
+     * @param maxThreadCount 0 means one thread for every core.
+     */
+    FindInFiles(int maxThreadCount = 0, QObject *parent = nullptr);
+    virtual ~FindInFiles();
+
+    /**
+     * @brief Starts searching all .j and .ai files of the folders and their subfolders and cancels any previous search.
+     */
+    void find(const QStringList &folderPaths, const QString &expression, FindEngine::Options options);
+    void cancel();
+    bool isSearching() const;
+
+    int getMaxThreadCount() const;
+    int getFilesCount() const;
+    int getSearchedFilesCount() const;
+    int getResultsCount() const;
+
+    /**
+     * @return Returns the paths of all .j and .ai files of the folder and its subfolders.
+     */
+    static QStringList scriptFiles(const QString &folderPath);
+    /**
+     * @brief Searches one file in the calling thread.
+     * @param stop If not nullptr, the search is aborted as soon as it is set to a value other than 0.
+     */
+    static Results findInFile(const QString &filePath, const QString &expression, FindEngine::Options options, const QAtomicInt *stop = nullptr);
+
+signals:
+    /**
+     * @brief Is emitted for every searched file which contains at least one match.
+     */
+    void resultsFound(const FindInFiles::Results &results);
+    void progress(int searchedFiles, int files);
+    void finished(bool success);
+
+private:
+    friend class TestMainWindow;
+
+    struct Search;
+
+    void receiveResults(int generation, const Results &results);
+
+    QThreadPool threadPool;
+    QSharedPointer<Search> search;
+    int filesCount;
+    int searchedFilesCount;
+    int resultsCount;
+    // incremented with every search to ignore the queued results of previous ones
+    int generation;
+    bool searching;
+};
+
+#endif // FINDINFILES_H
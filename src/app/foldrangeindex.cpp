@@ -0,0 +1,64 @@
+#include <QtCore>
+
+#include "foldrangeindex.h"
+
+FoldRangeIndex::FoldRangeIndex() {
+}
+
+void FoldRangeIndex::clear() {
+    ranges.clear();
+}
+
+void FoldRangeIndex::addRange(int startLine, int endLine) {
+    if (endLine > startLine) {
+        ranges.push_back(FoldRange(startLine, endLine));
+    }
+}
+
+void FoldRangeIndex::sort() {
+    std::sort(ranges.begin(), ranges.end(), [](const FoldRange &range1, const FoldRange &range2) {
+        return range1.startLine < range2.startLine || (range1.startLine == range2.startLine && range1.endLine > range2.endLine);
+    });
+}
+
+int FoldRangeIndex::size() const {
+    return ranges.size();
+}
+
+const FoldRangeIndex::FoldRange& FoldRangeIndex::at(int index) const {
+    return ranges.at(index);
+}
+
+const QVector<FoldRangeIndex::FoldRange>& FoldRangeIndex::getRanges() const {
+    return ranges;
+}
+
+int FoldRangeIndex::indexOf(int startLine) const {
+    auto iterator = std::lower_bound(ranges.cbegin(), ranges.cend(), startLine, [](const FoldRange &range, int line) {
+        return range.startLine < line;
+    });
+
+    if (iterator != ranges.cend() && iterator->startLine == startLine) {
+        return iterator - ranges.cbegin();
+    }
+
+    return -1;
+}
+
+int FoldRangeIndex::endLineOf(int startLine) const {
+    const int index = indexOf(startLine);
+
+    return index != -1 ? ranges.at(index).endLine : -1;
+}
+
+QBitArray FoldRangeIndex::toFoldableLines(int linesCount) const {
+    QBitArray result(linesCount);
+
+    for (const FoldRange &range : ranges) {
+        if (range.startLine >= 0 && range.startLine < linesCount) {
+            result.setBit(range.startLine);
+        }
+    }
+
+    return result;
+}
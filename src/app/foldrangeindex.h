@@ -0,0 +1,59 @@
+#ifndef FOLDRANGEINDEX_H
+#define FOLDRANGEINDEX_H
+
+#include <QVector>
+#include <QBitArray>
+
+/**
+ * @brief Stores the line ranges of all block constructs which can be folded like functions, globals, if statements and loops.
+ *
+ * The parser adds a range whenever it closes a block. Afterwards, the ranges are sorted by their start lines, so the range of a line is found by a binary search.
+ * If more than one range starts in the same line, the outermost range comes first.
+ */
+class FoldRangeIndex
+{
+public:
+    struct FoldRange {
+        int startLine;
+        int endLine;
+
+        FoldRange() : startLine(0), endLine(0) {
+        }
+
+        FoldRange(int startLine, int endLine) : startLine(startLine), endLine(endLine) {
+        }
+    };
+
+    FoldRangeIndex();
+
+    void clear();
+    /**
+     * @brief Adds the range of a block from its first up to its last line. Blocks within one line cannot be folded and are ignored.
+     */
+    void addRange(int startLine, int endLine);
+    /**
+     * @brief Sorts the ranges by their start lines. It has to be called after adding all ranges.
+     */
+    void sort();
+
+    int size() const;
+    const FoldRange& at(int index) const;
+    const QVector<FoldRange>& getRanges() const;
+    /**
+     * @return Returns the index of the outermost range which starts in the line or -1 if there is none.
+     */
+    int indexOf(int startLine) const;
+    /**
+     * @return Returns the last line of the outermost range which starts in the line or -1 if there is none.
+     */
+    int endLineOf(int startLine) const;
+    /**
+     * @return Returns one bit per line which is set if a range starts in the line.
+     */
+    QBitArray toFoldableLines(int linesCount) const;
+
+private:
+    QVector<FoldRange> ranges;
+};
+
+#endif // FOLDRANGEINDEX_H
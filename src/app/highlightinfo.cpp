@@ -1,4 +1,5 @@
 #include <QtCore>
+#include <QtGui>
 
 #include "vjassnative.h"
 #include "vjassfunction.h"
@@ -9,118 +10,41 @@
 #include "memoryleakanalyzer.h"
 #include "highlightinfo.h"
 
-HighLightInfo::HighLightInfo(const QString &text, const QList<VJassToken> &tokens, VJassAst *ast, const QList<VJassParseError> &parseErrors, bool fillCustomTextCharFormat, bool createTextDocument, bool analyzeMemoryLeaks) : ast(ast), textDocument(nullptr), parseErrors(parseErrors)
+HighLightInfo::HighLightInfo(const QString &text, const QList<VJassToken> &tokens, VJassAst *ast, const QList<VJassParseError> &parseErrors, bool fillCustomTextCharFormat, bool createTextDocument, bool analyzeMemoryLeaks) : formatRunsCount(0), ast(ast), textDocument(nullptr), parseErrors(parseErrors)
 {
     //qDebug() << "Getting tokens" << tokens.size();
 
     // filter for elements which need to be highlighted
     if (fillCustomTextCharFormat) {
+        // one entry per line, so the lookup of a block is a simple index access
+        formatRunsByLine.resize(text.count(QLatin1Char('\n')) + 1);
+        lineHashes.reserve(formatRunsByLine.size());
+
+        for (int lineStart = 0; lineStart <= text.length(); ) {
+            int lineEnd = text.indexOf(QLatin1Char('\n'), lineStart);
+
+            if (lineEnd == -1) {
+                lineEnd = text.length();
+            }
+
+            lineHashes.push_back(lineHash(QStringView(text).mid(lineStart, lineEnd - lineStart)));
+            lineStart = lineEnd + 1;
+        }
+
         for (const VJassToken &token : tokens) {
             if (token.highlight()) {
-                CustomTextCharFormat &customTextCharFormat = getCustomTextCharFormat(token.getLine(), token.getColumn());
-                customTextCharFormat.length = token.getLength();
-
-                // formats are taken from https://github.com/tdauth/syntaxhighlightings/blob/master/Kate/vjass.xml
-                // TODO You should be able to configure them in the settings but this has no high priority right now.
-                if (token.isValidKeyword()) {
-                    customTextCharFormat.applyForegroundColor = true;
-                    customTextCharFormat.foregroundColor = Qt::black;
-                    customTextCharFormat.isBold = true;
-
-                    //qDebug() << "Is keyword";
-                } else if (token.getType() == VJassToken::Comment) {
-                    customTextCharFormat.applyForegroundColor = true;
-                    customTextCharFormat.foregroundColor = Qt::gray;
-                    customTextCharFormat.isItalic = true;
-                    //qDebug() << "Is comment";
-                } else if (token.getType() == VJassToken::TrueKeyword || token.getType() == VJassToken::FalseKeyword) {
-                    customTextCharFormat.applyForegroundColor = true;
-                    customTextCharFormat.foregroundColor = Qt::blue;
-                } else if (token.getType() == VJassToken::RawCodeLiteral || token.getType() == VJassToken::IntegerLiteral || token.getType() == VJassToken::RealLiteral) {
-                    customTextCharFormat.applyForegroundColor = true;
-                    customTextCharFormat.foregroundColor = Qt::darkYellow;
-                } else if (token.getType() == VJassToken::StringLiteral) {
-                    customTextCharFormat.applyForegroundColor = true;
-                    customTextCharFormat.foregroundColor = Qt::red;
-                    // TODO highlight escape sequence inside of the string
-                } else if (token.getType() == VJassToken::EscapeLiteral) {
-                    customTextCharFormat.applyForegroundColor = true;
-                    customTextCharFormat.foregroundColor = QColor(0xFFC0CB);
-                } else if (token.getType() == VJassToken::Text) {
-                    // Make a quick check for the symbol from hash sets of standard types and functions so we have these highlighted even without syntax checking
-                    if (token.isCommonJType()) {
-                        customTextCharFormat.applyForegroundColor = true;
-                        customTextCharFormat.foregroundColor = Qt::blue;
-                    } else if (token.isCommonJNative()) {
-                        customTextCharFormat.applyForegroundColor = true;
-                        customTextCharFormat.foregroundColor = QColor(0xba55d3);
-                        customTextCharFormat.isBold = true;
-                    } else if (token.isCommonJConstant()) {
-                        customTextCharFormat.applyForegroundColor = true;
-                        customTextCharFormat.foregroundColor = QColor(0xff7f50);
-                        customTextCharFormat.isItalic = true;
-                    } else if (token.isBlizzardJConstant()) {
-                        //qDebug() << "BlizzardJ COnstant";
-                        customTextCharFormat.applyForegroundColor = true;
-                        customTextCharFormat.foregroundColor = QColor(0x00008b);
-                        customTextCharFormat.isItalic = true;
-                    } else if (token.isBlizzardJGlobal()) {
-                        customTextCharFormat.applyForegroundColor = true;
-                        customTextCharFormat.foregroundColor = QColor(0x497c8b);
-                        customTextCharFormat.isItalic = true;
-                    } else if (token.isBlizzardJFunction()) {
-                        customTextCharFormat.applyForegroundColor = true;
-                        customTextCharFormat.foregroundColor = QColor(0xff0000);
-                        customTextCharFormat.isBold = true;
-                        // color="#6b8e23" selColor="#ffffff" bold="0" italic="1
-                    } else if (token.isCommonAIConstant()) {
-                        customTextCharFormat.applyForegroundColor = true;
-                        customTextCharFormat.foregroundColor = QColor(0x6b8e23);
-                        customTextCharFormat.isItalic = true;
-                    } else if (token.isCommonAIGlobal()) {
-                        customTextCharFormat.applyForegroundColor = true;
-                        customTextCharFormat.foregroundColor = QColor(0x5c8e6c);
-                        customTextCharFormat.isItalic = true;
-                    } else if (token.isCommonAINative()) {
-                        customTextCharFormat.applyForegroundColor = true;
-                        customTextCharFormat.foregroundColor = QColor(0x218B21);
-                        customTextCharFormat.isBold = true;
-                    } else if (token.isCommonAIFunction()) {
-                        customTextCharFormat.applyForegroundColor = true;
-                        customTextCharFormat.foregroundColor = QColor(0x00CD63);
-                        customTextCharFormat.isBold = true;
-                    } else {
-                        qDebug() << "Token type should get some highlighting config:" << token.getValue();
-
-                        Q_ASSERT(false);
-                    }
+                const FormatCategory category = formatCategoryFromToken(token);
+
+                if (category != NoFormat) {
+                    addFormatRuns(token.getLine(), token.getColumn(), token.getValue(), category);
                 } else {
                     qDebug() << "Token type should get some highlighting config:" << token.getValue();
-
-                    Q_ASSERT(false);
                 }
             }
         }
     }
 
     if (ast != nullptr) {
-        // storing the errors prevents invalid memory references
-        /*
-         TODO format everything existing with parse errors but keep the same formats
-        const QList<VJassParseError> &allParseErrors = ast->getAllParseErrors();
-
-        for (const VJassParseError &parseError : allParseErrors) {
-            // TODO Handle multiple lines.
-            for (int column = parseError.getColumn(); column < parseError.getColumn() + parseError.getLength(); column++) {
-                //qDebug() << "Text char format of parse error in line " << parseError.getLine() << "and column" << column;
-
-                CustomTextCharFormat &customTextCharFormat = getCustomTextCharFormat(parseError.getLine(), column);
-                customTextCharFormat.syntaxError = true;
-            }
-        }
-        */
-
-
         // store all AST elements for the outliner
         QStack<VJassAst*> stack;
         stack.push_back(ast);
@@ -144,15 +68,16 @@ HighLightInfo::HighLightInfo(const QString &text, const QList<VJassToken> &token
         }
 
         VJassAst::sortByPosition(astElements);
-        std::sort(this->parseErrors.begin(), this->parseErrors.end(), [](VJassParseError &e1, VJassParseError &e2) {
-           const int lineDiff = e1.getLine() - e2.getLine();
+        astSpanIndex = AstSpanIndex(ast);
 
-           if (lineDiff == 0) {
-               return e1.getColumn() - e2.getColumn();
-           }
+        for (VJassAst *astElement : astElements) {
+            const QString identifier = declarationIdentifier(astElement);
 
-           return lineDiff;
-        });
+            // the first declaration wins like in the game
+            if (!identifier.isEmpty() && !declarationsByIdentifier.contains(identifier)) {
+                declarationsByIdentifier.insert(identifier, astElement);
+            }
+        }
 
         if (analyzeMemoryLeaks) {
             MemoryLeakAnalyzer memoryLeakAnalyzer(ast);
@@ -162,6 +87,13 @@ HighLightInfo::HighLightInfo(const QString &text, const QList<VJassToken> &token
         }
     }
 
+    // errors are ordered by their position, so the errors list and the index show them in the same order
+    std::stable_sort(this->parseErrors.begin(), this->parseErrors.end(), [](const VJassParseError &e1, const VJassParseError &e2) {
+        return e1.getLine() < e2.getLine() || (e1.getLine() == e2.getLine() && e1.getColumn() < e2.getColumn());
+    });
+
+    diagnosticsIndex = DiagnosticsIndex(this->parseErrors, text.count(QLatin1Char('\n')) + 1);
+
     if (createTextDocument) {
         textDocument = new QTextDocument(text);
         textDocument->setDocumentLayout(new QPlainTextDocumentLayout(textDocument));
@@ -169,42 +101,14 @@ HighLightInfo::HighLightInfo(const QString &text, const QList<VJassToken> &token
         textDocument->setIndentWidth(20.0);
         //textDocument->setDefaultTextOption(QTextOption::)
 
-        // This is the slow method creating all the extra selections!
-        // TODO This is the really slow part because of the iteration with the cursors. It might take about 30 seconds or longer.
-        // TODO If we use QSyntaxHighlighter properly, we can get rid of this stuff?
-        qDebug() << "Beginning highlighting code elements with elements size:" << getFormattedLocations().size();
+        // Every line is exactly one block, so the runs can be applied block by block without any cursor movements.
+        qDebug() << "Beginning highlighting code elements with elements size:" << getFormatRunsCount();
         QElapsedTimer timer;
         timer.start();
 
-        // The text document has signals such as "cursorPositionChanged" etc. we do not need to be emitted here.
-        QSignalBlocker signalBlockerTextDocument(textDocument);
-
-        for (auto iterator = customTextCharFormats.constKeyValueBegin(); iterator != customTextCharFormats.constKeyValueEnd(); ++iterator) {
-            const Location &location = iterator->first;
-            const CustomTextCharFormat &customTextCharFormat = iterator->second;
-
-            // move a cursor to the character
-            //QTextCursor cursor(textDocument);
-            QTextCursor cursor(textDocument);
-            //QSignalBlocker signalBlockerTextCursor(&cursor);
-            cursor.setPosition(0, QTextCursor::MoveAnchor);
-            cursor.movePosition(QTextCursor::Down, QTextCursor::MoveAnchor, location.line);
-            cursor.movePosition(QTextCursor::Right, QTextCursor::MoveAnchor, location.column);
-
-            // format all characters
-            // TODO This might be the slow part.
-            cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::KeepAnchor, customTextCharFormat.length);
-            QTextCharFormat fmt = getNormalFormat();
-            customTextCharFormat.applyToTextCharFormat(fmt, ast != nullptr);
-            cursor.setCharFormat(fmt); // for bold it is required that the cursor has the format
-
-            QTextEdit::ExtraSelection extraSelection;
-            extraSelection.cursor = cursor;
-            extraSelection.format = fmt;
-            extraSelections.push_back(extraSelection);
-        }
+        applyFormatRuns(textDocument, formatRunsByLine);
 
-        qDebug() << "Ending highlighting code elements with elements size:" << getFormattedLocations().size() << "and elapsed time" << timer.elapsed() << "ms and in seconds" << (timer.elapsed() / 1000) << "and in minutes" << (timer.elapsed() / (1000 * 60));
+        qDebug() << "Ending highlighting code elements with elements size:" << getFormatRunsCount() << "and elapsed time" << timer.elapsed() << "ms";
     }
 }
 
@@ -251,7 +155,8 @@ QFont HighLightInfo::getNormalFont() {
 }
 
 void HighLightInfo::applyNormalFormat(QTextCharFormat &textCharFormat) {
-    textCharFormat.setBackground(Qt::white);
+    // the background is left to the current line and selection highlighting of the text edit
+    textCharFormat.clearBackground();
     textCharFormat.setForeground(Qt::black);
     textCharFormat.setUnderlineStyle(QTextCharFormat::NoUnderline);
     textCharFormat.setFontItalic(false);
@@ -267,13 +172,92 @@ QTextCharFormat HighLightInfo::getNormalFormat() {
     return fmtNormal;
 }
 
-const QMap<HighLightInfo::Location, HighLightInfo::CustomTextCharFormat>& HighLightInfo::getFormattedLocations() const {
-    return customTextCharFormats;
+const QVector<HighLightInfo::FormatRuns>& HighLightInfo::getFormatRunsByLine() const {
+    return formatRunsByLine;
+}
+
+const HighLightInfo::FormatRuns& HighLightInfo::getFormatRuns(int line) const {
+    static const FormatRuns empty;
+
+    if (line < 0 || line >= formatRunsByLine.size()) {
+        return empty;
+    }
+
+    return formatRunsByLine.at(line);
+}
+
+int HighLightInfo::getFormatRunsCount() const {
+    return formatRunsCount;
+}
+
+const QVector<uint>& HighLightInfo::getLineHashes() const {
+    return lineHashes;
 }
 
-QList<QTextEdit::ExtraSelection> HighLightInfo::toExtraSelections(QTextDocument * /* textDocument */, bool /* checkSyntax */) const {
+uint HighLightInfo::lineHash(QStringView line) {
+    return static_cast<uint>(qHash(line));
+}
+
+int HighLightInfo::getFormatRunsMemoryUsage() const {
+    int result = static_cast<int>(sizeof(formatRunsByLine) + formatRunsByLine.capacity() * sizeof(FormatRuns));
+
+    for (const FormatRuns &formatRuns : formatRunsByLine) {
+        result += static_cast<int>(formatRuns.capacity() * sizeof(FormatRun));
+    }
+
+    return result;
+}
+
+QList<QTextEdit::ExtraSelection> HighLightInfo::toExtraSelections(QTextDocument *textDocument, bool /* checkSyntax */) const {
     // TODO use checkSyntax to remove all the underlining etc.
-    return extraSelections;
+    QList<QTextEdit::ExtraSelection> result;
+    int line = 0;
+
+    // walk the blocks once instead of moving a cursor from the start of the document for every run
+    for (QTextBlock block = textDocument->begin(); block.isValid() && line < formatRunsByLine.size(); block = block.next(), line++) {
+        for (const FormatRun &formatRun : formatRunsByLine.at(line)) {
+            QTextEdit::ExtraSelection extraSelection;
+            extraSelection.cursor = QTextCursor(block);
+            extraSelection.cursor.setPosition(block.position() + formatRun.column);
+            extraSelection.cursor.setPosition(block.position() + formatRun.column + formatRun.length, QTextCursor::KeepAnchor);
+            extraSelection.format = getTextCharFormat(formatRun.category);
+            result.push_back(extraSelection);
+        }
+    }
+
+    return result;
+}
+
+QVector<QTextLayout::FormatRange> HighLightInfo::toFormatRanges(const FormatRuns &formatRuns) {
+    QVector<QTextLayout::FormatRange> result;
+    result.reserve(formatRuns.size());
+
+    for (const FormatRun &formatRun : formatRuns) {
+        QTextLayout::FormatRange formatRange;
+        formatRange.start = formatRun.column;
+        formatRange.length = formatRun.length;
+        formatRange.format = getTextCharFormat(formatRun.category);
+        result.push_back(formatRange);
+    }
+
+    return result;
+}
+
+void HighLightInfo::applyFormatRuns(QTextDocument *textDocument, const QVector<FormatRuns> &formatRunsByLine) {
+    // The text document has signals such as "cursorPositionChanged" etc. we do not need to be emitted here.
+    QSignalBlocker signalBlockerTextDocument(textDocument);
+    int line = 0;
+
+    for (QTextBlock block = textDocument->begin(); block.isValid(); block = block.next(), line++) {
+        if (line < formatRunsByLine.size() && !formatRunsByLine.at(line).isEmpty()) {
+            block.layout()->setFormats(toFormatRanges(formatRunsByLine.at(line)));
+        } else if (!block.layout()->formats().isEmpty()) {
+            block.layout()->clearFormats();
+        }
+    }
+
+    // the layout formats do not change the document contents, so the layout has to be told to update everything once
+    textDocument->markContentsDirty(0, textDocument->characterCount());
 }
 
 VJassAst* HighLightInfo::getAst() const {
@@ -288,6 +272,10 @@ const QList<VJassParseError>& HighLightInfo::getParseErrors() const {
     return parseErrors;
 }
 
+const DiagnosticsIndex& HighLightInfo::getDiagnosticsIndex() const {
+    return diagnosticsIndex;
+}
+
 const QList<VJassAst*>& HighLightInfo::getAstElements() const {
     return astElements;
 }
@@ -296,16 +284,302 @@ const QMap<HighLightInfo::Location, VJassAst*>& HighLightInfo::getAstElementsByL
     return astElementsByLocation;
 }
 
+const AstSpanIndex& HighLightInfo::getAstSpanIndex() const {
+    return astSpanIndex;
+}
+
+const QHash<QString, VJassAst*>& HighLightInfo::getDeclarationsByIdentifier() const {
+    return declarationsByIdentifier;
+}
+
+QString HighLightInfo::declarationIdentifier(const VJassAst *ast) {
+    const VJassNative *vjassNative = dynamic_cast<const VJassNative*>(ast);
+
+    if (vjassNative != nullptr) {
+        return vjassNative->getIdentifier();
+    }
+
+    const VJassGlobal *vjassGlobal = dynamic_cast<const VJassGlobal*>(ast);
+
+    if (vjassGlobal != nullptr) {
+        return vjassGlobal->getName();
+    }
+
+    const VJassType *vjassType = dynamic_cast<const VJassType*>(ast);
+
+    if (vjassType != nullptr) {
+        return vjassType->getIdentifier();
+    }
+
+    return QString();
+}
+
 const QList<VJassAst*>& HighLightInfo::getAstLeakingElements() const {
     return astLeakingElements;
 }
 
-HighLightInfo::CustomTextCharFormat& HighLightInfo::getCustomTextCharFormat(int line, int column) {
-    const Location key = Location(line, column);
+void HighLightInfo::setBracketPairIndex(const BracketPairIndex &bracketPairIndex) {
+    this->bracketPairIndex = bracketPairIndex;
+}
+
+const BracketPairIndex& HighLightInfo::getBracketPairIndex() const {
+    return bracketPairIndex;
+}
+
+void HighLightInfo::setFoldRangeIndex(const FoldRangeIndex &foldRangeIndex) {
+    this->foldRangeIndex = foldRangeIndex;
+}
+
+const FoldRangeIndex& HighLightInfo::getFoldRangeIndex() const {
+    return foldRangeIndex;
+}
+
+void HighLightInfo::setCompletionUnits(const CompletionIndex::Units &completionUnits) {
+    this->completionUnits = completionUnits;
+}
+
+const CompletionIndex::Units& HighLightInfo::getCompletionUnits() const {
+    return completionUnits;
+}
+
+void HighLightInfo::setSymbols(const SymbolIndex::Symbols &symbols) {
+    this->symbols = symbols;
+}
+
+const SymbolIndex::Symbols& HighLightInfo::getSymbols() const {
+    return symbols;
+}
+
+void HighLightInfo::setSignatures(const SignatureIndex::Signatures &signatures) {
+    this->signatures = signatures;
+}
+
+const SignatureIndex::Signatures& HighLightInfo::getSignatures() const {
+    return signatures;
+}
+
+void HighLightInfo::setSymbolTable(const QSharedPointer<const VJassSymbolTable> &symbolTable) {
+    this->symbolTable = symbolTable;
+
+    // the format runs are only filled for highlighting
+    if (symbolTable.isNull() || lineHashes.isEmpty()) {
+        return;
+    }
+
+    const QVector<VJassSymbolTable::SemanticRuns> &semanticRunsByLine = symbolTable->getSemanticRunsByLine();
+
+    for (int line = 0; line < semanticRunsByLine.size(); line++) {
+        const VJassSymbolTable::SemanticRuns &semanticRuns = semanticRunsByLine.at(line);
+
+        if (semanticRuns.isEmpty()) {
+            continue;
+        }
+
+        for (const VJassSymbolTable::SemanticRun &semanticRun : semanticRuns) {
+            addFormatRun(line, semanticRun.column, semanticRun.length, formatCategoryFromKind(semanticRun.kind));
+        }
+
+        // the identifiers were not highlighted by their tokens, so the runs only have to be ordered again
+        FormatRuns &formatRuns = formatRunsByLine[line];
+        std::stable_sort(formatRuns.begin(), formatRuns.end(), [](const FormatRun &r1, const FormatRun &r2) {
+            return r1.column < r2.column;
+        });
+    }
+}
+
+const QSharedPointer<const VJassSymbolTable>& HighLightInfo::getSymbolTable() const {
+    return symbolTable;
+}
+
+HighLightInfo::FormatCategory HighLightInfo::formatCategoryFromToken(const VJassToken &token) {
+    if (token.isValidKeyword()) {
+        // true and false are keywords but are highlighted like literals
+        if (token.getType() == VJassToken::TrueKeyword || token.getType() == VJassToken::FalseKeyword) {
+            return BooleanFormat;
+        }
 
-    if (!customTextCharFormats.contains(key)) {
-        customTextCharFormats.insert(key, CustomTextCharFormat());
+        return KeywordFormat;
     }
 
-    return customTextCharFormats[key];
+    switch (token.getType()) {
+        case VJassToken::Comment: {
+            return CommentFormat;
+        }
+
+        case VJassToken::RawCodeLiteral:
+        case VJassToken::IntegerLiteral:
+        case VJassToken::RealLiteral: {
+            return NumberFormat;
+        }
+
+        case VJassToken::StringLiteral: {
+            // TODO highlight escape sequence inside of the string
+            return StringFormat;
+        }
+
+        case VJassToken::EscapeLiteral: {
+            return EscapeFormat;
+        }
+
+        case VJassToken::Text: {
+            // Make a quick check for the symbol from hash sets of standard types and functions so we have these highlighted even without syntax checking
+            if (token.isCommonJType()) {
+                return CommonJTypeFormat;
+            } else if (token.isCommonJNative()) {
+                return CommonJNativeFormat;
+            } else if (token.isCommonJConstant()) {
+                return CommonJConstantFormat;
+            } else if (token.isBlizzardJConstant()) {
+                return BlizzardJConstantFormat;
+            } else if (token.isBlizzardJGlobal()) {
+                return BlizzardJGlobalFormat;
+            } else if (token.isBlizzardJFunction()) {
+                return BlizzardJFunctionFormat;
+            } else if (token.isCommonAIConstant()) {
+                return CommonAIConstantFormat;
+            } else if (token.isCommonAIGlobal()) {
+                return CommonAIGlobalFormat;
+            } else if (token.isCommonAINative()) {
+                return CommonAINativeFormat;
+            } else if (token.isCommonAIFunction()) {
+                return CommonAIFunctionFormat;
+            }
+
+            break;
+        }
+
+        default: {
+            break;
+        }
+    }
+
+    return NoFormat;
+}
+
+HighLightInfo::FormatCategory HighLightInfo::formatCategoryFromKind(VJassSymbolTable::Kind kind) {
+    switch (kind) {
+        case VJassSymbolTable::Type: {
+            return TypeFormat;
+        }
+
+        case VJassSymbolTable::Native: {
+            return NativeFormat;
+        }
+
+        case VJassSymbolTable::Function: {
+            return FunctionFormat;
+        }
+
+        case VJassSymbolTable::Constant: {
+            return ConstantFormat;
+        }
+
+        case VJassSymbolTable::Global: {
+            return GlobalFormat;
+        }
+
+        case VJassSymbolTable::Local: {
+            return LocalFormat;
+        }
+
+        case VJassSymbolTable::Parameter: {
+            return ParameterFormat;
+        }
+
+        default: {
+            break;
+        }
+    }
+
+    return NoFormat;
+}
+
+namespace {
+
+QVector<HighLightInfo::CustomTextCharFormat> createCustomTextCharFormats() {
+    QVector<HighLightInfo::CustomTextCharFormat> result(HighLightInfo::FormatCategoryCount);
+
+    // formats are taken from https://github.com/tdauth/syntaxhighlightings/blob/master/Kate/vjass.xml
+    // TODO You should be able to configure them in the settings but this has no high priority right now.
+    result[HighLightInfo::KeywordFormat] = HighLightInfo::CustomTextCharFormat(Qt::black, true, false);
+    result[HighLightInfo::CommentFormat] = HighLightInfo::CustomTextCharFormat(Qt::gray, false, true);
+    result[HighLightInfo::BooleanFormat] = HighLightInfo::CustomTextCharFormat(Qt::blue, false, false);
+    result[HighLightInfo::NumberFormat] = HighLightInfo::CustomTextCharFormat(Qt::darkYellow, false, false);
+    result[HighLightInfo::StringFormat] = HighLightInfo::CustomTextCharFormat(Qt::red, false, false);
+    result[HighLightInfo::EscapeFormat] = HighLightInfo::CustomTextCharFormat(QColor(0xFFC0CB), false, false);
+    result[HighLightInfo::CommonJTypeFormat] = HighLightInfo::CustomTextCharFormat(Qt::blue, false, false);
+    result[HighLightInfo::CommonJNativeFormat] = HighLightInfo::CustomTextCharFormat(QColor(0xba55d3), true, false);
+    result[HighLightInfo::CommonJConstantFormat] = HighLightInfo::CustomTextCharFormat(QColor(0xff7f50), false, true);
+    result[HighLightInfo::BlizzardJConstantFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x00008b), false, true);
+    result[HighLightInfo::BlizzardJGlobalFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x497c8b), false, true);
+    result[HighLightInfo::BlizzardJFunctionFormat] = HighLightInfo::CustomTextCharFormat(QColor(0xff0000), true, false);
+    // color="#6b8e23" selColor="#ffffff" bold="0" italic="1
+    result[HighLightInfo::CommonAIConstantFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x6b8e23), false, true);
+    result[HighLightInfo::CommonAIGlobalFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x5c8e6c), false, true);
+    result[HighLightInfo::CommonAINativeFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x218B21), true, false);
+    result[HighLightInfo::CommonAIFunctionFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x00CD63), true, false);
+    result[HighLightInfo::TypeFormat] = HighLightInfo::CustomTextCharFormat(Qt::darkBlue, false, false);
+    result[HighLightInfo::NativeFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x800080), true, false);
+    result[HighLightInfo::FunctionFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x8b0000), true, false);
+    result[HighLightInfo::ConstantFormat] = HighLightInfo::CustomTextCharFormat(QColor(0xcd5c5c), false, true);
+    result[HighLightInfo::GlobalFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x2e8b57), false, true);
+    result[HighLightInfo::LocalFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x4682b4), false, false);
+    result[HighLightInfo::ParameterFormat] = HighLightInfo::CustomTextCharFormat(QColor(0x4682b4), false, true);
+
+    return result;
+}
+
+QVector<QTextCharFormat> createPalette() {
+    QVector<QTextCharFormat> result;
+    result.reserve(HighLightInfo::FormatCategoryCount);
+
+    for (int i = 0; i < HighLightInfo::FormatCategoryCount; i++) {
+        QTextCharFormat fmt = HighLightInfo::getNormalFormat();
+        HighLightInfo::getCustomTextCharFormat(static_cast<HighLightInfo::FormatCategory>(i)).applyToTextCharFormat(fmt, false);
+        result.push_back(fmt);
+    }
+
+    return result;
+}
+
+}
+
+const HighLightInfo::CustomTextCharFormat& HighLightInfo::getCustomTextCharFormat(FormatCategory category) {
+    static const QVector<CustomTextCharFormat> customTextCharFormats = createCustomTextCharFormats();
+
+    return customTextCharFormats.at(category);
+}
+
+const QTextCharFormat& HighLightInfo::getTextCharFormat(FormatCategory category) {
+    // the palette is built only once and shared by all highlighting information
+    static const QVector<QTextCharFormat> palette = createPalette();
+
+    return palette.at(category);
+}
+
+void HighLightInfo::addFormatRuns(int line, int column, const QString &value, FormatCategory category) {
+    // tokens like block comments might span multiple lines but every run belongs to exactly one line
+    int start = 0;
+    int lineBreak = value.indexOf(QLatin1Char('\n'));
+
+    while (lineBreak != -1) {
+        addFormatRun(line, column, lineBreak - start, category);
+        line++;
+        column = 0;
+        start = lineBreak + 1;
+        lineBreak = value.indexOf(QLatin1Char('\n'), start);
+    }
+
+    addFormatRun(line, column, value.length() - start, category);
+}
+
+void HighLightInfo::addFormatRun(int line, int column, int length, FormatCategory category) {
+    if (length > 0) {
+        if (line >= formatRunsByLine.size()) {
+            formatRunsByLine.resize(line + 1);
+        }
+
+        formatRunsByLine[line].push_back(FormatRun(column, length, category));
+        formatRunsCount++;
+    }
 }
@@ -3,18 +3,29 @@
 
 #include <QTextCharFormat>
 #include <QMap>
+#include <QHash>
+#include <QVector>
 #include <QTextEdit>
 #include <QPlainTextEdit>
 #include <QTextDocument>
+#include <QTextLayout>
 
 #include "vjasstoken.h"
 #include "vjassast.h"
+#include "diagnosticsindex.h"
+#include "astspanindex.h"
+#include "bracketpairindex.h"
+#include "foldrangeindex.h"
+#include "completionindex.h"
+#include "symbolindex.h"
+#include "signatureindex.h"
+#include "vjasssymboltable.h"
 
 /**
  * @brief The VJassCodeElementHolder class
  *
- * Holds code elements and stores their formatting for each line and column.
- * Stores the number of upcoming characters with the exact same formatting as well.
+ * Holds code elements and stores their formatting as compact runs for each line.
+ * Every run stores its column, the number of upcoming characters with the exact same formatting and a format category which points into a shared palette.
  *
  * TODO Rename to VJassHighlightInfo or something like that.
  */
@@ -44,18 +55,56 @@ public:
         }
     };
 
+    /**
+     * Every highlighted token belongs to exactly one category. Each category has one prebuilt text char format in a shared palette.
+     */
+    enum FormatCategory : quint8 {
+        NoFormat,
+        KeywordFormat,
+        CommentFormat,
+        BooleanFormat,
+        NumberFormat,
+        StringFormat,
+        EscapeFormat,
+        CommonJTypeFormat,
+        CommonJNativeFormat,
+        CommonJConstantFormat,
+        BlizzardJConstantFormat,
+        BlizzardJGlobalFormat,
+        BlizzardJFunctionFormat,
+        CommonAIConstantFormat,
+        CommonAIGlobalFormat,
+        CommonAINativeFormat,
+        CommonAIFunctionFormat,
+        // declarations of the script which are resolved by its symbol table
+        TypeFormat,
+        NativeFormat,
+        FunctionFormat,
+        ConstantFormat,
+        GlobalFormat,
+        LocalFormat,
+        ParameterFormat,
+        FormatCategoryCount
+    };
+
     struct CustomTextCharFormat {
         bool syntaxError;
         bool isBold;
         bool isItalic;
         bool applyForegroundColor;
         QColor foregroundColor;
-        // the number of upcoming characters with the exact same format
-        int length;
 
         void applyToTextCharFormat(QTextCharFormat &fmt, bool checkSyntax) const;
 
-        CustomTextCharFormat() : syntaxError(false), isBold(false), isItalic(false), applyForegroundColor(false), length(0) {
+        CustomTextCharFormat() : syntaxError(false), isBold(false), isItalic(false), applyForegroundColor(false) {
+        }
+
+        CustomTextCharFormat(const QColor &foregroundColor, bool isBold, bool isItalic)
+            : syntaxError(false)
+            , isBold(isBold)
+            , isItalic(isItalic)
+            , applyForegroundColor(true)
+            , foregroundColor(foregroundColor) {
         }
 
         CustomTextCharFormat(const CustomTextCharFormat &other)
@@ -63,7 +112,7 @@ public:
             , isBold(other.isBold)
             , isItalic(other.isItalic)
             , applyForegroundColor(other.applyForegroundColor)
-            , length(other.length) {
+            , foregroundColor(other.foregroundColor) {
         }
 
         CustomTextCharFormat& operator=(const CustomTextCharFormat &other) {
@@ -72,36 +121,147 @@ public:
             this->isItalic = other.isItalic;
             this->applyForegroundColor = other.applyForegroundColor;
             this->foregroundColor = other.foregroundColor;
-            this->length = other.length;
 
             return *this;
         }
     };
 
-    const QMap<Location, CustomTextCharFormat>& getFormattedLocations() const;
+    /**
+     * @brief A compact run of characters inside of one line which share the same format category.
+     */
+    struct FormatRun {
+        int column;
+        int length;
+        FormatCategory category;
+
+        FormatRun() : column(0), length(0), category(NoFormat) {
+        }
+
+        FormatRun(int column, int length, FormatCategory category) : column(column), length(length), category(category) {
+        }
+    };
+
+    using FormatRuns = QVector<FormatRun>;
+
+    /**
+     * @return Returns the format runs of all lines. The index is the line number starting with 0.
+     */
+    const QVector<FormatRuns>& getFormatRunsByLine() const;
+    /**
+     * @return Returns the format runs of the given line sorted by their columns or an empty list if the line has none.
+     */
+    const FormatRuns& getFormatRuns(int line) const;
+    int getFormatRunsCount() const;
+    /**
+     * @return Returns the hash of every line of the text the format runs have been created from. It can be compared to the hash of a text block to check if the runs are still valid for it.
+     */
+    const QVector<uint>& getLineHashes() const;
+    static uint lineHash(QStringView line);
+    /**
+     * @return Returns the approximate number of bytes used for storing the format runs.
+     */
+    int getFormatRunsMemoryUsage() const;
+
     QList<QTextEdit::ExtraSelection> toExtraSelections(QTextDocument *textDocument, bool checkSyntax) const;
+    /**
+     * @return Returns the format ranges of one line which can be applied to the layout of the corresponding text block.
+     */
+    static QVector<QTextLayout::FormatRange> toFormatRanges(const FormatRuns &formatRuns);
+    /**
+     * @brief Formats a whole text document block by block using the layout formats of every block.
+     * Every line is expected to be one block. This takes linear time in the number of blocks and runs and does not modify the undo stack.
+     */
+    static void applyFormatRuns(QTextDocument *textDocument, const QVector<FormatRuns> &formatRunsByLine);
     VJassAst* getAst() const;
     QTextDocument* getTextDocument() const;
     const QList<VJassParseError>& getParseErrors() const;
+    /**
+     * @return Returns the parse errors indexed by their lines.
+     */
+    const DiagnosticsIndex& getDiagnosticsIndex() const;
     const QList<VJassAst*>& getAstElements() const;
     const QMap<Location, VJassAst*>& getAstElementsByLocation() const;
+    /**
+     * @return Returns the index which finds the innermost AST element at a position.
+     */
+    const AstSpanIndex& getAstSpanIndex() const;
+    /**
+     * @return Returns all declared types, natives, functions and globals by their identifiers.
+     */
+    const QHash<QString, VJassAst*>& getDeclarationsByIdentifier() const;
     const QList<VJassAst*>& getAstLeakingElements() const;
+    /**
+     * @brief Stores the bracket pairs the scanner has found in the text. It has to be called before the results are shared with other threads.
+     */
+    void setBracketPairIndex(const BracketPairIndex &bracketPairIndex);
+    const BracketPairIndex& getBracketPairIndex() const;
+    /**
+     * @brief Stores the fold ranges the parser has found in the text. It has to be called before the results are shared with other threads.
+     */
+    void setFoldRangeIndex(const FoldRangeIndex &foldRangeIndex);
+    const FoldRangeIndex& getFoldRangeIndex() const;
+    /**
+     * @brief Stores the declarations grouped into units for the completion index. It has to be called before the results are shared with other threads.
+     */
+    void setCompletionUnits(const CompletionIndex::Units &completionUnits);
+    const CompletionIndex::Units& getCompletionUnits() const;
+    /**
+     * @brief Stores the declarations for the symbol index of all documents. It has to be called before the results are shared with other threads.
+     */
+    void setSymbols(const SymbolIndex::Symbols &symbols);
+    const SymbolIndex::Symbols& getSymbols() const;
+    /**
+     * @brief Stores the parameters and return types of the natives and functions for the signature index of all documents. It has to be called before the results are shared with other threads.
+     */
+    void setSignatures(const SignatureIndex::Signatures &signatures);
+    const SignatureIndex::Signatures& getSignatures() const;
+    /**
+     * @brief Stores the resolved symbol table and adds its semantic runs to the format runs of their lines. It has to be called before the results are shared with other threads.
+     */
+    void setSymbolTable(const QSharedPointer<const VJassSymbolTable> &symbolTable);
+    /**
+     * @return Returns the symbol table which the next analysis of the same document can reuse or nullptr.
+     */
+    const QSharedPointer<const VJassSymbolTable>& getSymbolTable() const;
+
+    static FormatCategory formatCategoryFromToken(const VJassToken &token);
+    static FormatCategory formatCategoryFromKind(VJassSymbolTable::Kind kind);
+    /**
+     * @return Returns the identifier of a type, native, function or global declaration or an empty string for any other element.
+     */
+    static QString declarationIdentifier(const VJassAst *ast);
+    static const CustomTextCharFormat& getCustomTextCharFormat(FormatCategory category);
+    /**
+     * @return Returns the prebuilt format of the category from the shared palette. It includes the normal font.
+     */
+    static const QTextCharFormat& getTextCharFormat(FormatCategory category);
 
     static QFont getNormalFont();
     static void applyNormalFormat(QTextCharFormat &textCharFormat);
     static QTextCharFormat getNormalFormat();
 
 private:
-    CustomTextCharFormat& getCustomTextCharFormat(int line, int column);
+    void addFormatRuns(int line, int column, const QString &value, FormatCategory category);
+    void addFormatRun(int line, int column, int length, FormatCategory category);
 
-    QMap<Location, CustomTextCharFormat> customTextCharFormats;
+    QVector<FormatRuns> formatRunsByLine;
+    int formatRunsCount;
+    QVector<uint> lineHashes;
     VJassAst *ast;
     QTextDocument *textDocument;
-    QList<QTextEdit::ExtraSelection> extraSelections;
     QList<VJassParseError> parseErrors;
+    DiagnosticsIndex diagnosticsIndex;
     QList<VJassAst*> astElements;
     QMap<Location, VJassAst*> astElementsByLocation;
+    AstSpanIndex astSpanIndex;
+    QHash<QString, VJassAst*> declarationsByIdentifier;
     QList<VJassAst*> astLeakingElements;
+    BracketPairIndex bracketPairIndex;
+    FoldRangeIndex foldRangeIndex;
+    CompletionIndex::Units completionUnits;
+    SymbolIndex::Symbols symbols;
+    SignatureIndex::Signatures signatures;
+    QSharedPointer<const VJassSymbolTable> symbolTable;
 };
 
 inline bool operator<(const HighLightInfo::Location &e1, const HighLightInfo::Location &e2) {
@@ -110,6 +270,12 @@ inline bool operator<(const HighLightInfo::Location &e1, const HighLightInfo::Lo
     return lineDiff > 0 || (lineDiff == 0 && e2.column > e1.column);
 }
 
+inline bool operator==(const HighLightInfo::FormatRun &e1, const HighLightInfo::FormatRun &e2) {
+    return e1.column == e2.column
+            && e1.length == e2.length
+            && e1.category == e2.category;
+}
+
 inline bool operator==(const HighLightInfo::CustomTextCharFormat &e1, const HighLightInfo::CustomTextCharFormat &e2) {
     return e1.applyForegroundColor == e2.applyForegroundColor
             && e1.foregroundColor == e2.foregroundColor
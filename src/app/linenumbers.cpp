@@ -2,56 +2,234 @@
 #include <QtWidgets>
 
 #include "linenumbers.h"
-#include "ui_linenumbers.h"
+#include "textedit.h"
+
+namespace {
+
+const int MARGIN = 4;
+const int MARKER_WIDTH = 10;
+
+}
 
 LineNumbers::LineNumbers(QWidget *parent)
     : QWidget(parent)
-    , ui(new Ui::LineNumbers)
+    , textEdit(nullptr)
+    , visibleLinesValid(false)
+    , digits(1)
+    , lineStart(0)
+    , lineEnd(0)
 {
-    ui->setupUi(this);
+    setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
 }
 
 LineNumbers::~LineNumbers() {
-    delete ui;
-    ui = nullptr;
 }
 
-void LineNumbers::setLineNumbers(int start, int lineNumbers, const QList<qreal> &lineHeights) {
-    ui->listWidget->clear();
+void LineNumbers::setTextEdit(TextEdit *textEdit) {
+    if (this->textEdit != nullptr) {
+        disconnect(this->textEdit, nullptr, this, nullptr);
+    }
+
+    this->textEdit = textEdit;
+
+    if (textEdit != nullptr) {
+        setFont(textEdit->font());
+        // the text edit requests updates for scrolling, editing and the blinking cursor
+        connect(textEdit, &QPlainTextEdit::updateRequest, this, &LineNumbers::updateRequest);
+        connect(textEdit, &QPlainTextEdit::blockCountChanged, this, &LineNumbers::updateWidth);
+    }
+
+    updateWidth();
+    invalidateVisibleLines();
+}
 
-    //qDebug() << "Set line numbers from" << start << "with count" << lineNumbers;
+TextEdit* LineNumbers::getTextEdit() const {
+    return textEdit;
+}
 
-    for (int i = 0; i < lineNumbers; i++) {
-        const int lineNumber = start + i;
-        QListWidgetItem *listWidgetItem = new QListWidgetItem(ui->listWidget);
-        listWidgetItem->setText(QString::number(lineNumber + 1));
-        listWidgetItem->setData(Qt::UserRole, lineNumber);
-        //QFont font = listWidgetItem->font();
-        //font.setPointSizeF(lineHeights.at(i));
-        //listWidgetItem->setFont(font);
-        listWidgetItem->setSizeHint(QSize(30, lineHeights.at(i)));
+QSize LineNumbers::sizeHint() const {
+    return QSize(MARKER_WIDTH + MARGIN + fontMetrics().horizontalAdvance(QLatin1Char('9')) * digits + MARGIN + MARKER_WIDTH, 0);
+}
 
-        //qDebug() << "Setting line height of line" << i << "to" << lineHeights.at(i);
-        //listWidgetItem->setSizeHint(QSize(10, lineHeights.at(i)));
+int LineNumbers::lineAt(int y) const {
+    for (const VisibleLine &visibleLine : visibleLines) {
+        if (y >= visibleLine.top && y < visibleLine.top + visibleLine.height) {
+            return visibleLine.line;
+        }
     }
+
+    return -1;
+}
+
+int LineNumbers::getVisibleLinesCount() const {
+    return visibleLines.size();
 }
 
 void LineNumbers::updateSelectedLines(int lineStart, int lineEnd) {
-    //qDebug() << "Set selected line numbers from" << lineStart << "to" << lineEnd;
+    if (this->lineStart != lineStart || this->lineEnd != lineEnd) {
+        this->lineStart = lineStart;
+        this->lineEnd = lineEnd;
+        update();
+    }
+}
+
+void LineNumbers::setDiagnosticsIndex(const DiagnosticsIndex &diagnosticsIndex) {
+    this->diagnosticsIndex = diagnosticsIndex;
+    update();
+}
+
+void LineNumbers::setFoldRangeIndex(const FoldRangeIndex &foldRangeIndex) {
+    this->foldRangeIndex = foldRangeIndex;
+    this->foldableLines = foldRangeIndex.toFoldableLines(textEdit != nullptr ? textEdit->blockCount() : 0);
+    invalidateVisibleLines();
+}
+
+void LineNumbers::paintEvent(QPaintEvent *event) {
+    QPainter painter(this);
+    painter.fillRect(event->rect(), Qt::white);
+
+    if (!visibleLinesValid) {
+        updateVisibleLines();
+    }
+
+    const int numberWidth = width() - 2 * MARKER_WIDTH - MARGIN;
+    QFont normalFont = font();
+    normalFont.setBold(false);
+    QFont boldFont = font();
+    boldFont.setBold(true);
+
+    for (const VisibleLine &visibleLine : visibleLines) {
+        if (visibleLine.top > event->rect().bottom()) {
+            break;
+        } else if (visibleLine.top + visibleLine.height < event->rect().top()) {
+            continue;
+        }
+
+        const bool isSelected = visibleLine.line >= lineStart && visibleLine.line <= lineEnd;
+
+        if (isSelected) {
+            painter.fillRect(QRect(0, visibleLine.top, width(), visibleLine.height), QColor(0xfaf5d4));
+        }
+
+        painter.setFont(isSelected ? boldFont : normalFont);
+        painter.setPen(isSelected ? Qt::black : Qt::darkGray);
+        painter.drawText(QRect(MARKER_WIDTH, visibleLine.top, numberWidth, visibleLine.height), Qt::AlignRight | Qt::AlignVCenter, QString::number(visibleLine.line + 1));
+
+        // the errors and foldable ranges are looked up in constant time per line
+        if (diagnosticsIndex.hasDiagnostics(visibleLine.line)) {
+            const int size = qMin(MARKER_WIDTH - 4, visibleLine.height - 4);
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(Qt::red);
+            painter.drawEllipse(QRect(2, visibleLine.top + (visibleLine.height - size) / 2, size, size));
+        }
+
+        if (visibleLine.line < foldableLines.size() && foldableLines.testBit(visibleLine.line)) {
+            const int size = qMin(MARKER_WIDTH - 4, visibleLine.height - 4);
+            const QRect rect(width() - MARKER_WIDTH + 2, visibleLine.top + (visibleLine.height - size) / 2, size, size);
+            painter.setPen(Qt::darkGray);
+            painter.setBrush(Qt::NoBrush);
+            painter.drawRect(rect);
+            painter.drawLine(rect.left() + 2, rect.center().y(), rect.right() - 2, rect.center().y());
+
+            if (visibleLine.folded) {
+                painter.drawLine(rect.center().x(), rect.top() + 2, rect.center().x(), rect.bottom() - 2);
+            }
+        }
+    }
+}
+
+void LineNumbers::mousePressEvent(QMouseEvent *event) {
+    if (event->button() == Qt::LeftButton) {
+        const int line = lineAt(event->pos().y());
+
+        if (line != -1) {
+            if (event->pos().x() >= width() - MARKER_WIDTH && line < foldableLines.size() && foldableLines.testBit(line)) {
+                emit foldMarkerClicked(line);
+            } else {
+                emit lineClicked(line);
+            }
+        }
+    }
+}
+
+void LineNumbers::resizeEvent(QResizeEvent *event) {
+    invalidateVisibleLines();
+
+    QWidget::resizeEvent(event);
+}
+
+void LineNumbers::updateRequest(const QRect &rect, int dy) {
+    // the cursor blinking does not change any line
+    if (dy != 0 || rect.contains(textEdit->viewport()->rect())) {
+        invalidateVisibleLines();
+    } else {
+        update(0, rect.y(), width(), rect.height());
+    }
+}
+
+void LineNumbers::updateWidth() {
+    const int blockCount = textEdit != nullptr ? textEdit->blockCount() : 1;
+    const int newDigits = QString::number(qMax(1, blockCount)).length();
+
+    if (newDigits != digits) {
+        digits = newDigits;
+        setFixedWidth(sizeHint().width());
+    } else if (width() != sizeHint().width()) {
+        setFixedWidth(sizeHint().width());
+    }
+
+    invalidateVisibleLines();
+}
+
+void LineNumbers::updateVisibleLines() {
+    visibleLines.clear();
+    visibleLinesValid = true;
+
+    if (textEdit == nullptr) {
+        return;
+    }
+
+    // the viewport might have a different position than this widget
+    const int offset = textEdit->viewport()->mapTo(window(), QPoint(0, 0)).y() - mapTo(window(), QPoint(0, 0)).y();
+    const QPointF contentOffset = textEdit->getContentOffset();
+    const int bottom = height();
+
+    for (QTextBlock block = textEdit->getFirstVisibleBlock(); block.isValid(); block = nextUnfoldedBlock(block)) {
+        if (!block.isVisible()) {
+            continue;
+        }
+
+        const QRectF geometry = textEdit->getBlockBoundingGeometry(block).translated(contentOffset);
+        const int top = qRound(geometry.top()) + offset;
+
+        if (top > bottom) {
+            break;
+        }
+
+        visibleLines.push_back(VisibleLine(block.blockNumber(), top, qRound(geometry.height()), block.next().isValid() && !block.next().isVisible()));
+    }
+}
+
+QTextBlock LineNumbers::nextUnfoldedBlock(const QTextBlock &block) const {
+    const QTextBlock next = block.next();
 
-    for (int i = 0; i < ui->listWidget->count(); i++) {
-        const int lineNumber = ui->listWidget->item(i)->data(Qt::UserRole).toInt();
-        QFont font = ui->listWidget->item(i)->font();
+    if (next.isValid() && !next.isVisible()) {
+        // the blocks of a folded range are skipped in one step instead of one by one
+        const int endLine = foldRangeIndex.endLineOf(block.blockNumber());
 
-        if (lineNumber >= lineStart && lineNumber <= lineEnd) {
-            font.setBold(true);
-            ui->listWidget->item(i)->setBackground(QColor(0xfaf5d4));
-            // TODO Change palette highlighted color as well.
-            ui->listWidget->item(i)->setFont(font);
-        } else {
-            font.setBold(false);
-            ui->listWidget->item(i)->setBackground(QColor(0xffffff));
-            ui->listWidget->item(i)->setFont(font);
+        if (endLine > block.blockNumber()) {
+            const QTextBlock last = block.document()->findBlockByNumber(endLine);
+
+            if (last.isValid() && !last.isVisible()) {
+                return last.next();
+            }
         }
     }
+
+    return next;
+}
+
+void LineNumbers::invalidateVisibleLines() {
+    visibleLinesValid = false;
+    update();
 }
@@ -2,11 +2,21 @@
 #define LINENUMBERS_H
 
 #include <QWidget>
+#include <QVector>
+#include <QBitArray>
+#include <QTextBlock>
 
-QT_BEGIN_NAMESPACE
-namespace Ui { class LineNumbers; }
-QT_END_NAMESPACE
+#include "diagnosticsindex.h"
+#include "foldrangeindex.h"
 
+class TextEdit;
+
+/**
+ * @brief Paints the line numbers of the visible blocks of a text edit together with markers for errors and foldable lines.
+ *
+ * It starts with the first visible block of the text edit and uses the geometry of the blocks, so it never walks the whole document.
+ * The numbers and positions of the visible lines are cached until the text edit has been scrolled, resized or its content has changed.
+ */
 class LineNumbers : public QWidget
 {
     Q_OBJECT
@@ -15,12 +25,71 @@ public:
     LineNumbers(QWidget *parent);
     virtual ~LineNumbers();
 
+    void setTextEdit(TextEdit *textEdit);
+    TextEdit* getTextEdit() const;
+
+    virtual QSize sizeHint() const override;
+
+    /**
+     * @return Returns the line at the y coordinate or -1 if there is no visible line.
+     */
+    int lineAt(int y) const;
+    int getVisibleLinesCount() const;
+
 public slots:
-    void setLineNumbers(int start, int lineNumbers, const QList<qreal> &lineHeights);
     void updateSelectedLines(int lineStart, int lineEnd);
+    void setDiagnosticsIndex(const DiagnosticsIndex &diagnosticsIndex);
+    /**
+     * @brief Marks the lines at which a range of the index starts as foldable. The ends of the ranges let the painting skip a folded range at once.
+     */
+    void setFoldRangeIndex(const FoldRangeIndex &foldRangeIndex);
+
+signals:
+    void lineClicked(int line);
+    /**
+     * @brief Is emitted when the marker of a foldable line has been clicked.
+     */
+    void foldMarkerClicked(int line);
+
+protected:
+    virtual void paintEvent(QPaintEvent *event) override;
+    virtual void mousePressEvent(QMouseEvent *event) override;
+    virtual void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    void updateRequest(const QRect &rect, int dy);
+    void updateWidth();
 
 private:
-    Ui::LineNumbers *ui;
+    struct VisibleLine {
+        int line;
+        int top;
+        int height;
+        bool folded; // the following blocks are hidden
+
+        VisibleLine() : line(0), top(0), height(0), folded(false) {
+        }
+
+        VisibleLine(int line, int top, int height, bool folded) : line(line), top(top), height(height), folded(folded) {
+        }
+    };
+
+    void updateVisibleLines();
+    /**
+     * @return Returns the next block after the block which is not hidden by a fold of the block.
+     */
+    QTextBlock nextUnfoldedBlock(const QTextBlock &block) const;
+    void invalidateVisibleLines();
+
+    TextEdit *textEdit;
+    QVector<VisibleLine> visibleLines;
+    bool visibleLinesValid;
+    int digits;
+    int lineStart;
+    int lineEnd;
+    DiagnosticsIndex diagnosticsIndex;
+    FoldRangeIndex foldRangeIndex;
+    QBitArray foldableLines;
 };
 
 #endif // LINENUMBERS_H
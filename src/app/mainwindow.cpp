@@ -6,29 +6,93 @@
 #include "ui_mainwindow.h"
 #include "vjassscanner.h"
 #include "highlightinfo.h"
+#include "analysis.h"
 #include "pjass.h"
 #include "jasshelper.h"
 #include "memoryleakanalyzer.h"
 #include "version.h"
+#include "scriptviewer.h"
+#include "vjassstatement.h"
+#include "vjassexpression.h"
+#include "vjassnative.h"
+#include "vjassfunction.h"
+#include "vjasslocalstatement.h"
+#include "vjassglobals.h"
+#include "vjassglobal.h"
+#include "vjasstype.h"
+
+namespace {
+
+/**
+ * Returns the declaration of the signature with the parameter at the index in bold as rich text.
+ */
+QString signatureHelpText(const SignatureIndex::Signature &signature, int activeParameter) {
+    QStringList parameters;
+
+    for (int i = 0; i < signature.parameters.size(); i++) {
+        const QString parameter = (signature.parameters.at(i).type + " " + signature.parameters.at(i).name).toHtmlEscaped();
+        parameters.push_back(i == activeParameter ? "<b>" + parameter + "</b>" : parameter);
+    }
+
+    return (signature.isNative ? VJassToken::KEYWORD_NATIVE : VJassToken::KEYWORD_FUNCTION) + " " + signature.name.toHtmlEscaped() + " " + VJassToken::KEYWORD_TAKES + " "
+            + (parameters.isEmpty() ? VJassToken::KEYWORD_NOTHING : parameters.join(", "))
+            + " " + VJassToken::KEYWORD_RETURNS + " " + signature.returnType.toHtmlEscaped();
+}
+
+QTextDocument* newTextDocument(QObject *parent) {
+    QTextDocument *textDocument = new QTextDocument(parent);
+    // the text edit requires the plain text layout
+    textDocument->setDocumentLayout(new QPlainTextDocumentLayout(textDocument));
+
+    return textDocument;
+}
+
+}
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , popup(new AutoCompletionPopup)
     , timerId(0)
-    , timerIdCheck(startTimer(500)) // poll every 0.5 seconds for a parser result
-    , scanAndParseInput(nullptr)
-    , scanAndParseResults(nullptr)
     , scanAndParsePaused(0)
-    , stopScanAndParseThread(0)
     , syntaxChecker(0) // vjasside
     , parserName("vjasside")
 {
     ui->setupUi(this);
+
+    // every open file has its own document and tab which is shown above the text edit
+    documentTabBar = new QTabBar(this);
+    documentTabBar->setTabsClosable(true);
+    documentTabBar->setMovable(true);
+    documentTabBar->setExpanding(false);
+    documentTabBar->setDocumentMode(true);
+    ui->verticalLayout_2->insertWidget(0, documentTabBar);
+    ui->textEdit->setDocument(newTextDocument(this));
+
     findDialog = new FindDialog(ui->textEdit, this);
     findDialog->hide();
     syntaxHighlighter = new SyntaxHighlighter(ui->textEdit->document());
 
+    /*
+     * Scan, parse and prestore highlighting information concurrently to avoid blocking the GUI.
+     * All documents share the threads of the pool and the active document is analyzed first.
+     */
+    analysisPool = new AnalysisPool(0, this);
+
+    // the initial document is empty
+    Document *document = new Document();
+    document->id = nextDocumentId++;
+    document->textDocument = ui->textEdit->document();
+    document->syntaxHighlighter = syntaxHighlighter;
+    document->indexedRevision = document->textDocument->revision();
+    documents.push_back(document);
+    activeDocument = document;
+    analysisPool->setPriorityQueue(document->id);
+    documentTabBar->addTab(documentTitle(document));
+    connect(documentTabBar, &QTabBar::currentChanged, this, &MainWindow::activateDocumentTab);
+    connect(documentTabBar, &QTabBar::tabCloseRequested, this, &MainWindow::closeDocumentTab);
+    connect(documentTabBar, &QTabBar::tabMoved, this, &MainWindow::moveDocumentTab);
+
     // make only the text edit expand
     ui->splitter->setStretchFactor(0, 1);
     ui->splitter->setStretchFactor(1, 0);
@@ -36,15 +100,38 @@ MainWindow::MainWindow(QWidget *parent)
     // make the status bar not disappear
     statusBar = new QLabel(tr(""));
     ui->statusbar->addPermanentWidget(statusBar, 1);
+    // shows the enclosing declaration and statements of the cursor
+    breadcrumb = new QLabel(tr(""));
+    ui->statusbar->addPermanentWidget(breadcrumb, 0);
+    // shows the progress of loading a file
+    loadingProgressBar = new QProgressBar(this);
+    loadingProgressBar->setRange(0, 100);
+    loadingProgressBar->setMaximumWidth(200);
+    loadingProgressBar->hide();
+    ui->statusbar->addPermanentWidget(loadingProgressBar, 0);
+
+    fileLoader = new FileLoader(this);
+    connect(fileLoader, &FileLoader::chunkLoaded, this, &MainWindow::insertLoadedChunk);
+    connect(fileLoader, &FileLoader::finished, this, &MainWindow::finishLoading);
+
+    // hovering identifiers shows their declarations
+    ui->textEdit->viewport()->installEventFilter(this);
 
     connect(ui->actionNew, &QAction::triggered, this, &MainWindow::newFile);
     connect(ui->actionOpen, &QAction::triggered, this, &MainWindow::openFile);
+    connect(ui->actionOpenInViewer, &QAction::triggered, this, &MainWindow::openInViewer);
     connect(ui->actionSaveAs, &QAction::triggered, this, &MainWindow::saveAs);
     connect(ui->actionClose, &QAction::triggered, this, &MainWindow::closeFile);
     connect(ui->actionQuit, &QAction::triggered, this, &MainWindow::quit);
 
     connect(ui->actionGoToLine, &QAction::triggered, this, &MainWindow::goToLine);
+    connect(ui->actionGoToSymbol, &QAction::triggered, this, &MainWindow::showSymbolPalette);
+    connect(ui->actionGoToDeclaration, &QAction::triggered, this, &MainWindow::goToDeclaration);
+    connect(ui->actionFindReferences, &QAction::triggered, this, &MainWindow::findReferences);
+    connect(ui->actionRename, &QAction::triggered, this, &MainWindow::renameSymbol);
+    connect(ui->actionShowCallHierarchy, &QAction::triggered, this, &MainWindow::showCallHierarchy);
     connect(ui->actionFindAndReplace, &QAction::triggered, this, &MainWindow::findAndReplace);
+    connect(ui->actionFindInFiles, &QAction::triggered, this, &MainWindow::showFindInFiles);
     connect(ui->actionApplyColor, &QAction::triggered, this, &MainWindow::applyColor);
 
     connect(ui->actionCommonj, &QAction::triggered, this, &MainWindow::openCommonj);
@@ -55,7 +142,11 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(ui->actionLineNumbers, &QAction::changed, this, &MainWindow::updateLineNumbersView);
     connect(ui->actionShowWhiteSpaces, &QAction::changed, this, &MainWindow::showWhiteSpaces);
+    connect(ui->actionFoldAll, &QAction::triggered, this, &MainWindow::foldAll);
+    connect(ui->actionUnfoldAll, &QAction::triggered, this, &MainWindow::unfoldAll);
 
+    // the popup is shown immediately from the current line and refined when the analysis of the text has finished
+    connect(ui->actionComplete, &QAction::triggered, this, &MainWindow::showCompletionPopup);
     connect(ui->actionComplete, &QAction::triggered, this, &MainWindow::updateSyntaxErrorsWithAutoComplete);
     // trigger a restart so the result is updated even if the text has not changed
     connect(ui->actionComplete, &QAction::triggered, this, &MainWindow::restartTimer);
@@ -82,16 +173,37 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->textEdit, &QPlainTextEdit::textChanged, this, &MainWindow::restartTimer);
     connect(ui->textEdit, &QPlainTextEdit::textChanged, this, &MainWindow::documentChanges);
 
-    // whenever the user changes the view we have to update the line numbers
-    connect(ui->textEdit->horizontalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::updateLineNumbers);
-    connect(ui->textEdit->verticalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::updateLineNumbers);
+    // the line numbers follow the update requests of the text edit when it is scrolled or edited
+    ui->lineNumbersWidget->setTextEdit(ui->textEdit);
+    connect(ui->lineNumbersWidget, &LineNumbers::lineClicked, this, &MainWindow::moveCursorToLine);
+    connect(ui->lineNumbersWidget, &LineNumbers::foldMarkerClicked, this, &MainWindow::toggleFold);
 
     // whenever the cursor position changes, the selection needs to be updated but also the background color/syntax highlighting
     connect(ui->textEdit, &QPlainTextEdit::cursorPositionChanged, this, &MainWindow::updateSelectedLines);
 
-    connect(popup, &QTreeWidget::clicked, this, &MainWindow::clickPopupItem);
-
-    connect(ui->outputListWidget, &QListWidget::itemDoubleClicked, this, &MainWindow::astListItemDoubleClicked);
+    connect(popup, &QAbstractItemView::clicked, this, &MainWindow::clickPopupItem);
+    // the popup is filtered with every keystroke while it is shown
+    connect(ui->textEdit, &QPlainTextEdit::textChanged, this, &MainWindow::updateCompletionPopup);
+
+    // the parameters of the call at the cursor are shown above it and follow every keystroke
+    signatureHelp = new QLabel(this, Qt::ToolTip);
+    signatureHelp->setTextFormat(Qt::RichText);
+    signatureHelp->setMargin(2);
+    connect(ui->textEdit, &QPlainTextEdit::cursorPositionChanged, this, &MainWindow::updateSignatureHelp);
+
+    // the errors are sorted by a proxy and only the texts of the visible rows are created
+    diagnosticsModel = new DiagnosticsModel(this);
+    diagnosticsSortModel = new QSortFilterProxyModel(this);
+    diagnosticsSortModel->setSourceModel(diagnosticsModel);
+    diagnosticsSortModel->setSortRole(DiagnosticsModel::SortRole);
+    ui->diagnosticsTreeView->setModel(diagnosticsSortModel);
+    ui->diagnosticsTreeView->sortByColumn(DiagnosticsModel::LineColumn, Qt::AscendingOrder);
+    connect(ui->diagnosticsTreeView, &QTreeView::doubleClicked, this, &MainWindow::diagnosticsIndexDoubleClicked);
+    connect(ui->groupingComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::updateDiagnosticsGrouping);
+
+    // overview ruler
+    connect(ui->textEdit, &QPlainTextEdit::blockCountChanged, ui->overviewRuler, &OverviewRuler::setLineCount);
+    connect(ui->overviewRuler, &OverviewRuler::lineClicked, this, &MainWindow::moveCursorToLine);
 
     // outliner
 
@@ -100,17 +212,52 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->checkBoxAll, &QCheckBox::clicked, ui->checkBoxConstants, &QCheckBox::setChecked);
     connect(ui->checkBoxAll, &QCheckBox::clicked, ui->checkBoxGlobals, &QCheckBox::setChecked);
     connect(ui->checkBoxAll, &QCheckBox::clicked, ui->checkBoxFunctions, &QCheckBox::setChecked);
-    connect(ui->checkBoxAll, &QCheckBox::clicked, this, &MainWindow::updateOutliner);
-
-    connect(ui->checkBoxTypes, &QCheckBox::clicked, this, &MainWindow::updateOutliner);
-    connect(ui->checkBoxNatives, &QCheckBox::clicked, this, &MainWindow::updateOutliner);
-    connect(ui->checkBoxConstants, &QCheckBox::clicked, this, &MainWindow::updateOutliner);
-    connect(ui->checkBoxGlobals, &QCheckBox::clicked, this, &MainWindow::updateOutliner);
-    connect(ui->checkBoxFunctions, &QCheckBox::clicked, this, &MainWindow::updateOutliner);
-
-    connect(ui->outlinerListWidget, &QListWidget::itemDoubleClicked, this, &MainWindow::astListItemDoubleClicked);
+    connect(ui->checkBoxAll, &QCheckBox::clicked, this, &MainWindow::updateOutlinerFilter);
+
+    connect(ui->checkBoxTypes, &QCheckBox::clicked, this, &MainWindow::updateOutlinerFilter);
+    connect(ui->checkBoxNatives, &QCheckBox::clicked, this, &MainWindow::updateOutlinerFilter);
+    connect(ui->checkBoxConstants, &QCheckBox::clicked, this, &MainWindow::updateOutlinerFilter);
+    connect(ui->checkBoxGlobals, &QCheckBox::clicked, this, &MainWindow::updateOutlinerFilter);
+    connect(ui->checkBoxFunctions, &QCheckBox::clicked, this, &MainWindow::updateOutlinerFilter);
+
+    // the view only requests the labels of the visible rows
+    outlinerModel = new OutlinerModel(this);
+    outlinerFilterModel = new OutlinerFilterModel(this);
+    outlinerFilterModel->setSourceModel(outlinerModel);
+    ui->outlinerListView->setModel(outlinerFilterModel);
+    ui->outlinerListView->setUniformItemSizes(true);
+    connect(ui->outlinerListView, &QListView::doubleClicked, this, &MainWindow::outlinerIndexDoubleClicked);
+    // the placeholder is shown whenever the filter does not accept any declaration
+    connect(outlinerFilterModel, &OutlinerFilterModel::rowsInserted, this, &MainWindow::updateOutlinerPlaceholder);
+    connect(outlinerFilterModel, &OutlinerFilterModel::rowsRemoved, this, &MainWindow::updateOutlinerPlaceholder);
+    connect(outlinerFilterModel, &OutlinerFilterModel::modelReset, this, &MainWindow::updateOutlinerPlaceholder);
+    connect(outlinerFilterModel, &OutlinerFilterModel::layoutChanged, this, &MainWindow::updateOutlinerPlaceholder);
+    updateOutlinerPlaceholder();
+
+    // lists of tabs which are not visible are only filled when they are shown
+    connect(ui->tabWidget, &QTabWidget::currentChanged, this, &MainWindow::startApplyingResults);
     connect(ui->memoryLeaksListWidget, &QListWidget::itemDoubleClicked, this, &MainWindow::astListItemDoubleClicked);
 
+    // all script files of a folder tree are searched in parallel and the results are added file by file
+    findInFilesSearch = new FindInFiles(0, this);
+    connect(findInFilesSearch, &FindInFiles::resultsFound, this, &MainWindow::addFindInFilesResults);
+    connect(findInFilesSearch, &FindInFiles::progress, this, &MainWindow::updateFindInFilesProgress);
+    connect(findInFilesSearch, &FindInFiles::finished, this, &MainWindow::finishFindInFiles);
+    connect(ui->lineEditFindInFiles, &QLineEdit::returnPressed, this, &MainWindow::findInFiles);
+    connect(ui->pushButtonFindInFiles, &QPushButton::clicked, this, &MainWindow::findInFiles);
+    connect(ui->pushButtonCancelFindInFiles, &QPushButton::clicked, this, &MainWindow::cancelFindInFiles);
+    connect(ui->pushButtonFindInFilesFolder, &QPushButton::clicked, this, &MainWindow::chooseFindInFilesFolder);
+    connect(ui->treeWidgetFindInFiles, &QTreeWidget::itemActivated, this, &MainWindow::findInFilesItemActivated);
+    connect(ui->treeWidgetCallHierarchy, &QTreeWidget::itemExpanded, this, &MainWindow::expandCallHierarchyItem);
+    connect(ui->treeWidgetCallHierarchy, &QTreeWidget::itemActivated, this, &MainWindow::callHierarchyItemActivated);
+    ui->lineEditFindInFilesFolder->setText(QFileInfo("wc3reforged").absoluteFilePath());
+
+    // the standard scripts are indexed once when the palette is shown for the first time
+    standardScripts << QFileInfo("wc3reforged/common.j").absoluteFilePath() << QFileInfo("wc3reforged/Blizzard.j").absoluteFilePath() << QFileInfo("wc3reforged/common.ai").absoluteFilePath();
+    // the declarations of the open documents are preferred
+    crossReferenceIndex.setSecondarySources(standardScripts);
+    signatureIndex.setSecondarySources(standardScripts);
+
     // basic settings for text
     ui->textEdit->setFont(HighLightInfo::getNormalFont());
     ui->textEdit->setTabStopDistance(20.0);
@@ -126,159 +273,79 @@ MainWindow::MainWindow(QWidget *parent)
 
     // initial document is empty
     resetDocumentChanges();
-
-    /*
-     * Scan, parse and prestore highlighting information concurrently to avoid blocking the GUI.
-     */
-    scanAndParseThread = QThread::create([this]() {
-                VJassScanner scanner;
-                VJassParser parser;
-
-                // consume the text until the thread is stopped and scan and parse it
-                while (this->stopScanAndParseThread.loadAcquire() == 0) {
-                    //qDebug() << "Retrieving possible scan and parse input text from thread";
-
-                    if (this->scanAndParsePaused.loadAcquire() == 0) {
-                        // consume by replacing it with an empty pointer
-                        QString *text = this->scanAndParseInput.fetchAndStoreAcquire(nullptr);
-
-                        if (text != nullptr) {
-                            //qDebug() << "Got scan and parse input text";
-
-                            QString input = QString(*text);
-                            input.detach(); // avoid memory issues by creating a real deep copy
-                            // discard the transfered text
-                            delete text;
-                            text = nullptr;
-
-                            QList<VJassToken> tokens = scanner.scan(input, true);
-                            qDebug() << "Tokens after scanning" << tokens.size();
-                            VJassAst *ast = parser.parse(tokens);
-
-                            const int syntaxChecker = this->syntaxChecker.loadAcquire();
-                            QList<VJassParseError> parseErrors;
-
-                            // pjass syntax check
-                            if (syntaxChecker == 1) {
-                                PJass pjass;
-                                int pjassExitCode = pjass.run(input);
-
-                                QString jassStandardOutput = pjass.getStandardOutput();
-                                QString pjassErrorOutput = pjass.getStandardError();
-                                qDebug() << "Using pjass and getting exit code" << pjassExitCode;
-
-                                parseErrors = PJass::outputToParseErrors(jassStandardOutput);
-                            // JassHelper syntax check
-                            } else if (syntaxChecker == 2) {
-                                JassHelper jassHelper;
-                                int jassHelperExitCode = jassHelper.run(input);
-
-                                QString jassHelperStandardOutput = jassHelper.getStandardOutput();
-                                QString jassHelperErrorOutput = jassHelper.getStandardError();
-                                qDebug() << "Using JassHelper and getting exit code" << jassHelperExitCode;
-
-                                parseErrors = JassHelper::outputToParseErrors(jassHelperStandardOutput);
-                            // vjasside syntax check
-                            } else {
-                                parseErrors = ast->getAllParseErrors();
-                            }
-
-                            // this stores also the required highlighting information
-                            HighLightInfo *results = new HighLightInfo(input, std::move(tokens), ast, parseErrors, this->analyzeMemoryLeaks.loadAcquire() == 1);
-
-                            if (this->scanAndParsePaused.loadAcquire() == 0) {
-                                // by the end there could be new input and we have to start again
-                                if (this->scanAndParseInput.loadAcquire() == nullptr) {
-                                    //qDebug() << "Finished scanning and parsing and storing it";
-                                    this->scanAndParseResults.storeRelease(results);
-                                } else {
-                                    //qDebug() << "Finished scanning and parsing but discarding it";
-                                    delete results;
-                                    results = nullptr;
-                                }
-                            } else {
-                                //qDebug() << "Finished scanning and parsing but discarding it";
-                                delete results;
-                                results = nullptr;
-                            }
-                        } else {
-                            QThread::msleep(300);
-                        }
-                    } else {
-                        //qDebug() << "Waiting for scan and parse input text in thread";
-                        QThread::msleep(300);
-                    }
-                }
-    });
-    // we have to start the thread and it should not block any applications
-    scanAndParseThread->start(QThread::LowestPriority);
 }
 
 MainWindow::~MainWindow()
 {
+    fileLoader->cancel();
+    // running jobs refer to the main window
+    analysisPool->shutdown();
+
+    if (standardScriptsThread != nullptr) {
+        stopStandardScriptsThread.storeRelease(1);
+        standardScriptsThread->wait();
+        delete standardScriptsThread;
+        standardScriptsThread = nullptr;
+    }
+
     delete ui;
     ui = nullptr;
     delete popup;
     popup = nullptr;
 
-    killTimer(timerIdCheck);
+    if (timerIdApplyResults != 0) {
+        killTimer(timerIdApplyResults);
+    }
+
+    if (timerIdFindReferences != 0) {
+        killTimer(timerIdFindReferences);
+    }
 
     if (timerId != 0) {
         killTimer(timerId);
     }
 
-    stopScanAndParseThread.storeRelease(1);
-    scanAndParseThread->wait();
-    delete scanAndParseThread;
-    scanAndParseThread = nullptr;
-
-    if (currentResults != nullptr) {
-        delete currentResults;
-        currentResults = nullptr;
-    }
+    currentResults.reset();
+    qDeleteAll(documents);
+    documents.clear();
 }
 
 void MainWindow::newFile() {
-    if (documentHasChanged) {
-        if (QMessageBox::question(this, tr("Discard unsaved changes"), tr("The document has been modified. Do you want to save your changes?")) == QMessageBox::Yes) {
-            if (saveAs()) {
-                ui->textEdit->clear();
-                resetDocumentChanges();
-            }
-        }
-    } else {
-        ui->textEdit->clear();
-        resetDocumentChanges();
-    }
+    cancelLoading();
+    addDocument();
 }
 
 void MainWindow::openFile() {
-    bool saved = true;
+    QString openFileName = QFileDialog::getOpenFileName(this, tr("Open File"), fileDir, tr("All files (*.*);;JASS script (*.j *.ai)"));
 
-    if (documentHasChanged) {
-        saved = false;
+    if (!openFileName.isEmpty()) {
+        QFileInfo fileInfo(openFileName);
+        fileDir = fileInfo.absoluteDir().path();
 
-        if (QMessageBox::question(this, tr("Discard unsaved changes"), tr("The document has been modified. Do you want to save your changes?")) == QMessageBox::Yes) {
-            if (saveAs()) {
-                saved = true;
-            }
+        if (!openDocument(openFileName)) {
+            QMessageBox::warning(this, tr("Error"), tr("Error on reading file into %1").arg(openFileName));
         }
     }
+}
 
-    if (saved) {
-        QString openFileName = QFileDialog::getOpenFileName(this, tr("Open File"), fileDir, tr("All files (*.*);;JASS script (*.j *.ai)"));
+void MainWindow::openInViewer() {
+    QString openFileName = QFileDialog::getOpenFileName(this, tr("Open in Viewer"), fileDir, tr("All files (*.*);;JASS script (*.j *.ai)"));
 
-        if (!openFileName.isEmpty()) {
-            QFile f(openFileName);
-            QFileInfo fileInfo(openFileName);
-            fileDir = fileInfo.absoluteDir().path();
+    if (!openFileName.isEmpty()) {
+        QFileInfo fileInfo(openFileName);
+        fileDir = fileInfo.absoluteDir().path();
 
-            if (f.open(QIODevice::ReadOnly)) {
-                this->ui->textEdit->document()->setPlainText(f.readAll());
-                resetDocumentChanges();
-            } else {
-                QMessageBox::warning(this, tr("Error"), tr("Error on reading file into %1").arg(openFileName));
-            }
+        ScriptViewer *scriptViewer = new ScriptViewer(this);
+        // a separate window which is deleted with its mapping when it is closed
+        scriptViewer->setWindowFlags(Qt::Window);
+        scriptViewer->setAttribute(Qt::WA_DeleteOnClose);
+        scriptViewer->resize(size());
+
+        if (scriptViewer->open(openFileName)) {
+            scriptViewer->show();
+        } else {
+            delete scriptViewer;
+            QMessageBox::warning(this, tr("Error"), tr("Could not open file %1").arg(openFileName));
         }
     }
 }
@@ -293,6 +360,7 @@ bool MainWindow::saveAs() {
 
         if (f.open(QIODevice::WriteOnly)) {
             f.write(ui->textEdit->toPlainText().toUtf8());
+            activeDocument->filePath = fileInfo.absoluteFilePath();
             resetDocumentChanges();
 
             return true;
@@ -305,40 +373,254 @@ bool MainWindow::saveAs() {
 }
 
 bool MainWindow::closeFile() {
+    // the partially loaded document has already been removed
+    if (cancelLoading()) {
+        return true;
+    }
+
     if (documentHasChanged) {
         if (QMessageBox::question(this, tr("Discard unsaved changes"), tr("The document has been modified. Do you want to save your changes?")) == QMessageBox::Yes) {
-            if (saveAs()) {
-                ui->textEdit->clear();
-                resetDocumentChanges();
-            } else {
+            if (!saveAs()) {
                 return false;
             }
-        } else {
-            ui->textEdit->clear();
-            resetDocumentChanges();
         }
-    } else {
-        ui->textEdit->clear();
-        resetDocumentChanges();
     }
 
+    removeDocument(documentTabBar->currentIndex());
+
     return true;
 }
 
 void MainWindow::quit() {
-    if (documentHasChanged) {
-        if (QMessageBox::question(this, tr("Discard unsaved changes"), tr("The document has been modified. Do you want to save your changes?")) == QMessageBox::Yes) {
-            if (saveAs()) {
-                this->close();
+    // ask for every modified document
+    for (int i = 0; i < documents.size(); i++) {
+        if (documents.at(i)->hasChanged || (documents.at(i) == activeDocument && documentHasChanged)) {
+            documentTabBar->setCurrentIndex(i);
+
+            if (QMessageBox::question(this, tr("Discard unsaved changes"), tr("The document has been modified. Do you want to save your changes?")) == QMessageBox::Yes) {
+                if (!saveAs()) {
+                    return;
+                }
             }
-        } else {
-            this->close();
         }
+    }
+
+    this->close();
+}
+
+MainWindow::Document* MainWindow::addDocument() {
+    Document *document = new Document();
+    document->id = nextDocumentId++;
+    document->textDocument = newTextDocument(this);
+    // the same font and tab stops as all other documents
+    document->textDocument->setDefaultFont(ui->textEdit->document()->defaultFont());
+    document->textDocument->setDefaultTextOption(ui->textEdit->document()->defaultTextOption());
+    document->syntaxHighlighter = new SyntaxHighlighter(document->textDocument);
+    document->indexedRevision = document->textDocument->revision();
+    documents.push_back(document);
+    documentTabBar->addTab(documentTitle(document));
+    documentTabBar->setCurrentIndex(documents.size() - 1);
+
+    return document;
+}
+
+bool MainWindow::openDocument(const QString &filePath) {
+    cancelLoading();
+
+    const QString absoluteFilePath = QFileInfo(filePath).absoluteFilePath();
+
+    // a file which is already open is only shown
+    for (int i = 0; i < documents.size(); i++) {
+        if (documents.at(i)->filePath == absoluteFilePath) {
+            documentTabBar->setCurrentIndex(i);
+
+            return true;
+        }
+    }
+
+    // an empty new document is replaced by the file
+    const bool reuseDocument = activeDocument->filePath.isEmpty() && !documentHasChanged && activeDocument->textDocument->isEmpty();
+
+    if (!reuseDocument) {
+        addDocument();
+    }
+
+    if (!loadFile(filePath)) {
+        if (!reuseDocument) {
+            removeDocument(documentTabBar->currentIndex());
+        }
+
+        return false;
+    }
+
+    activeDocument->filePath = absoluteFilePath;
+    updateWindowTitle();
+
+    return true;
+}
+
+void MainWindow::removeDocument(int index) {
+    // there is always one document
+    if (documents.size() == 1) {
+        symbolIndex.removeSource(documentSymbolSource(activeDocument));
+        crossReferenceIndex.removeSource(documentSymbolSource(activeDocument));
+        signatureIndex.removeSource(documentSymbolSource(activeDocument));
+        ui->textEdit->clear();
+        activeDocument->indexedRevision = activeDocument->textDocument->revision();
+        activeDocument->filePath.clear();
+        currentResults.reset();
+        applyResults(false);
+        resetDocumentChanges();
+
+        return;
+    }
+
+    Document *document = documents.takeAt(index);
+    // activates another document, so the removed one is not shown anymore
+    documentTabBar->removeTab(index);
+
+    analysisPool->clear(document->id);
+    symbolIndex.removeSource(documentSymbolSource(document));
+    crossReferenceIndex.removeSource(documentSymbolSource(document));
+    signatureIndex.removeSource(documentSymbolSource(document));
+    delete document->textDocument;
+    delete document;
+}
+
+MainWindow::Document* MainWindow::findDocument(int id) const {
+    for (Document *document : documents) {
+        if (document->id == id) {
+            return document;
+        }
+    }
+
+    return nullptr;
+}
+
+QString MainWindow::documentTitle(const Document *document) const {
+    return document->filePath.isEmpty() ? tr("Untitled") : QFileInfo(document->filePath).fileName();
+}
+
+QString MainWindow::documentSymbolSource(const Document *document) const {
+    return QString::number(document->id);
+}
+
+void MainWindow::updateDocumentSymbols(Document *document, const QSharedPointer<HighLightInfo> &results) {
+    // only the symbols which have been added or removed change the trigrams
+    if (results.isNull() || standardScripts.contains(document->filePath)) {
+        symbolIndex.removeSource(documentSymbolSource(document));
+        crossReferenceIndex.removeSource(documentSymbolSource(document));
+        signatureIndex.removeSource(documentSymbolSource(document));
     } else {
-        this->close();
+        symbolIndex.setSymbols(documentSymbolSource(document), results->getSymbols());
+        signatureIndex.setSignatures(documentSymbolSource(document), results->getSignatures());
+
+        // only the changed functions and top level lines are indexed again
+        if (!results->getSymbolTable().isNull()) {
+            crossReferenceIndex.setUnits(documentSymbolSource(document), results->getSymbolTable()->getUnits());
+        }
+    }
+
+    if (symbolPalette != nullptr && symbolPalette->isVisible()) {
+        symbolPalette->restartSearch();
     }
 }
 
+void MainWindow::indexStandardScripts() {
+    if (standardScriptsThread != nullptr) {
+        return;
+    }
+
+    const QStringList filePaths = standardScripts;
+
+    standardScriptsThread = QThread::create([this, filePaths]() {
+        for (const QString &filePath : filePaths) {
+            if (stopStandardScriptsThread.loadAcquire() != 0) {
+                break;
+            }
+
+            VJassSymbolTable::Units units;
+            SignatureIndex::Signatures signatures;
+            const SymbolIndex::Symbols symbols = Analysis::scanAndParseSymbols(filePath, units, signatures);
+
+            // every script is available as soon as it has been parsed
+            QMetaObject::invokeMethod(this, [this, filePath, symbols, units, signatures]() { receiveStandardScriptSymbols(filePath, symbols, units, signatures); }, Qt::QueuedConnection);
+        }
+    });
+    standardScriptsThread->start();
+}
+
+void MainWindow::receiveStandardScriptSymbols(const QString &filePath, const SymbolIndex::Symbols &symbols, const VJassSymbolTable::Units &units, const SignatureIndex::Signatures &signatures) {
+    symbolIndex.setSymbols(filePath, symbols);
+    crossReferenceIndex.setUnits(filePath, units);
+    signatureIndex.setSignatures(filePath, signatures);
+
+    if (symbolPalette != nullptr && symbolPalette->isVisible()) {
+        symbolPalette->restartSearch();
+    }
+
+    // the call at the cursor might be a native of the script
+    updateSignatureHelp();
+}
+
+void MainWindow::activateDocumentTab(int index) {
+    if (index < 0 || index >= documents.size() || documents.at(index) == activeDocument) {
+        return;
+    }
+
+    Document *document = documents.at(index);
+
+    // the state of the previous document is kept for showing it again
+    if (activeDocument != nullptr) {
+        activeDocument->hasChanged = documentHasChanged;
+        activeDocument->results = currentResults;
+        activeDocument->resultsRevision = currentResultsRevision;
+
+        // the latest changes are analyzed in the background
+        if (timerId != 0) {
+            killTimer(timerId);
+            timerId = 0;
+            startAnalysis(activeDocument);
+        }
+    }
+
+    activeDocument = document;
+    analysisPool->setPriorityQueue(document->id);
+    syntaxHighlighter = document->syntaxHighlighter;
+    documentHasChanged = document->hasChanged;
+    currentResults = document->results;
+    currentResultsRevision = document->resultsRevision;
+
+    {
+        // showing another document does not change it
+        QSignalBlocker signalBlocker(ui->textEdit);
+        ui->textEdit->setDocument(document->textDocument);
+    }
+
+    ui->lineNumbersWidget->setTextEdit(ui->textEdit);
+    ui->overviewRuler->setLineCount(ui->textEdit->blockCount());
+    updateSyntaxErrorsOnly();
+    updateSelectedLines();
+    updateWindowTitle();
+
+    // the highlighting of the document is kept, only results which have arrived in the background have to be highlighted
+    applyResults(!document->resultsApplied);
+
+    if (document->inputRevision != document->textDocument->revision()) {
+        startAnalysis(document);
+    }
+}
+
+void MainWindow::closeDocumentTab(int index) {
+    // asks to save the document before closing it
+    documentTabBar->setCurrentIndex(index);
+    closeFile();
+}
+
+void MainWindow::moveDocumentTab(int from, int to) {
+    documents.move(from, to);
+}
+
 void MainWindow::goToLine() {
     bool ok = false;
     const int line = QInputDialog::getInt(this, tr("Go to Line"), tr("Line %1 - %2").arg(1).arg(ui->textEdit->blockCount()), ui->textEdit->textCursor().blockNumber(), 1, ui->textEdit->blockCount(), 1, &ok);
@@ -348,10 +630,146 @@ void MainWindow::goToLine() {
         textCursor.movePosition(QTextCursor::Start);
         textCursor.movePosition(QTextCursor::Down, QTextCursor::MoveAnchor, line - 1);
         ui->textEdit->setTextCursor(textCursor);
-        updateLineNumbers();
     }
 }
 
+void MainWindow::showSymbolPalette() {
+    if (symbolPalette == nullptr) {
+        symbolPalette = new SymbolPalette(&symbolIndex, this);
+        connect(symbolPalette, &SymbolPalette::symbolActivated, this, &MainWindow::goToSymbol);
+    }
+
+    indexStandardScripts();
+
+    QHash<QString, QString> sourceTitles;
+
+    for (const Document *document : documents) {
+        sourceTitles.insert(documentSymbolSource(document), documentTitle(document));
+    }
+
+    symbolPalette->setSourceTitles(sourceTitles);
+    symbolPalette->show();
+    symbolPalette->raise();
+    symbolPalette->activateWindow();
+}
+
+void MainWindow::goToDeclaration() {
+    indexStandardScripts();
+
+    const QString identifier = identifierAtCursor();
+    CrossReferenceIndex::Location location;
+
+    if (identifier.isEmpty() || activeDocument == nullptr || !crossReferenceIndex.findDeclaration(documentSymbolSource(activeDocument), ui->textEdit->textCursor().blockNumber(), identifier, location)) {
+        statusBar->setText(tr("No declaration found."));
+
+        return;
+    }
+
+    goToSource(location.source, QPoint(location.line, location.column));
+}
+
+void MainWindow::findReferences() {
+    indexStandardScripts();
+    cancelFindReferences();
+
+    const QString identifier = identifierAtCursor();
+
+    if (identifier.isEmpty() || activeDocument == nullptr) {
+        return;
+    }
+
+    const QString source = documentSymbolSource(activeDocument);
+    const int line = ui->textEdit->textCursor().blockNumber();
+    referencesName = identifier;
+    referencesIsLocal = crossReferenceIndex.isLocal(crossReferenceIndex.unitAt(source, line), identifier);
+    referencesCandidates = crossReferenceIndex.candidates(source, line, identifier);
+    referencesProgress = 0;
+    referencesCount = 0;
+    referencesSourceItems.clear();
+
+    // the results are shown in the find in files panel
+    findInFilesSearch->cancel();
+    ui->treeWidgetFindInFiles->clear();
+    ui->tabWidget->setCurrentWidget(ui->tabFindInFiles);
+    findReferencesTimer.start();
+
+    if (!referencesCandidates.isEmpty()) {
+        timerIdFindReferences = startTimer(0);
+    }
+
+    // the first slice is shown immediately
+    findReferencesSlice();
+}
+
+void MainWindow::renameSymbol() {
+    const QString identifier = identifierAtCursor();
+
+    if (identifier.isEmpty()) {
+        statusBar->setText(tr("There is no identifier at the cursor."));
+
+        return;
+    }
+
+    bool ok = false;
+    const QString newName = QInputDialog::getText(this, tr("Rename"), tr("New name of %1:").arg(identifier), QLineEdit::Normal, identifier, &ok).trimmed();
+
+    if (ok && newName != identifier) {
+        renameIdentifierAtCursor(newName);
+    }
+}
+
+void MainWindow::showCallHierarchy() {
+    const CallGraph &callGraph = activeDocument->callGraph;
+    int id = callGraph.getId(identifierAtCursor());
+
+    // the hierarchy of the enclosing function is shown if the cursor is not placed at a function
+    if ((id == -1 || (!callGraph.isDeclared(id) && callGraph.getCallers(id).isEmpty())) && !currentResults.isNull() && !currentResults->getSymbolTable().isNull()) {
+        const VJassSymbolTable &symbolTable = *currentResults->getSymbolTable();
+        const int function = symbolTable.functionAt(ui->textEdit->textCursor().blockNumber());
+        id = function != -1 ? callGraph.getId(symbolTable.getFunctionName(function)) : -1;
+    }
+
+    ui->treeWidgetCallHierarchy->clear();
+    ui->tabWidget->setCurrentWidget(ui->tabCallHierarchy);
+
+    QSet<int> recursiveFunctions;
+
+    for (const QVector<int> &recursion : callGraph.findRecursions()) {
+        for (int function : recursion) {
+            recursiveFunctions.insert(function);
+        }
+    }
+
+    ui->labelCallHierarchy->setText(tr("%1 functions with %2 calls, %3 unreachable from main and config, %4 recursive").arg(callGraph.getFunctionsCount()).arg(callGraph.getEdgesCount()).arg(callGraph.findUnreachable().size()).arg(recursiveFunctions.size()));
+
+    if (id == -1) {
+        return;
+    }
+
+    QTreeWidgetItem *rootItem = new QTreeWidgetItem(ui->treeWidgetCallHierarchy);
+    rootItem->setText(0, recursiveFunctions.contains(id) ? tr("%1 (recursive)").arg(callGraph.getName(id)) : callGraph.getName(id));
+    rootItem->setData(0, Qt::UserRole, id);
+
+    if (callGraph.isDeclared(id)) {
+        rootItem->setText(1, QString::number(callGraph.getLine(id) + 1));
+    }
+
+    // the children are added when the items are expanded, so recursive calls do not expand forever
+    QTreeWidgetItem *calleesItem = new QTreeWidgetItem(rootItem);
+    calleesItem->setText(0, tr("Calls (%1)").arg(callGraph.getCallees(id).size()));
+    calleesItem->setData(0, Qt::UserRole, id);
+    calleesItem->setData(1, Qt::UserRole, true);
+    calleesItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+
+    QTreeWidgetItem *callersItem = new QTreeWidgetItem(rootItem);
+    callersItem->setText(0, tr("Called by (%1)").arg(callGraph.getCallers(id).size()));
+    callersItem->setData(0, Qt::UserRole, id);
+    callersItem->setData(1, Qt::UserRole, false);
+    callersItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+
+    rootItem->setExpanded(true);
+}
+
 void MainWindow::findAndReplace() {
     if (ui->textEdit->textCursor().hasSelection()) {
         findDialog->setSearchExpression(ui->textEdit->textCursor().selectedText());
@@ -362,6 +780,55 @@ void MainWindow::findAndReplace() {
     findDialog->raise();
 }
 
+void MainWindow::showFindInFiles() {
+    if (ui->textEdit->textCursor().hasSelection()) {
+        ui->lineEditFindInFiles->setText(ui->textEdit->textCursor().selectedText());
+    }
+
+    if (!activeDocument->filePath.isEmpty()) {
+        ui->lineEditFindInFilesFolder->setText(QFileInfo(activeDocument->filePath).absolutePath());
+    }
+
+    ui->tabWidget->setCurrentWidget(ui->tabFindInFiles);
+    ui->lineEditFindInFiles->setFocus();
+    ui->lineEditFindInFiles->selectAll();
+}
+
+void MainWindow::findInFiles() {
+    FindEngine::Options options = FindEngine::NoOptions;
+
+    if (ui->checkBoxFindInFilesCaseSensitive->isChecked()) {
+        options |= FindEngine::CaseSensitive;
+    }
+
+    if (ui->checkBoxFindInFilesRegex->isChecked()) {
+        options |= FindEngine::RegularExpression;
+    }
+
+    if (ui->checkBoxFindInFilesIdentifiersOnly->isChecked()) {
+        options |= FindEngine::IdentifiersOnly;
+    }
+
+    const QString expression = ui->lineEditFindInFiles->text();
+
+    if (!FindEngine::isValidExpression(expression, options)) {
+        ui->labelFindInFiles->setText(tr("Invalid regular expression."));
+
+        return;
+    }
+
+    findInFilesSearch->cancel();
+    cancelFindReferences();
+    ui->treeWidgetFindInFiles->clear();
+    ui->pushButtonCancelFindInFiles->setEnabled(true);
+    findInFilesTimer.start();
+    findInFilesSearch->find(QStringList() << ui->lineEditFindInFilesFolder->text(), expression, options);
+}
+
+void MainWindow::cancelFindInFiles() {
+    findInFilesSearch->cancel();
+}
+
 void MainWindow::applyColor() {
     QColor color = QColorDialog::getColor(QColor(0xffcc00), this, tr("Apply Color"));
 
@@ -377,61 +844,37 @@ void MainWindow::applyColor() {
 }
 
 void MainWindow::openCommonj() {
-    if (closeFile()) {
-        const QString filePath = "wc3reforged/common.j";
-        QFile f(filePath);
+    const QString filePath = "wc3reforged/common.j";
 
-        if (f.open(QIODevice::ReadOnly)) {
-            ui->textEdit->document()->setPlainText(f.readAll());
-            resetDocumentChanges();
-        } else {
-            QMessageBox::warning(this, tr("Error"), tr("Could not open file %1").arg(filePath));
-        }
+    if (!openDocument(filePath)) {
+        QMessageBox::warning(this, tr("Error"), tr("Could not open file %1").arg(filePath));
     }
 }
 
 void MainWindow::openCommonai() {
-    if (closeFile()) {
-        const QString filePath = "wc3reforged/common.ai";
-        QFile f(filePath);
+    const QString filePath = "wc3reforged/common.ai";
 
-        if (f.open(QIODevice::ReadOnly)) {
-            ui->textEdit->document()->setPlainText(f.readAll());
-            resetDocumentChanges();
-        } else {
-            QMessageBox::warning(this, tr("Error"), tr("Could not open file %1").arg(filePath));
-        }
+    if (!openDocument(filePath)) {
+        QMessageBox::warning(this, tr("Error"), tr("Could not open file %1").arg(filePath));
     }
 }
 
 void MainWindow::openBlizzardj() {
-    if (closeFile()) {
-        const QString filePath = "wc3reforged/Blizzard.j";
-        QFile f(filePath);
+    const QString filePath = "wc3reforged/Blizzard.j";
 
-        if (f.open(QIODevice::ReadOnly)) {
-            ui->textEdit->document()->setPlainText(f.readAll());
-            resetDocumentChanges();
-        } else {
-            QMessageBox::warning(this, tr("Error"), tr("Could not open file %1").arg(filePath));
-        }
+    if (!openDocument(filePath)) {
+        QMessageBox::warning(this, tr("Error"), tr("Could not open file %1").arg(filePath));
     }
 }
 
 void MainWindow::openScript() {
-    if (closeFile()) {
-        QAction *action = dynamic_cast<QAction*>(sender());
-
-        if (action != nullptr) {
-            const QString filePath = action->data().toString();
-            QFile f(filePath);
-
-            if (f.open(QIODevice::ReadOnly)) {
-                ui->textEdit->document()->setPlainText(f.readAll());
-                resetDocumentChanges();
-            } else {
-                QMessageBox::warning(this, tr("Error"), tr("Could not open file %1").arg(filePath));
-            }
+    QAction *action = dynamic_cast<QAction*>(sender());
+
+    if (action != nullptr) {
+        const QString filePath = action->data().toString();
+
+        if (!openDocument(filePath)) {
+            QMessageBox::warning(this, tr("Error"), tr("Could not open file %1").arg(filePath));
         }
     }
 }
@@ -481,36 +924,464 @@ void MainWindow::updateCursorPosition(int position) {
     ui->textEdit->setTabStopDistance(20.0);
 }
 
-void MainWindow::highlightTokensAndAst(const HighLightInfo & /* highLightInfo */, bool /* checkSyntax */) {
-    // TODO Only highlight syntax errors.
+void MainWindow::highlightTokensAndAst(const HighLightInfo &highLightInfo, bool /* checkSyntax */) {
+    // the highlighter looks up the formats of the analysis instead of scanning every block again
+    syntaxHighlighter->setBlockFormatCache(highLightInfo, currentResultsRevision);
+
+    highlightVisibleBlocks();
+
     //QList<QTextEdit::ExtraSelection> extraSelections = highLightInfo.toExtraSelections(ui->textEdit->document(), checkSyntax);
 
-    //qDebug() << "Extra selections" << extraSelections.size();
+    //qDebug() << "Extra selections" << extraSelections.size();
+
+    //ui->textEdit->setExtraSelections(extraSelections);
+}
+
+void MainWindow::highlightVisibleBlocks() {
+    // the visible blocks are highlighted immediately, all other blocks are highlighted in time slices
+    const int firstVisibleLine = ui->textEdit->cursorForPosition(QPoint(0, 0)).blockNumber();
+    const int lastVisibleLine = ui->textEdit->cursorForPosition(QPoint(ui->textEdit->viewport()->width() - 1, ui->textEdit->viewport()->height() - 1)).blockNumber();
+
+    for (QTextBlock block = ui->textEdit->document()->findBlockByNumber(firstVisibleLine); block.isValid() && block.blockNumber() <= lastVisibleLine; block = block.next()) {
+        syntaxHighlighter->rehighlightBlock(block);
+    }
+
+    highlightingProgress = 0;
+    startApplyingResults();
+}
+
+bool MainWindow::loadFile(const QString &filePath) {
+    loadingTimer.start();
+
+    if (!fileLoader->load(filePath)) {
+        return false;
+    }
+
+    loadingFirstScreenNs = -1;
+
+    // the analysis of the previous text is not required anymore
+    if (timerId != 0) {
+        killTimer(timerId);
+        timerId = 0;
+    }
+
+    highlightingProgress = -1;
+    syntaxHighlighter->clearBlockFormatCache();
+    // inserted blocks are highlighted after they have become visible or the file has been loaded
+    syntaxHighlighter->setDeferred(true);
+    ui->textEdit->document()->setUndoRedoEnabled(false);
+    ui->textEdit->setReadOnly(true);
+    ui->textEdit->clear();
+    // the chunks are inserted into the shown document
+    documentTabBar->setEnabled(false);
+
+    loadingProgressBar->setValue(0);
+    loadingProgressBar->show();
+
+    return true;
+}
+
+bool MainWindow::cancelLoading() {
+    if (fileLoader->isLoading()) {
+        fileLoader->cancel();
+        finishLoading(false);
+
+        return true;
+    }
+
+    return false;
+}
+
+void MainWindow::insertLoadedChunk(const QString &text, qint64 bytesRead, qint64 bytesTotal) {
+    QTextCursor cursor(ui->textEdit->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(text);
+
+    loadingProgressBar->setValue(bytesTotal > 0 ? static_cast<int>(bytesRead * 100 / bytesTotal) : 100);
+
+    // the first chunk fills at least the first screen which is highlighted immediately
+    if (loadingFirstScreenNs == -1) {
+        syntaxHighlighter->setDeferred(false);
+        highlightVisibleBlocks();
+        highlightingProgress = -1;
+        syntaxHighlighter->setDeferred(true);
+
+        loadingFirstScreenNs = loadingTimer.nsecsElapsed();
+    }
+}
+
+void MainWindow::finishLoading(bool success) {
+    loadingProgressBar->hide();
+    documentTabBar->setEnabled(true);
+    ui->textEdit->setReadOnly(false);
+    ui->textEdit->document()->setUndoRedoEnabled(true);
+    syntaxHighlighter->setDeferred(false);
+
+    const QVariant pendingCursorPosition = this->pendingCursorPosition;
+    this->pendingCursorPosition.clear();
+
+    if (success) {
+        highlightVisibleBlocks();
+        resetDocumentChanges();
+
+        if (pendingCursorPosition.isValid()) {
+            moveCursorToPosition(pendingCursorPosition);
+        }
+
+        // the analysis replaces the local highlighting of the blocks
+        restartTimer();
+    } else {
+        // the truncated text must not be saved into the file, so the document being loaded is removed or cleared if it is the only one
+        removeDocument(documentTabBar->currentIndex());
+
+        // cancelling the loading is not an error
+        if (sender() == fileLoader) {
+            QMessageBox::warning(this, tr("Error"), tr("Error on reading file into %1").arg(fileLoader->getFilePath()));
+        }
+    }
+}
+
+void MainWindow::astListItemDoubleClicked(QListWidgetItem *item) {
+    moveCursorToPosition(item->data(Qt::UserRole));
+}
+
+void MainWindow::outlinerIndexDoubleClicked(const QModelIndex &index) {
+    moveCursorToPosition(index.data(OutlinerModel::PositionRole));
+}
+
+void MainWindow::diagnosticsIndexDoubleClicked(const QModelIndex &index) {
+    moveCursorToPosition(index.data(DiagnosticsModel::PositionRole));
+}
+
+void MainWindow::moveCursorToPosition(const QVariant &position) {
+    if (position.isValid() && position.canConvert<QPoint>()) {
+        int line = position.toPoint().x();
+        int column = position.toPoint().y();
+
+        // moving down would skip folded blocks and stop at wrapped lines
+        const QTextBlock block = ui->textEdit->document()->findBlockByNumber(line);
+
+        if (!block.isValid()) {
+            return;
+        }
+
+        QTextCursor cursor(block);
+        cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::MoveAnchor, qMin(column, block.length() - 1));
+        ui->textEdit->setTextCursor(cursor);
+        ui->textEdit->centerCursor();
+        ui->textEdit->setFocus();
+
+        qDebug() << "Moving cursor to line" << line << "and column" << column;
+    }
+}
+
+void MainWindow::updateSyntaxErrors(bool checkSyntax, bool autoComplete, bool highlight) {
+    this->expectAutoComplete = autoComplete;
+
+    ui->overviewRuler->setVisible(checkSyntax);
+
+    // add or remove the underlines of all blocks
+    if (syntaxHighlighter->getShowDiagnostics() != checkSyntax) {
+        syntaxHighlighter->setShowDiagnostics(checkSyntax);
+        highlightingProgress = 0;
+        startApplyingResults();
+    }
+
+    if (!checkSyntax && !autoComplete && !highlight) {
+        //clearAllHighLighting();
+    }
+}
+
+void MainWindow::addFindInFilesResults(const FindInFiles::Results &results) {
+    // one item per file with one child per match
+    QTreeWidgetItem *fileItem = new QTreeWidgetItem();
+    fileItem->setText(0, QDir::toNativeSeparators(results.first().filePath));
+    fileItem->setText(1, tr("%n match(es)", "", results.size()));
+    fileItem->setData(0, Qt::UserRole, results.first().filePath);
+
+    QList<QTreeWidgetItem*> matchItems;
+    matchItems.reserve(results.size());
+
+    for (const FindInFiles::Result &result : results) {
+        QTreeWidgetItem *matchItem = new QTreeWidgetItem();
+        matchItem->setText(0, tr("Line %1, column %2").arg(result.line + 1).arg(result.column + 1));
+        matchItem->setText(1, result.lineText.trimmed());
+        matchItem->setData(0, Qt::UserRole, result.filePath);
+        matchItem->setData(1, Qt::UserRole, QPoint(result.line, result.column));
+        matchItems.push_back(matchItem);
+    }
+
+    fileItem->addChildren(matchItems);
+    ui->treeWidgetFindInFiles->addTopLevelItem(fileItem);
+}
+
+void MainWindow::updateFindInFilesProgress(int searchedFiles, int files) {
+    ui->labelFindInFiles->setText(tr("%1 results in %2 of %3 files").arg(findInFilesSearch->getResultsCount()).arg(searchedFiles).arg(files));
+}
+
+void MainWindow::finishFindInFiles(bool success) {
+    ui->pushButtonCancelFindInFiles->setEnabled(false);
+
+    const QString text = tr("%1 results in %2 of %3 files").arg(findInFilesSearch->getResultsCount()).arg(findInFilesSearch->getSearchedFilesCount()).arg(findInFilesSearch->getFilesCount());
+
+    if (success) {
+        ui->labelFindInFiles->setText(tr("%1 in %2 ms").arg(text).arg(findInFilesTimer.elapsed()));
+    } else {
+        ui->labelFindInFiles->setText(tr("%1 (cancelled)").arg(text));
+    }
+}
+
+void MainWindow::chooseFindInFilesFolder() {
+    const QString folder = QFileDialog::getExistingDirectory(this, tr("Find in Files"), ui->lineEditFindInFilesFolder->text());
+
+    if (!folder.isEmpty()) {
+        ui->lineEditFindInFilesFolder->setText(folder);
+    }
+}
+
+void MainWindow::findInFilesItemActivated(QTreeWidgetItem *item) {
+    const QString source = item->data(0, Qt::UserRole).toString();
+
+    // references refer to the sources of open documents
+    if (!source.isEmpty()) {
+        goToSource(source, item->data(1, Qt::UserRole));
+    }
+}
+
+void MainWindow::expandCallHierarchyItem(QTreeWidgetItem *item) {
+    // only the items with callees or callers are filled and only once
+    if (item->childCount() > 0 || !item->data(1, Qt::UserRole).isValid()) {
+        return;
+    }
+
+    const CallGraph &callGraph = activeDocument->callGraph;
+    const int id = item->data(0, Qt::UserRole).toInt();
+    const bool callees = item->data(1, Qt::UserRole).toBool();
+
+    // the graph might have been updated since the item has been added
+    if (id < 0 || id >= callGraph.size()) {
+        return;
+    }
+
+    for (int function : callees ? callGraph.getCallees(id) : callGraph.getCallers(id)) {
+        QTreeWidgetItem *functionItem = new QTreeWidgetItem(item);
+        functionItem->setText(0, callGraph.getName(function));
+        functionItem->setData(0, Qt::UserRole, function);
+        functionItem->setData(1, Qt::UserRole, callees);
+
+        if (callGraph.isDeclared(function)) {
+            functionItem->setText(1, QString::number(callGraph.getLine(function) + 1));
+        }
+
+        if (!(callees ? callGraph.getCallees(function) : callGraph.getCallers(function)).isEmpty()) {
+            functionItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        }
+    }
+
+    item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+}
+
+void MainWindow::callHierarchyItemActivated(QTreeWidgetItem *item) {
+    const CallGraph &callGraph = activeDocument->callGraph;
+    const int id = item->data(0, Qt::UserRole).toInt();
+
+    if (id >= 0 && id < callGraph.size() && callGraph.isDeclared(id)) {
+        goToSource(documentSymbolSource(activeDocument), QPoint(callGraph.getLine(id), 0));
+    }
+}
+
+void MainWindow::goToSymbol(const QString &source, int line) {
+    goToSource(source, QPoint(line, 0));
+}
+
+void MainWindow::goToSource(const QString &source, const QVariant &position) {
+    for (int i = 0; i < documents.size(); i++) {
+        if (documentSymbolSource(documents.at(i)) == source) {
+            documentTabBar->setCurrentIndex(i);
+            moveCursorToPosition(position);
+
+            return;
+        }
+    }
+
+    // the symbols of standard scripts refer to their files, the sources of closed documents are never reused
+    if (standardScripts.contains(source)) {
+        openDocumentAt(source, position);
+    }
+}
+
+QString MainWindow::identifierAtCursor() const {
+    const QTextCursor cursor = ui->textEdit->textCursor();
+    const int column = cursor.positionInBlock();
+    VJassScanner scanner;
+
+    // the cursor might be placed directly behind the identifier
+    for (const VJassToken &token : scanner.scan(cursor.block().text())) {
+        if (token.getType() == VJassToken::Text && token.getColumn() <= column && column <= token.getColumn() + token.getLength()) {
+            return token.getValue();
+        }
+    }
+
+    return QString();
+}
+
+int MainWindow::renameIdentifierAtCursor(const QString &newName) {
+    const QString identifier = identifierAtCursor();
+    const QString source = documentSymbolSource(activeDocument);
+    const int line = ui->textEdit->textCursor().blockNumber();
+    CrossReferenceIndex::Location declaration;
+    QString error;
+
+    if (identifier.isEmpty()) {
+        error = tr("There is no identifier at the cursor.");
+    } else if (!crossReferenceIndex.findDeclaration(source, line, identifier, declaration)) {
+        error = tr("No declaration of %1 found.").arg(identifier);
+    } else {
+        error = crossReferenceIndex.renameConflict(source, line, identifier, newName);
+    }
+
+    // references which have been typed after the last analysis are not indexed yet and would keep the old name
+    for (int i = 0; error.isEmpty() && i < documents.size(); i++) {
+        if (documents.at(i)->textDocument->revision() != documents.at(i)->indexedRevision) {
+            error = tr("The analysis of %1 is not up to date.").arg(documentTitle(documents.at(i)));
+        }
+    }
+
+    // the references are grouped by their documents and sorted from the end towards the start, so the positions of the remaining ones stay valid
+    QHash<Document*, CrossReferenceIndex::Locations> locationsByDocument;
+    const CrossReferenceIndex::Locations locations = error.isEmpty() ? crossReferenceIndex.findReferences(source, line, identifier) : CrossReferenceIndex::Locations();
+
+    for (const CrossReferenceIndex::Location &location : locations) {
+        Document *document = nullptr;
+
+        for (Document *d : documents) {
+            if (documentSymbolSource(d) == location.source) {
+                document = d;
+
+                break;
+            }
+        }
+
+        // standard scripts are never changed
+        if (document == nullptr) {
+            error = tr("%1 is used by %2.").arg(identifier).arg(QFileInfo(location.source).fileName());
+
+            break;
+        }
+
+        locationsByDocument[document].push_back(location);
+    }
+
+    if (!error.isEmpty()) {
+        statusBar->setText(error);
+
+        return -1;
+    }
+
+    for (auto iterator = locationsByDocument.begin(); iterator != locationsByDocument.end(); ++iterator) {
+        CrossReferenceIndex::Locations &documentLocations = iterator.value();
+        std::sort(documentLocations.begin(), documentLocations.end(), [](const CrossReferenceIndex::Location &l1, const CrossReferenceIndex::Location &l2) {
+            return l1.line > l2.line || (l1.line == l2.line && l1.column > l2.column);
+        });
+
+        // all edits of a document are undone at once
+        QTextCursor cursor(iterator.key()->textDocument);
+        cursor.beginEditBlock();
+
+        for (const CrossReferenceIndex::Location &location : documentLocations) {
+            const int position = iterator.key()->textDocument->findBlockByNumber(location.line).position() + location.column;
+            cursor.setPosition(position);
+            cursor.setPosition(position + location.length, QTextCursor::KeepAnchor);
+            cursor.insertText(newName);
+        }
+
+        cursor.endEditBlock();
+
+        // documents in the background are not analyzed by the input timer
+        if (iterator.key() != activeDocument) {
+            iterator.key()->hasChanged = true;
+            documentTabBar->setTabText(documents.indexOf(iterator.key()), documentTitle(iterator.key()) + "*");
+            startAnalysis(iterator.key());
+        }
+    }
+
+    statusBar->setText(tr("Renamed %n reference(s) of %1 to %2.", "", locations.size()).arg(identifier).arg(newName));
+
+    return locations.size();
+}
+
+void MainWindow::findReferencesSlice() {
+    QElapsedTimer timer;
+    timer.start();
+    CrossReferenceIndex::Locations locations;
+
+    // yield back to the event loop after the budget, so the first references are shown immediately
+    while (referencesProgress < referencesCandidates.size() && timer.nsecsElapsed() < FIND_REFERENCES_BUDGET_NS) {
+        referencesProgress = crossReferenceIndex.findReferences(referencesCandidates, referencesProgress, FIND_REFERENCES_SLICE_SIZE, referencesName, referencesIsLocal, locations);
+    }
+
+    QHash<QString, QString> sourceTitles;
+
+    for (const Document *document : documents) {
+        sourceTitles.insert(documentSymbolSource(document), documentTitle(document));
+    }
+
+    for (const CrossReferenceIndex::Location &location : locations) {
+        QTreeWidgetItem *sourceItem = referencesSourceItems.value(location.source, nullptr);
+
+        // one item per source with one child per reference like the results of find in files
+        if (sourceItem == nullptr) {
+            sourceItem = new QTreeWidgetItem(ui->treeWidgetFindInFiles);
+            sourceItem->setText(0, sourceTitles.contains(location.source) ? sourceTitles.value(location.source) : QDir::toNativeSeparators(location.source));
+            referencesSourceItems.insert(location.source, sourceItem);
+        }
+
+        QTreeWidgetItem *referenceItem = new QTreeWidgetItem(sourceItem);
+        referenceItem->setText(0, tr("Line %1, column %2").arg(location.line + 1).arg(location.column + 1));
+        referenceItem->setText(1, location.isDeclaration ? tr("Declaration") : tr("Reference"));
+        referenceItem->setData(0, Qt::UserRole, location.source);
+        referenceItem->setData(1, Qt::UserRole, QPoint(location.line, location.column));
+        sourceItem->setText(1, tr("%n reference(s)", "", sourceItem->childCount()));
+        referencesCount++;
+    }
+
+    if (referencesProgress >= referencesCandidates.size()) {
+        cancelFindReferences();
+        ui->labelFindInFiles->setText(tr("%1 references to %2 in %3 ms").arg(referencesCount).arg(referencesName).arg(findReferencesTimer.elapsed()));
+    } else {
+        ui->labelFindInFiles->setText(tr("%1 references to %2 in %3 of %4 units").arg(referencesCount).arg(referencesName).arg(referencesProgress).arg(referencesCandidates.size()));
+    }
+}
 
-    //ui->textEdit->setExtraSelections(extraSelections);
+void MainWindow::cancelFindReferences() {
+    if (timerIdFindReferences != 0) {
+        killTimer(timerIdFindReferences);
+        timerIdFindReferences = 0;
+    }
 }
 
-void MainWindow::astListItemDoubleClicked(QListWidgetItem *item) {
-    if (item->data(Qt::UserRole).isValid() && item->data(Qt::UserRole).canConvert<QPoint>()) {
-        int line = item->data(Qt::UserRole).toPoint().x();
-        int column = item->data(Qt::UserRole).toPoint().y();
-
-        QTextCursor cursor(ui->textEdit->document());
-        cursor.movePosition(QTextCursor::Start, QTextCursor::MoveAnchor);
-        cursor.movePosition(QTextCursor::Down, QTextCursor::MoveAnchor, line);
-        cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::MoveAnchor, column);
-        ui->textEdit->setTextCursor(cursor);
-        ui->textEdit->setFocus();
+void MainWindow::openDocumentAt(const QString &filePath, const QVariant &position) {
+    const QString absoluteFilePath = QFileInfo(filePath).absoluteFilePath();
+    const bool isOpen = std::any_of(documents.cbegin(), documents.cend(), [&absoluteFilePath](const Document *document) {
+        return document->filePath == absoluteFilePath;
+    });
 
-        qDebug() << "Moving cursor to line" << line << "and column" << column;
+    if (!openDocument(filePath)) {
+        QMessageBox::warning(this, tr("Error"), tr("Error on reading file into %1").arg(filePath));
+    } else if (isOpen) {
+        moveCursorToPosition(position);
+    } else {
+        pendingCursorPosition = position;
     }
 }
 
-void MainWindow::updateSyntaxErrors(bool checkSyntax, bool autoComplete, bool highlight) {
-    this->expectAutoComplete = autoComplete;
+void MainWindow::moveCursorToLine(int line) {
+    const QTextBlock block = ui->textEdit->document()->findBlockByNumber(line);
 
-    if (!checkSyntax && !autoComplete && !highlight) {
-        //clearAllHighLighting();
+    if (block.isValid()) {
+        ui->textEdit->setTextCursor(QTextCursor(block));
+        ui->textEdit->centerCursor();
+        ui->textEdit->setFocus();
     }
 }
 
@@ -540,35 +1411,47 @@ void MainWindow::showWhiteSpaces() {
 }
 
 void MainWindow::updateLineNumbers() {
-    QTextCursor startCursor = ui->textEdit->cursorForPosition(QPoint(0, 0));
-    //const int start_pos = startCursor.position();
-    const QPoint bottom_right(ui->textEdit->viewport()->width() - 1, ui->textEdit->viewport()->height() - 1);
-    //const QPoint bottom_right(ui->textEdit->viewport()->width(), ui->textEdit->viewport()->height());
-    QTextCursor bottomCursor = ui->textEdit->cursorForPosition(bottom_right);
-    //const int end_pos = ui->textEdit->cursorForPosition(bottom_right).position();
+    // only schedules painting the visible lines, the gutter tracks scrolling and editing on its own
+    ui->lineNumbersWidget->update();
+}
 
-    const int startLine = startCursor.blockNumber();
-    const int visibleLines = bottomCursor.blockNumber() - startCursor.blockNumber() + 1;
-    //const int visibleLines = ui->textEdit->height() / ui->textEdit->fontMetrics().height();
+void MainWindow::updateLineNumberMarkers() {
+    if (currentResults.isNull()) {
+        ui->lineNumbersWidget->setDiagnosticsIndex(DiagnosticsIndex());
+        ui->lineNumbersWidget->setFoldRangeIndex(FoldRangeIndex());
+
+        return;
+    }
 
-    qDebug() << "Visible lines" << visibleLines << "starting at" << startLine;
+    ui->lineNumbersWidget->setDiagnosticsIndex(currentResults->getDiagnosticsIndex());
+    // the parser has stored the ranges of all block constructs which span multiple lines
+    ui->lineNumbersWidget->setFoldRangeIndex(currentResults->getFoldRangeIndex());
+}
 
-    QList<qreal> lineHeights;
+void MainWindow::toggleFold(int line) {
+    if (ui->textEdit->isFolded(line)) {
+        ui->textEdit->unfold(line);
+    } else if (!currentResults.isNull()) {
+        const int endLine = currentResults->getFoldRangeIndex().endLineOf(line);
 
-    for (int i = 0; i < visibleLines; i++) {
-        const qreal lineHeight = ui->textEdit->document()->documentLayout()->blockBoundingRect(startCursor.block()).height(); // TODO is 0 before anything happens
-        lineHeights.push_back(lineHeight); // since it can be set a min height
-        //lineHeights.push_back(startCursor.blockFormat().lineHeight());
-        //lineHeights.push_back(startCursor.charFormat().font().pointSizeF());
-        startCursor.movePosition(QTextCursor::Down);
+        if (endLine != -1) {
+            ui->textEdit->fold(line, endLine);
+        }
     }
+}
 
-    ui->lineNumbersWidget->setLineNumbers(startLine, visibleLines, lineHeights);
-    updateSelectedLines();
+void MainWindow::foldAll() {
+    if (!currentResults.isNull()) {
+        ui->textEdit->foldAll(currentResults->getFoldRangeIndex());
+    }
+}
+
+void MainWindow::unfoldAll() {
+    ui->textEdit->unfoldAll();
 }
 
 void MainWindow::clickPopupItem(const QModelIndex &index) {
-    const QString &keyword = index.data().toString();
+    const QString keyword = index.sibling(index.row(), 0).data().toString();
 
     // backtrack and check if the start of the data is already there and only append missing stuff
     QTextCursor cursor(ui->textEdit->document());
@@ -596,6 +1479,112 @@ void MainWindow::clickPopupItem(const QModelIndex &index) {
     popup->close();
 }
 
+QString MainWindow::completionPrefix() const {
+    const QTextCursor cursor = ui->textEdit->textCursor();
+    const QString text = cursor.block().text();
+    int start = cursor.positionInBlock();
+
+    while (start > 0 && (text.at(start - 1).isLetterOrNumber() || text.at(start - 1) == '_')) {
+        start--;
+    }
+
+    return text.mid(start, cursor.positionInBlock() - start);
+}
+
+CompletionContext MainWindow::completionContext() const {
+    const QTextCursor cursor = ui->textEdit->textCursor();
+    CompletionContext result(cursor.block().text(), cursor.positionInBlock());
+
+    if (!result.isEnabled() || currentResults.isNull()) {
+        return result;
+    }
+
+    // the results might be older than the text but the enclosing function rarely changes while typing
+    const VJassFunction *function = nullptr;
+
+    for (const VJassAst *ast : currentResults->getAstSpanIndex().getEnclosing(cursor.blockNumber(), cursor.positionInBlock())) {
+        function = dynamic_cast<const VJassFunction*>(ast);
+
+        if (function != nullptr) {
+            result.setFunction(function->getIdentifier());
+
+            break;
+        }
+    }
+
+    if (!result.getAssignedVariable().isEmpty()) {
+        const CompletionIndex::Entry *declaration = activeDocument->completionIndex.findDeclaration(result.getAssignedVariable(), result.getFunction());
+
+        if (declaration != nullptr) {
+            result.setExpectedType(declaration->detail);
+        }
+    } else if (result.isReturnValue() && function != nullptr) {
+        result.setExpectedType(function->getReturnType());
+    }
+
+    return result;
+}
+
+void MainWindow::showCompletionPopup() {
+    const CompletionContext context = completionContext();
+    CompletionIndex::Entries entries;
+
+    // the parser suggests the keywords which are expected at the start of a line
+    if (context.getPrefix().isEmpty() && context.isStatementStart() && !currentResults.isNull() && currentResults->getAst() != nullptr) {
+        for (VJassAst *codeCompletionSuggestion : currentResults->getAst()->getCodeCompletionSuggestions()) {
+            entries.push_back(CompletionIndex::Entry(codeCompletionSuggestion->toString(), CompletionIndex::Keyword));
+        }
+    } else {
+        entries = activeDocument->completionIndex.find(context, MAX_COMPLETION_ENTRIES);
+    }
+
+    if (entries.isEmpty()) {
+        popup->close();
+
+        return;
+    }
+
+    popup->setEntries(entries);
+    popup->setFocusProxy(this);
+    popup->move(ui->textEdit->mapToGlobal(ui->textEdit->cursorRect().bottomRight()));
+    popup->show();
+}
+
+void MainWindow::updateCompletionPopup() {
+    if (popup->isVisible()) {
+        showCompletionPopup();
+    }
+}
+
+void MainWindow::updateSignatureHelp() {
+    const QTextCursor cursor = ui->textEdit->textCursor();
+    QString name;
+    int activeParameter = 0;
+
+    // only the line of the cursor is scanned, so the active parameter changes with every keystroke
+    if (!ui->textEdit->isVisible() || cursor.hasSelection() || !SignatureIndex::findCall(cursor.block().text(), cursor.positionInBlock(), name, activeParameter)) {
+        signatureHelp->hide();
+
+        return;
+    }
+
+    // the natives are available as soon as the standard scripts have been parsed
+    indexStandardScripts();
+    const SignatureIndex::Signature *signature = signatureIndex.find(name, documentSymbolSource(activeDocument));
+
+    if (signature == nullptr) {
+        signatureHelp->hide();
+
+        return;
+    }
+
+    signatureHelp->setText(signatureHelpText(*signature, activeParameter));
+    signatureHelp->adjustSize();
+    const QRect cursorRect = ui->textEdit->cursorRect();
+    signatureHelp->move(ui->textEdit->viewport()->mapToGlobal(QPoint(cursorRect.left(), cursorRect.top() - signatureHelp->height())));
+    signatureHelp->show();
+}
+
 void MainWindow::openJASSManual() {
     QDesktopServices::openUrl(QUrl("http://jass.sourceforge.net/doc/"));
 }
@@ -629,6 +1618,11 @@ void MainWindow::aboutDialog() {
 }
 
 void MainWindow::restartTimer() {
+    // the analysis starts after the whole file has been loaded
+    if (fileLoader->isLoading()) {
+        return;
+    }
+
     if (timerId != 0) {
         killTimer(timerId);
     }
@@ -643,10 +1637,14 @@ void MainWindow::restartTimer() {
 }
 
 void MainWindow::documentChanges() {
+    // loading a file does not change it
+    if (fileLoader->isLoading()) {
+        return;
+    }
+
     documentHasChanged = true;
     syncDocumentState = false;
     updateWindowTitle();
-    updateLineNumbers();
 }
 
 void MainWindow::resetDocumentChanges() {
@@ -656,6 +1654,9 @@ void MainWindow::resetDocumentChanges() {
 }
 
 void MainWindow::updateWindowTitle() {
+    const QString title = documentTitle(activeDocument);
+    documentTabBar->setTabText(documents.indexOf(activeDocument), documentHasChanged ? title + "*" : title);
+
     if (documentHasChanged) {
         setWindowTitle(tr("Baradé's vJass IDE *"));
     } else {
@@ -671,6 +1672,11 @@ void MainWindow::updateSelectedLines() {
 
     ui->lineNumbersWidget->updateSelectedLines(lineStart, lineEnd);
 
+    // moving the cursor into a folded block construct shows it
+    if (!ui->textEdit->textCursor().block().isVisible()) {
+        ui->textEdit->unfoldBlock(ui->textEdit->textCursor().block());
+    }
+
     updateCurrentLineHighLighting();
 
     updateWindowStatusBar();
@@ -684,6 +1690,8 @@ void MainWindow::updateWindowStatusBar() {
     //qDebug() << "Size of AST elements by location" << astElementyByLocation.size();
     //qDebug() << "Location line" << location.line << "and column" << location.column;
 
+    updateBreadcrumb(currentLine, currentColumn);
+
     const QString parserState = timerId != 0 ? tr("Waiting for user stopping") : (syncDocumentState ? tr("Done") : tr("Parsing"));
 
     if (currentResults != nullptr && currentResults->getAstElementsByLocation().contains(location)) {
@@ -695,6 +1703,180 @@ void MainWindow::updateWindowStatusBar() {
     }
 }
 
+namespace {
+
+inline QString breadcrumbText(const VJassAst *ast) {
+    if (typeid(*ast) == typeid(VJassFunction)) {
+        return VJassToken::KEYWORD_FUNCTION + " " + dynamic_cast<const VJassFunction*>(ast)->getIdentifier();
+    } else if (typeid(*ast) == typeid(VJassNative)) {
+        return VJassToken::KEYWORD_NATIVE + " " + dynamic_cast<const VJassNative*>(ast)->getIdentifier();
+    } else if (typeid(*ast) == typeid(VJassType)) {
+        return VJassToken::KEYWORD_TYPE + " " + dynamic_cast<const VJassType*>(ast)->getIdentifier();
+    } else if (typeid(*ast) == typeid(VJassGlobals)) {
+        return VJassToken::KEYWORD_GLOBALS;
+    } else if (typeid(*ast) == typeid(VJassGlobal)) {
+        return dynamic_cast<const VJassGlobal*>(ast)->getName();
+    }
+
+    const VJassStatement *statement = dynamic_cast<const VJassStatement*>(ast);
+
+    if (statement != nullptr) {
+        switch (statement->getType()) {
+            case VJassStatement::Local: {
+                return VJassToken::KEYWORD_LOCAL;
+            }
+            case VJassStatement::Set: {
+                return VJassToken::KEYWORD_SET;
+            }
+            case VJassStatement::Call: {
+                return VJassToken::KEYWORD_CALL;
+            }
+            case VJassStatement::If: {
+                return VJassToken::KEYWORD_IF;
+            }
+            case VJassStatement::Elseif: {
+                return VJassToken::KEYWORD_ELSEIF;
+            }
+            case VJassStatement::Else: {
+                return VJassToken::KEYWORD_ELSE;
+            }
+            case VJassStatement::Loop: {
+                return VJassToken::KEYWORD_LOOP;
+            }
+            case VJassStatement::Exitwhen: {
+                return VJassToken::KEYWORD_EXITWHEN;
+            }
+            case VJassStatement::Return: {
+                return VJassToken::KEYWORD_RETURN;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+
+    // expressions are too fine-grained for the breadcrumb
+    return QString();
+}
+
+}
+
+void MainWindow::updateBreadcrumb(int line, int column) {
+    QStringList parts;
+
+    if (currentResults != nullptr) {
+        // the enclosing elements are returned starting with the innermost one
+        for (const VJassAst *ast : currentResults->getAstSpanIndex().getEnclosing(line, column)) {
+            const QString text = breadcrumbText(ast);
+
+            if (!text.isEmpty()) {
+                parts.prepend(text);
+            }
+        }
+    }
+
+    breadcrumb->setText(parts.join(QStringLiteral(" > ")));
+}
+
+QString MainWindow::hoverText(int line, int column) const {
+    if (currentResults == nullptr) {
+        return QString();
+    }
+
+    const QList<VJassAst*> enclosing = currentResults->getAstSpanIndex().getEnclosing(line, column);
+
+    for (const VJassAst *ast : enclosing) {
+        const VJassExpression *expression = dynamic_cast<const VJassExpression*>(ast);
+
+        if (expression != nullptr && (expression->getType() == VJassExpression::Identifier || expression->getType() == VJassExpression::FunctionCall)) {
+            const QString &identifier = expression->getValue();
+            const QSharedPointer<const VJassSymbolTable> &symbolTable = currentResults->getSymbolTable();
+
+            // parameters and locals of the enclosing function hide the declarations of the script
+            if (expression->getType() == VJassExpression::Identifier && !symbolTable.isNull()) {
+                const VJassSymbolTable::Kind kind = symbolTable->resolve(identifier, symbolTable->functionAt(line));
+
+                if (kind == VJassSymbolTable::Parameter || kind == VJassSymbolTable::Local) {
+                    for (const VJassAst *enclosingAst : enclosing) {
+                        const VJassFunction *function = dynamic_cast<const VJassFunction*>(enclosingAst);
+
+                        if (function == nullptr) {
+                            continue;
+                        }
+
+                        for (const VJassFunctionParameter &parameter : function->getParameters()) {
+                            if (parameter.getName() == identifier) {
+                                return tr("%1\nParameter of %2 declared at line %3").arg(parameter.toString()).arg(function->getIdentifier()).arg(parameter.getLine() + 1);
+                            }
+                        }
+
+                        for (const VJassAst *child : function->getChildren()) {
+                            const VJassLocalStatement *localStatement = dynamic_cast<const VJassLocalStatement*>(child);
+
+                            if (localStatement != nullptr && localStatement->getVariableName() == identifier) {
+                                return tr("local %1 %2\nDeclared at line %3").arg(localStatement->getType()).arg(identifier).arg(localStatement->getLine() + 1);
+                            }
+                        }
+
+                        break;
+                    }
+                }
+            }
+
+            const QHash<QString, VJassAst*>::const_iterator declaration = currentResults->getDeclarationsByIdentifier().constFind(identifier);
+
+            const SignatureIndex::Signature *signature = signatureIndex.find(identifier, documentSymbolSource(activeDocument));
+
+            if (declaration != currentResults->getDeclarationsByIdentifier().constEnd()) {
+                return tr("%1\nDeclared at line %2").arg(declaration.value()->toString().section('\n', 0, 0)).arg(declaration.value()->getLine() + 1);
+            // natives and functions of other documents and the standard scripts
+            } else if (signature != nullptr) {
+                const QString source = signatureIndex.findSource(identifier, documentSymbolSource(activeDocument));
+                QString title = QFileInfo(source).fileName();
+
+                for (const Document *document : documents) {
+                    if (documentSymbolSource(document) == source) {
+                        title = documentTitle(document);
+
+                        break;
+                    }
+                }
+
+                return tr("%1\nDeclared in %2 at line %3").arg(signature->toString()).arg(title).arg(signature->line + 1);
+            } else if (VJassToken::COMMONJ_NATIVES_ALL.contains(identifier) || VJassToken::COMMONAI_NATIVES_ALL.contains(identifier)) {
+                return tr("native %1").arg(identifier);
+            } else if (VJassToken::BLIZZARDJ_FUNCTIONS_ALL.contains(identifier)) {
+                return tr("function %1 from Blizzard.j").arg(identifier);
+            } else if (VJassToken::COMMONJ_CONSTANTS_ALL.contains(identifier) || VJassToken::BLIZZARDJ_CONSTANTS_ALL.contains(identifier) || VJassToken::COMMONAI_CONSTANTS_ALL.contains(identifier)) {
+                return tr("constant %1").arg(identifier);
+            }
+
+            return QString();
+        }
+    }
+
+    return QString();
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event) {
+    if (watched == ui->textEdit->viewport() && event->type() == QEvent::ToolTip) {
+        QHelpEvent *helpEvent = static_cast<QHelpEvent*>(event);
+        const QTextCursor cursor = ui->textEdit->cursorForPosition(helpEvent->pos());
+        const QString text = hoverText(cursor.blockNumber(), cursor.positionInBlock());
+
+        if (!text.isEmpty()) {
+            QToolTip::showText(helpEvent->globalPos(), text, ui->textEdit->viewport());
+        } else {
+            QToolTip::hideText();
+            event->ignore();
+        }
+
+        return true;
+    }
+
+    return QMainWindow::eventFilter(watched, event);
+}
+
 void MainWindow::pauseParserThread() {
     scanAndParsePaused.storeRelease(1);
 }
@@ -762,70 +1944,139 @@ void MainWindow::setAnalyzeMemoryLeaks(bool checked) {
     restartTimer();
 }
 
-namespace {
+void MainWindow::updateCurrentLineHighLighting() {
+    const QTextCursor textCursor = ui->textEdit->textCursor();
+    const QTextBlock startBlock = ui->textEdit->document()->findBlock(textCursor.selectionStart());
+    const QTextBlock endBlock = ui->textEdit->document()->findBlock(textCursor.selectionEnd());
+
+    currentLineStart = startBlock.blockNumber();
+    currentLineEnd = endBlock.blockNumber();
+
+    // one full width selection covers all selected lines and is only painted for the visible blocks
+    currentLineSelection.cursor = QTextCursor(ui->textEdit->document());
+    currentLineSelection.cursor.setPosition(startBlock.position());
+    currentLineSelection.cursor.setPosition(endBlock.position() + endBlock.length() - 1, QTextCursor::KeepAnchor);
+    currentLineSelection.format.setBackground(QColor(0xfaf5d4));
+    currentLineSelection.format.setProperty(QTextFormat::FullWidthSelection, true);
+
+    updateBracketHighlighting();
+
+    //qDebug() << "Selection line start" << currentLineStart << "and end" << currentLineEnd;
+}
 
-inline void setTextBlockBackgroundColor(QTextCursor textCursor, int lineStart, int lineEnd, QColor backgroundColor) {
-    QTextBlockFormat textBlockFormat;
+namespace {
 
-    textCursor.setPosition(0);
-    textCursor.movePosition(QTextCursor::Down, QTextCursor::MoveAnchor, lineStart);
-    textCursor.movePosition(QTextCursor::Down, QTextCursor::KeepAnchor, lineEnd - lineStart);
-    //textCursor.movePosition(QTextCursor::EndOfLine, QTextCursor::KeepAnchor);
-    textBlockFormat.setBackground(backgroundColor);
-    textCursor.setBlockFormat(textBlockFormat);
+inline bool isBracket(QChar c) {
+    return c == '(' || c == ')' || c == '[' || c == ']';
 }
 
-inline void rehighlightBlocks(SyntaxHighlighter *syntaxHighlighter, QTextDocument *textDocument, int lineStart, int lineEnd) {
-    for (int i = lineStart; i <= lineEnd; i++) {
-        syntaxHighlighter->rehighlightBlock(textDocument->findBlockByLineNumber(i));
+/**
+ * Finds the matching bracket inside of the given line only. This is used for lines which have been edited since the last analysis.
+ */
+inline int findMatchingBracketInLine(QStringView text, int column) {
+    const QChar bracket = text.at(column);
+    const bool opening = bracket == '(' || bracket == '[';
+    const QChar openingBracket = bracket == '(' || bracket == ')' ? '(' : '[';
+    const QChar closingBracket = openingBracket == '(' ? ')' : ']';
+    const int step = opening ? 1 : -1;
+    int depth = 0;
+
+    for (int i = column; i >= 0 && i < text.length(); i += step) {
+        if (text.at(i) == openingBracket) {
+            depth += step;
+        } else if (text.at(i) == closingBracket) {
+            depth -= step;
+        }
+
+        if (depth == 0) {
+            return i;
+        }
     }
+
+    return -1;
 }
 
+inline QTextEdit::ExtraSelection bracketSelection(const QTextBlock &block, int column, const QColor &color) {
+    QTextEdit::ExtraSelection selection;
+    selection.cursor = QTextCursor(block);
+    selection.cursor.setPosition(block.position() + column);
+    selection.cursor.setPosition(block.position() + column + 1, QTextCursor::KeepAnchor);
+    selection.format.setBackground(color);
+
+    return selection;
 }
 
-void MainWindow::updateCurrentLineHighLighting() {
-    QSignalBlocker signalBlocker(ui->textEdit);
+}
 
-    const int previousLineStart = currentLineStart;
-    const int previousLineEnd = currentLineEnd;
+bool MainWindow::isBlockUnchangedSinceResults(const QTextBlock &block) const {
+    if (currentResults == nullptr || !block.isValid()) {
+        return false;
+    }
 
-    currentLineStart = ui->textEdit->textCursor().hasSelection() ? ui->textEdit->document()->findBlock(ui->textEdit->textCursor().selectionStart()).blockNumber() : ui->textEdit->textCursor().blockNumber();
-    currentLineEnd = ui->textEdit->textCursor().hasSelection() ? ui->textEdit->document()->findBlock(ui->textEdit->textCursor().selectionEnd()).blockNumber() : ui->textEdit->textCursor().blockNumber();
+    const QVector<uint> &lineHashes = currentResults->getLineHashes();
+    const int blockNumber = block.blockNumber();
 
-    QTextCursor textCursor = ui->textEdit->textCursor();
-    const int originalPosition = textCursor.position();
+    return blockNumber < lineHashes.size()
+            && block.revision() <= currentResultsRevision
+            && lineHashes.at(blockNumber) == HighLightInfo::lineHash(QStringView(block.text()));
+}
 
-    setTextBlockBackgroundColor(textCursor, previousLineStart, previousLineEnd, QColor(0xffffff));
-    setTextBlockBackgroundColor(textCursor, currentLineStart, currentLineEnd, QColor(0xfaf5d4));
+void MainWindow::updateBracketHighlighting() {
+    bracketSelections.clear();
 
-    syntaxHighlighter->setCurrentLineStart(currentLineStart);
-    syntaxHighlighter->setCurrentLineEnd(currentLineEnd);
+    const QTextCursor cursor = ui->textEdit->textCursor();
+    const QTextBlock block = cursor.block();
+    const QString text = block.text();
+    int column = cursor.positionInBlock();
 
-    const QChar characterAfterCursor = ui->textEdit->document()->characterAt(originalPosition);
-    int bracketsColumnNumber = -1;
+    // prefer the bracket after the cursor
+    if (column >= text.length() || !isBracket(text.at(column))) {
+        column--;
+    }
 
-    if (characterAfterCursor == '(' || characterAfterCursor == '[' || characterAfterCursor == ']' || characterAfterCursor == ')') {
-        bracketsColumnNumber = ui->textEdit->textCursor().columnNumber();
-    } else if (ui->textEdit->textCursor().columnNumber() > 0) {
-        const QChar characterBeforeCursor = ui->textEdit->document()->characterAt(originalPosition - 1);
+    if (column >= 0 && isBracket(text.at(column))) {
+        // the pairs of the analysis span multiple lines but are only valid for unchanged lines
+        if (isBlockUnchangedSinceResults(block)) {
+            const BracketPairIndex &bracketPairIndex = currentResults->getBracketPairIndex();
+            const int index = bracketPairIndex.indexOf(block.blockNumber(), column);
+
+            if (index != -1) {
+                const int matchIndex = bracketPairIndex.at(index).matchIndex;
+                const QTextBlock matchBlock = matchIndex != -1 ? ui->textEdit->document()->findBlockByNumber(bracketPairIndex.at(matchIndex).line) : QTextBlock();
+
+                if (matchIndex == -1) {
+                    bracketSelections.push_back(bracketSelection(block, column, QColor(0xff9999)));
+                } else if (isBlockUnchangedSinceResults(matchBlock)) {
+                    bracketSelections.push_back(bracketSelection(block, column, Qt::green));
+                    bracketSelections.push_back(bracketSelection(matchBlock, bracketPairIndex.at(matchIndex).column, Qt::green));
+                }
+            }
+        } else {
+            const int matchColumn = findMatchingBracketInLine(QStringView(text), column);
 
-        if (characterBeforeCursor == '(' || characterBeforeCursor == '[' || characterBeforeCursor == ']' || characterBeforeCursor == ')') {
-            bracketsColumnNumber = ui->textEdit->textCursor().columnNumber() - 1;
+            if (matchColumn != -1) {
+                bracketSelections.push_back(bracketSelection(block, column, Qt::green));
+                bracketSelections.push_back(bracketSelection(block, matchColumn, Qt::green));
+            }
         }
     }
 
-    if (bracketsColumnNumber != -1) {
-        syntaxHighlighter->setHighlightBracketPosition(ui->textEdit->textCursor().blockNumber(), bracketsColumnNumber);
-    } else {
-        syntaxHighlighter->setHighlightBracketPosition(-1, -1);
-    }
+    updateExtraSelections();
+}
+
+void MainWindow::updateExtraSelections() {
+    QList<QTextEdit::ExtraSelection> extraSelections;
+    extraSelections.reserve(bracketSelections.size() + 1);
 
-    rehighlightBlocks(syntaxHighlighter, ui->textEdit->document(), previousLineStart, previousLineEnd);
-    rehighlightBlocks(syntaxHighlighter, ui->textEdit->document(), currentLineStart, currentLineEnd);
+    // the brackets are painted on top of the current line
+    if (!currentLineSelection.cursor.isNull()) {
+        extraSelections.push_back(currentLineSelection);
+    }
 
-    textCursor.setPosition(originalPosition);
+    extraSelections.append(bracketSelections);
 
-    //qDebug() << "Selection line start" << currentLineStart << "and end" << currentLineEnd;
+    // painting extra selections does not rehighlight any block
+    ui->textEdit->setExtraSelections(extraSelections);
 }
 
 void MainWindow::clearAllHighLighting() {
@@ -840,155 +2091,252 @@ void MainWindow::clearAllHighLighting() {
 }
 
 void MainWindow::updateOutliner() {
-    ui->outlinerListWidget->clear();
+    // only the changed declarations are inserted or removed
+    outlinerModel->setResults(currentResults);
+}
 
-    if (currentResults != nullptr) {
-        for (const VJassAst *astElement : currentResults->getAstElements()) {
-            const QString text = astElement->toString();
-
-            if ((text.startsWith(VJassToken::KEYWORD_NATIVE) && ui->checkBoxNatives->isChecked())
-                || (text.startsWith(VJassToken::KEYWORD_FUNCTION) && ui->checkBoxFunctions->isChecked())
-                || (text.startsWith(VJassToken::KEYWORD_CONSTANT) && ui->checkBoxConstants->isChecked())
-                || (text.startsWith(VJassToken::KEYWORD_TYPE) && ui->checkBoxTypes->isChecked())
-                || (!text.startsWith(VJassToken::KEYWORD_NATIVE) && !text.startsWith(VJassToken::KEYWORD_FUNCTION) && !text.startsWith(VJassToken::KEYWORD_CONSTANT) && !text.startsWith(VJassToken::KEYWORD_TYPE) && ui->checkBoxGlobals->isChecked())
-            ) {
-                QListWidgetItem *item = new QListWidgetItem(tr("%1 - line %2 and column %3").arg(astElement->toString()).arg(astElement->getLine() + 1).arg(astElement->getColumn() + 1));
-                item->setData(Qt::UserRole, QPoint(astElement->getLine(), astElement->getColumn()));
-                ui->outlinerListWidget->addItem(item);
-            }
-        }
-    }
+void MainWindow::updateOutlinerFilter() {
+    outlinerFilterModel->setKindVisible(OutlinerModel::Type, ui->checkBoxTypes->isChecked());
+    outlinerFilterModel->setKindVisible(OutlinerModel::Native, ui->checkBoxNatives->isChecked());
+    outlinerFilterModel->setKindVisible(OutlinerModel::Constant, ui->checkBoxConstants->isChecked());
+    outlinerFilterModel->setKindVisible(OutlinerModel::Global, ui->checkBoxGlobals->isChecked());
+    outlinerFilterModel->setKindVisible(OutlinerModel::Function, ui->checkBoxFunctions->isChecked());
+}
 
-    if (ui->outlinerListWidget->count() == 0) {
-        ui->outlinerListWidget->addItem(tr("No matching elements."));
-        ui->tabWidget->setTabText(1, tr("0 Elements"));
-    } else {
-        ui->tabWidget->setTabText(1, tr("%n Elements", "%n Elements", currentResults->getAstElements().length()));
-    }
+void MainWindow::updateOutlinerPlaceholder() {
+    ui->outlinerPlaceholderLabel->setVisible(outlinerFilterModel->rowCount() == 0);
 }
 
 void MainWindow::updateMemoryLeaks() {
     ui->memoryLeaksListWidget->clear();
+    memoryLeaksProgress = 0;
+    startApplyingResults();
+}
 
-    if (currentResults != nullptr) {
-        for (const VJassAst *astElement : currentResults->getAstLeakingElements()) {
-            const QString text = astElement->toString();
+void MainWindow::updateSyntaxErrorsList() {
+    // only the changed errors are inserted or removed
+    diagnosticsModel->setResults(currentResults);
+}
+
+void MainWindow::updateDiagnosticsGrouping(int index) {
+    diagnosticsModel->setGrouping(static_cast<DiagnosticsModel::Grouping>(index));
+    ui->diagnosticsTreeView->expandAll();
+}
+
+void MainWindow::startApplyingResults() {
+    if (timerIdApplyResults == 0) {
+        // runs whenever there are no other events to be processed
+        timerIdApplyResults = startTimer(0);
+    }
+}
+
+void MainWindow::applyResultsSlice() {
+    QElapsedTimer timer;
+    timer.start();
+
+    // yield back to the event loop after the budget so typing stays responsive
+    while (timer.nsecsElapsed() < APPLY_RESULTS_BUDGET_NS && applyNextResult()) {
+    }
+
+    if (!hasPendingVisibleResults()) {
+        killTimer(timerIdApplyResults);
+        timerIdApplyResults = 0;
+    }
+}
+
+bool MainWindow::isResultsTabVisible(int index) const {
+    return ui->tabWidget->isVisible() && ui->tabWidget->currentIndex() == index;
+}
+
+bool MainWindow::hasPendingVisibleResults() const {
+    return highlightingProgress != -1
+            || (memoryLeaksProgress != -1 && isResultsTabVisible(2));
+}
 
-            QListWidgetItem *item = new QListWidgetItem(tr("%1 - line %2 and column %3").arg(astElement->toString()).arg(astElement->getLine() + 1).arg(astElement->getColumn() + 1));
-            item->setData(Qt::UserRole, QPoint(astElement->getLine(), astElement->getColumn()));
-            ui->memoryLeaksListWidget->addItem(item);
+bool MainWindow::applyNextResult() {
+    if (highlightingProgress != -1) {
+        const QTextBlock block = ui->textEdit->document()->findBlockByNumber(highlightingProgress);
+
+        if (block.isValid()) {
+            syntaxHighlighter->rehighlightBlock(block);
+            highlightingProgress++;
+        } else {
+            highlightingProgress = -1;
         }
+
+        return true;
+    }
+
+    // panels which are not shown are skipped until they are shown
+    if (memoryLeaksProgress != -1 && isResultsTabVisible(2)) {
+        appendMemoryLeakItem();
+
+        return true;
     }
 
-    if (ui->memoryLeaksListWidget->count() == 0) {
-        ui->memoryLeaksListWidget->addItem(tr("No memory leaks."));
-        ui->tabWidget->setTabText(2, tr("0 Memory Leaks"));
+    return false;
+}
+
+void MainWindow::appendMemoryLeakItem() {
+    const int astLeakingElementsCount = currentResults != nullptr ? currentResults->getAstLeakingElements().size() : 0;
+
+    if (memoryLeaksProgress < astLeakingElementsCount) {
+        const VJassAst *astElement = currentResults->getAstLeakingElements().at(memoryLeaksProgress);
+        QListWidgetItem *item = new QListWidgetItem(tr("%1 - line %2 and column %3").arg(astElement->toString()).arg(astElement->getLine() + 1).arg(astElement->getColumn() + 1));
+        item->setData(Qt::UserRole, QPoint(astElement->getLine(), astElement->getColumn()));
+        ui->memoryLeaksListWidget->addItem(item);
+        memoryLeaksProgress++;
     } else {
-        ui->tabWidget->setTabText(2, tr("%n Memory Leaks", "%n Memory Leaks", currentResults->getAstLeakingElements().length()));
+        memoryLeaksProgress = -1;
+
+        if (ui->memoryLeaksListWidget->count() == 0) {
+            ui->memoryLeaksListWidget->addItem(tr("No memory leaks."));
+        }
     }
 }
 
-void MainWindow::timerEvent(QTimerEvent *event) {
-    // the user input timer finishes, so the user has stopped writing for some time, let's send the finished text to the thread for handling.
-    if (event->timerId() == timerId) {
-        timerId = 0; // set to 0 so the other timer will fetch from now on
+void MainWindow::updateResultsTabTexts() {
+    const int parseErrorsCount = currentResults != nullptr ? currentResults->getParseErrors().size() : 0;
+    const int astElementsCount = currentResults != nullptr ? currentResults->getAstElements().size() : 0;
+    const int astLeakingElementsCount = currentResults != nullptr ? currentResults->getAstLeakingElements().size() : 0;
 
-        // create a deep copy to avoid data races
-        QString text = ui->textEdit->toPlainText();
-        text.detach();
+    // the counts are known before the lists are filled, so the tabs show them even if they are not visible
+    ui->tabWidget->setTabText(0, tr("%n Syntax Errors", "%n Syntax Error", parseErrorsCount));
+    ui->tabWidget->setTabText(1, tr("%n Elements", "%n Elements", astElementsCount));
+    ui->tabWidget->setTabText(2, tr("%n Memory Leaks", "%n Memory Leaks", astLeakingElementsCount));
+}
 
-        qDebug() << "Finished user input timer and storing text with length" << text.length() << "for the scan and parser thread";
+void MainWindow::timerEvent(QTimerEvent *event) {
+    if (event->timerId() == timerIdApplyResults) {
+        applyResultsSlice();
 
-        //qassert(text.isDetached());
-        scanAndParseInput.storeRelease(new QString(text));
-        scanAndParseResults.storeRelease(nullptr);
+        return;
+    }
 
-        updateWindowStatusBar();
-    } else if (timerId == 0 && event->timerId() == timerIdCheck) {
-        //qDebug() << "Checking scan and parse result";
+    if (event->timerId() == timerIdFindReferences) {
+        findReferencesSlice();
 
-        HighLightInfo *scanAndParseResults = this->scanAndParseResults.fetchAndStoreAcquire(nullptr);
+        return;
+    }
 
-        // if there are results we will highlight everything now
-        if (scanAndParseResults != nullptr) {
+    // the user input timer finishes, so the user has stopped writing for some time, let's send the finished text to the thread for handling.
+    if (event->timerId() == timerId) {
+        killTimer(timerId);
+        timerId = 0;
 
-            if (currentResults != nullptr) {
-                delete currentResults;
-                currentResults = nullptr;
-            }
+        startAnalysis(activeDocument);
 
-            currentResults = scanAndParseResults;
-            syncDocumentState = true;
-            updateWindowStatusBar();
+        updateWindowStatusBar();
+    }
+}
 
-            qDebug() << "Got scan and parse result from thread into the main window";
+void MainWindow::startAnalysis(Document *document) {
+    // create a deep copy to avoid data races
+    QString text = document->textDocument->toPlainText();
+    text.detach();
+
+    qDebug() << "Storing text with length" << text.length() << "for the analysis";
+
+    const int revision = document->textDocument->revision();
+    const int syntaxChecker = this->syntaxChecker.loadAcquire();
+    const bool analyzeMemoryLeaks = this->analyzeMemoryLeaks.loadAcquire() == 1;
+    const int documentId = document->id;
+    document->inputRevision = revision;
+    // the symbol table is never modified after the analysis, so the thread can read it while it is still used here
+    const QSharedPointer<HighLightInfo> &previousResults = document == activeDocument ? currentResults : document->results;
+    const QSharedPointer<const VJassSymbolTable> previousSymbolTable = previousResults.isNull() ? QSharedPointer<const VJassSymbolTable>() : previousResults->getSymbolTable();
+
+    // only the latest text of the document has to be analyzed
+    analysisPool->clear(documentId);
+    analysisPool->enqueue(documentId, [this, documentId, text, revision, syntaxChecker, analyzeMemoryLeaks, previousSymbolTable]() {
+        if (this->scanAndParsePaused.loadAcquire() == 0) {
+            QSharedPointer<HighLightInfo> results(Analysis::scanAndParse(text, syntaxChecker, analyzeMemoryLeaks, previousSymbolTable));
+
+            QMetaObject::invokeMethod(this, [this, documentId, revision, results]() { receiveResults(documentId, revision, results); }, Qt::QueuedConnection);
+        }
+    });
+}
 
-            bool checkSyntax = ui->actionEnableSyntaxCheck->isChecked();
-            bool autoComplete = expectAutoComplete;
-            expectAutoComplete = false; // reset
-            bool highlight = ui->actionEnableSyntaxHighlighting->isChecked();
+void MainWindow::receiveResults(int documentId, int revision, const QSharedPointer<HighLightInfo> &results) {
+    Document *document = findDocument(documentId);
 
-            if (checkSyntax || autoComplete || highlight) {
-                if (highlight) {
-                    qDebug() << "Highlight!";
-                    highlightTokensAndAst(*currentResults, checkSyntax);
-                }
+    // the document might have been closed or there might be newer input in the meantime
+    if (document == nullptr || document->inputRevision != revision || scanAndParsePaused.loadAcquire() != 0) {
+        //qDebug() << "Finished scanning and parsing but discarding it";
+        return;
+    }
 
-                if (checkSyntax || autoComplete) {
-                    // update syntax errors output widget
-                    ui->outputListWidget->clear();
+    updateDocumentSymbols(document, results);
+    document->indexedRevision = revision;
 
-                    const QList<VJassParseError> &parseErrors = currentResults->getParseErrors();
+    // only the edges of the changed functions are replaced
+    if (!results->getSymbolTable().isNull()) {
+        document->callGraph.setUnits(results->getSymbolTable()->getUnits());
+    }
 
-                    for (const VJassParseError &parseError : parseErrors) {
-                        QListWidgetItem *item = new QListWidgetItem(tr("Syntax error at line %1 and column %2: %3").arg(parseError.getLine() + 1).arg(parseError.getColumn() + 1).arg(parseError.getError()));
-                        item->setData(Qt::UserRole, QPoint(parseError.getLine(), parseError.getColumn()));
-                        ui->outputListWidget->addItem(item);
-                    }
+    // the results of documents in the background are applied when their tabs are shown
+    if (document != activeDocument) {
+        document->results = results;
+        document->resultsRevision = revision;
+        document->resultsApplied = false;
 
-                    if (ui->outputListWidget->count() == 0) {
-                        ui->outputListWidget->addItem(tr("No syntax errors."));
-                        ui->tabWidget->setTabText(0, tr("0 Syntax Errors"));
-                    } else {
-                        ui->tabWidget->setTabText(0, tr("%n Syntax Errors", "%n Syntax Error", parseErrors.length()));
-                    }
+        return;
+    }
 
-                    // update outliner
-                    updateOutliner();
+    qDebug() << "Got scan and parse result from thread into the main window";
 
-                    // update memory leaks
-                    updateMemoryLeaks();
+    // the outliner keeps the previous results until it has been updated
+    currentResults = results;
+    currentResultsRevision = revision;
+    applyResults(true);
+}
 
-                    if (autoComplete && currentResults->getAst()->getCodeCompletionSuggestions().size() > 0) {
-                        popup->clear();
-                        popup->setFocusProxy(this);
-                        QTreeWidgetItem *firstItem = nullptr;
+void MainWindow::applyResults(bool highlightResults) {
+    activeDocument->resultsApplied = true;
+    // any progress belongs to the previous results
+    highlightingProgress = -1;
+    memoryLeaksProgress = -1;
+    syncDocumentState = true;
+    updateWindowStatusBar();
+    // the bracket pairs of the new results might span multiple lines
+    updateBracketHighlighting();
 
-                        for (VJassAst *codeCompletionSuggestion : currentResults->getAst()->getCodeCompletionSuggestions()) {
-                            QTreeWidgetItem *item = new QTreeWidgetItem(popup, QStringList(codeCompletionSuggestion->toString()));
+    // only the declarations of changed functions and globals blocks are updated
+    if (!currentResults.isNull()) {
+        activeDocument->completionIndex.setUnits(currentResults->getCompletionUnits());
+    }
 
-                            if (firstItem == nullptr) {
-                                firstItem = item;
-                            }
-                        }
+    bool checkSyntax = ui->actionEnableSyntaxCheck->isChecked();
+    bool autoComplete = expectAutoComplete;
+    expectAutoComplete = false; // reset
+    bool highlight = ui->actionEnableSyntaxHighlighting->isChecked();
+
+    if (currentResults.isNull()) {
+        ui->overviewRuler->setDiagnosticsIndex(DiagnosticsIndex());
+        updateLineNumberMarkers();
+        updateResultsTabTexts();
+        updateSyntaxErrorsList();
+        updateOutliner();
+        updateMemoryLeaks();
+    } else if (checkSyntax || autoComplete || highlight) {
+        if (highlight && highlightResults) {
+            qDebug() << "Highlight!";
+            highlightTokensAndAst(*currentResults, checkSyntax);
+        }
 
-                        qDebug() << "Bottom right 1:" << ui->textEdit, ui->textEdit->cursorRect().bottomRight();
-                        qDebug() << "Bottom right 2:" << ui->textEdit->mapToGlobal(ui->textEdit->cursorRect().bottomRight());
+        if (checkSyntax || autoComplete) {
+            ui->overviewRuler->setDiagnosticsIndex(currentResults->getDiagnosticsIndex());
+            updateLineNumberMarkers();
 
-                        popup->move(ui->textEdit->mapToGlobal(ui->textEdit->cursorRect().bottomRight()));
-                        // preselect first entry
-                        popup->setCurrentItem(firstItem);
+            // the lists are filled in time slices by the timer
+            updateResultsTabTexts();
+            updateSyntaxErrorsList();
+            updateOutliner();
+            updateMemoryLeaks();
 
-                        popup->show();
-                    }
-                }
+            if (autoComplete) {
+                showCompletionPopup();
             }
         }
     }
 }
-
-void MainWindow::resizeEvent(QResizeEvent *event) {
-    updateLineNumbers();
-
-    QMainWindow::resizeEvent(event);
-}
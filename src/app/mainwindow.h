@@ -6,15 +6,30 @@
 #include <QModelIndex>
 #include <QListWidgetItem>
 #include <QLabel>
-#include <QThread>
+#include <QProgressBar>
+#include <QElapsedTimer>
+#include <QTextEdit>
+#include <QTextBlock>
+#include <QTabBar>
 #include <QAtomicInt>
-#include <QAtomicPointer>
 
 #include "vjassparser.h"
 #include "syntaxhighlighter.h"
 #include "autocompletionpopup.h"
+#include "completioncontext.h"
 #include "highlightinfo.h"
 #include "finddialog.h"
+#include "overviewruler.h"
+#include "outlinermodel.h"
+#include "outlinerfiltermodel.h"
+#include "diagnosticsmodel.h"
+#include "fileloader.h"
+#include "analysispool.h"
+#include "findinfiles.h"
+#include "symbolpalette.h"
+#include "crossreferenceindex.h"
+#include "callgraph.h"
+#include "signatureindex.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -31,12 +46,42 @@ public:
 public slots:
     void newFile();
     void openFile();
+    /**
+     * @brief Opens a file read-only in a separate window which maps the file into memory instead of loading it into the editor.
+     */
+    void openInViewer();
     bool saveAs();
     bool closeFile();
     void quit();
 
     void goToLine();
+    /**
+     * @brief Shows the palette which finds the declarations of all open documents and the standard scripts.
+     */
+    void showSymbolPalette();
+    /**
+     * @brief Jumps to the declaration of the identifier at the cursor in any open document or standard script.
+     */
+    void goToDeclaration();
+    /**
+     * @brief Lists all references to the identifier at the cursor in the find in files panel. They are shown while the remaining ones are searched.
+     */
+    void findReferences();
+    /**
+     * @brief Asks for a new name of the symbol at the cursor and renames its declaration and all references.
+     */
+    void renameSymbol();
+    /**
+     * @brief Shows the callers and callees of the function at the cursor or of the enclosing function.
+     */
+    void showCallHierarchy();
     void findAndReplace();
+    /**
+     * @brief Shows the find in files panel. The folder of the current file or the standard scripts are searched by default.
+     */
+    void showFindInFiles();
+    void findInFiles();
+    void cancelFindInFiles();
     void applyColor();
 
     void openCommonj();
@@ -51,8 +96,35 @@ public slots:
     void updateLineNumbersView();
     void showWhiteSpaces();
     void updateLineNumbers();
+    /**
+     * @brief Shows the errors and the foldable declarations of the current results next to the line numbers.
+     */
+    void updateLineNumberMarkers();
+    /**
+     * @brief Folds the block construct which starts in the line or unfolds it if it is already folded.
+     */
+    void toggleFold(int line);
+    void foldAll();
+    void unfoldAll();
+
+    void insertLoadedChunk(const QString &text, qint64 bytesRead, qint64 bytesTotal);
+    void finishLoading(bool success);
 
     void clickPopupItem(const QModelIndex &index);
+    /**
+     * @brief Shows the declarations which start with the identifier in front of the cursor and can be used there.
+     * It only scans the current line, so it is shown immediately after a keystroke. The analysis of the whole text refines it later.
+     */
+    void showCompletionPopup();
+    /**
+     * @brief Filters the shown popup by the new prefix.
+     */
+    void updateCompletionPopup();
+    /**
+     * @brief Shows the parameters of the native or function whose arguments contain the cursor with the parameter at the cursor in bold.
+     * It only scans the current line, so it is updated with every keystroke before the analysis of the changed text.
+     */
+    void updateSignatureHelp();
 
     void openJASSManual();
     void openCodeOnHive();
@@ -71,6 +143,7 @@ public slots:
     void updateSelectedLines();
 
     void updateWindowStatusBar();
+    void updateBreadcrumb(int line, int column);
 
     void pauseParserThread();
     void resumeParserThread();
@@ -81,6 +154,21 @@ private slots:
     void updateCursorPosition(int position);
     void highlightTokensAndAst(const HighLightInfo &highLightInfo, bool checkSyntax);
     void astListItemDoubleClicked(QListWidgetItem *item);
+    void outlinerIndexDoubleClicked(const QModelIndex &index);
+    void diagnosticsIndexDoubleClicked(const QModelIndex &index);
+    void moveCursorToLine(int line);
+    void addFindInFilesResults(const FindInFiles::Results &results);
+    void updateFindInFilesProgress(int searchedFiles, int files);
+    void finishFindInFiles(bool success);
+    void chooseFindInFilesFolder();
+    void findInFilesItemActivated(QTreeWidgetItem *item);
+    /**
+     * @param source The source of a symbol is the source of its document or the file path of a standard script.
+     */
+    void goToSymbol(const QString &source, int line);
+    void cancelFindReferences();
+    void expandCallHierarchyItem(QTreeWidgetItem *item);
+    void callHierarchyItemActivated(QTreeWidgetItem *item);
 
     void updatePJassSyntaxCheckerVJassIDE(bool checked);
     void updatePJassSyntaxCheckerPJass(bool checked);
@@ -91,26 +179,84 @@ private slots:
     void setAnalyzeMemoryLeaks(bool checked);
 
     void updateCurrentLineHighLighting();
+    void updateBracketHighlighting();
+    /**
+     * @brief Paints the current line and bracket selections on top of the syntax highlighting.
+     */
+    void updateExtraSelections();
 
     void clearAllHighLighting();
 
     void updateOutliner();
+    void updateOutlinerFilter();
+    void updateOutlinerPlaceholder();
     void updateMemoryLeaks();
+    void updateSyntaxErrorsList();
+    void updateDiagnosticsGrouping(int index);
+    void updateResultsTabTexts();
+
+    void startApplyingResults();
+
+    void activateDocumentTab(int index);
+    void closeDocumentTab(int index);
+    void moveDocumentTab(int from, int to);
 
     friend class TestMainWindow;
     friend class SyntaxHighLighter;
 
 protected:
+    virtual bool eventFilter(QObject *watched, QEvent *event) override;
     virtual void timerEvent(QTimerEvent *event) override;
-    virtual void resizeEvent(QResizeEvent *event) override;
 
 private:
     Ui::MainWindow *ui;
 
     // we use a permanent status bar widget
     QLabel *statusBar = nullptr;
+    QLabel *breadcrumb = nullptr;
 
     FindDialog *findDialog = nullptr;
+    FindInFiles *findInFilesSearch = nullptr;
+    QElapsedTimer findInFilesTimer;
+
+    // the declarations of all open documents and the standard scripts
+    SymbolIndex symbolIndex;
+    SymbolPalette *symbolPalette = nullptr;
+    QStringList standardScripts;
+    QThread *standardScriptsThread = nullptr;
+    QAtomicInt stopStandardScriptsThread;
+
+    // the declarations and references of all open documents and the standard scripts
+    CrossReferenceIndex crossReferenceIndex;
+    // the references are searched in time slices like the current results are applied
+    static const qint64 FIND_REFERENCES_BUDGET_NS = 4000000;
+    static const int FIND_REFERENCES_SLICE_SIZE = 64;
+    int timerIdFindReferences = 0;
+    QString referencesName;
+    bool referencesIsLocal = false;
+    QVector<int> referencesCandidates;
+    int referencesProgress = 0;
+    int referencesCount = 0;
+    QHash<QString, QTreeWidgetItem*> referencesSourceItems;
+    QElapsedTimer findReferencesTimer;
+
+    // the parameters and return types of the natives and functions of all open documents and the standard scripts
+    SignatureIndex signatureIndex;
+    QLabel *signatureHelp = nullptr;
+
+    // files are read in the background and inserted in chunks
+    FileLoader *fileLoader = nullptr;
+    QProgressBar *loadingProgressBar = nullptr;
+    QElapsedTimer loadingTimer;
+    qint64 loadingFirstScreenNs = -1;
+    // the cursor is moved to this position as soon as the file has been loaded
+    QVariant pendingCursorPosition;
+
+    OutlinerModel *outlinerModel = nullptr;
+    OutlinerFilterModel *outlinerFilterModel = nullptr;
+
+    DiagnosticsModel *diagnosticsModel = nullptr;
+    QSortFilterProxyModel *diagnosticsSortModel = nullptr;
 
     // selection
     int currentLineStart = 0;
@@ -123,24 +269,153 @@ private:
 
     bool expectAutoComplete = false;
     AutoCompletionPopup *popup;
-
-    // the scanner and parser is executed in a separate thread
-    // it waits for some text input to be scanned and parsed and returns it for the main window to be retrieved
+    static const int MAX_COMPLETION_ENTRIES = 100;
+
+    /**
+     * @brief Every open file has its own document. The state of the active document is stored in the members of the main window while it is shown.
+     */
+    struct Document {
+        // unique for the lifetime of the main window unlike the address of a closed document
+        int id = 0;
+        QTextDocument *textDocument = nullptr;
+        SyntaxHighlighter *syntaxHighlighter = nullptr;
+        QString filePath;
+        bool hasChanged = false;
+        QSharedPointer<HighLightInfo> results;
+        int resultsRevision = 0;
+        bool resultsApplied = true;
+        int inputRevision = -1; // the document revision of the latest input for the analysis
+        int indexedRevision = -1; // the document revision of the text whose symbols and references are indexed
+        CompletionIndex completionIndex;
+        CallGraph callGraph;
+    };
+
+    QTabBar *documentTabBar = nullptr;
+    // in the order of the tabs
+    QList<Document*> documents;
+    Document *activeDocument = nullptr;
+    int nextDocumentId = 1;
+
+    // the scanner and parser is executed by the threads of the pool which are shared by all documents
     // there is a timer which waits for some time until the user doesnt input anything anymore
-    // only when this timer is not running anymore we retrieve the scan and parse results every X seconds
-    // as soon as they are available we update the text edit
+    // only when this timer is finished the text of the active document is analyzed
+    // as soon as the results are available we update the text edit
+    AnalysisPool *analysisPool = nullptr;
     int timerId;
-    int timerIdCheck;
-    QAtomicPointer<QString> scanAndParseInput;
-    QAtomicPointer<HighLightInfo> scanAndParseResults;
     QAtomicInt scanAndParsePaused;
-    QThread *scanAndParseThread;
-    QAtomicInt stopScanAndParseThread;
     QAtomicInt syntaxChecker; // 0 - vjasside, 1 - pjass
     QAtomicInt analyzeMemoryLeaks; // 0 - on, 1 - off
     QString parserName;
     bool syncDocumentState = true;
 
-    HighLightInfo *currentResults = nullptr;
+    // shared with the outliner model whose rows refer to the AST elements
+    QSharedPointer<HighLightInfo> currentResults;
+    int currentResultsRevision = 0;
+
+    // the current lines and the matching brackets at the cursor are painted on top of the highlighting
+    QTextEdit::ExtraSelection currentLineSelection;
+    QList<QTextEdit::ExtraSelection> bracketSelections;
+
+    // the current results are applied in time slices to keep the GUI responsive
+    // every progress is the index of the next item or -1 if there is nothing to be done
+    static const qint64 APPLY_RESULTS_BUDGET_NS = 4000000;
+    int timerIdApplyResults = 0;
+    int highlightingProgress = -1;
+    int memoryLeaksProgress = -1;
+
+    /**
+     * @return Returns the declaration of the identifier at the given position or an empty string.
+     */
+    QString hoverText(int line, int column) const;
+    /**
+     * @return Returns the part of the identifier in front of the cursor.
+     */
+    QString completionPrefix() const;
+    /**
+     * @brief Scans only the line of the cursor and adds the enclosing function and the expected type from the last results, so it does not wait for the analysis of the changed text.
+     */
+    CompletionContext completionContext() const;
+    Document* addDocument();
+    /**
+     * @brief Shows the file in its own tab. If it is already open, its tab is shown.
+     * @return Returns false if the file cannot be opened.
+     */
+    bool openDocument(const QString &filePath);
+    /**
+     * @brief Removes the document without asking for saving it. The last document is cleared instead.
+     */
+    void removeDocument(int index);
+    /**
+     * @return Returns the open document with the ID or nullptr if it has been closed.
+     */
+    Document* findDocument(int id) const;
+    QString documentTitle(const Document *document) const;
+    /**
+     * @return Returns the source of the symbols of the document in the indices which is its ID. It does not change when the document is saved under another name and is never reused by another document.
+     */
+    QString documentSymbolSource(const Document *document) const;
+    /**
+     * @brief Replaces the symbols of the document in the symbol index unless it is a standard script which is indexed on its own.
+     */
+    void updateDocumentSymbols(Document *document, const QSharedPointer<HighLightInfo> &results);
+    /**
+     * @brief Parses the standard scripts once in a separate thread and adds their declarations to the symbol index, their references to the cross-reference index and their signatures to the signature index.
+     */
+    void indexStandardScripts();
+    /**
+     * @brief Shows the file in its tab and moves the cursor to the position as soon as it has been loaded.
+     */
+    void openDocumentAt(const QString &filePath, const QVariant &position);
+    /**
+     * @brief Shows the document with the source or opens the standard script with the source as file path and moves the cursor to the position.
+     */
+    void goToSource(const QString &source, const QVariant &position);
+    /**
+     * @return Returns the identifier at the cursor or an empty string.
+     */
+    QString identifierAtCursor() const;
+    void findReferencesSlice();
+    /**
+     * @brief Replaces the declaration and all references of the identifier at the cursor in all open documents. Strings, comments and other symbols with the same name are not changed.
+     * Every document gets one undo step for all of its edits. It is refused while the analysis of any document is not up to date since its new references are not indexed yet.
+     * @return Returns the number of replaced references or -1 if the symbol cannot be renamed. The reason is shown in the status bar.
+     */
+    int renameIdentifierAtCursor(const QString &newName);
+    void receiveStandardScriptSymbols(const QString &filePath, const SymbolIndex::Symbols &symbols, const VJassSymbolTable::Units &units, const SignatureIndex::Signatures &signatures);
+    /**
+     * @brief Analyzes the current text of the document in the analysis pool.
+     */
+    void startAnalysis(Document *document);
+    void receiveResults(int documentId, int revision, const QSharedPointer<HighLightInfo> &results);
+    /**
+     * @brief Shows the current results in all views.
+     * @param highlightResults If it is false, the blocks have already been highlighted with the current results.
+     */
+    void applyResults(bool highlightResults);
+    /**
+     * @brief Starts loading the file into the text edit. The text edit is read-only until the file has been loaded.
+     * @return Returns false if the file cannot be opened.
+     */
+    bool loadFile(const QString &filePath);
+    /**
+     * @brief Stops loading the file and removes the partially loaded document.
+     * @return Returns false if no file is being loaded.
+     */
+    bool cancelLoading();
+    /**
+     * @brief Highlights the visible blocks immediately. All other blocks are highlighted in time slices.
+     */
+    void highlightVisibleBlocks();
+    void moveCursorToPosition(const QVariant &position);
+    /**
+     * @return Returns true if the block has the same text as the corresponding line of the current results, so their positions are still valid.
+     */
+    bool isBlockUnchangedSinceResults(const QTextBlock &block) const;
+
+    void applyResultsSlice();
+    bool applyNextResult();
+    bool hasPendingVisibleResults() const;
+    bool isResultsTabVisible(int index) const;
+    void appendMemoryLeakItem();
 };
 #endif // MAINWINDOW_H
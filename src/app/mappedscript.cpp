@@ -0,0 +1,161 @@
+#include <QtCore>
+
+#include <cstring>
+
+#include "mappedscript.h"
+
+MappedScript::MappedScript(QObject *parent)
+    : QObject(parent)
+    , data(nullptr)
+    , size(0)
+    , thread(nullptr)
+    , stop(0)
+    , generation(0)
+    , indexing(false)
+{
+}
+
+MappedScript::~MappedScript() {
+    close();
+}
+
+bool MappedScript::open(const QString &filePath) {
+    close();
+
+    file.setFileName(filePath);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    size = file.size();
+
+    // empty files cannot be mapped
+    if (size > 0) {
+        data = file.map(0, size);
+
+        if (data == nullptr) {
+            file.close();
+            size = 0;
+
+            return false;
+        }
+    }
+
+    lineOffsets.push_back(0);
+    indexing = true;
+    stop.storeRelease(0);
+
+    const uchar *data = this->data;
+    const qint64 size = this->size;
+    const int generation = this->generation;
+
+    thread = QThread::create([this, data, size, generation]() {
+        qint64 position = 0;
+
+        while (position < size && stop.loadAcquire() == 0) {
+            const qint64 end = qMin(size, position + INDEX_SLICE_SIZE);
+            QVector<qint64> lineOffsets;
+
+            while (position < end) {
+                const void *lineBreak = std::memchr(data + position, '\n', static_cast<size_t>(end - position));
+
+                if (lineBreak == nullptr) {
+                    position = end;
+                } else {
+                    position = static_cast<const uchar*>(lineBreak) - data + 1;
+                    lineOffsets.push_back(position);
+                }
+            }
+
+            const bool finished = position >= size;
+            QMetaObject::invokeMethod(this, [this, generation, lineOffsets, finished]() { receiveLineOffsets(generation, lineOffsets, finished); }, Qt::QueuedConnection);
+        }
+
+        if (size == 0) {
+            QMetaObject::invokeMethod(this, [this, generation]() { receiveLineOffsets(generation, QVector<qint64>(), true); }, Qt::QueuedConnection);
+        }
+    });
+    thread->start(QThread::LowPriority);
+
+    return true;
+}
+
+void MappedScript::close() {
+    stopThread();
+    generation++;
+    indexing = false;
+    lineOffsets.clear();
+
+    if (data != nullptr) {
+        file.unmap(const_cast<uchar*>(data));
+        data = nullptr;
+    }
+
+    size = 0;
+    file.close();
+}
+
+bool MappedScript::isOpen() const {
+    return file.isOpen();
+}
+
+bool MappedScript::isIndexing() const {
+    return indexing;
+}
+
+QString MappedScript::getFilePath() const {
+    return file.fileName();
+}
+
+qint64 MappedScript::getSize() const {
+    return size;
+}
+
+int MappedScript::getLineCount() const {
+    // the end of the last line is only known after indexing
+    return indexing ? qMax(0, lineOffsets.size() - 1) : lineOffsets.size();
+}
+
+QString MappedScript::getLine(int line) const {
+    if (line < 0 || line >= getLineCount()) {
+        return QString();
+    }
+
+    const qint64 start = lineOffsets.at(line);
+    qint64 end = line + 1 < lineOffsets.size() ? lineOffsets.at(line + 1) - 1 : size;
+
+    if (end > start && data[end - 1] == '\r') {
+        end--;
+    }
+
+    return QString::fromUtf8(reinterpret_cast<const char*>(data + start), static_cast<int>(end - start));
+}
+
+void MappedScript::stopThread() {
+    if (thread != nullptr) {
+        stop.storeRelease(1);
+        thread->wait();
+        delete thread;
+        thread = nullptr;
+    }
+}
+
+void MappedScript::receiveLineOffsets(int generation, const QVector<qint64> &lineOffsets, bool finished) {
+    if (generation != this->generation) {
+        return;
+    }
+
+    this->lineOffsets += lineOffsets;
+
+    if (finished) {
+        indexing = false;
+        stopThread();
+    }
+
+    emit linesIndexed(getLineCount());
+
+    if (finished) {
+        emit indexed();
+    }
+}
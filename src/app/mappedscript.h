@@ -0,0 +1,66 @@
+#ifndef MAPPEDSCRIPT_H
+#define MAPPEDSCRIPT_H
+
+#include <QObject>
+#include <QFile>
+#include <QVector>
+#include <QThread>
+#include <QAtomicInt>
+
+/**
+ * @brief Maps a script file into memory and indexes the offsets of its lines in a separate thread.
+ *
+ * The text is never copied as a whole. Only the requested lines are decoded, so even huge generated scripts can be viewed with little memory.
+ * The offsets are delivered in slices to the thread of the script, so the first lines are available before the whole file has been indexed.
+ */
+class MappedScript : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const qint64 INDEX_SLICE_SIZE = 4 * 1024 * 1024;
+
+    MappedScript(QObject *parent = nullptr);
+    virtual ~MappedScript();
+
+    /**
+     * @brief Maps the file and starts indexing its lines. Any previous file is closed.
+     * @return Returns false if the file cannot be opened or mapped.
+     */
+    bool open(const QString &filePath);
+    void close();
+    bool isOpen() const;
+    bool isIndexing() const;
+
+    QString getFilePath() const;
+    qint64 getSize() const;
+    /**
+     * @return Returns the number of lines which have been indexed so far.
+     */
+    int getLineCount() const;
+    /**
+     * @return Returns the decoded line without its line break.
+     */
+    QString getLine(int line) const;
+
+signals:
+    void linesIndexed(int lineCount);
+    void indexed();
+
+private:
+    void stopThread();
+    void receiveLineOffsets(int generation, const QVector<qint64> &lineOffsets, bool finished);
+
+    QFile file;
+    const uchar *data;
+    qint64 size;
+    // the start of every line, the first line always starts at 0
+    QVector<qint64> lineOffsets;
+    QThread *thread;
+    QAtomicInt stop;
+    // incremented with every file to ignore the queued offsets of previous ones
+    int generation;
+    bool indexing;
+};
+
+#endif // MAPPEDSCRIPT_H
@@ -0,0 +1,33 @@
+#include <QtCore>
+
+#include "outlinerfiltermodel.h"
+
+OutlinerFilterModel::OutlinerFilterModel(QObject *parent) : QSortFilterProxyModel(parent), visibleKinds(~0) {
+    // the source model reports all changes itself
+    setDynamicSortFilter(true);
+}
+
+void OutlinerFilterModel::setKindVisible(OutlinerModel::Kind kind, bool visible) {
+    const int bit = 1 << static_cast<int>(kind);
+    const int newVisibleKinds = visible ? (visibleKinds | bit) : (visibleKinds & ~bit);
+
+    if (newVisibleKinds != visibleKinds) {
+        visibleKinds = newVisibleKinds;
+        invalidateFilter();
+    }
+}
+
+bool OutlinerFilterModel::isKindVisible(OutlinerModel::Kind kind) const {
+    return (visibleKinds & (1 << static_cast<int>(kind))) != 0;
+}
+
+bool OutlinerFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
+    const OutlinerModel *outlinerModel = qobject_cast<const OutlinerModel*>(sourceModel());
+
+    // avoid data() which would create the label
+    if (outlinerModel != nullptr && !sourceParent.isValid()) {
+        return isKindVisible(outlinerModel->getKind(sourceRow));
+    }
+
+    return QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
+}
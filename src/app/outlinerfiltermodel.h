@@ -0,0 +1,28 @@
+#ifndef OUTLINERFILTERMODEL_H
+#define OUTLINERFILTERMODEL_H
+
+#include <QSortFilterProxyModel>
+
+#include "outlinermodel.h"
+
+/**
+ * @brief Filters the rows of the outliner model by the kinds of their declarations.
+ */
+class OutlinerFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    OutlinerFilterModel(QObject *parent = nullptr);
+
+    void setKindVisible(OutlinerModel::Kind kind, bool visible);
+    bool isKindVisible(OutlinerModel::Kind kind) const;
+
+protected:
+    virtual bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    int visibleKinds; // one bit per kind
+};
+
+#endif // OUTLINERFILTERMODEL_H
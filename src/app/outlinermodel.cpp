@@ -0,0 +1,140 @@
+#include <QtCore>
+#include <QtGui>
+
+#include "outlinermodel.h"
+#include "rowdiff.h"
+#include "vjassnative.h"
+#include "vjassfunction.h"
+#include "vjassglobal.h"
+#include "vjasstype.h"
+
+OutlinerModel::OutlinerModel(QObject *parent) : QAbstractListModel(parent) {
+}
+
+int OutlinerModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : entries.size();
+}
+
+QVariant OutlinerModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= entries.size()) {
+        return QVariant();
+    }
+
+    const Entry &entry = entries.at(index.row());
+
+    switch (role) {
+        case Qt::DisplayRole: {
+            // the only place where the label is created, so rows which are never shown do not need any string
+            return tr("%1 - line %2 and column %3").arg(entry.ast->toString()).arg(entry.ast->getLine() + 1).arg(entry.ast->getColumn() + 1);
+        }
+
+        case PositionRole: {
+            return QPoint(entry.ast->getLine(), entry.ast->getColumn());
+        }
+
+        case KindRole: {
+            return static_cast<int>(entry.kind);
+        }
+
+        default: {
+            break;
+        }
+    }
+
+    return QVariant();
+}
+
+void OutlinerModel::setResults(const QSharedPointer<HighLightInfo> &results) {
+    QVector<Entry> newEntries;
+
+    if (results != nullptr) {
+        newEntries.reserve(results->getAstElements().size());
+
+        for (const VJassAst *ast : results->getAstElements()) {
+            newEntries.push_back(Entry(kindFromAst(ast), HighLightInfo::declarationIdentifier(ast), ast));
+        }
+    }
+
+    // the old results have to be kept until all rows refer to the new ones
+    const QSharedPointer<HighLightInfo> previousResults = this->results;
+    this->results = results;
+
+    int row = 0;
+    int j = 0;
+
+    for (const RowDiff::Edit &edit : RowDiff::diff(entries, newEntries, [](const Entry &entry) { return entry.key(); })) {
+        switch (edit.type) {
+            case RowDiff::Edit::Keep: {
+                // same declaration, only the AST element is replaced and only rows whose labels have changed are reported
+                int firstChangedRow = -1;
+
+                for (int i = 0; i < edit.count; i++) {
+                    const bool changed = hasChangedLabel(entries.at(row).ast, newEntries.at(j).ast);
+                    entries[row] = newEntries.at(j);
+
+                    if (changed && firstChangedRow == -1) {
+                        firstChangedRow = row;
+                    } else if (!changed && firstChangedRow != -1) {
+                        emit dataChanged(index(firstChangedRow), index(row - 1));
+                        firstChangedRow = -1;
+                    }
+
+                    row++;
+                    j++;
+                }
+
+                if (firstChangedRow != -1) {
+                    emit dataChanged(index(firstChangedRow), index(row - 1));
+                }
+
+                break;
+            }
+
+            case RowDiff::Edit::Remove: {
+                beginRemoveRows(QModelIndex(), row, row + edit.count - 1);
+                entries.erase(entries.begin() + row, entries.begin() + row + edit.count);
+                endRemoveRows();
+
+                break;
+            }
+
+            case RowDiff::Edit::Insert: {
+                beginInsertRows(QModelIndex(), row, row + edit.count - 1);
+                RowDiff::insertRows(entries, row, newEntries, j, edit.count);
+                endInsertRows();
+
+                row += edit.count;
+                j += edit.count;
+
+                break;
+            }
+        }
+    }
+}
+
+const QSharedPointer<HighLightInfo>& OutlinerModel::getResults() const {
+    return results;
+}
+
+OutlinerModel::Kind OutlinerModel::getKind(int row) const {
+    return entries.at(row).kind;
+}
+
+OutlinerModel::Kind OutlinerModel::kindFromAst(const VJassAst *ast) {
+    if (typeid(*ast) == typeid(VJassType)) {
+        return Type;
+    } else if (typeid(*ast) == typeid(VJassFunction)) {
+        return Function;
+    } else if (typeid(*ast) == typeid(VJassNative)) {
+        return Native;
+    }
+
+    const VJassGlobal *global = dynamic_cast<const VJassGlobal*>(ast);
+
+    return global != nullptr && global->getIsConstant() ? Constant : Global;
+}
+
+bool OutlinerModel::hasChangedLabel(const VJassAst *ast, const VJassAst *newAst) {
+    // the position is cheaper to compare than the declaration
+    return ast->getLine() != newAst->getLine() || ast->getColumn() != newAst->getColumn() || ast->toString() != newAst->toString();
+}
@@ -0,0 +1,81 @@
+#ifndef OUTLINERMODEL_H
+#define OUTLINERMODEL_H
+
+#include <QAbstractListModel>
+#include <QSharedPointer>
+#include <QVector>
+#include <QPair>
+
+#include "highlightinfo.h"
+
+/**
+ * @brief Lists all declarations of the results of an analysis for the outliner.
+ *
+ * The kind of every declaration is taken from the type of its AST element. The label is only generated in data(), so only rows which are shown create strings.
+ * New results are compared to the current rows by the kind and identifier of the declarations and only the differences are inserted or removed.
+ * Kept rows are only reported as changed if their labels or positions have changed.
+ * The model keeps a reference to the results since the rows refer to their AST elements.
+ */
+class OutlinerModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Kind {
+        Type,
+        Native,
+        Constant,
+        Global,
+        Function
+    };
+
+    enum Roles {
+        // the position as QPoint with the line as x and the column as y like in the other lists
+        PositionRole = Qt::UserRole,
+        KindRole
+    };
+
+    OutlinerModel(QObject *parent = nullptr);
+
+    virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Replaces the rows by the declarations of the results. Unchanged declarations keep their rows.
+     */
+    void setResults(const QSharedPointer<HighLightInfo> &results);
+    const QSharedPointer<HighLightInfo>& getResults() const;
+
+    Kind getKind(int row) const;
+
+    static Kind kindFromAst(const VJassAst *ast);
+
+private:
+    using Key = QPair<int, QString>;
+
+    /**
+     * @return Returns true if the label or the position of a kept declaration differs between both AST elements.
+     */
+    static bool hasChangedLabel(const VJassAst *ast, const VJassAst *newAst);
+
+    struct Entry {
+        Kind kind;
+        QString identifier;
+        const VJassAst *ast;
+
+        Entry() : kind(Global), ast(nullptr) {
+        }
+
+        Entry(Kind kind, const QString &identifier, const VJassAst *ast) : kind(kind), identifier(identifier), ast(ast) {
+        }
+
+        Key key() const {
+            return Key(static_cast<int>(kind), identifier);
+        }
+    };
+
+    QSharedPointer<HighLightInfo> results;
+    QVector<Entry> entries;
+};
+
+#endif // OUTLINERMODEL_H
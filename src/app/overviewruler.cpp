@@ -0,0 +1,83 @@
+#include <QtGui>
+#include <QtWidgets>
+
+#include "overviewruler.h"
+
+namespace {
+
+const int MARKER_HEIGHT = 3;
+
+}
+
+OverviewRuler::OverviewRuler(QWidget *parent) : QWidget(parent), lineCount(1) {
+    setMinimumWidth(12);
+    setMaximumWidth(12);
+    setCursor(Qt::PointingHandCursor);
+}
+
+OverviewRuler::~OverviewRuler() {
+}
+
+QSize OverviewRuler::sizeHint() const {
+    return QSize(12, 0);
+}
+
+const DiagnosticsIndex& OverviewRuler::getDiagnosticsIndex() const {
+    return diagnosticsIndex;
+}
+
+int OverviewRuler::getLineCount() const {
+    return lineCount;
+}
+
+int OverviewRuler::lineAt(int y) const {
+    const int lines = qMax(lineCount, diagnosticsIndex.getLineCount());
+
+    if (height() <= 0 || lines <= 0) {
+        return 0;
+    }
+
+    return qBound(0, static_cast<int>(static_cast<qint64>(y) * lines / height()), lines - 1);
+}
+
+void OverviewRuler::setDiagnosticsIndex(const DiagnosticsIndex &diagnosticsIndex) {
+    this->diagnosticsIndex = diagnosticsIndex;
+    update();
+}
+
+void OverviewRuler::setLineCount(int lineCount) {
+    if (this->lineCount != lineCount) {
+        this->lineCount = qMax(1, lineCount);
+        update();
+    }
+}
+
+void OverviewRuler::paintEvent(QPaintEvent *event) {
+    QPainter painter(this);
+    painter.fillRect(event->rect(), palette().window());
+
+    if (diagnosticsIndex.getRangesCount() == 0) {
+        return;
+    }
+
+    const int lines = qMax(lineCount, diagnosticsIndex.getLineCount());
+    const int top = event->rect().top() - event->rect().top() % MARKER_HEIGHT;
+
+    // one check for every marker row instead of one for every error
+    for (int y = top; y <= event->rect().bottom(); y += MARKER_HEIGHT) {
+        const int firstLine = lineAt(y);
+        const int lastLine = qMax(firstLine, static_cast<int>(static_cast<qint64>(y + MARKER_HEIGHT) * lines / height()) - 1);
+
+        if (diagnosticsIndex.hasDiagnostics(firstLine, lastLine)) {
+            painter.fillRect(QRect(2, y, width() - 4, MARKER_HEIGHT - 1), Qt::red);
+        }
+    }
+}
+
+void OverviewRuler::mousePressEvent(QMouseEvent *event) {
+    if (event->button() == Qt::LeftButton) {
+        emit lineClicked(lineAt(event->pos().y()));
+    }
+
+    QWidget::mousePressEvent(event);
+}
@@ -0,0 +1,45 @@
+#ifndef OVERVIEWRULER_H
+#define OVERVIEWRULER_H
+
+#include <QWidget>
+
+#include "diagnosticsindex.h"
+
+/**
+ * @brief Shows markers for all lines with errors of the whole document next to the vertical scroll bar of the text edit.
+ * Painting checks every marker row for errors in constant time using the diagnostics index, so it does not depend on the number of errors.
+ */
+class OverviewRuler : public QWidget
+{
+    Q_OBJECT
+
+public:
+    OverviewRuler(QWidget *parent);
+    virtual ~OverviewRuler();
+
+    virtual QSize sizeHint() const override;
+
+    const DiagnosticsIndex& getDiagnosticsIndex() const;
+    int getLineCount() const;
+    /**
+     * @return Returns the line which is represented by the given y coordinate.
+     */
+    int lineAt(int y) const;
+
+public slots:
+    void setDiagnosticsIndex(const DiagnosticsIndex &diagnosticsIndex);
+    void setLineCount(int lineCount);
+
+signals:
+    void lineClicked(int line);
+
+protected:
+    virtual void paintEvent(QPaintEvent *event) override;
+    virtual void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    DiagnosticsIndex diagnosticsIndex;
+    int lineCount;
+};
+
+#endif // OVERVIEWRULER_H
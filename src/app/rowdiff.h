@@ -0,0 +1,130 @@
+#ifndef ROWDIFF_H
+#define ROWDIFF_H
+
+#include <QVector>
+#include <QHash>
+
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * @brief Compares the rows of a list model to new rows by their keys.
+ *
+ * The result is a sequence of edits which transforms the old rows into the new rows when being applied from the first row to the last row.
+ * Rows with the same key in the same order are kept, so a model only has to insert and remove the rows which have changed.
+ * It takes linear time in the number of rows but it does not find the minimal number of edits if rows have been moved.
+ */
+namespace RowDiff {
+
+struct Edit {
+    enum Type {
+        Keep,
+        Remove,
+        Insert
+    };
+
+    Type type;
+    int count;
+
+    Edit() : type(Keep), count(0) {
+    }
+
+    Edit(Type type, int count) : type(type), count(count) {
+    }
+};
+
+namespace Detail {
+
+inline void appendEdit(QVector<Edit> &edits, Edit::Type type, int count) {
+    if (!edits.isEmpty() && edits.last().type == type) {
+        edits.last().count += count;
+    } else {
+        edits.push_back(Edit(type, count));
+    }
+}
+
+template<typename Key>
+inline void removeKey(QHash<Key, int> &keys, const Key &key) {
+    typename QHash<Key, int>::iterator it = keys.find(key);
+
+    if (it != keys.end() && --it.value() == 0) {
+        keys.erase(it);
+    }
+}
+
+}
+
+/**
+ * @brief Compares the rows by the keys which are returned by keyOf, so the keys which are stored in the rows are not copied.
+ */
+template<typename Row, typename KeyOf>
+QVector<Edit> diff(const QVector<Row> &oldRows, const QVector<Row> &newRows, KeyOf keyOf) {
+    typedef typename std::decay<decltype(keyOf(newRows.at(0)))>::type Key;
+
+    QVector<Edit> edits;
+    // counts the keys of all new rows which have not been placed yet
+    QHash<Key, int> remainingKeys;
+
+    for (const Row &row : newRows) {
+        remainingKeys[keyOf(row)]++;
+    }
+
+    int i = 0;
+    int j = 0;
+
+    while (i < oldRows.size() || j < newRows.size()) {
+        if (i < oldRows.size() && j < newRows.size() && keyOf(oldRows.at(i)) == keyOf(newRows.at(j))) {
+            Detail::appendEdit(edits, Edit::Keep, 1);
+            Detail::removeKey(remainingKeys, keyOf(newRows.at(j)));
+            i++;
+            j++;
+
+            continue;
+        }
+
+        // remove all following rows which do not exist anymore
+        int removeEnd = i;
+
+        while (removeEnd < oldRows.size() && !remainingKeys.contains(keyOf(oldRows.at(removeEnd)))) {
+            removeEnd++;
+        }
+
+        if (removeEnd > i) {
+            Detail::appendEdit(edits, Edit::Remove, removeEnd - i);
+            i = removeEnd;
+
+            continue;
+        }
+
+        // insert all new rows until the current row matches again
+        int insertEnd = j;
+
+        while (insertEnd < newRows.size() && (i >= oldRows.size() || !(keyOf(newRows.at(insertEnd)) == keyOf(oldRows.at(i))))) {
+            Detail::removeKey(remainingKeys, keyOf(newRows.at(insertEnd)));
+            insertEnd++;
+        }
+
+        Detail::appendEdit(edits, Edit::Insert, insertEnd - j);
+        j = insertEnd;
+    }
+
+    return edits;
+}
+
+template<typename Key>
+QVector<Edit> diff(const QVector<Key> &oldKeys, const QVector<Key> &newKeys) {
+    return diff(oldKeys, newKeys, [](const Key &key) -> const Key& { return key; });
+}
+
+/**
+ * @brief Inserts the given range of new rows at the row in place, so only the rows behind it are moved.
+ */
+template<typename T>
+void insertRows(QVector<T> &rows, int row, const QVector<T> &newRows, int first, int count) {
+    rows.insert(row, count, T());
+    std::copy(newRows.cbegin() + first, newRows.cbegin() + first + count, rows.begin() + row);
+}
+
+}
+
+#endif // ROWDIFF_H
@@ -0,0 +1,161 @@
+#include <QtGui>
+#include <QtWidgets>
+
+#include "scriptviewer.h"
+#include "vjassscanner.h"
+
+namespace {
+
+const int MARGIN = 4;
+
+/**
+ * Tabs are painted as spaces, so the columns of the format runs match the painted characters.
+ */
+inline QString expandTabs(const QString &text) {
+    return text.contains('\t') ? QString(text).replace('\t', QLatin1String("    ")) : text;
+}
+
+}
+
+ScriptViewer::ScriptViewer(QWidget *parent)
+    : QAbstractScrollArea(parent)
+    , script(new MappedScript(this))
+    , formatRunsCache(FORMAT_RUNS_CACHE_SIZE)
+    , scannedLinesCount(0)
+    , maxLineWidth(0)
+{
+    setFont(HighLightInfo::getNormalFont());
+    viewport()->setAutoFillBackground(false);
+
+    connect(script, &MappedScript::linesIndexed, this, &ScriptViewer::updateScrollBars);
+}
+
+ScriptViewer::~ScriptViewer() {
+}
+
+bool ScriptViewer::open(const QString &filePath) {
+    formatRunsCache.clear();
+    maxLineWidth = 0;
+
+    const bool result = script->open(filePath);
+    setWindowTitle(filePath);
+    updateScrollBars();
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+    viewport()->update();
+
+    return result;
+}
+
+MappedScript* ScriptViewer::getScript() const {
+    return script;
+}
+
+int ScriptViewer::getFirstVisibleLine() const {
+    return verticalScrollBar()->value();
+}
+
+int ScriptViewer::getVisibleLinesCount() const {
+    return viewport()->height() / lineHeight() + 1;
+}
+
+int ScriptViewer::getScannedLinesCount() const {
+    return scannedLinesCount;
+}
+
+void ScriptViewer::scrollToLine(int line) {
+    verticalScrollBar()->setValue(line);
+}
+
+void ScriptViewer::paintEvent(QPaintEvent *event) {
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), Qt::white);
+
+    const int height = lineHeight();
+    const int ascent = fontMetrics().ascent();
+    const int gutter = gutterWidth();
+    const int x = gutter + MARGIN - horizontalScrollBar()->value();
+    const int firstLine = getFirstVisibleLine();
+    const int lastLine = qMin(script->getLineCount(), firstLine + getVisibleLinesCount());
+    int previousMaxLineWidth = maxLineWidth;
+
+    painter.fillRect(QRect(0, 0, gutter, viewport()->height()), QColor(0xf0f0f0));
+
+    for (int line = firstLine; line < lastLine; line++) {
+        const int y = (line - firstLine) * height;
+        const QString text = expandTabs(script->getLine(line));
+
+        painter.setClipRect(QRect(gutter, y, viewport()->width() - gutter, height));
+
+        // the text without any format is painted first and the runs are painted on top of it
+        painter.setFont(HighLightInfo::getNormalFont());
+        painter.setPen(Qt::black);
+        painter.drawText(x, y + ascent, text);
+
+        for (const HighLightInfo::FormatRun &formatRun : formatRuns(line, text)) {
+            const QTextCharFormat &format = HighLightInfo::getTextCharFormat(formatRun.category);
+            const int runX = x + fontMetrics().horizontalAdvance(text.left(formatRun.column));
+            const QString runText = text.mid(formatRun.column, formatRun.length);
+
+            painter.fillRect(QRect(runX, y, fontMetrics().horizontalAdvance(runText), height), Qt::white);
+            painter.setFont(format.font());
+            painter.setPen(format.foreground().color());
+            painter.drawText(runX, y + ascent, runText);
+        }
+
+        maxLineWidth = qMax(maxLineWidth, fontMetrics().horizontalAdvance(text));
+
+        painter.setClipping(false);
+        painter.setFont(HighLightInfo::getNormalFont());
+        painter.setPen(Qt::darkGray);
+        painter.drawText(QRect(0, y, gutter - MARGIN, height), Qt::AlignRight | Qt::AlignVCenter, QString::number(line + 1));
+    }
+
+    // lines which have not been visible before might be longer
+    if (maxLineWidth != previousMaxLineWidth) {
+        QTimer::singleShot(0, this, &ScriptViewer::updateScrollBars);
+    }
+}
+
+void ScriptViewer::resizeEvent(QResizeEvent *event) {
+    QAbstractScrollArea::resizeEvent(event);
+
+    updateScrollBars();
+}
+
+void ScriptViewer::scrollContentsBy(int /* dx */, int /* dy */) {
+    viewport()->update();
+}
+
+void ScriptViewer::updateScrollBars() {
+    const int visibleLinesCount = viewport()->height() / lineHeight();
+
+    verticalScrollBar()->setPageStep(visibleLinesCount);
+    verticalScrollBar()->setRange(0, qMax(0, script->getLineCount() - visibleLinesCount));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setRange(0, qMax(0, gutterWidth() + MARGIN + maxLineWidth - viewport()->width()));
+    viewport()->update();
+}
+
+const HighLightInfo::FormatRuns& ScriptViewer::formatRuns(int line, const QString &text) {
+    HighLightInfo::FormatRuns *formatRuns = formatRunsCache.object(line);
+
+    if (formatRuns == nullptr) {
+        VJassScanner scanner;
+        QList<VJassToken> tokens = scanner.scan(text, true);
+        HighLightInfo highLightInfo(text, tokens, nullptr, QList<VJassParseError>(), true, false);
+        formatRuns = new HighLightInfo::FormatRuns(highLightInfo.getFormatRuns(0));
+        formatRunsCache.insert(line, formatRuns);
+        scannedLinesCount++;
+    }
+
+    return *formatRuns;
+}
+
+int ScriptViewer::lineHeight() const {
+    return qMax(1, fontMetrics().lineSpacing());
+}
+
+int ScriptViewer::gutterWidth() const {
+    return fontMetrics().horizontalAdvance(QString::number(qMax(1, script->getLineCount()))) + 2 * MARGIN;
+}
@@ -0,0 +1,58 @@
+#ifndef SCRIPTVIEWER_H
+#define SCRIPTVIEWER_H
+
+#include <QAbstractScrollArea>
+#include <QCache>
+
+#include "mappedscript.h"
+#include "highlightinfo.h"
+
+/**
+ * @brief Read-only view of a memory mapped script which paints only the visible lines.
+ *
+ * Every visible line is scanned on its own when it is painted for the first time and its format runs are cached.
+ * Hence, comments spanning multiple lines are not highlighted.
+ */
+class ScriptViewer : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    static const int FORMAT_RUNS_CACHE_SIZE = 10000;
+
+    ScriptViewer(QWidget *parent = nullptr);
+    virtual ~ScriptViewer();
+
+    bool open(const QString &filePath);
+    MappedScript* getScript() const;
+
+    int getFirstVisibleLine() const;
+    int getVisibleLinesCount() const;
+    /**
+     * @return Returns how many lines have been scanned for painting them.
+     */
+    int getScannedLinesCount() const;
+
+public slots:
+    void scrollToLine(int line);
+
+protected:
+    virtual void paintEvent(QPaintEvent *event) override;
+    virtual void resizeEvent(QResizeEvent *event) override;
+    virtual void scrollContentsBy(int dx, int dy) override;
+
+private slots:
+    void updateScrollBars();
+
+private:
+    const HighLightInfo::FormatRuns& formatRuns(int line, const QString &text);
+    int lineHeight() const;
+    int gutterWidth() const;
+
+    MappedScript *script;
+    QCache<int, HighLightInfo::FormatRuns> formatRunsCache;
+    int scannedLinesCount;
+    int maxLineWidth;
+};
+
+#endif // SCRIPTVIEWER_H
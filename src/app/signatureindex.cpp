@@ -0,0 +1,224 @@
+#include <QtCore>
+
+#include "signatureindex.h"
+#include "vjassscanner.h"
+#include "vjassnative.h"
+#include "vjassfunction.h"
+
+QString SignatureIndex::Signature::toString() const {
+    QStringList parameterStrings;
+
+    for (const Parameter &parameter : parameters) {
+        parameterStrings.push_back(parameter.type + " " + parameter.name);
+    }
+
+    return (isNative ? VJassToken::KEYWORD_NATIVE : VJassToken::KEYWORD_FUNCTION) + " " + name + " " + VJassToken::KEYWORD_TAKES + " "
+            + (parameters.isEmpty() ? VJassToken::KEYWORD_NOTHING : parameterStrings.join(", "))
+            + " " + VJassToken::KEYWORD_RETURNS + " " + returnType;
+}
+
+SignatureIndex::SignatureIndex() : declaredNames(0) {
+}
+
+int SignatureIndex::setSignatures(const QString &source, const Signatures &signatures) {
+    int changedNames = 0;
+
+    for (int id : sources.value(source)) {
+        QVector<Declaration> &idDeclarations = declarations[id];
+
+        for (int i = 0; i < idDeclarations.size(); i++) {
+            if (idDeclarations.at(i).source == source) {
+                idDeclarations.removeAt(i);
+                changedNames++;
+
+                break;
+            }
+        }
+
+        if (idDeclarations.isEmpty()) {
+            declaredNames--;
+        }
+    }
+
+    QVector<int> sourceIds;
+    sourceIds.reserve(signatures.size());
+
+    for (const Signature &signature : signatures) {
+        const int id = intern(signature.name);
+        QVector<Declaration> &idDeclarations = declarations[id];
+
+        // redeclarations are reported by the parser, the first one is enough
+        if (std::any_of(idDeclarations.cbegin(), idDeclarations.cend(), [&source](const Declaration &declaration) { return declaration.source == source; })) {
+            continue;
+        }
+
+        if (idDeclarations.isEmpty()) {
+            declaredNames++;
+        }
+
+        Declaration declaration;
+        declaration.source = source;
+        declaration.signature = signature;
+        idDeclarations.push_back(declaration);
+        sourceIds.push_back(id);
+        changedNames++;
+    }
+
+    if (sourceIds.isEmpty()) {
+        sources.remove(source);
+    } else {
+        sources.insert(source, sourceIds);
+    }
+
+    return changedNames;
+}
+
+void SignatureIndex::removeSource(const QString &source) {
+    setSignatures(source, Signatures());
+}
+
+bool SignatureIndex::hasSource(const QString &source) const {
+    return sources.contains(source);
+}
+
+void SignatureIndex::setSecondarySources(const QStringList &sources) {
+    secondarySources.clear();
+
+    for (const QString &source : sources) {
+        secondarySources.insert(source);
+    }
+}
+
+int SignatureIndex::size() const {
+    return declaredNames;
+}
+
+int SignatureIndex::getId(const QString &name) const {
+    return ids.value(name, -1);
+}
+
+const SignatureIndex::Signature* SignatureIndex::find(const QString &name, const QString &source) const {
+    return find(getId(name), source);
+}
+
+const SignatureIndex::Signature* SignatureIndex::find(int id, const QString &source) const {
+    const Declaration *declaration = findDeclaration(id, source);
+
+    return declaration != nullptr ? &declaration->signature : nullptr;
+}
+
+QString SignatureIndex::findSource(const QString &name, const QString &source) const {
+    const Declaration *declaration = findDeclaration(getId(name), source);
+
+    return declaration != nullptr ? declaration->source : QString();
+}
+
+bool SignatureIndex::findCall(const QString &line, int column, QString &name, int &activeParameter) {
+    column = qBound(0, column, line.size());
+
+    VJassScanner scanner;
+    const QList<VJassToken> tokens = scanner.scan(line.left(column));
+
+    if (tokens.isEmpty()) {
+        return false;
+    }
+
+    const VJassToken &last = tokens.last();
+
+    // there is no call in comments and unterminated strings
+    if (last.getType() == VJassToken::Comment || (last.getType() == VJassToken::StringLiteral && (last.getLength() < 2 || !last.getValue().endsWith('"')))) {
+        return false;
+    }
+
+    int depth = 0;
+    int separators = 0;
+
+    for (int i = tokens.size() - 1; i >= 0; i--) {
+        const VJassToken &token = tokens.at(i);
+
+        if (token.getType() == VJassToken::RightBracket) {
+            depth++;
+        } else if (token.getType() == VJassToken::LeftBracket) {
+            if (depth > 0) {
+                depth--;
+            // brackets of expressions are skipped until the bracket of a call is found
+            } else if (i > 0 && tokens.at(i - 1).getType() == VJassToken::Text) {
+                name = tokens.at(i - 1).getValue();
+                activeParameter = separators;
+
+                return true;
+            }
+        } else if (token.getType() == VJassToken::Separator && depth == 0) {
+            separators++;
+        }
+    }
+
+    return false;
+}
+
+SignatureIndex::Signatures SignatureIndex::signaturesFromAst(const VJassAst *ast) {
+    Signatures result;
+
+    if (ast == nullptr) {
+        return result;
+    }
+
+    for (const VJassAst *child : ast->getChildren()) {
+        const VJassNative *vjassNative = dynamic_cast<const VJassNative*>(child);
+
+        if (vjassNative == nullptr || vjassNative->getIdentifier().isEmpty()) {
+            continue;
+        }
+
+        Signature signature;
+        signature.name = vjassNative->getIdentifier();
+        signature.isNative = dynamic_cast<const VJassFunction*>(child) == nullptr;
+        signature.returnType = vjassNative->getReturnType();
+        signature.line = child->getLine();
+
+        for (const VJassFunctionParameter &parameter : vjassNative->getParameters()) {
+            signature.parameters.push_back(Parameter(parameter.getType(), parameter.getName()));
+        }
+
+        result.push_back(signature);
+    }
+
+    return result;
+}
+
+const SignatureIndex::Declaration* SignatureIndex::findDeclaration(int id, const QString &source) const {
+    if (id < 0 || id >= declarations.size()) {
+        return nullptr;
+    }
+
+    // the signatures of a source are appended again whenever it is analyzed, so the first one depends on the order of the analyses
+    const Declaration *result = nullptr;
+
+    for (const Declaration &declaration : declarations.at(id)) {
+        if (declaration.source == source) {
+            return &declaration;
+        }
+
+        if (result == nullptr
+                || (secondarySources.contains(result->source) && !secondarySources.contains(declaration.source))
+                || (secondarySources.contains(result->source) == secondarySources.contains(declaration.source) && declaration.source < result->source)) {
+            result = &declaration;
+        }
+    }
+
+    return result;
+}
+
+int SignatureIndex::intern(const QString &name) {
+    auto iterator = ids.constFind(name);
+
+    if (iterator != ids.cend()) {
+        return iterator.value();
+    }
+
+    const int id = declarations.size();
+    declarations.push_back(QVector<Declaration>());
+    ids.insert(name, id);
+
+    return id;
+}
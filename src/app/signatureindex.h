@@ -0,0 +1,116 @@
+#ifndef SIGNATUREINDEX_H
+#define SIGNATUREINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+#include "vjassast.h"
+
+/**
+ * @brief Stores the parameters and return types of the natives and functions of all open documents and the standard scripts for the signature help and the hover tooltips.
+ *
+ * Every name is interned to an ID once, so a lookup is one hash access. The signatures of every ID are stored by their sources.
+ * If multiple sources declare a name, the signature of the querying source is preferred to the ones of other sources and secondary sources like the standard scripts come last.
+ * The call at the cursor is found by scanning only the current line, so it does not wait for the analysis of the changed text.
+ */
+class SignatureIndex
+{
+public:
+    struct Parameter {
+        QString type;
+        QString name;
+
+        Parameter() {
+        }
+
+        Parameter(const QString &type, const QString &name) : type(type), name(name) {
+        }
+    };
+
+    struct Signature {
+        QString name;
+        bool isNative;
+        QVector<Parameter> parameters;
+        QString returnType;
+        int line;
+
+        Signature() : isNative(true), line(0) {
+        }
+
+        /**
+         * @return Returns the declaration like "native CreateUnit takes player id, ... returns unit".
+         */
+        QString toString() const;
+    };
+
+    using Signatures = QVector<Signature>;
+
+    SignatureIndex();
+
+    /**
+     * @brief Replaces the signatures of the source.
+     * @return Returns the number of names whose signatures of the source have been removed or inserted.
+     */
+    int setSignatures(const QString &source, const Signatures &signatures);
+    void removeSource(const QString &source);
+    bool hasSource(const QString &source) const;
+    /**
+     * @brief Signatures of secondary sources are only found if no other source declares the name.
+     */
+    void setSecondarySources(const QStringList &sources);
+    /**
+     * @return Returns the number of names which have at least one signature.
+     */
+    int size() const;
+
+    /**
+     * @return Returns the ID of the name or -1 if it has never been declared.
+     */
+    int getId(const QString &name) const;
+    /**
+     * @param source The source which uses the name.
+     * @return Returns the signature of the name or nullptr.
+     */
+    const Signature* find(const QString &name, const QString &source = QString()) const;
+    const Signature* find(int id, const QString &source = QString()) const;
+    /**
+     * @return Returns the source of the signature of the name which is found for the given source or an empty string.
+     */
+    QString findSource(const QString &name, const QString &source = QString()) const;
+
+    /**
+     * @brief Finds the innermost call whose opened argument list contains the column of the line.
+     * @param activeParameter The index of the argument at the column which is the number of separators in front of it.
+     * @return Returns false if the column is not inside of the arguments of a call or inside of a comment or string.
+     */
+    static bool findCall(const QString &line, int column, QString &name, int &activeParameter);
+    /**
+     * @return Returns the signatures of all natives and functions of the AST.
+     */
+    static Signatures signaturesFromAst(const VJassAst *ast);
+
+private:
+    struct Declaration {
+        QString source;
+        Signature signature;
+    };
+
+    int intern(const QString &name);
+    /**
+     * @return Returns the preferred declaration of the name with the ID for the source or nullptr. The order does not depend on the order of their insertion.
+     */
+    const Declaration* findDeclaration(int id, const QString &source) const;
+
+    QHash<QString, int> ids;
+    // the declarations of every ID in the order of their insertion
+    QVector<QVector<Declaration>> declarations;
+    // the IDs of the names which every source declares
+    QHash<QString, QVector<int>> sources;
+    QSet<QString> secondarySources;
+    int declaredNames;
+};
+
+#endif // SIGNATUREINDEX_H
@@ -0,0 +1,510 @@
+#include <QtCore>
+
+#include "symbolindex.h"
+#include "vjassnative.h"
+#include "vjassfunction.h"
+#include "vjassglobals.h"
+#include "vjassglobal.h"
+#include "vjasstype.h"
+
+namespace {
+
+const int SCORE_EXACT = 100;
+const int SCORE_PREFIX = 50;
+const int SCORE_START = 10;
+const int SCORE_WORD_START = 8;
+const int SCORE_CONSECUTIVE = 5;
+
+quint64 trigramKey(QChar c1, QChar c2, QChar c3) {
+    return (quint64(c1.unicode()) << 32) | (quint64(c2.unicode()) << 16) | quint64(c3.unicode());
+}
+
+/**
+ * A word starts at the start of the name, at an upper case letter following a lower case one, behind underscores and at the first digit of a number.
+ */
+bool isWordStart(const QString &name, int i) {
+    if (i == 0) {
+        return true;
+    }
+
+    const QChar previous = name.at(i - 1);
+    const QChar current = name.at(i);
+
+    return (current.isUpper() && previous.isLower())
+            || (previous == '_' && current != '_')
+            || (current.isDigit() && !previous.isDigit());
+}
+
+bool isSubsequence(const QString &lowerName, int from, const QString &lowerQuery, int queryFrom) {
+    for (int i = from; i < lowerName.size() && queryFrom < lowerQuery.size(); i++) {
+        if (lowerName.at(i) == lowerQuery.at(queryFrom)) {
+            queryFrom++;
+        }
+    }
+
+    return queryFrom == lowerQuery.size();
+}
+
+/**
+ * Intersects the sorted lists starting with the shortest one, so the intersection never grows.
+ */
+QVector<int> intersect(QVector<const QVector<int>*> lists) {
+    if (lists.isEmpty()) {
+        return QVector<int>();
+    }
+
+    std::sort(lists.begin(), lists.end(), [](const QVector<int> *l1, const QVector<int> *l2) {
+        return l1->size() < l2->size();
+    });
+
+    QVector<int> result = *lists.first();
+
+    for (int i = 1; i < lists.size() && !result.isEmpty(); i++) {
+        QVector<int> intersection;
+        std::set_intersection(result.cbegin(), result.cend(), lists.at(i)->cbegin(), lists.at(i)->cend(), std::back_inserter(intersection));
+        result = intersection;
+    }
+
+    return result;
+}
+
+int fuzzyScore(const QString &name, const QString &lowerName, const QString &lowerQuery) {
+    if (lowerQuery.isEmpty()) {
+        return 0;
+    }
+
+    if (!isSubsequence(lowerName, 0, lowerQuery, 0)) {
+        return -1;
+    }
+
+    int score = 0;
+    int position = 0;
+    int previous = -2;
+
+    for (int q = 0; q < lowerQuery.size(); q++) {
+        const QChar c = lowerQuery.at(q);
+        int match = -1;
+        int wordStartMatch = -1;
+
+        for (int i = position; i < lowerName.size(); i++) {
+            if (lowerName.at(i) != c) {
+                continue;
+            }
+
+            if (match == -1) {
+                match = i;
+
+                // continuing a run is always taken
+                if (i == previous + 1) {
+                    break;
+                }
+            }
+
+            // a later start of a word is only taken if the rest of the query still matches behind it
+            if (isWordStart(name, i) && isSubsequence(lowerName, i + 1, lowerQuery, q + 1)) {
+                wordStartMatch = i;
+
+                break;
+            }
+        }
+
+        if (wordStartMatch != -1 && match != previous + 1) {
+            match = wordStartMatch;
+        }
+
+        score++;
+
+        if (match == 0) {
+            score += SCORE_START;
+        } else if (isWordStart(name, match)) {
+            score += SCORE_WORD_START;
+        }
+
+        if (match == previous + 1) {
+            score += SCORE_CONSECUTIVE;
+        }
+
+        previous = match;
+        position = match + 1;
+    }
+
+    if (lowerName == lowerQuery) {
+        score += SCORE_EXACT;
+    } else if (lowerName.startsWith(lowerQuery)) {
+        score += SCORE_PREFIX;
+    }
+
+    // shorter names are preferred
+    return qMax(0, score * 4 - (name.size() - lowerQuery.size()));
+}
+
+}
+
+SymbolIndex::SymbolIndex() {
+}
+
+int SymbolIndex::setSymbols(const QString &source, const Symbols &symbols) {
+    QHash<QString, int> oldIds = sources.value(source);
+    QHash<QString, int> newIds;
+    int changedSymbols = 0;
+
+    for (const Symbol &symbol : symbols) {
+        const QString key = QString::number(symbol.kind) + ' ' + symbol.name;
+
+        // redeclarations are reported by the parser, the first one is enough to jump there
+        if (newIds.contains(key)) {
+            continue;
+        }
+
+        auto iterator = oldIds.find(key);
+
+        if (iterator != oldIds.end()) {
+            // the name and therefore the trigrams have not changed
+            entries[iterator.value()].symbol = symbol;
+            newIds.insert(key, iterator.value());
+            oldIds.erase(iterator);
+        } else {
+            newIds.insert(key, insertSymbol(source, symbol));
+            changedSymbols++;
+        }
+    }
+
+    for (int id : oldIds) {
+        removeSymbol(id);
+        changedSymbols++;
+    }
+
+    if (newIds.isEmpty()) {
+        sources.remove(source);
+    } else {
+        sources.insert(source, newIds);
+    }
+
+    return changedSymbols;
+}
+
+void SymbolIndex::removeSource(const QString &source) {
+    setSymbols(source, Symbols());
+}
+
+bool SymbolIndex::hasSource(const QString &source) const {
+    return sources.contains(source);
+}
+
+int SymbolIndex::size() const {
+    return entries.size() - freeIds.size();
+}
+
+int SymbolIndex::getTrigramsCount() const {
+    return postings.size();
+}
+
+const SymbolIndex::Symbol& SymbolIndex::getSymbol(int id) const {
+    return entries.at(id).symbol;
+}
+
+const QString& SymbolIndex::getSource(int id) const {
+    return entries.at(id).source;
+}
+
+QVector<int> SymbolIndex::candidates(const QString &query) const {
+    QVector<int> result;
+
+    if (query.isEmpty()) {
+        result.reserve(size());
+
+        for (int id = 0; id < entries.size(); id++) {
+            if (!entries.at(id).removed) {
+                result.push_back(id);
+            }
+        }
+
+        return result;
+    }
+
+    // every character of a subsequence is contained in the name, so the intersection contains all matches
+    QVector<const QVector<int>*> lists;
+
+    for (ushort character : characters(query)) {
+        auto iterator = characterPostings.constFind(character);
+
+        if (iterator == characterPostings.cend()) {
+            return result;
+        }
+
+        lists.push_back(&iterator.value());
+    }
+
+    result = intersect(lists);
+
+    if (query.size() < 3 || result.isEmpty()) {
+        return result;
+    }
+
+    // the trigrams of the query skip no characters, so they only select the best matches which are ranked first
+    lists.clear();
+
+    for (quint64 trigram : trigrams(query, false)) {
+        auto iterator = postings.constFind(trigram);
+
+        if (iterator == postings.cend()) {
+            return result;
+        }
+
+        lists.push_back(&iterator.value());
+    }
+
+    const QVector<int> trigramMatches = intersect(lists);
+
+    if (trigramMatches.isEmpty()) {
+        return result;
+    }
+
+    QVector<int> otherMatches;
+    std::set_difference(result.cbegin(), result.cend(), trigramMatches.cbegin(), trigramMatches.cend(), std::back_inserter(otherMatches));
+
+    return trigramMatches + otherMatches;
+}
+
+int SymbolIndex::rank(const QVector<int> &candidates, int from, int count, const QString &query, int maxResults, Matches &matches) const {
+    const int to = qMin(candidates.size(), from + count);
+    const QString lowerQuery = query.toLower();
+    auto betterThan = [this](const Match &m1, const Match &m2) {
+        if (m1.score != m2.score) {
+            return m1.score > m2.score;
+        }
+
+        const QString &name1 = entries.at(m1.id).symbol.name;
+        const QString &name2 = entries.at(m2.id).symbol.name;
+
+        return name1 < name2 || (name1 == name2 && m1.id < m2.id);
+    };
+
+    for (int i = from; i < to; i++) {
+        const int id = candidates.at(i);
+        const int score = ::fuzzyScore(entries.at(id).symbol.name, entries.at(id).key, lowerQuery);
+
+        if (score < 0) {
+            continue;
+        }
+
+        const Match match(id, score);
+
+        if (matches.size() >= maxResults && !betterThan(match, matches.last())) {
+            continue;
+        }
+
+        matches.insert(std::upper_bound(matches.begin(), matches.end(), match, betterThan), match);
+
+        if (matches.size() > maxResults) {
+            matches.removeLast();
+        }
+    }
+
+    return to;
+}
+
+SymbolIndex::Matches SymbolIndex::find(const QString &query, int maxResults) const {
+    const QVector<int> ids = candidates(query);
+    Matches result;
+    rank(ids, 0, ids.size(), query, maxResults, result);
+
+    return result;
+}
+
+int SymbolIndex::fuzzyScore(const QString &name, const QString &query) {
+    return ::fuzzyScore(name, name.toLower(), query.toLower());
+}
+
+QVector<quint64> SymbolIndex::trigrams(const QString &name, bool skipToWords) {
+    QVector<quint64> result;
+    const int size = name.size();
+
+    if (size < 3) {
+        return result;
+    }
+
+    const QString lowerName = name.toLower();
+    // the start of the next word behind the next character for every character since the next character is a successor anyway
+    QVector<int> nextWordStarts(size, -1);
+
+    if (skipToWords) {
+        int nextWordStart = -1;
+
+        for (int i = size - 1; i >= 2; i--) {
+            if (isWordStart(name, i)) {
+                nextWordStart = i;
+            }
+
+            nextWordStarts[i - 2] = nextWordStart;
+        }
+    }
+
+    auto successors = [&nextWordStarts, size](int i, int *result) {
+        int count = 0;
+
+        if (i + 1 < size) {
+            result[count++] = i + 1;
+        }
+
+        if (nextWordStarts.at(i) != -1) {
+            result[count++] = nextWordStarts.at(i);
+        }
+
+        return count;
+    };
+
+    int second[2];
+    int third[2];
+
+    for (int i = 0; i < size; i++) {
+        const int secondCount = successors(i, second);
+
+        for (int j = 0; j < secondCount; j++) {
+            const int thirdCount = successors(second[j], third);
+
+            for (int k = 0; k < thirdCount; k++) {
+                result.push_back(trigramKey(lowerName.at(i), lowerName.at(second[j]), lowerName.at(third[k])));
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    return result;
+}
+
+QVector<ushort> SymbolIndex::characters(const QString &name) {
+    QVector<ushort> result;
+    result.reserve(name.size());
+
+    for (const QChar c : name.toLower()) {
+        result.push_back(c.unicode());
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    return result;
+}
+
+SymbolIndex::Symbols SymbolIndex::symbolsFromAst(const VJassAst *ast) {
+    Symbols result;
+
+    if (ast == nullptr) {
+        return result;
+    }
+
+    for (const VJassAst *child : ast->getChildren()) {
+        const VJassNative *vjassNative = dynamic_cast<const VJassNative*>(child);
+
+        if (vjassNative != nullptr) {
+            if (!vjassNative->getIdentifier().isEmpty()) {
+                const bool isFunction = dynamic_cast<const VJassFunction*>(child) != nullptr;
+                // skips the keyword and the identifier of the declaration without converting the body of a function
+                const QString detail = vjassNative->VJassNative::toString().section(' ', 2);
+                result.push_back(Symbol(vjassNative->getIdentifier(), isFunction ? CompletionIndex::Function : CompletionIndex::Native, detail, child->getLine()));
+            }
+
+            continue;
+        }
+
+        const VJassType *type = dynamic_cast<const VJassType*>(child);
+
+        if (type != nullptr) {
+            if (!type->getIdentifier().isEmpty()) {
+                result.push_back(Symbol(type->getIdentifier(), CompletionIndex::Type, VJassToken::KEYWORD_EXTENDS + " " + type->getParent(), child->getLine()));
+            }
+
+            continue;
+        }
+
+        if (dynamic_cast<const VJassGlobals*>(child) != nullptr) {
+            for (const VJassAst *declaration : child->getChildren()) {
+                const VJassGlobal *global = dynamic_cast<const VJassGlobal*>(declaration);
+
+                if (global != nullptr && !global->getName().isEmpty()) {
+                    const QString detail = global->getIsArray() ? global->getType() + " " + VJassToken::KEYWORD_ARRAY : global->getType();
+                    result.push_back(Symbol(global->getName(), global->getIsConstant() ? CompletionIndex::Constant : CompletionIndex::Global, detail, declaration->getLine()));
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+int SymbolIndex::insertSymbol(const QString &source, const Symbol &symbol) {
+    int id = entries.size();
+
+    if (freeIds.isEmpty()) {
+        entries.push_back(Entry());
+    } else {
+        id = freeIds.takeLast();
+    }
+
+    Entry &entry = entries[id];
+    entry.symbol = symbol;
+    entry.key = symbol.name.toLower();
+    entry.source = source;
+    entry.removed = false;
+
+    // reused IDs have to be inserted at their sorted positions
+    for (quint64 trigram : trigrams(symbol.name)) {
+        QVector<int> &ids = postings[trigram];
+        ids.insert(std::lower_bound(ids.begin(), ids.end(), id), id);
+    }
+
+    for (ushort character : characters(symbol.name)) {
+        QVector<int> &ids = characterPostings[character];
+        ids.insert(std::lower_bound(ids.begin(), ids.end(), id), id);
+    }
+
+    return id;
+}
+
+void SymbolIndex::removeSymbol(int id) {
+    Entry &entry = entries[id];
+
+    for (quint64 trigram : trigrams(entry.symbol.name)) {
+        auto iterator = postings.find(trigram);
+
+        if (iterator == postings.end()) {
+            continue;
+        }
+
+        QVector<int> &ids = iterator.value();
+        auto idIterator = std::lower_bound(ids.begin(), ids.end(), id);
+
+        if (idIterator != ids.end() && *idIterator == id) {
+            ids.erase(idIterator);
+        }
+
+        if (ids.isEmpty()) {
+            postings.erase(iterator);
+        }
+    }
+
+    for (ushort character : characters(entry.symbol.name)) {
+        auto iterator = characterPostings.find(character);
+
+        if (iterator == characterPostings.end()) {
+            continue;
+        }
+
+        QVector<int> &ids = iterator.value();
+        auto idIterator = std::lower_bound(ids.begin(), ids.end(), id);
+
+        if (idIterator != ids.end() && *idIterator == id) {
+            ids.erase(idIterator);
+        }
+
+        if (ids.isEmpty()) {
+            characterPostings.erase(iterator);
+        }
+    }
+
+    entry = Entry();
+    freeIds.push_back(id);
+}
@@ -0,0 +1,135 @@
+#ifndef SYMBOLINDEX_H
+#define SYMBOLINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+#include "vjassast.h"
+#include "completionindex.h"
+
+/**
+ * @brief Finds declarations of all open documents and the standard scripts by fuzzy queries.
+ *
+ * Every symbol is indexed by the trigrams of its lower case name. Besides the trigrams of consecutive characters, a trigram may skip to the start of the next word of the name, so "crun" finds "CreateUnit".
+ * A query only visits the symbols which contain all characters of the query, so every subsequence is found. The symbols which contain all trigrams of the query are visited first since they are the best matches.
+ * The symbols are grouped by their sources. Updating a source only removes and inserts the symbols which have been changed.
+ */
+class SymbolIndex
+{
+public:
+    struct Symbol {
+        QString name;
+        CompletionIndex::Kind kind;
+        // the parameters and the return type of a function or the type of a global
+        QString detail;
+        int line;
+
+        Symbol() : kind(CompletionIndex::Function), line(0) {
+        }
+
+        Symbol(const QString &name, CompletionIndex::Kind kind, const QString &detail, int line)
+            : name(name)
+            , kind(kind)
+            , detail(detail)
+            , line(line) {
+        }
+    };
+
+    using Symbols = QVector<Symbol>;
+
+    /**
+     * @brief A symbol which matches a query. Higher scores are better.
+     */
+    struct Match {
+        int id;
+        int score;
+
+        Match() : id(-1), score(0) {
+        }
+
+        Match(int id, int score) : id(id), score(score) {
+        }
+    };
+
+    using Matches = QVector<Match>;
+
+    SymbolIndex();
+
+    /**
+     * @brief Replaces the symbols of the source. Symbols which have only moved keep their IDs and trigrams.
+     * @return Returns the number of symbols which have been removed or inserted.
+     */
+    int setSymbols(const QString &source, const Symbols &symbols);
+    void removeSource(const QString &source);
+    bool hasSource(const QString &source) const;
+    /**
+     * @return Returns the number of symbols of all sources.
+     */
+    int size() const;
+    int getTrigramsCount() const;
+
+    /**
+     * @return Returns the symbol with the ID. IDs of removed symbols are reused.
+     */
+    const Symbol& getSymbol(int id) const;
+    const QString& getSource(int id) const;
+
+    /**
+     * @return Returns the IDs of all symbols which might match the query. The sorted IDs of the symbols which contain all trigrams of the query come first, followed by the sorted IDs of the remaining ones.
+     */
+    QVector<int> candidates(const QString &query) const;
+    /**
+     * @brief Scores the candidates from the given index on and keeps the best maxResults matches sorted in matches.
+     * @return Returns the index of the next candidate.
+     */
+    int rank(const QVector<int> &candidates, int from, int count, const QString &query, int maxResults, Matches &matches) const;
+    /**
+     * @return Returns the best maxResults matches of the query sorted by their scores.
+     */
+    Matches find(const QString &query, int maxResults) const;
+
+    /**
+     * @return Returns the score of a fuzzy match or -1 if the query is no subsequence of the name ignoring the case.
+     * Matches at the start of words, consecutive matches and short names are preferred.
+     */
+    static int fuzzyScore(const QString &name, const QString &query);
+    /**
+     * @return Returns the trigrams of the lower case name. The trigrams of a query are its consecutive ones only.
+     */
+    static QVector<quint64> trigrams(const QString &name, bool skipToWords = true);
+    /**
+     * @return Returns the sorted distinct characters of the lower case name.
+     */
+    static QVector<ushort> characters(const QString &name);
+    /**
+     * @return Returns the types, natives, functions and globals of the AST.
+     */
+    static Symbols symbolsFromAst(const VJassAst *ast);
+
+private:
+    struct Entry {
+        Symbol symbol;
+        // the lower case name
+        QString key;
+        QString source;
+        bool removed;
+
+        Entry() : removed(true) {
+        }
+    };
+
+    int insertSymbol(const QString &source, const Symbol &symbol);
+    void removeSymbol(int id);
+
+    QVector<Entry> entries;
+    QVector<int> freeIds;
+    // the IDs of the symbols of every source by their kinds and names
+    QHash<QString, QHash<QString, int>> sources;
+    // sorted IDs of all symbols containing the trigram
+    QHash<quint64, QVector<int>> postings;
+    // sorted IDs of all symbols containing the lower case character
+    QHash<ushort, QVector<int>> characterPostings;
+};
+
+#endif // SYMBOLINDEX_H
@@ -0,0 +1,185 @@
+#include <QtGui>
+#include <QtWidgets>
+
+#include "symbolpalette.h"
+#include "completionmodel.h"
+
+SymbolPalette::SymbolPalette(const SymbolIndex *symbolIndex, QWidget *parent) :
+    QDialog(parent),
+    symbolIndex(symbolIndex),
+    lineEdit(new QLineEdit(this)),
+    treeWidget(new QTreeWidget(this)),
+    label(new QLabel(this)),
+    progress(0),
+    selectBestMatch(true),
+    timerId(0)
+{
+    setWindowTitle(tr("Go to Symbol"));
+    resize(600, 400);
+
+    lineEdit->setPlaceholderText(tr("Symbol"));
+    treeWidget->setColumnCount(3);
+    treeWidget->setHeaderLabels(QStringList() << tr("Symbol") << tr("Declaration") << tr("File"));
+    treeWidget->setRootIsDecorated(false);
+    treeWidget->setUniformRowHeights(true);
+    treeWidget->setFocusPolicy(Qt::NoFocus);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(lineEdit);
+    layout->addWidget(treeWidget);
+    layout->addWidget(label);
+
+    connect(lineEdit, &QLineEdit::textChanged, this, &SymbolPalette::restartSearch);
+    connect(lineEdit, &QLineEdit::returnPressed, this, [this]() {
+        activateItem(treeWidget->currentItem());
+    });
+    connect(treeWidget, &QTreeWidget::itemActivated, this, &SymbolPalette::activateItem);
+}
+
+QLineEdit* SymbolPalette::getLineEdit() const {
+    return lineEdit;
+}
+
+QTreeWidget* SymbolPalette::getTreeWidget() const {
+    return treeWidget;
+}
+
+bool SymbolPalette::isRanking() const {
+    return timerId != 0;
+}
+
+const SymbolIndex::Matches& SymbolPalette::getMatches() const {
+    return matches;
+}
+
+void SymbolPalette::setSourceTitles(const QHash<QString, QString> &sourceTitles) {
+    this->sourceTitles = sourceTitles;
+}
+
+void SymbolPalette::restartSearch() {
+    query = lineEdit->text().trimmed();
+    matches.clear();
+    progress = 0;
+    selectBestMatch = true;
+
+    // an empty query would match every symbol equally
+    if (query.isEmpty()) {
+        candidates.clear();
+    } else {
+        candidates = symbolIndex->candidates(query);
+    }
+
+    if (timerId == 0 && !candidates.isEmpty()) {
+        timerId = startTimer(0);
+    }
+
+    // the first slice is ranked immediately to show the best matches with the keystroke
+    rankSlice();
+}
+
+void SymbolPalette::showEvent(QShowEvent *event) {
+    QDialog::showEvent(event);
+
+    lineEdit->selectAll();
+    lineEdit->setFocus();
+    restartSearch();
+}
+
+void SymbolPalette::keyPressEvent(QKeyEvent *event) {
+    // the selection is moved while the focus stays in the line edit
+    if (event->key() == Qt::Key_Up || event->key() == Qt::Key_Down || event->key() == Qt::Key_PageUp || event->key() == Qt::Key_PageDown) {
+        QCoreApplication::sendEvent(treeWidget, event);
+        selectBestMatch = false;
+
+        return;
+    }
+
+    QDialog::keyPressEvent(event);
+}
+
+void SymbolPalette::timerEvent(QTimerEvent *event) {
+    if (event->timerId() == timerId) {
+        rankSlice();
+    }
+}
+
+void SymbolPalette::activateItem(QTreeWidgetItem *item) {
+    if (item == nullptr) {
+        return;
+    }
+
+    const int id = item->data(0, Qt::UserRole).toInt();
+
+    emit symbolActivated(symbolIndex->getSource(id), symbolIndex->getSymbol(id).line);
+    close();
+}
+
+void SymbolPalette::rankSlice() {
+    QElapsedTimer timer;
+    timer.start();
+
+    // yield back to the event loop after the budget so typing stays responsive
+    while (progress < candidates.size() && timer.nsecsElapsed() < RANK_BUDGET_NS) {
+        progress = symbolIndex->rank(candidates, progress, RANK_SLICE_SIZE, query, MAX_RESULTS, matches);
+    }
+
+    if (progress >= candidates.size() && timerId != 0) {
+        killTimer(timerId);
+        timerId = 0;
+    }
+
+    updateItems();
+}
+
+void SymbolPalette::updateItems() {
+    const int previousId = treeWidget->currentItem() != nullptr ? treeWidget->currentItem()->data(0, Qt::UserRole).toInt() : -1;
+
+    // there are at most MAX_RESULTS items which are reused for the matches
+    while (treeWidget->topLevelItemCount() > matches.size()) {
+        delete treeWidget->takeTopLevelItem(treeWidget->topLevelItemCount() - 1);
+    }
+
+    while (treeWidget->topLevelItemCount() < matches.size()) {
+        new QTreeWidgetItem(treeWidget);
+    }
+
+    QTreeWidgetItem *currentItem = nullptr;
+
+    for (int i = 0; i < matches.size(); i++) {
+        const SymbolIndex::Symbol &symbol = symbolIndex->getSymbol(matches.at(i).id);
+        QTreeWidgetItem *item = treeWidget->topLevelItem(i);
+        item->setText(0, symbol.name);
+        item->setText(1, CompletionModel::kindName(symbol.kind) + " " + symbol.detail);
+        item->setText(2, tr("%1:%2").arg(sourceTitle(symbolIndex->getSource(matches.at(i).id))).arg(symbol.line + 1));
+        item->setData(0, Qt::UserRole, matches.at(i).id);
+
+        if (matches.at(i).id == previousId) {
+            currentItem = item;
+        }
+    }
+
+    // the best match is selected until the user selects another one
+    if (currentItem == nullptr || selectBestMatch) {
+        currentItem = treeWidget->topLevelItem(0);
+    }
+
+    treeWidget->setCurrentItem(currentItem);
+
+    if (isRanking()) {
+        label->setText(tr("Ranked %1 of %2 symbols...").arg(progress).arg(candidates.size()));
+    } else if (!query.isEmpty()) {
+        label->setText(tr("%1 of %2 symbols").arg(matches.size()).arg(symbolIndex->size()));
+    } else {
+        label->setText(tr("%1 symbols").arg(symbolIndex->size()));
+    }
+}
+
+QString SymbolPalette::sourceTitle(const QString &source) const {
+    auto iterator = sourceTitles.constFind(source);
+
+    if (iterator != sourceTitles.cend()) {
+        return iterator.value();
+    }
+
+    return QFileInfo(source).fileName();
+}
@@ -0,0 +1,75 @@
+#ifndef SYMBOLPALETTE_H
+#define SYMBOLPALETTE_H
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QTreeWidget>
+#include <QLabel>
+
+#include "symbolindex.h"
+
+/**
+ * @brief Jumps to the declarations of a symbol index which match a fuzzy query.
+ *
+ * The candidates of a query are ranked in time slices, so the best matches found so far are shown while the remaining candidates are ranked.
+ * Every edit of the query restarts the ranking.
+ */
+class SymbolPalette : public QDialog
+{
+    Q_OBJECT
+
+public:
+    static const int MAX_RESULTS = 100;
+    static const qint64 RANK_BUDGET_NS = 2000000;
+    static const int RANK_SLICE_SIZE = 256;
+
+    explicit SymbolPalette(const SymbolIndex *symbolIndex, QWidget *parent = nullptr);
+
+    QLineEdit* getLineEdit() const;
+    QTreeWidget* getTreeWidget() const;
+    /**
+     * @return Returns true until all candidates of the current query have been ranked.
+     */
+    bool isRanking() const;
+    const SymbolIndex::Matches& getMatches() const;
+    /**
+     * @brief The titles are shown instead of the sources of the symbols. Sources without a title are shown as file names.
+     */
+    void setSourceTitles(const QHash<QString, QString> &sourceTitles);
+
+public slots:
+    /**
+     * @brief Ranks the symbols again. It has to be called whenever the symbol index has been changed.
+     */
+    void restartSearch();
+
+signals:
+    void symbolActivated(const QString &source, int line);
+
+protected:
+    virtual void showEvent(QShowEvent *event) override;
+    virtual void keyPressEvent(QKeyEvent *event) override;
+    virtual void timerEvent(QTimerEvent *event) override;
+
+private slots:
+    void activateItem(QTreeWidgetItem *item);
+
+private:
+    void rankSlice();
+    void updateItems();
+    QString sourceTitle(const QString &source) const;
+
+    const SymbolIndex *symbolIndex;
+    QLineEdit *lineEdit;
+    QTreeWidget *treeWidget;
+    QLabel *label;
+    QHash<QString, QString> sourceTitles;
+    QString query;
+    QVector<int> candidates;
+    int progress;
+    SymbolIndex::Matches matches;
+    bool selectBestMatch;
+    int timerId;
+};
+
+#endif // SYMBOLPALETTE_H
@@ -5,113 +5,158 @@
 #include "vjassscanner.h"
 #include "highlightinfo.h"
 
-SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent) : QSyntaxHighlighter(parent), currentLineStart(0), currentLineEnd(0), highlightBracketLine(-1), highlightBracketColumn(-1) {
+SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent) : QSyntaxHighlighter(parent), blockFormatCacheRevision(-1), showDiagnostics(true), deferred(false), blockFormatCacheHits(0), blockFormatCacheMisses(0) {
 }
 
 void SyntaxHighlighter::highlightBlock(const QString &text) {
     //qDebug() << "Highlight block" << text;
     //qDebug() << "Highlight block by syntax highlighter" << currentBlock().blockNumber();
 
-    // only format necessary tokens
-    VJassScanner scanner;
-    QList<VJassToken> tokens = scanner.scan(text, true);
-    HighLightInfo highLightInfo(text, tokens, nullptr, QList<VJassParseError>(), true, false);
+    if (deferred) {
+        return;
+    }
 
-    // the background color depends on whether it is the current line
-    QTextCharFormat textCharFormat = highLightInfo.getNormalFormat();
-    const int currentBlockLine = currentBlock().blockNumber();
-    const bool isCurrentLine = currentBlockLine >= currentLineStart && currentBlockLine <= currentLineEnd;
+    // prefer the runs of the background analysis and only lex blocks which have been edited since then
+    HighLightInfo::FormatRuns localFormatRuns;
+    const HighLightInfo::FormatRuns *cachedFormatRuns = lookupBlockFormatCache(text);
 
-    if (isCurrentLine) {
-        textCharFormat.setBackground(QColor(0xfaf5d4));
+    if (cachedFormatRuns != nullptr) {
+        blockFormatCacheHits++;
     } else {
-        textCharFormat.setBackground(QColor(0xffffff));
+        blockFormatCacheMisses++;
+
+        // only format necessary tokens
+        VJassScanner scanner;
+        QList<VJassToken> tokens = scanner.scan(text, true);
+        HighLightInfo highLightInfo(text, tokens, nullptr, QList<VJassParseError>(), true, false);
+        localFormatRuns = highLightInfo.getFormatRuns(0);
     }
 
-    setFormat(0, text.length(), textCharFormat);
+    // the background of the current line is painted by the text edit, so moving the cursor does not highlight any block again
+    setFormat(0, text.length(), HighLightInfo::getTextCharFormat(HighLightInfo::NoFormat));
 
-    // highlight all characters which need to be highlighted
-    const QMap<HighLightInfo::Location, HighLightInfo::CustomTextCharFormat> &formattedLocations = highLightInfo.getFormattedLocations();
+    // highlight all characters which need to be highlighted, the block contains only one line
+    const HighLightInfo::FormatRuns &formatRuns = cachedFormatRuns != nullptr ? *cachedFormatRuns : localFormatRuns;
 
-    for (auto iterator = formattedLocations.constKeyValueBegin(); iterator != formattedLocations.constKeyValueEnd(); ++iterator) {
-        const HighLightInfo::Location &location = iterator->first;
-        const HighLightInfo::CustomTextCharFormat &customTextCharFormat = iterator->second;
-        QTextCharFormat fmt = highLightInfo.getNormalFormat();
-        customTextCharFormat.applyToTextCharFormat(fmt, false);
+    for (const HighLightInfo::FormatRun &formatRun : formatRuns) {
+        setFormat(formatRun.column, formatRun.length, HighLightInfo::getTextCharFormat(formatRun.category));
+    }
 
-        if (isCurrentLine) {
-            fmt.setBackground(QColor(0xfaf5d4));
-        } else {
-            fmt.setBackground(QColor(0xffffff));
-        }
+    // the errors are only valid for blocks which have not been edited since the analysis
+    if (showDiagnostics && cachedFormatRuns != nullptr) {
+        highlightDiagnostics(text, formatRuns);
+    }
+}
+
+void SyntaxHighlighter::setBlockFormatCache(const HighLightInfo &highLightInfo, int revision) {
+    const QVector<HighLightInfo::FormatRuns> &formatRunsByLine = highLightInfo.getFormatRunsByLine();
+    const QVector<uint> &lineHashes = highLightInfo.getLineHashes();
+
+    blockFormatCache.clear();
+    blockFormatCache.reserve(lineHashes.size());
 
-        setFormat(location.column, customTextCharFormat.length, fmt);
+    for (int line = 0; line < lineHashes.size(); line++) {
+        blockFormatCache.push_back(BlockFormatCacheEntry(lineHashes.at(line), line < formatRunsByLine.size() ? formatRunsByLine.at(line) : HighLightInfo::FormatRuns()));
     }
 
-    if (highlightBracketLine != -1 && highlightBracketColumn != -1 && currentBlock().blockNumber() == highlightBracketLine) {
-        QTextCharFormat fmt = format(highlightBracketColumn);
-        fmt.setBackground(Qt::green);
-        setFormat(highlightBracketColumn, 1, fmt);
+    blockFormatCacheRevision = revision;
+    diagnosticsIndex = highLightInfo.getDiagnosticsIndex();
+    blockFormatCacheHits = 0;
+    blockFormatCacheMisses = 0;
+}
 
-        const QString highlightedBracket = text.mid(highlightBracketColumn, 1);
+void SyntaxHighlighter::clearBlockFormatCache() {
+    blockFormatCache.clear();
+    blockFormatCacheRevision = -1;
+    diagnosticsIndex = DiagnosticsIndex();
+}
 
-        //qDebug() << "Highlighted bracket" << highlightedBracket;
+void SyntaxHighlighter::setShowDiagnostics(bool showDiagnostics) {
+    this->showDiagnostics = showDiagnostics;
+}
 
-        if (highlightedBracket == "(" || highlightedBracket == "[") {
-            const QString openingBracket = highlightedBracket;
-            const QString closingBracket = highlightedBracket == "(" ? ")" : "]";
-            int foundOpeningBrackets = 0;
-            int foundClosingBrackets = 0;
+bool SyntaxHighlighter::getShowDiagnostics() const {
+    return showDiagnostics;
+}
 
-            for (int i = highlightBracketColumn; i < text.length(); i++) {
-                if (text.mid(i, 1) == openingBracket) {
-                    foundOpeningBrackets++;
-                } else if (text.mid(i, 1) == closingBracket) {
-                    foundClosingBrackets++;
+void SyntaxHighlighter::setDeferred(bool deferred) {
+    this->deferred = deferred;
+}
 
-                    if (foundClosingBrackets == foundOpeningBrackets) {
-                        QTextCharFormat fmt = format(i);
-                        fmt.setBackground(Qt::green);
-                        setFormat(i, 1, fmt);
+bool SyntaxHighlighter::isDeferred() const {
+    return deferred;
+}
 
-                        break;
-                    }
-                }
-            }
-        } else if (highlightedBracket == ")" || highlightedBracket == "]") {
-            const QString openingBracket = highlightedBracket == ")" ? "(" : "[";
-            const QString closingBracket = highlightedBracket;
-            int foundOpeningBrackets = 0;
-            int foundClosingBrackets = 0;
-
-            for (int i = highlightBracketColumn; i >= 0; i--) {
-                if (text.mid(i, 1) == closingBracket) {
-                    foundClosingBrackets++;
-                } else if (text.mid(i, 1) == openingBracket) {
-                    foundOpeningBrackets++;
-
-                    if (foundClosingBrackets == foundOpeningBrackets) {
-                        QTextCharFormat fmt = format(i);
-                        fmt.setBackground(Qt::green);
-                        setFormat(i, 1, fmt);
-
-                        break;
-                    }
-                }
-            }
-        }
-    }
+int SyntaxHighlighter::getBlockFormatCacheRevision() const {
+    return blockFormatCacheRevision;
 }
 
-void SyntaxHighlighter::setCurrentLineStart(int currentLineStart) {
-    this->currentLineStart = currentLineStart;
+int SyntaxHighlighter::getBlockFormatCacheHits() const {
+    return blockFormatCacheHits;
 }
 
-void SyntaxHighlighter::setCurrentLineEnd(int currentLineEnd) {
-    this->currentLineEnd = currentLineEnd;
+int SyntaxHighlighter::getBlockFormatCacheMisses() const {
+    return blockFormatCacheMisses;
 }
 
-void SyntaxHighlighter::setHighlightBracketPosition(int highlightBracketLine, int highlightBracketColumn) {
-    this->highlightBracketLine = highlightBracketLine;
-    this->highlightBracketColumn = highlightBracketColumn;
+const HighLightInfo::FormatRuns* SyntaxHighlighter::lookupBlockFormatCache(const QString &text) const {
+    const QTextBlock block = currentBlock();
+    const int blockNumber = block.blockNumber();
+
+    // the block must not have been edited after the text has been sent for the analysis
+    if (blockNumber < 0 || blockNumber >= blockFormatCache.size() || block.revision() > blockFormatCacheRevision) {
+        return nullptr;
+    }
+
+    const BlockFormatCacheEntry &entry = blockFormatCache.at(blockNumber);
+
+    // lines might have been inserted or removed before this block
+    if (entry.textHash != HighLightInfo::lineHash(QStringView(text))) {
+        return nullptr;
+    }
+
+    return &entry.formatRuns;
+}
+
+void SyntaxHighlighter::highlightDiagnostics(const QString &text, const HighLightInfo::FormatRuns &formatRuns) {
+    const int line = currentBlock().blockNumber();
+    const int rangesEnd = diagnosticsIndex.getRangesEnd(line);
+
+    for (int i = diagnosticsIndex.getRangesBegin(line); i < rangesEnd; i++) {
+        const DiagnosticsIndex::Range &range = diagnosticsIndex.getRange(i);
+        // errors at the end of the line underline at least the last character
+        const int column = qMax(0, qMin(range.column, text.length() - 1));
+        const int end = range.length == -1 ? text.length() : qMin(text.length(), column + qMax(1, range.length));
+
+        // keep the formats of the tokens and add the underline only, the range is split at the boundaries of the format runs
+        int position = column;
+        int run = 0;
+
+        while (position < end) {
+            while (run < formatRuns.size() && formatRuns.at(run).column + formatRuns.at(run).length <= position) {
+                run++;
+            }
+
+            HighLightInfo::FormatCategory category = HighLightInfo::NoFormat;
+            int segmentEnd = end;
+
+            if (run < formatRuns.size()) {
+                const HighLightInfo::FormatRun &formatRun = formatRuns.at(run);
+
+                if (formatRun.column <= position) {
+                    category = formatRun.category;
+                    segmentEnd = qMin(end, formatRun.column + formatRun.length);
+                } else {
+                    // the characters in front of the next run are not formatted
+                    segmentEnd = qMin(end, formatRun.column);
+                }
+            }
+
+            QTextCharFormat fmt = HighLightInfo::getTextCharFormat(category);
+            fmt.setUnderlineColor(Qt::red);
+            fmt.setUnderlineStyle(QTextCharFormat::WaveUnderline);
+            setFormat(position, segmentEnd - position, fmt);
+            position = segmentEnd;
+        }
+    }
 }
@@ -3,6 +3,8 @@
 
 #include <QSyntaxHighlighter>
 
+#include "highlightinfo.h"
+
 class SyntaxHighlighter : public QSyntaxHighlighter
 {
     Q_OBJECT
@@ -10,18 +12,55 @@ class SyntaxHighlighter : public QSyntaxHighlighter
 public:
     SyntaxHighlighter(QTextDocument *parent);
 
-    void setCurrentLineStart(int currentLineStart);
-    void setCurrentLineEnd(int currentLineEnd);
-    void setHighlightBracketPosition(int line, int column);
+    /**
+     * @brief Fills the block format cache with the format runs of the background analysis.
+     * @param revision The revision of the document when its text has been sent for the analysis. Blocks which have been edited afterwards are lexed locally again.
+     */
+    void setBlockFormatCache(const HighLightInfo &highLightInfo, int revision);
+    void clearBlockFormatCache();
+
+    /**
+     * @brief Enables underlining the errors of the diagnostics index which is filled together with the block format cache.
+     */
+    void setShowDiagnostics(bool showDiagnostics);
+    bool getShowDiagnostics() const;
+
+    /**
+     * @brief Skips highlighting blocks while a file is loaded. The blocks have to be highlighted again afterwards.
+     */
+    void setDeferred(bool deferred);
+    bool isDeferred() const;
+
+    int getBlockFormatCacheRevision() const;
+    int getBlockFormatCacheHits() const;
+    int getBlockFormatCacheMisses() const;
 
 protected:
     virtual void highlightBlock(const QString &text) override;
 
 private:
-    int currentLineStart;
-    int currentLineEnd;
-    int highlightBracketLine;
-    int highlightBracketColumn;
+    struct BlockFormatCacheEntry {
+        uint textHash;
+        HighLightInfo::FormatRuns formatRuns;
+
+        BlockFormatCacheEntry() : textHash(0) {
+        }
+
+        BlockFormatCacheEntry(uint textHash, const HighLightInfo::FormatRuns &formatRuns) : textHash(textHash), formatRuns(formatRuns) {
+        }
+    };
+
+    const HighLightInfo::FormatRuns* lookupBlockFormatCache(const QString &text) const;
+    void highlightDiagnostics(const QString &text, const HighLightInfo::FormatRuns &formatRuns);
+
+    // the index is the block number
+    QVector<BlockFormatCacheEntry> blockFormatCache;
+    int blockFormatCacheRevision;
+    DiagnosticsIndex diagnosticsIndex;
+    bool showDiagnostics;
+    bool deferred;
+    int blockFormatCacheHits;
+    int blockFormatCacheMisses;
 };
 
 #endif // SYNTAXHIGHLIGHTER_H
@@ -13,6 +13,116 @@ TextEdit::TextEdit(QWidget *parent) : QPlainTextEdit(parent), pressedControl(fal
 TextEdit::~TextEdit() {
 }
 
+QTextBlock TextEdit::getFirstVisibleBlock() const {
+    return firstVisibleBlock();
+}
+
+QRectF TextEdit::getBlockBoundingGeometry(const QTextBlock &block) const {
+    return blockBoundingGeometry(block);
+}
+
+QPointF TextEdit::getContentOffset() const {
+    return contentOffset();
+}
+
+void TextEdit::fold(int firstLine, int lastLine) {
+    const QTextBlock firstBlock = document()->findBlockByNumber(firstLine);
+    const QTextBlock lastBlock = document()->findBlockByNumber(qMin(lastLine, blockCount() - 1));
+
+    if (!firstBlock.isValid() || !lastBlock.isValid() || lastBlock.blockNumber() <= firstLine) {
+        return;
+    }
+
+    // the cursor must not stay in a hidden block
+    const int cursorLine = textCursor().blockNumber();
+
+    if (cursorLine > firstLine && cursorLine <= lastBlock.blockNumber()) {
+        QTextCursor cursor(firstBlock);
+        cursor.movePosition(QTextCursor::EndOfBlock);
+        setTextCursor(cursor);
+    }
+
+    setBlocksVisible(firstBlock.next(), lastBlock, false);
+}
+
+void TextEdit::foldAll(const FoldRangeIndex &foldRangeIndex) {
+    int lastFoldedLine = -1;
+
+    for (const FoldRangeIndex::FoldRange &range : foldRangeIndex.getRanges()) {
+        // nested ranges are hidden by their outer range
+        if (range.startLine > lastFoldedLine && range.startLine < blockCount()) {
+            const int lastLine = qMin(range.endLine, blockCount() - 1);
+
+            for (QTextBlock block = document()->findBlockByNumber(range.startLine + 1); block.isValid() && block.blockNumber() <= lastLine; block = block.next()) {
+                block.setVisible(false);
+            }
+
+            lastFoldedLine = lastLine;
+        }
+    }
+
+    if (!textCursor().block().isVisible()) {
+        unfoldBlock(textCursor().block());
+    }
+
+    // lay out the whole document only once
+    document()->markContentsDirty(0, document()->characterCount());
+    viewport()->update();
+}
+
+void TextEdit::unfold(int line) {
+    const QTextBlock block = document()->findBlockByNumber(line);
+
+    if (block.isValid() && block.next().isValid() && !block.next().isVisible()) {
+        QTextBlock last = block.next();
+
+        while (last.next().isValid() && !last.next().isVisible()) {
+            last = last.next();
+        }
+
+        setBlocksVisible(block.next(), last, true);
+    }
+}
+
+void TextEdit::unfoldAll() {
+    for (QTextBlock block = document()->firstBlock(); block.isValid(); block = block.next()) {
+        block.setVisible(true);
+    }
+
+    document()->markContentsDirty(0, document()->characterCount());
+    viewport()->update();
+}
+
+bool TextEdit::isFolded(int line) const {
+    const QTextBlock next = document()->findBlockByNumber(line + 1);
+
+    return next.isValid() && !next.isVisible();
+}
+
+void TextEdit::unfoldBlock(const QTextBlock &block) {
+    QTextBlock first = block;
+
+    while (first.isValid() && !first.isVisible()) {
+        first = first.previous();
+    }
+
+    if (first.isValid()) {
+        unfold(first.blockNumber());
+    }
+}
+
+void TextEdit::setBlocksVisible(QTextBlock first, const QTextBlock &last, bool visible) {
+    const int position = first.position();
+
+    for ( ; first.isValid() && first.blockNumber() <= last.blockNumber(); first = first.next()) {
+        first.setVisible(visible);
+    }
+
+    // only relayouts the blocks without changing the text or the undo stack
+    document()->markContentsDirty(position, last.position() + last.length() - position);
+    viewport()->update();
+}
+
 void TextEdit::keyPressEvent(QKeyEvent *e) {
     //qDebug() << "Key press event in plain text edit with key" << e->key() << "which is in hex" << QString::to (e->key()).toInt(16);
 
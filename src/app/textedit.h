@@ -3,6 +3,8 @@
 
 #include <QPlainTextEdit>
 
+#include "foldrangeindex.h"
+
 class TextEdit : public QPlainTextEdit
 {
     Q_OBJECT
@@ -11,11 +13,46 @@ public:
     TextEdit(QWidget *parent);
     virtual ~TextEdit();
 
+    /*
+     * Make the geometry of the visible blocks available for painting the line numbers.
+     */
+    QTextBlock getFirstVisibleBlock() const;
+    QRectF getBlockBoundingGeometry(const QTextBlock &block) const;
+    QPointF getContentOffset() const;
+
+    /**
+     * @brief Hides the blocks after the first line up to the last line.
+     * Hidden blocks have no height in the document layout, so they are neither laid out nor painted.
+     */
+    void fold(int firstLine, int lastLine);
+    /**
+     * @brief Folds the outermost ranges of the index at once.
+     */
+    void foldAll(const FoldRangeIndex &foldRangeIndex);
+    /**
+     * @brief Shows all hidden blocks which follow the line.
+     */
+    void unfold(int line);
+    void unfoldAll();
+    /**
+     * @return Returns true if the block after the line is hidden.
+     */
+    bool isFolded(int line) const;
+    /**
+     * @brief Shows the hidden blocks around the block, so it can be edited.
+     */
+    void unfoldBlock(const QTextBlock &block);
+
 protected:
     virtual void keyPressEvent(QKeyEvent *e) override;
     virtual void keyReleaseEvent(QKeyEvent *e) override;
 
 private:
+    /**
+     * @brief Changes the visibility of the blocks from the first up to the last block and lets the document layout update their heights.
+     */
+    void setBlocksVisible(QTextBlock first, const QTextBlock &last, bool visible);
+
     bool pressedControl;
 };
 
@@ -9,6 +9,8 @@ VJassAst::VJassAst(int line, int column)
     , codeCompletionSuggestions()
     , line(line)
     , column(column)
+    , endLine(line)
+    , endColumn(column)
     , comments()
 {
 }
@@ -19,6 +21,8 @@ VJassAst::VJassAst(const VJassAst &other)
   , codeCompletionSuggestions(other.getCodeCompletionSuggestions())
   , line(other.getLine())
   , column(other.getColumn())
+  , endLine(other.getEndLine())
+  , endColumn(other.getEndColumn())
   , comments(other.getComments())
 {
 }
@@ -29,6 +33,8 @@ VJassAst& VJassAst::operator=(const VJassAst &other) {
     this->codeCompletionSuggestions = other.getCodeCompletionSuggestions();
     this->line = other.getLine();
     this->column = other.getColumn();
+    this->endLine = other.getEndLine();
+    this->endColumn = other.getEndColumn();
     this->comments = other.getComments();
 
     return *this;
@@ -90,13 +96,67 @@ int VJassAst::getColumn() const {
     return column;
 }
 
+void VJassAst::setEnd(int endLine, int endColumn) {
+    this->endLine = endLine;
+    this->endColumn = endColumn;
+}
+
+void VJassAst::extendEndTo(const VJassToken &token) {
+    const QString &value = token.getValue();
+    const int lineBreaks = value.count(QLatin1Char('\n'));
+    const int tokenEndLine = token.getLine() + lineBreaks;
+    const int tokenEndColumn = lineBreaks > 0 ? value.length() - value.lastIndexOf(QLatin1Char('\n')) - 1 : token.getColumn() + value.length();
+
+    if (tokenEndLine > endLine || (tokenEndLine == endLine && tokenEndColumn > endColumn)) {
+        setEnd(tokenEndLine, tokenEndColumn);
+    }
+}
+
+void VJassAst::extendEndUntil(const VJassToken &token) {
+    if (token.getLine() > endLine || (token.getLine() == endLine && token.getColumn() > endColumn)) {
+        setEnd(token.getLine(), token.getColumn());
+    }
+}
+
+void VJassAst::extendEndsByChildren() {
+    for (VJassAst *child : children) {
+        child->extendEndsByChildren();
+
+        if (child->getEndLine() > endLine || (child->getEndLine() == endLine && child->getEndColumn() > endColumn)) {
+            setEnd(child->getEndLine(), child->getEndColumn());
+        }
+    }
+}
+
+int VJassAst::getEndLine() const {
+    return endLine;
+}
+
+int VJassAst::getEndColumn() const {
+    return endColumn;
+}
+
+bool VJassAst::contains(int line, int column) const {
+    const bool afterStart = line > this->line || (line == this->line && column >= this->column);
+    const bool beforeEnd = line < this->endLine || (line == this->endLine && column < this->endColumn);
+
+    return afterStart && beforeEnd;
+}
+
 void VJassAst::addError(int line, int column, int length, const QString &error) {
     this->errors.push_back(VJassParseError(line, column, length, error));
 }
 
 void VJassAst::addError(const VJassToken &token, const QString &error) {
-    // TODO Handle multiple lines.
-    this->errors.push_back(VJassParseError(token.getLine(), token.getColumn(), token.getLength(), error));
+    const QString &value = token.getValue();
+    const int lineBreaks = value.count(QLatin1Char('\n'));
+
+    // tokens like block comments might span multiple lines
+    if (lineBreaks > 0) {
+        this->errors.push_back(VJassParseError(token.getLine(), token.getColumn(), token.getLine() + lineBreaks, value.length() - value.lastIndexOf(QLatin1Char('\n')) - 1, error));
+    } else {
+        this->errors.push_back(VJassParseError(token.getLine(), token.getColumn(), token.getLength(), error));
+    }
 }
 
 void VJassAst::addErrorAtEndOf(const VJassToken &token, const QString &error) {
@@ -163,12 +223,6 @@ QList<VJassAst*> VJassAst::getAllMatching(std::function<bool(VJassAst*)> &&f) {
 
 void VJassAst::sortByPosition(QList<VJassAst*> &list) {
     std::sort(list.begin(), list.end(), [](VJassAst *e1, VJassAst *e2) {
-       const int lineDiff = e1->getLine() - e2->getLine();
-
-       if (lineDiff == 0) {
-           return e1->getColumn() - e2->getColumn();
-       }
-
-       return lineDiff;
+       return e1->getLine() < e2->getLine() || (e1->getLine() == e2->getLine() && e1->getColumn() < e2->getColumn());
     });
 }
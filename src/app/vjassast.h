@@ -24,6 +24,27 @@ public:
     int getLine() const;
     int getColumn() const;
 
+    /**
+     * The source span of the element ranges from its line and column up to its end line and end column (exclusive).
+     * It includes the spans of all children.
+     */
+    void setEnd(int endLine, int endColumn);
+    /**
+     * @brief Extends the span to the end of the given token if it ends after the current end.
+     */
+    void extendEndTo(const VJassToken &token);
+    /**
+     * @brief Extends the span until the start of the given token if it starts after the current end.
+     */
+    void extendEndUntil(const VJassToken &token);
+    /**
+     * @brief Extends the spans of this element and all of its descendants to include the spans of their children.
+     */
+    void extendEndsByChildren();
+    int getEndLine() const;
+    int getEndColumn() const;
+    bool contains(int line, int column) const;
+
     void addError(int line, int column, int length, const QString &error);
     void addError(const VJassToken &token, const QString &error);
     void addErrorAtEndOf(const VJassToken &token, const QString &error);
@@ -49,6 +70,8 @@ private:
     QList<VJassAst*> codeCompletionSuggestions;
     int line = 0;
     int column = 0;
+    int endLine = 0;
+    int endColumn = 0;
     QList<QString> comments;
 };
 
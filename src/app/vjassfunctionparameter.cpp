@@ -5,6 +5,14 @@ VJassFunctionParameter::VJassFunctionParameter(int line, int column, const QStri
 
 }
 
+const QString& VJassFunctionParameter::getType() const {
+    return type;
+}
+
+const QString& VJassFunctionParameter::getName() const {
+    return name;
+}
+
 QString VJassFunctionParameter::toString() const {
     return type + " " + name;
 }
@@ -10,6 +10,9 @@ class VJassFunctionParameter : public VJassAst
 public:
     VJassFunctionParameter(int line, int column, const QString &type, const QString &name);
 
+    const QString& getType() const;
+    const QString& getName() const;
+
     virtual QString toString() const override;
 
 private:
@@ -1,19 +1,25 @@
 #include "vjassparseerror.h"
 
-VJassParseError::VJassParseError() : line(0), column(0), length(0) {
+VJassParseError::VJassParseError() : line(0), column(0), length(0), endLine(0), endColumn(0) {
 }
 
-VJassParseError::VJassParseError(int line, int column, int length, const QString &error) : line(line), column(column), length(length), error(error) {
+VJassParseError::VJassParseError(int line, int column, int length, const QString &error) : line(line), column(column), length(length), endLine(line), endColumn(column + length), error(error) {
 }
 
-VJassParseError::VJassParseError(const VJassParseError &other) : line(other.getLine()), column(other.getColumn()), length(other.getLength()), error(other.getError()) {
+VJassParseError::VJassParseError(int line, int column, int endLine, int endColumn, const QString &error) : line(line), column(column), length(endLine == line ? endColumn - column : -1), endLine(endLine), endColumn(endColumn), error(error) {
+}
+
+VJassParseError::VJassParseError(const VJassParseError &other) : line(other.getLine()), column(other.getColumn()), length(other.getLength()), endLine(other.getEndLine()), endColumn(other.getEndColumn()), error(other.getError()), severity(other.getSeverity()) {
 }
 
 VJassParseError& VJassParseError::operator=(const VJassParseError &other) {
     this->line = other.getLine();
     this->column = other.getColumn();
     this->length = other.getLength();
+    this->endLine = other.getEndLine();
+    this->endColumn = other.getEndColumn();
     this->error = other.getError();
+    this->severity = other.getSeverity();
 
     return *this;
 }
@@ -33,3 +39,23 @@ const QString& VJassParseError::getError() const {
 int VJassParseError::getLength() const {
     return length;
 }
+
+int VJassParseError::getEndLine() const {
+    return endLine;
+}
+
+int VJassParseError::getEndColumn() const {
+    return endColumn;
+}
+
+bool VJassParseError::isMultiLine() const {
+    return endLine > line;
+}
+
+void VJassParseError::setSeverity(Severity severity) {
+    this->severity = severity;
+}
+
+VJassParseError::Severity VJassParseError::getSeverity() const {
+    return severity;
+}
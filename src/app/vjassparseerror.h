@@ -3,12 +3,23 @@
 
 #include <QString>
 
+/**
+ * @brief A parse error which spans from its line and column up to its end line and end column (exclusive).
+ */
 class VJassParseError
 {
 public:
+    enum Severity {
+        Error,
+        Warning
+    };
+
     VJassParseError();
-    // TODO handle errors over multiple lines
     VJassParseError(int line, int column, int length, const QString &error);
+    /**
+     * @brief Creates an error which might span over multiple lines.
+     */
+    VJassParseError(int line, int column, int endLine, int endColumn, const QString &error);
     VJassParseError(const VJassParseError &other);
     VJassParseError& operator=(const VJassParseError &other);
 
@@ -16,13 +27,25 @@ public:
     int getColumn() const;
     const QString& getError() const;
 
+    /**
+     * @return Returns the number of characters of the error in its first line. Returns -1 if the error continues until the end of the first line.
+     */
     int getLength() const;
+    int getEndLine() const;
+    int getEndColumn() const;
+    bool isMultiLine() const;
+
+    void setSeverity(Severity severity);
+    Severity getSeverity() const;
 
 private:
     int line = 0;
     int column = 0;
     int length = 0;
+    int endLine = 0;
+    int endColumn = 0;
     QString error;
+    Severity severity = Error;
 };
 
 #endif // VJASSPARSEERROR_H
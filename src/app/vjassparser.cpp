@@ -66,6 +66,7 @@ inline void suggestLineStartKeywords(bool isInFunction, bool isInGlobals, VJassA
 }
 
 inline void parseFunctionDeclaration(const QList<VJassToken> &tokens, const VJassToken &token, VJassNative *vjassFunction, VJassAst *ast, int &i) {
+    vjassFunction->extendEndTo(token);
     i++;
 
     if (i == tokens.size()) {
@@ -75,6 +76,7 @@ inline void parseFunctionDeclaration(const QList<VJassToken> &tokens, const VJas
 
         if (identifier.isValidIdentifier()) {
             vjassFunction->setIdentifier(identifier.getValue());
+            vjassFunction->extendEndTo(identifier);
             i++;
 
             if (i == tokens.size()) {
@@ -89,6 +91,8 @@ inline void parseFunctionDeclaration(const QList<VJassToken> &tokens, const VJas
                 if (takesKeyword.getType() != VJassToken::TakesKeyword) {
                     vjassFunction->addError(takesKeyword, "Expected takes keyword instead of " + takesKeyword.getValue());
                 } else {
+                    vjassFunction->extendEndTo(takesKeyword);
+
                     if (i == tokens.size()) {
                         vjassFunction->addErrorAtEndOf(takesKeyword, "Missing parameters.");
                     // function parameters
@@ -123,6 +127,7 @@ inline void parseFunctionDeclaration(const QList<VJassToken> &tokens, const VJas
 
                                     if (parameterName.isValidIdentifier()) {
                                         vjassFunction->addParameter(parameterType.getLine(), parameterType.getColumn(), parameterType.getValue(), parameterName.getValue());
+                                        vjassFunction->extendEndTo(parameterName);
                                     } else {
                                         vjassFunction->addErrorAtEndOf(parameterName, "Invalid parameter name: " + parameterName.getValue());
                                         gotError = true;
@@ -167,6 +172,7 @@ inline void parseFunctionDeclaration(const QList<VJassToken> &tokens, const VJas
                             } else {
                                 const VJassToken &returnType = tokens.at(i);
                                 vjassFunction->setReturnType(returnType.getValue());
+                                vjassFunction->extendEndTo(returnType);
 
                                 if (returnType.getType() != VJassToken::NothingKeyword && !returnType.isValidType()) {
                                     vjassFunction->addErrorAtEndOf(returnType, QObject::tr("Invalid return type: %1").arg(returnType.getValue()));
@@ -234,6 +240,7 @@ inline VJassExpression* parseExpression(const QList<VJassToken> &tokens, const V
 
                     result = new VJassExpression(nextToken.getLine(), nextToken.getColumn());
                     result->setType(VJassExpression::Brackets);
+                    result->extendEndTo(tokens.at(rightBracketIndex));
 
                     // get all expressions in between the brackets, parseExpression starts one token after i, stop one index before the right bracket
                     while (i < rightBracketIndex - 1 && !hasReachedEndOfLine(tokens, i)) {
@@ -283,6 +290,7 @@ inline VJassExpression* parseExpression(const QList<VJassToken> &tokens, const V
                 } else {
                     result = new VJassExpression(nextToken.getLine(), nextToken.getColumn());
                     result->setType(VJassExpression::ArrayAccess);
+                    result->extendEndTo(tokens.at(rightSquareBracketIndex));
 
                     VJassAst *child = parseExpression(tokens, nextToken, result, i);
 
@@ -333,7 +341,7 @@ inline VJassExpression* parseExpression(const QList<VJassToken> &tokens, const V
             }
             case VJassToken::Text: {
                 // identifier only (for example on return or an if statement with only a boolean variable)
-                result = new VJassExpression(token.getLine(), token.getColumn());
+                result = new VJassExpression(nextToken.getLine(), nextToken.getColumn());
                 result->setType(VJassExpression::Identifier);
                 result->setValue(nextToken.getValue());
 
@@ -410,6 +418,11 @@ inline VJassExpression* parseExpression(const QList<VJassToken> &tokens, const V
             }
         }
 
+        // the spans of composed expressions are extended by their children after parsing
+        if (result != nullptr) {
+            result->extendEndTo(nextToken);
+        }
+
         // some tokens can have following tokens which lead to whole expressions
         if (
                 nextToken.getType() == VJassToken::Text
@@ -558,6 +571,44 @@ inline VJassExpression* parseExpression(const QList<VJassToken> &tokens, const V
     return result;
 }
 
+/**
+ * @brief Ends the span of the previous elseif or else branch of the if statement at the start of the given token.
+ */
+inline void endIfBranch(VJassStatement *ifStatement, const VJassToken &token) {
+    if (!ifStatement->getChildren().isEmpty()) {
+        VJassStatement *branch = dynamic_cast<VJassStatement*>(ifStatement->getChildren().last());
+
+        if (branch != nullptr && (branch->getType() == VJassStatement::Elseif || branch->getType() == VJassStatement::Else)) {
+            branch->extendEndUntil(token);
+        }
+    }
+}
+
+/**
+ * Adds the native or function to the symbol table. A function starts a new scope with its parameters.
+ */
+inline void declareFunction(VJassSymbolTable *symbolTable, const VJassNative *vjassNative, bool isFunction) {
+    if (symbolTable == nullptr || vjassNative->getIdentifier().isEmpty()) {
+        return;
+    }
+
+    symbolTable->addDeclaration(vjassNative->getIdentifier(), isFunction ? VJassSymbolTable::Function : VJassSymbolTable::Native, vjassNative->getLine());
+
+    if (isFunction) {
+        symbolTable->beginFunction(vjassNative->getIdentifier(), vjassNative->getLine());
+
+        for (const VJassFunctionParameter &parameter : vjassNative->getParameters()) {
+            symbolTable->addFunctionDeclaration(parameter.getName(), VJassSymbolTable::Parameter, vjassNative->getLine());
+        }
+    }
+}
+
+inline void declareGlobal(VJassSymbolTable *symbolTable, const VJassGlobal *global) {
+    if (symbolTable != nullptr && !global->getName().isEmpty()) {
+        symbolTable->addDeclaration(global->getName(), global->getIsConstant() ? VJassSymbolTable::Constant : VJassSymbolTable::Global, global->getLine());
+    }
+}
+
 inline VJassGlobal* parseGlobal(bool isConstant, int line, int column, const VJassToken &type, const QList<VJassToken> &tokens, VJassAst *ast, int &i, bool &wasLineBreak) {
     if (!type.isValidType()) {
         ast->addError(type, QObject::tr("Invalid type of global: %1.").arg(type.getValue()));
@@ -575,11 +626,13 @@ inline VJassGlobal* parseGlobal(bool isConstant, int line, int column, const VJa
         VJassGlobal *global = new VJassGlobal(line, column);
         global->setIsConstant(isConstant);
         global->setType(type.getValue());
+        global->extendEndTo(type);
 
         const VJassToken &arrayToken = tokens.at(i);
 
         if (arrayToken.getType() == VJassToken::ArrayKeyword) {
             global->setIsArray(true);
+            global->extendEndTo(arrayToken);
             i++;
         }
 
@@ -587,6 +640,7 @@ inline VJassGlobal* parseGlobal(bool isConstant, int line, int column, const VJa
             ast->addErrorAtEndOf(arrayToken, QObject::tr("Missing identifier of global variable."));
         } else {
             const VJassToken &nameToken = tokens.at(i);
+            global->extendEndTo(nameToken);
 
             if (!nameToken.isValidIdentifier()) {
                 ast->addError(nameToken, QObject::tr("Invalid identifier for global %1").arg(nameToken.getValue()));
@@ -630,8 +684,17 @@ inline VJassGlobal* parseGlobal(bool isConstant, int line, int column, const VJa
 
 }
 
-VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
+VJassAst* VJassParser::parse(const QList<VJassToken> &tokens, FoldRangeIndex *foldRangeIndex, VJassSymbolTable *symbolTable) {
     VJassAst *ast = new VJassAst(0, 0);
+
+    if (foldRangeIndex != nullptr) {
+        foldRangeIndex->clear();
+    }
+
+    if (symbolTable != nullptr) {
+        symbolTable->clear();
+    }
+
     bool isInFunction = false;
     bool afterLocalsInFunction = false;
     QStack<VJassStatement*> ifStatements;
@@ -653,6 +716,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
             }
             case VJassToken::TypeKeyword: {
                 VJassType *vjassType = new VJassType(token.getLine(), token.getColumn());
+                vjassType->extendEndTo(token);
 
                 if (isInFunction) {
                     vjassType->addError(token, "Cannot declare a type inside of a function.");
@@ -669,6 +733,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
 
                     if (typeName.isValidIdentifier()) {
                         vjassType->setIdentifier(typeName.getValue());
+                        vjassType->extendEndTo(typeName);
 
                         i++;
 
@@ -696,6 +761,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                                         vjassType->addError(parentType, "Invalid parent type identifier " + parentType.getValue());
                                     } else {
                                         vjassType->setParent(parentType.getValue());
+                                        vjassType->extendEndTo(parentType);
                                     }
                                 }
                             }
@@ -707,6 +773,10 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                     }
                 }
 
+                if (symbolTable != nullptr && !vjassType->getIdentifier().isEmpty()) {
+                    symbolTable->addDeclaration(vjassType->getIdentifier(), VJassSymbolTable::Type, vjassType->getLine());
+                }
+
                 ast->addChild(vjassType);
 
                 break;
@@ -723,6 +793,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                         VJassGlobal *global = parseGlobal(true, token.getLine(), token.getColumn(), type, tokens, ast, i, wasLineBreak);
 
                         if (global != nullptr) {
+                            declareGlobal(symbolTable, global);
                             currentGlobals->addChild(global);
                         }
                     }
@@ -745,6 +816,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                             isInFunction = true;
                             currentFunction = vjassFunction;
                             parseFunctionDeclaration(tokens, token, vjassFunction, ast, i);
+                            declareFunction(symbolTable, vjassFunction, true);
 
                             ast->addChild(vjassFunction);
                         } else if (functionKeyword.getType() == VJassToken::NativeKeyword) {
@@ -755,6 +827,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                             }
 
                             parseFunctionDeclaration(tokens, token, vjassNative, ast, i);
+                            declareFunction(symbolTable, vjassNative, false);
 
                             ast->addChild(vjassNative);
                         } else {
@@ -775,6 +848,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                 }
 
                 parseFunctionDeclaration(tokens, token, vjassNative, ast, i);
+                declareFunction(symbolTable, vjassNative, false);
 
                 ast->addChild(vjassNative);
 
@@ -782,6 +856,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
             }
             case VJassToken::GlobalsKeyword: {
                 VJassGlobals *vjassGlobals = new VJassGlobals(token.getLine(), token.getColumn());
+                vjassGlobals->extendEndTo(token);
 
                 if (isInFunction) {
                     vjassGlobals->addError(token, QObject::tr("Cannot declare globals inside of function."));
@@ -799,6 +874,12 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
             case VJassToken::EndglobalsKeyword: {
                 if (!isInGlobals) {
                     ast->addError(token, QObject::tr("Unable to close globals when no globals were declared."));
+                } else if (currentGlobals != nullptr) {
+                    currentGlobals->extendEndTo(token);
+
+                    if (foldRangeIndex != nullptr) {
+                        foldRangeIndex->addRange(currentGlobals->getLine(), token.getLine());
+                    }
                 }
 
                 isInGlobals = false;
@@ -819,6 +900,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                 isInFunction = true;
                 currentFunction = vjassFunction;
                 parseFunctionDeclaration(tokens, token, vjassFunction, ast, i);
+                declareFunction(symbolTable, vjassFunction, true);
 
                 ast->addChild(vjassFunction);
 
@@ -826,6 +908,18 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
             }
             case VJassToken::EndfunctionKeyword: {
                 if (isInFunction) {
+                    if (currentFunction != nullptr) {
+                        currentFunction->extendEndTo(token);
+
+                        if (foldRangeIndex != nullptr) {
+                            foldRangeIndex->addRange(currentFunction->getLine(), token.getLine());
+                        }
+                    }
+
+                    if (symbolTable != nullptr) {
+                        symbolTable->endFunction(token.getLine());
+                    }
+
                     isInFunction = false;
                     currentFunction = nullptr;
                     afterLocalsInFunction = false;
@@ -848,6 +942,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                     ast->addError(token, QObject::tr("Keyword local is only allowed at the beginning of the function"));
                 } else {
                     VJassLocalStatement *localStatement = new VJassLocalStatement(token.getLine(), token.getColumn());
+                    localStatement->extendEndTo(token);
 
                     i++;
 
@@ -860,6 +955,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                             ast->addError(typeName, QObject::tr("Invalid type name %1").arg(typeName.getValue()));
                         } else {
                             localStatement->setType(typeName.getValue());
+                            localStatement->extendEndTo(typeName);
 
                             i++;
 
@@ -872,6 +968,11 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                                     ast->addError(variableIdentifier, QObject::tr("Invalid variable name %1").arg(variableIdentifier.getValue()));
                                 } else {
                                     localStatement->setVariableName(variableIdentifier.getValue());
+                                    localStatement->extendEndTo(variableIdentifier);
+
+                                    if (symbolTable != nullptr) {
+                                        symbolTable->addFunctionDeclaration(variableIdentifier.getValue(), VJassSymbolTable::Local, variableIdentifier.getLine());
+                                    }
 
                                     i++;
 
@@ -910,6 +1011,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                 } else {
                     afterLocalsInFunction = true;
                     VJassSetStatement *setStatement = new VJassSetStatement(token.getLine(), token.getColumn());
+                    setStatement->extendEndTo(token);
 
                     i++;
 
@@ -921,6 +1023,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                         if (!variableName.isValidIdentifier()) {
                             ast->addError(variableName, QObject::tr("Invalid variable name %1").arg(variableName.getValue()));
                         } else {
+                            setStatement->extendEndTo(variableName);
                             const int j = i + 1;
 
                             if (hasReachedEndOfLine(tokens, j, wasLineBreak)) {
@@ -968,6 +1071,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                     afterLocalsInFunction = true;
 
                     VJassStatement *loopStatement = new VJassStatement(token.getLine(), token.getColumn(), VJassStatement::Loop);
+                    loopStatement->extendEndTo(token);
 
                     currentFunction->addChild(loopStatement);
                     loopStatements.push_back(loopStatement);
@@ -979,6 +1083,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                     ast->addError(token, QObject::tr("Keyword exitwhen is only allowed inside of a loop."));
                 } else {
                     VJassStatement *exitwhenStatement = new VJassStatement(token.getLine(), token.getColumn(), VJassStatement::Exitwhen);
+                    exitwhenStatement->extendEndTo(token);
 
                     VJassExpression *expression = parseExpression(tokens, token, ast, i);
 
@@ -1001,6 +1106,12 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                 if (loopStatements.isEmpty()) {
                     ast->addError(token, QObject::tr("Unexpected endloop keyword"));
                 } else {
+                    loopStatements.back()->extendEndTo(token);
+
+                    if (foldRangeIndex != nullptr) {
+                        foldRangeIndex->addRange(loopStatements.back()->getLine(), token.getLine());
+                    }
+
                     loopStatements.pop_back();
                 }
 
@@ -1011,6 +1122,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                 } else {
                     afterLocalsInFunction = true;
                     VJassStatement *ifStatement = new VJassStatement(token.getLine(), token.getColumn(), VJassStatement::If);
+                    ifStatement->extendEndTo(token);
 
                     VJassExpression *expression = parseExpression(tokens, token, ast, i);
 
@@ -1025,6 +1137,8 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
 
                         if (thenToken.getType() != VJassToken::ThenKeyword) {
                             ast->addErrorAtEndOf(thenToken, QObject::tr("Expected then keyword instead of %1").arg(thenToken.getValue()));
+                        } else {
+                            ifStatement->extendEndTo(thenToken);
                         }
                     }
 
@@ -1044,11 +1158,13 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                     ast->addError(token, QObject::tr("Unexpected elseif keyword"));
                 } else {
                     VJassStatement *currentIfStatement = ifStatements.back();
+                    endIfBranch(currentIfStatement, token);
 
                     if (currentIfStatement->getHasElse()) {
                         currentIfStatement->addError(token, QObject::tr("Unexpected elseif keyword after having already one else statement"));
                     } else {
                         VJassStatement *elseifStatement = new VJassStatement(token.getLine(), token.getColumn(), VJassStatement::Elseif);
+                        elseifStatement->extendEndTo(token);
 
                         VJassExpression *expression = parseExpression(tokens, token, ast, i);
 
@@ -1082,11 +1198,13 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                     ast->addError(token, QObject::tr("Unexpected else keyword"));
                 } else {
                     VJassStatement *currentIfStatement = ifStatements.back();
+                    endIfBranch(currentIfStatement, token);
 
                     if (currentIfStatement->getHasElse()) {
                         currentIfStatement->addError(token, QObject::tr("Unexpected else keyword after having already one"));
                     } else {
                         VJassStatement *elseStatement = new VJassStatement(token.getLine(), token.getColumn(), VJassStatement::Else);
+                        elseStatement->extendEndTo(token);
 
                         currentIfStatement->setHasElse(true);
                         currentIfStatement->addChild(elseStatement);
@@ -1104,6 +1222,13 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                 if (ifStatements.isEmpty()) {
                     ast->addError(token, QObject::tr("Unexpected endif keyword"));
                 } else {
+                    endIfBranch(ifStatements.back(), token);
+                    ifStatements.back()->extendEndTo(token);
+
+                    if (foldRangeIndex != nullptr) {
+                        foldRangeIndex->addRange(ifStatements.back()->getLine(), token.getLine());
+                    }
+
                     ifStatements.pop_back();
                 }
 
@@ -1115,6 +1240,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                     afterLocalsInFunction = true;
 
                     VJassStatement *callStatement = new VJassStatement(token.getLine(), token.getColumn(), VJassStatement::Call);
+                    callStatement->extendEndTo(token);
 
                     VJassExpression *expression = parseExpression(tokens, token, ast, i);
 
@@ -1137,6 +1263,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                     afterLocalsInFunction = true;
 
                     VJassStatement *returnStatement = new VJassStatement(token.getLine(), token.getColumn(), VJassStatement::Return);
+                    returnStatement->extendEndTo(token);
 
                     VJassExpression *expression = parseExpression(tokens, token, ast, i, 0, false);
 
@@ -1162,6 +1289,7 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
                     VJassGlobal *global = parseGlobal(false, token.getLine(), token.getColumn(), token, tokens, ast, i, wasLineBreak);
 
                     if (global != nullptr) {
+                        declareGlobal(symbolTable, global);
                         currentGlobals->addChild(global);
                     }
                 } else {
@@ -1216,6 +1344,21 @@ VJassAst* VJassParser::parse(const QList<VJassToken> &tokens) {
     // suggest auto completions in a new empty document
     if (tokens.isEmpty()) {
         suggestLineStartKeywords(isInFunction, isInGlobals, *ast, nullptr);
+    } else {
+        ast->extendEndTo(tokens.last());
+    }
+
+    // the spans of declarations and statements have to include their expressions
+    ast->extendEndsByChildren();
+
+    // the blocks are closed from the inside out
+    if (foldRangeIndex != nullptr) {
+        foldRangeIndex->sort();
+    }
+
+    // a function without endfunction reaches until the end
+    if (symbolTable != nullptr && !tokens.isEmpty()) {
+        symbolTable->endFunction(tokens.last().getLine());
     }
 
     return ast;
@@ -4,6 +4,8 @@
 #include <QList>
 
 #include "vjassast.h"
+#include "foldrangeindex.h"
+#include "vjasssymboltable.h"
 
 
 class VJassParser
@@ -11,7 +13,11 @@ class VJassParser
 public:
     VJassParser();
 
-    VJassAst* parse(const QList<VJassToken> &tokens);
+    /**
+     * @param foldRangeIndex If not nullptr, it is cleared and filled with the line ranges of all functions, globals, if statements and loops.
+     * @param symbolTable If not nullptr, it is cleared and filled with all declarations and the scopes of all functions. The tokens still have to be resolved.
+     */
+    VJassAst* parse(const QList<VJassToken> &tokens, FoldRangeIndex *foldRangeIndex = nullptr, VJassSymbolTable *symbolTable = nullptr);
 };
 
 #endif // VJASSPARSER_H
@@ -12,11 +12,15 @@ inline bool isNotFollowedByIdentifier(const QString &currentContent, int length)
     return length <= currentContent.length() || !QRegularExpression("[A-Za-z_0-9]{1}").match(currentContent.mid(length, 1)).hasMatch();
 }
 
-QList<VJassToken> VJassScanner::scan(const QString &content, bool dropWhiteSpaces) {
+QList<VJassToken> VJassScanner::scan(const QString &content, bool dropWhiteSpaces, BracketPairIndex *bracketPairIndex) {
     QList<VJassToken> result;
     int line = 0;
     int column = 0;
 
+    if (bracketPairIndex != nullptr) {
+        bracketPairIndex->clear();
+    }
+
     // TODO Generated lexers are much faster probably since they have internal state machines going from one symbol to the next.
     // TODO Use a Symbol table instead of storing all the identifiers for tokens since we often have the same symbol more than once.
     for (int i = 0; i < content.size(); ) {
@@ -109,29 +113,31 @@ QList<VJassToken> VJassScanner::scan(const QString &content, bool dropWhiteSpace
             // block comment
             }  else if (currentContent.startsWith("/*")) {
                 int j = i + 2;
-                int columns = 0;
-                int lines = 0;
 
                 for ( ; j < content.size(); j++) {
-                    if (content.at(j) == '\n') {
-                        lines++;
-                        columns = 0;
-                    } else if (content.at(j) == '*' && j + 1 < content.size() && content.at(j + 1) == '/') {
-                        j++;
-                        columns++;
+                    if (content.at(j) == '*' && j + 1 < content.size() && content.at(j + 1) == '/') {
+                        // consume the closing */ as well
+                        j += 2;
 
                         break;
-                    } else {
-                        columns++;
                     }
                 }
 
-                const int length = j - i;
+                const int length = qMin(j, content.size()) - i;
+                const QString value = content.mid(i, length);
 
-                result.push_back(VJassToken(content.mid(i, length), line, column, VJassToken::Comment));
+                result.push_back(VJassToken(value, line, column, VJassToken::Comment));
+
+                // block comments can span multiple lines and the following tokens need the correct line and column
+                const int lines = value.count(QLatin1Char('\n'));
+
+                if (lines > 0) {
+                    line += lines;
+                    column = length - value.lastIndexOf(QLatin1Char('\n')) - 1;
+                } else {
+                    column += length;
+                }
 
-                column += columns;
-                lines += lines;
                 i += length;
             // Comparison Operator
             } else if (currentContent.startsWith("<") || currentContent.startsWith(">") || currentContent.startsWith("==") || currentContent.startsWith("<=") || currentContent.startsWith(">=") || currentContent.startsWith("!=")) {
@@ -254,24 +260,40 @@ QList<VJassToken> VJassScanner::scan(const QString &content, bool dropWhiteSpace
             } else if (currentContent.startsWith("(")) {
                 result.push_back(VJassToken(content.mid(i, 1), line, column, VJassToken::LeftBracket));
 
+                if (bracketPairIndex != nullptr) {
+                    bracketPairIndex->addOpeningBracket(line, column, false);
+                }
+
                 column += 1;
                 i += 1;
             // right bracket
             } else if (currentContent.startsWith(")")) {
                 result.push_back(VJassToken(content.mid(i, 1), line, column, VJassToken::RightBracket));
 
+                if (bracketPairIndex != nullptr) {
+                    bracketPairIndex->addClosingBracket(line, column, false);
+                }
+
                 column += 1;
                 i += 1;
             // left square bracket
             } else if (currentContent.startsWith("[")) {
                 result.push_back(VJassToken(content.mid(i, 1), line, column, VJassToken::LeftSquareBracket));
 
+                if (bracketPairIndex != nullptr) {
+                    bracketPairIndex->addOpeningBracket(line, column, true);
+                }
+
                 column += 1;
                 i += 1;
             // right square bracket
             } else if (currentContent.startsWith("]")) {
                 result.push_back(VJassToken(content.mid(i, 1), line, column, VJassToken::RightSquareBracket));
 
+                if (bracketPairIndex != nullptr) {
+                    bracketPairIndex->addClosingBracket(line, column, true);
+                }
+
                 column += 1;
                 i += 1;
             // text
@@ -4,6 +4,7 @@
 #include <QList>
 
 #include "vjasstoken.h"
+#include "bracketpairindex.h"
 
 
 class VJassScanner
@@ -11,7 +12,10 @@ class VJassScanner
 public:
     VJassScanner();
 
-    QList<VJassToken> scan(const QString &content, bool dropWhiteSpaces = true);
+    /**
+     * @param bracketPairIndex If not nullptr, it is cleared and filled with all round and square brackets of the content.
+     */
+    QList<VJassToken> scan(const QString &content, bool dropWhiteSpaces = true, BracketPairIndex *bracketPairIndex = nullptr);
 };
 
 #endif // VJASSSCANNER_H
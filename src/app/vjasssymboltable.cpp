@@ -0,0 +1,329 @@
+#include <QtCore>
+
+#include "vjasssymboltable.h"
+
+VJassSymbolTable::VJassSymbolTable() : currentFunction(-1), semanticRunsCount(0), reusedFunctionsCount(0) {
+}
+
+void VJassSymbolTable::clear() {
+    declarations.clear();
+    declarationLines.clear();
+    functions.clear();
+    currentFunction = -1;
+    semanticRunsByLine.clear();
+    semanticRunsCount = 0;
+    reusedFunctionsCount = 0;
+    units.clear();
+}
+
+void VJassSymbolTable::addDeclaration(const QString &name, Kind kind, int line) {
+    if (!declarations.contains(name)) {
+        declarations.insert(name, kind);
+    }
+
+    declarationLines.insert(qMakePair(name, line));
+}
+
+void VJassSymbolTable::beginFunction(const QString &name, int line) {
+    // functions cannot be nested, so a missing endfunction ends the previous one
+    endFunction(line - 1);
+
+    FunctionScope scope;
+    scope.name = name;
+    scope.startLine = line;
+    scope.endLine = line;
+    functions.push_back(scope);
+    currentFunction = functions.size() - 1;
+}
+
+void VJassSymbolTable::addFunctionDeclaration(const QString &name, Kind kind, int line) {
+    if (currentFunction != -1) {
+        if (!functions.at(currentFunction).declarations.contains(name)) {
+            functions[currentFunction].declarations.insert(name, kind);
+        }
+
+        declarationLines.insert(qMakePair(name, line));
+    }
+}
+
+void VJassSymbolTable::endFunction(int line) {
+    if (currentFunction != -1) {
+        functions[currentFunction].endLine = qMax(functions.at(currentFunction).startLine, line);
+        currentFunction = -1;
+    }
+}
+
+VJassSymbolTable::Kind VJassSymbolTable::getDeclarationKind(const QString &name) const {
+    return declarations.value(name, NoKind);
+}
+
+int VJassSymbolTable::getFunctionsCount() const {
+    return functions.size();
+}
+
+int VJassSymbolTable::functionAt(int line) const {
+    // the functions are added in the order of their lines
+    auto iterator = std::upper_bound(functions.cbegin(), functions.cend(), line, [](int line, const FunctionScope &scope) {
+        return line < scope.startLine;
+    });
+
+    if (iterator == functions.cbegin()) {
+        return -1;
+    }
+
+    --iterator;
+
+    return line <= iterator->endLine ? int(iterator - functions.cbegin()) : -1;
+}
+
+const QString& VJassSymbolTable::getFunctionName(int index) const {
+    return functions.at(index).name;
+}
+
+VJassSymbolTable::Kind VJassSymbolTable::resolve(const QString &name, int function) const {
+    if (function >= 0 && function < functions.size()) {
+        const Kind kind = functions.at(function).declarations.value(name, NoKind);
+
+        if (kind != NoKind) {
+            return kind;
+        }
+    }
+
+    return getDeclarationKind(name);
+}
+
+int VJassSymbolTable::resolveTokens(const QList<VJassToken> &tokens, const VJassSymbolTable *previous, const QVector<uint> &lineHashes) {
+    semanticRunsByLine.clear();
+    semanticRunsCount = 0;
+    reusedFunctionsCount = 0;
+    units.clear();
+
+    QHash<QString, const FunctionScope*> previousFunctions;
+
+    if (previous != nullptr) {
+        for (const FunctionScope &previousScope : previous->functions) {
+            if (!previousFunctions.contains(previousScope.name)) {
+                previousFunctions.insert(previousScope.name, &previousScope);
+            }
+        }
+    }
+
+    int resolvedFunctions = 0;
+    int function = 0;
+    // the first token of the current top level lines or -1
+    int topLevelBegin = -1;
+    int topLevelUnits = 0;
+
+    for (int i = 0; i < tokens.size(); ) {
+        const VJassToken &token = tokens.at(i);
+
+        while (function < functions.size() && functions.at(function).endLine < token.getLine()) {
+            function++;
+        }
+
+        // the tokens of a function are resolved or reused together
+        if (function < functions.size() && functions.at(function).startLine <= token.getLine()) {
+            if (topLevelBegin != -1) {
+                addTopLevelUnit(tokens, topLevelBegin, i, topLevelUnits, lineHashes);
+                topLevelBegin = -1;
+            }
+
+            FunctionScope &scope = functions[function];
+            int end = i;
+
+            while (end < tokens.size() && tokens.at(end).getLine() <= scope.endLine) {
+                end++;
+            }
+
+            scope.tokensHash = tokensHash(tokens, i, end, scope.startLine, scope.endLine, lineHashes);
+            const FunctionScope *previousScope = previousFunctions.value(scope.name, nullptr);
+
+            if (previousScope != nullptr && canReuse(scope, *previousScope)) {
+                scope.semanticRuns = previousScope->semanticRuns;
+                scope.references = previousScope->references;
+                scope.callees = previousScope->callees;
+                scope.globalReferences = previousScope->globalReferences;
+                reusedFunctionsCount++;
+            } else {
+                resolveFunction(scope, tokens, i, end);
+                resolvedFunctions++;
+            }
+
+            for (int line = 0; line < scope.semanticRuns.size(); line++) {
+                for (const SemanticRun &semanticRun : scope.semanticRuns.at(line)) {
+                    addSemanticRun(semanticRunsByLine, scope.startLine + line, semanticRun);
+                    semanticRunsCount++;
+                }
+            }
+
+            Unit unit;
+            unit.key = QString("function ") + scope.name;
+            unit.startLine = scope.startLine;
+            unit.endLine = scope.endLine;
+            unit.tokensHash = scope.tokensHash;
+            unit.references = scope.references;
+            unit.callees = scope.callees;
+            units.push_back(unit);
+
+            i = end;
+            function++;
+
+            continue;
+        }
+
+        if (topLevelBegin == -1) {
+            topLevelBegin = i;
+        }
+
+        i++;
+    }
+
+    if (topLevelBegin != -1) {
+        addTopLevelUnit(tokens, topLevelBegin, tokens.size(), topLevelUnits, lineHashes);
+    }
+
+    return resolvedFunctions;
+}
+
+int VJassSymbolTable::getReusedFunctionsCount() const {
+    return reusedFunctionsCount;
+}
+
+const QVector<VJassSymbolTable::SemanticRuns>& VJassSymbolTable::getSemanticRunsByLine() const {
+    return semanticRunsByLine;
+}
+
+const VJassSymbolTable::SemanticRuns& VJassSymbolTable::getSemanticRuns(int line) const {
+    static const SemanticRuns empty;
+
+    if (line < 0 || line >= semanticRunsByLine.size()) {
+        return empty;
+    }
+
+    return semanticRunsByLine.at(line);
+}
+
+int VJassSymbolTable::getSemanticRunsCount() const {
+    return semanticRunsCount;
+}
+
+const VJassSymbolTable::Units& VJassSymbolTable::getUnits() const {
+    return units;
+}
+
+bool VJassSymbolTable::canReuse(const FunctionScope &scope, const FunctionScope &previousScope) const {
+    if (scope.tokensHash != previousScope.tokensHash || scope.endLine - scope.startLine != previousScope.endLine - previousScope.startLine) {
+        return false;
+    }
+
+    // a new or removed global might change the kind of an identifier which has not been changed
+    for (auto iterator = previousScope.globalReferences.cbegin(); iterator != previousScope.globalReferences.cend(); ++iterator) {
+        if (getDeclarationKind(iterator.key()) != iterator.value()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void VJassSymbolTable::resolveFunction(FunctionScope &scope, const QList<VJassToken> &tokens, int begin, int end) {
+    scope.semanticRuns.clear();
+    scope.references.clear();
+    scope.callees.clear();
+    scope.globalReferences.clear();
+    QSet<QString> callees;
+
+    for (int i = begin; i < end; i++) {
+        const VJassToken &token = tokens.at(i);
+
+        if (token.getType() != VJassToken::Text) {
+            continue;
+        }
+
+        Kind kind = scope.declarations.value(token.getValue(), NoKind);
+
+        if (kind == NoKind) {
+            kind = getDeclarationKind(token.getValue());
+            scope.globalReferences.insert(token.getValue(), kind);
+        }
+
+        if (kind != NoKind && !token.highlight()) {
+            addSemanticRun(scope.semanticRuns, token.getLine() - scope.startLine, SemanticRun(token.getColumn(), token.getLength(), kind));
+        }
+
+        scope.references.push_back(Reference(token.getValue(), token.getLine() - scope.startLine, token.getColumn(), token.getLength(), kind, declarationLines.contains(qMakePair(token.getValue(), token.getLine()))));
+
+        // calls are followed by their arguments and code values follow the keyword function outside of the declaration
+        const bool isCall = i + 1 < end && tokens.at(i + 1).getType() == VJassToken::LeftBracket;
+        const bool isCode = i > begin && tokens.at(i - 1).getType() == VJassToken::FunctionKeyword && token.getLine() != scope.startLine;
+
+        if ((isCall || isCode) && !callees.contains(token.getValue())) {
+            callees.insert(token.getValue());
+            scope.callees.push_back(token.getValue());
+        }
+    }
+}
+
+void VJassSymbolTable::addSemanticRun(QVector<SemanticRuns> &semanticRuns, int line, const SemanticRun &semanticRun) {
+    if (line >= semanticRuns.size()) {
+        semanticRuns.resize(line + 1);
+    }
+
+    semanticRuns[line].push_back(semanticRun);
+}
+
+void VJassSymbolTable::addTopLevelUnit(const QList<VJassToken> &tokens, int begin, int end, int &topLevelUnits, const QVector<uint> &lineHashes) {
+    Unit unit;
+    unit.startLine = tokens.at(begin).getLine();
+    unit.endLine = tokens.at(end - 1).getLine();
+
+    // declarations outside of functions only refer to global names
+    for (int i = begin; i < end; i++) {
+        const VJassToken &token = tokens.at(i);
+
+        if (token.getType() != VJassToken::Text) {
+            continue;
+        }
+
+        const Kind kind = getDeclarationKind(token.getValue());
+
+        if (kind != NoKind && !token.highlight()) {
+            addSemanticRun(semanticRunsByLine, token.getLine(), SemanticRun(token.getColumn(), token.getLength(), kind));
+            semanticRunsCount++;
+        }
+
+        unit.references.push_back(Reference(token.getValue(), token.getLine() - unit.startLine, token.getColumn(), token.getLength(), kind, declarationLines.contains(qMakePair(token.getValue(), token.getLine()))));
+    }
+
+    // comments and empty lines are not referenced
+    if (!unit.references.isEmpty()) {
+        // the blocks are numbered since their lines change with every edit above them
+        unit.key = QString("lines %1").arg(topLevelUnits++);
+        unit.tokensHash = tokensHash(tokens, begin, end, unit.startLine, unit.endLine, lineHashes);
+        units.push_back(unit);
+    }
+}
+
+uint VJassSymbolTable::tokensHash(const QList<VJassToken> &tokens, int begin, int end, int startLine, int endLine, const QVector<uint> &lineHashes) {
+    uint result = qHash(endLine - startLine);
+
+    // equal lines contain equal tokens, so only one hash per line has to be combined
+    if (endLine < lineHashes.size()) {
+        result = 31 * result + uint(end - begin);
+
+        for (int line = startLine; line <= endLine; line++) {
+            result = 31 * result + lineHashes.at(line);
+        }
+
+        return result;
+    }
+
+    for (int i = begin; i < end; i++) {
+        const VJassToken &token = tokens.at(i);
+        result = 31 * result + qHash(token.getValue());
+        result = 31 * result + uint(token.getLine() - startLine);
+        result = 31 * result + uint(token.getColumn());
+    }
+
+    return result;
+}
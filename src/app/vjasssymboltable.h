@@ -0,0 +1,183 @@
+#ifndef VJASSSYMBOLTABLE_H
+#define VJASSSYMBOLTABLE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+
+#include "vjasstoken.h"
+
+/**
+ * @brief Resolves the identifiers of a script to the kinds of their declarations.
+ *
+ * The parser adds the declarations of types, natives, functions and globals and the scopes of functions with their parameters and locals.
+ * Afterwards, every identifier token is resolved and stored as semantic run of its line.
+ * Every function is resolved on its own. A function whose tokens have not changed since the previous symbol table reuses its runs unless one of the global declarations it refers to has changed.
+ * All identifiers are grouped into units of functions and top level lines as references for the cross-reference index.
+ */
+class VJassSymbolTable
+{
+public:
+    enum Kind : quint8 {
+        NoKind,
+        Type,
+        Native,
+        Function,
+        Constant,
+        Global,
+        Local,
+        Parameter
+    };
+
+    /**
+     * @brief A resolved identifier inside of one line.
+     */
+    struct SemanticRun {
+        int column;
+        int length;
+        Kind kind;
+
+        SemanticRun() : column(0), length(0), kind(NoKind) {
+        }
+
+        SemanticRun(int column, int length, Kind kind) : column(column), length(length), kind(kind) {
+        }
+    };
+
+    using SemanticRuns = QVector<SemanticRun>;
+
+    /**
+     * @brief An identifier of a unit. Its line is relative to the start line of the unit.
+     */
+    struct Reference {
+        QString name;
+        int line;
+        int column;
+        int length;
+        // unresolved identifiers might be declared by another script
+        Kind kind;
+        bool isDeclaration;
+
+        Reference() : line(0), column(0), length(0), kind(NoKind), isDeclaration(false) {
+        }
+
+        Reference(const QString &name, int line, int column, int length, Kind kind, bool isDeclaration)
+            : name(name)
+            , line(line)
+            , column(column)
+            , length(length)
+            , kind(kind)
+            , isDeclaration(isDeclaration) {
+        }
+    };
+
+    using References = QVector<Reference>;
+
+    /**
+     * @brief A function or the top level lines between two functions whose identifiers are referenced together.
+     */
+    struct Unit {
+        // "function Name" or the number of the top level lines
+        QString key;
+        int startLine;
+        int endLine;
+        // equal hashes mean equal tokens or lines relative to the start line
+        uint tokensHash;
+        References references;
+        // the names of all functions and natives which a function calls or passes as code in the order of their first use
+        QStringList callees;
+
+        Unit() : startLine(0), endLine(0), tokensHash(0) {
+        }
+    };
+
+    using Units = QVector<Unit>;
+
+    VJassSymbolTable();
+
+    void clear();
+    /**
+     * @brief Adds the declaration of a type, native, function or global in the given line. The first declaration of a name wins like in the game.
+     */
+    void addDeclaration(const QString &name, Kind kind, int line);
+    /**
+     * @brief Starts the scope of a function. All parameters and locals are added to this scope until it is ended.
+     */
+    void beginFunction(const QString &name, int line);
+    void addFunctionDeclaration(const QString &name, Kind kind, int line);
+    /**
+     * @brief Ends the scope of the current function if there is one.
+     */
+    void endFunction(int line);
+
+    Kind getDeclarationKind(const QString &name) const;
+    int getFunctionsCount() const;
+    /**
+     * @return Returns the index of the function whose scope contains the line or -1.
+     */
+    int functionAt(int line) const;
+    const QString& getFunctionName(int index) const;
+    /**
+     * @return Returns the kind of the declaration the name refers to in the function with the given index. Parameters and locals hide globals.
+     */
+    Kind resolve(const QString &name, int function) const;
+
+    /**
+     * @brief Resolves all identifier tokens to semantic runs. Identifiers of the standard scripts are left to their lexical highlighting.
+     * @param previous The symbol table of the previous version of the script whose unchanged functions are reused.
+     * @param lineHashes The hashes of all lines of the script like HighLightInfo::getLineHashes(). If they are given, a unit is compared by the hashes of its lines instead of hashing all of its tokens.
+     * @return Returns the number of functions which have been resolved again.
+     */
+    int resolveTokens(const QList<VJassToken> &tokens, const VJassSymbolTable *previous = nullptr, const QVector<uint> &lineHashes = QVector<uint>());
+    int getReusedFunctionsCount() const;
+
+    const QVector<SemanticRuns>& getSemanticRunsByLine() const;
+    /**
+     * @return Returns the semantic runs of the line sorted by their columns or an empty list if the line has none.
+     */
+    const SemanticRuns& getSemanticRuns(int line) const;
+    int getSemanticRunsCount() const;
+    /**
+     * @return Returns the units of all resolved tokens in the order of their lines.
+     */
+    const Units& getUnits() const;
+
+private:
+    struct FunctionScope {
+        QString name;
+        int startLine;
+        int endLine;
+        QHash<QString, Kind> declarations;
+        uint tokensHash;
+        // the lines are relative to the start line, so moving the function keeps them valid
+        QVector<SemanticRuns> semanticRuns;
+        References references;
+        QStringList callees;
+        // every global name the identifiers of the function refer to and the kind it has been resolved to
+        QHash<QString, Kind> globalReferences;
+
+        FunctionScope() : startLine(0), endLine(0), tokensHash(0) {
+        }
+    };
+
+    bool canReuse(const FunctionScope &scope, const FunctionScope &previousScope) const;
+    void resolveFunction(FunctionScope &scope, const QList<VJassToken> &tokens, int begin, int end);
+    void addSemanticRun(QVector<SemanticRuns> &semanticRuns, int line, const SemanticRun &semanticRun);
+    void addTopLevelUnit(const QList<VJassToken> &tokens, int begin, int end, int &topLevelUnits, const QVector<uint> &lineHashes);
+    static uint tokensHash(const QList<VJassToken> &tokens, int begin, int end, int startLine, int endLine, const QVector<uint> &lineHashes);
+
+    QHash<QString, Kind> declarations;
+    // every name with the line of its declaration including the ones which are hidden by the first declaration
+    QSet<QPair<QString, int>> declarationLines;
+    QVector<FunctionScope> functions;
+    // the index of the function which is still open or -1
+    int currentFunction;
+    QVector<SemanticRuns> semanticRunsByLine;
+    int semanticRunsCount;
+    int reusedFunctionsCount;
+    Units units;
+};
+
+#endif // VJASSSYMBOLTABLE_H
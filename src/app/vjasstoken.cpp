@@ -5917,7 +5917,8 @@ VJassToken::Type VJassToken::typeFromKeyword(const QString &keyword) {
         return VJassToken::FalseKeyword;
     }
 
-    Q_ASSERT(false);
+    // only keywords are passed but unknown tokens are simply not highlighted
+    return VJassToken::Unknown;
 }
 
 int VJassToken::getValueLength() const {
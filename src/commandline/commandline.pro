@@ -12,9 +12,16 @@ SOURCES -= ../app/mainwindow.cpp
 SOURCES -= ../app/autocompletionpopup.cpp
 SOURCES -= ../app/linenumbers.cpp
 SOURCES -= ../app/highlightinfo.cpp
+SOURCES -= ../app/analysis.cpp
 SOURCES -= ../app/textedit.cpp
 SOURCES -= ../app/syntaxhighlighter.cpp
 SOURCES -= ../app/finddialog.cpp
+SOURCES -= ../app/overviewruler.cpp
+SOURCES -= ../app/outlinermodel.cpp
+SOURCES -= ../app/outlinerfiltermodel.cpp
+SOURCES -= ../app/diagnosticsmodel.cpp
+SOURCES -= ../app/scriptviewer.cpp
+SOURCES -= ../app/symbolpalette.cpp
 
 # message("My sources: " + $$SOURCES)
 
@@ -23,9 +30,16 @@ HEADERS -= ../app/mainwindow.h
 HEADERS -= ../app/autocompletionpopup.h
 HEADERS -= ../app/linenumbers.h
 HEADERS -= ../app/highlightinfo.h
+HEADERS -= ../app/analysis.h
 HEADERS -= ../app/textedit.h
 HEADERS -= ../app/syntaxhighlighter.h
 HEADERS -= ../app/finddialog.h
+HEADERS -= ../app/overviewruler.h
+HEADERS -= ../app/outlinermodel.h
+HEADERS -= ../app/outlinerfiltermodel.h
+HEADERS -= ../app/diagnosticsmodel.h
+HEADERS -= ../app/scriptviewer.h
+HEADERS -= ../app/symbolpalette.h
 
 SOURCES += \
     main.cpp
@@ -3,6 +3,8 @@
 #include "../../app/highlightinfo.h"
 #include "../../app/vjassscanner.h"
 #include "../../app/vjassparser.h"
+#include "../../app/diagnosticsindex.h"
+#include "../../app/syntaxhighlighter.h"
 #include "testhighlightinfo.h"
 
 void TestHighlightInfo::canHoldTokens() {
@@ -12,12 +14,15 @@ void TestHighlightInfo::canHoldTokens() {
 
     HighLightInfo highLightInfo(text, tokens, nullptr);
 
-    QCOMPARE(highLightInfo.getFormattedLocations().size(), 1);
-    QVERIFY(highLightInfo.getFormattedLocations().contains(HighLightInfo::Location(0, 0)));
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].isBold, true);
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].isItalic, false);
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].length, 8);
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].applyForegroundColor, true);
+    QCOMPARE(highLightInfo.getFormatRunsCount(), 1);
+    QCOMPARE(highLightInfo.getFormatRuns(0).size(), 1);
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).column, 0);
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).length, 8);
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).category, HighLightInfo::KeywordFormat);
+    QCOMPARE(HighLightInfo::getCustomTextCharFormat(HighLightInfo::KeywordFormat).isBold, true);
+    QCOMPARE(HighLightInfo::getCustomTextCharFormat(HighLightInfo::KeywordFormat).isItalic, false);
+    QCOMPARE(HighLightInfo::getCustomTextCharFormat(HighLightInfo::KeywordFormat).applyForegroundColor, true);
+    QCOMPARE(HighLightInfo::getTextCharFormat(HighLightInfo::KeywordFormat).fontWeight(), static_cast<int>(QFont::Bold));
 }
 
 void TestHighlightInfo::canHoldTokensFromCommonJ() {
@@ -34,19 +39,19 @@ void TestHighlightInfo::canHoldTokensFromCommonJ() {
 
     // native GroupEnumUnitsInRangeOfLocCounted    takes group location real radius boolexpr integer returns nothing
     // native GroupEnumUnitsSelected               takes group player boolexpr filter returns nothing
-    QCOMPARE(highLightInfo.getFormattedLocations().size(), 18);
-    QVERIFY(highLightInfo.getFormattedLocations().contains(HighLightInfo::Location(0, 0)));
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].isBold, true);
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].isItalic, false);
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].length, 6); // native
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].applyForegroundColor, true);
+    QCOMPARE(highLightInfo.getFormatRunsCount(), 18);
+    QCOMPARE(highLightInfo.getFormatRunsByLine().size(), 2);
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).column, 0);
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).length, 6); // native
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).category, HighLightInfo::KeywordFormat);
 
     // second native
-    QVERIFY(highLightInfo.getFormattedLocations().contains(HighLightInfo::Location(1, 0)));
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].isBold, true);
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].isItalic, false);
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].length, 6); // native
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].applyForegroundColor, true);
+    QCOMPARE(highLightInfo.getFormatRuns(1).at(0).column, 0);
+    QCOMPARE(highLightInfo.getFormatRuns(1).at(0).length, 6); // native
+    QCOMPARE(highLightInfo.getFormatRuns(1).at(0).category, HighLightInfo::KeywordFormat);
+
+    // no lines after the second one
+    QVERIFY(highLightInfo.getFormatRuns(2).isEmpty());
 }
 
 
@@ -57,12 +62,90 @@ void TestHighlightInfo::canHoldTokensFromBlizzardJ() {
 
     HighLightInfo highLightInfo(text, tokens, nullptr);
 
-    QCOMPARE(highLightInfo.getFormattedLocations().size(), 1);
-    QVERIFY(highLightInfo.getFormattedLocations().contains(HighLightInfo::Location(0, 0)));
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].isBold, false);
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].isItalic, true);
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].length, 5); // bj_PI
-    QCOMPARE(highLightInfo.getFormattedLocations()[HighLightInfo::Location(0, 0)].applyForegroundColor, true);
+    QCOMPARE(highLightInfo.getFormatRunsCount(), 1);
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).column, 0);
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).length, 5); // bj_PI
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).category, HighLightInfo::BlizzardJConstantFormat);
+    QCOMPARE(HighLightInfo::getCustomTextCharFormat(HighLightInfo::BlizzardJConstantFormat).isBold, false);
+    QCOMPARE(HighLightInfo::getCustomTextCharFormat(HighLightInfo::BlizzardJConstantFormat).isItalic, true);
+    QCOMPARE(HighLightInfo::getCustomTextCharFormat(HighLightInfo::BlizzardJConstantFormat).applyForegroundColor, true);
+}
+
+void TestHighlightInfo::canSplitMultiLineTokens() {
+    const QString text = QString("/* first line\nsecond line */ function");
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(text, true);
+
+    HighLightInfo highLightInfo(text, tokens, nullptr);
+
+    QCOMPARE(highLightInfo.getFormatRunsCount(), 3);
+    QCOMPARE(highLightInfo.getFormatRuns(0).size(), 1);
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).length, 13);
+    QCOMPARE(highLightInfo.getFormatRuns(0).at(0).category, HighLightInfo::CommentFormat);
+    QCOMPARE(highLightInfo.getFormatRuns(1).size(), 2);
+    QCOMPARE(highLightInfo.getFormatRuns(1).at(0).column, 0);
+    QCOMPARE(highLightInfo.getFormatRuns(1).at(0).length, 14);
+    QCOMPARE(highLightInfo.getFormatRuns(1).at(0).category, HighLightInfo::CommentFormat);
+    QCOMPARE(highLightInfo.getFormatRuns(1).at(1).column, 15);
+    QCOMPARE(highLightInfo.getFormatRuns(1).at(1).length, 8);
+    QCOMPARE(highLightInfo.getFormatRuns(1).at(1).category, HighLightInfo::KeywordFormat);
+}
+
+void TestHighlightInfo::canBuildFormatRunsFromBlizzardJ() {
+    QFile f("wc3reforged/Blizzard.j");
+
+    QVERIFY(f.open(QFile::ReadOnly | QFile::Text));
+
+    QTextStream in(&f);
+    QString input = in.readAll();
+    QCOMPARE(input.size(), 471054);
+
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(input, true);
+
+    QBENCHMARK {
+        HighLightInfo highLightInfo(input, tokens, nullptr);
+    }
+
+    HighLightInfo highLightInfo(input, tokens, nullptr);
+    const int lines = input.count(QLatin1Char('\n')) + 1;
+
+    QCOMPARE(highLightInfo.getFormatRunsByLine().size(), lines);
+    QVERIFY(highLightInfo.getFormatRunsCount() > 0);
+
+    // every run is stored inline in the vector of its line instead of a tree node with the location as key
+    // a node of the previous QMap<Location, CustomTextCharFormat> has a parent, a left and a right pointer besides its key and value
+    const int mapNodeSize = static_cast<int>(3 * sizeof(void*) + sizeof(HighLightInfo::Location) + sizeof(HighLightInfo::CustomTextCharFormat));
+
+    QVERIFY(highLightInfo.getFormatRunsMemoryUsage() < highLightInfo.getFormatRunsCount() * mapNodeSize);
+}
+
+void TestHighlightInfo::canLookupFormatRunsFromBlizzardJ() {
+    QFile f("wc3reforged/Blizzard.j");
+
+    QVERIFY(f.open(QFile::ReadOnly | QFile::Text));
+
+    QTextStream in(&f);
+    QString input = in.readAll();
+
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(input, true);
+    HighLightInfo highLightInfo(input, tokens, nullptr);
+    int formattedCharacters = 0;
+
+    // the highlighter looks up the runs of one line for every block
+    QBENCHMARK {
+        formattedCharacters = 0;
+
+        for (int line = 0; line < highLightInfo.getFormatRunsByLine().size(); line++) {
+            for (const HighLightInfo::FormatRun &formatRun : highLightInfo.getFormatRuns(line)) {
+                formattedCharacters += formatRun.length;
+            }
+        }
+    }
+
+    QVERIFY(formattedCharacters > 0);
+    QVERIFY(formattedCharacters < input.size());
 }
 
 /*
@@ -97,6 +180,43 @@ void TestHighlightInfo::canOrderCodeElementsFromCommonJ() {
 }
 */
 
+void TestHighlightInfo::canCreateTextDocumentFromCommonJ() {
+    QFile f("wc3reforged/common.j");
+
+    QVERIFY(f.open(QFile::ReadOnly | QFile::Text));
+
+    QTextStream in(&f);
+    QString input = in.readAll();
+    QCOMPARE(input.size(), 355533);
+
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(input, true);
+
+    QBENCHMARK {
+        HighLightInfo highLightInfo(input, tokens, nullptr, QList<VJassParseError>(), true, true);
+        delete highLightInfo.getTextDocument();
+    }
+
+    HighLightInfo highLightInfo(input, tokens, nullptr, QList<VJassParseError>(), true, true);
+    QTextDocument *textDocument = highLightInfo.getTextDocument();
+    QVERIFY(textDocument != nullptr);
+    QCOMPARE(textDocument->blockCount(), highLightInfo.getFormatRunsByLine().size());
+
+    // type agent extends handle
+    const QTextBlock block = textDocument->findBlockByNumber(4);
+    const QVector<QTextLayout::FormatRange> formats = block.layout()->formats();
+    QCOMPARE(formats.size(), highLightInfo.getFormatRuns(4).size());
+    QCOMPARE(formats.at(0).start, 0);
+    QCOMPARE(formats.at(0).length, 4);
+    QVERIFY(formats.at(0).format == HighLightInfo::getTextCharFormat(HighLightInfo::KeywordFormat));
+
+    // the document contents are not modified by the formatting
+    QCOMPARE(textDocument->isUndoAvailable(), false);
+    QCOMPARE(textDocument->toPlainText(), input);
+
+    delete textDocument;
+}
+
 void TestHighlightInfo::canHoldAst() {
     const QString text = QString("function test takes nothing returns nothing\n")
             + "call DisplayTextToPlayer\n" //DisplayTextToPlayer(Player(0) , 0.0, 0.0, \"Number \" + I2S(i))
@@ -112,4 +232,114 @@ void TestHighlightInfo::canHoldAst() {
     QCOMPARE(highLightInfo.getAstElementsByLocation().size(), 1);
 }
 
+void TestHighlightInfo::canIndexDiagnostics() {
+    QList<VJassParseError> parseErrors;
+    parseErrors.push_back(VJassParseError(3, 4, 2, "error 1"));
+    parseErrors.push_back(VJassParseError(1, 2, 3, 5, "error 2"));
+    parseErrors.push_back(VJassParseError(3, 0, 1, "error 3"));
+
+    DiagnosticsIndex diagnosticsIndex(parseErrors, 5);
+
+    QCOMPARE(diagnosticsIndex.getLineCount(), 5);
+    QCOMPARE(diagnosticsIndex.getErrorsCount(), 3);
+    // the multi-line error has one range in each of its 3 lines
+    QCOMPARE(diagnosticsIndex.getRangesCount(), 5);
+
+    QVERIFY(!diagnosticsIndex.hasDiagnostics(0));
+    QVERIFY(diagnosticsIndex.hasDiagnostics(1));
+    QVERIFY(diagnosticsIndex.hasDiagnostics(2));
+    QVERIFY(diagnosticsIndex.hasDiagnostics(3));
+    QVERIFY(!diagnosticsIndex.hasDiagnostics(4));
+    QVERIFY(diagnosticsIndex.hasDiagnostics(0, 4));
+    QVERIFY(!diagnosticsIndex.hasDiagnostics(4, 10));
+    QCOMPARE(diagnosticsIndex.countRanges(0, 4), 5);
+
+    // first line of the multi-line error
+    QCOMPARE(diagnosticsIndex.getRangesEnd(1) - diagnosticsIndex.getRangesBegin(1), 1);
+    QCOMPARE(diagnosticsIndex.getRange(diagnosticsIndex.getRangesBegin(1)).column, 2);
+    QCOMPARE(diagnosticsIndex.getRange(diagnosticsIndex.getRangesBegin(1)).length, -1);
+    QCOMPARE(diagnosticsIndex.getRange(diagnosticsIndex.getRangesBegin(1)).errorIndex, 1);
+
+    // middle line of the multi-line error
+    QCOMPARE(diagnosticsIndex.getRange(diagnosticsIndex.getRangesBegin(2)).column, 0);
+    QCOMPARE(diagnosticsIndex.getRange(diagnosticsIndex.getRangesBegin(2)).length, -1);
+
+    // last line of the multi-line error and two other errors
+    QCOMPARE(diagnosticsIndex.getRangesEnd(3) - diagnosticsIndex.getRangesBegin(3), 3);
+    QCOMPARE(diagnosticsIndex.getRange(diagnosticsIndex.getRangesBegin(3)).errorIndex, 0);
+    QCOMPARE(diagnosticsIndex.getRange(diagnosticsIndex.getRangesBegin(3) + 1).column, 0);
+    QCOMPARE(diagnosticsIndex.getRange(diagnosticsIndex.getRangesBegin(3) + 1).length, 5);
+    QCOMPARE(diagnosticsIndex.getRange(diagnosticsIndex.getRangesBegin(3) + 1).errorIndex, 1);
+
+    // errors after the last line extend the index
+    parseErrors.push_back(VJassParseError(9, 0, 1, "error 4"));
+    QCOMPARE(DiagnosticsIndex(parseErrors, 5).getLineCount(), 10);
+}
+
+void TestHighlightInfo::canIndexManyDiagnostics() {
+    QList<VJassParseError> parseErrors;
+
+    for (int i = 0; i < 10000; i++) {
+        parseErrors.push_back(VJassParseError(i, 0, 10, "error"));
+    }
+
+    QBENCHMARK {
+        DiagnosticsIndex diagnosticsIndex(parseErrors, 10000);
+    }
+
+    DiagnosticsIndex diagnosticsIndex(parseErrors, 10000);
+    int linesWithDiagnostics = 0;
+
+    // the overview ruler checks every marker row
+    QBENCHMARK {
+        linesWithDiagnostics = 0;
+
+        for (int line = 0; line < 10000; line += 10) {
+            if (diagnosticsIndex.hasDiagnostics(line, line + 9)) {
+                linesWithDiagnostics++;
+            }
+        }
+    }
+
+    QCOMPARE(linesWithDiagnostics, 1000);
+}
+
+void TestHighlightInfo::canUnderlineDiagnostics() {
+    const QString text = "function test takes nothing returns nothing";
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(text, false);
+    QList<VJassParseError> parseErrors;
+    // covers the identifier, the following space and the keyword
+    parseErrors.push_back(VJassParseError(0, 9, 10, "error"));
+
+    HighLightInfo highLightInfo(text, tokens, nullptr, parseErrors);
+
+    QTextDocument textDocument(text);
+    SyntaxHighlighter syntaxHighlighter(&textDocument);
+    syntaxHighlighter.setBlockFormatCache(highLightInfo, textDocument.revision());
+    syntaxHighlighter.rehighlight();
+
+    const QVector<QTextLayout::FormatRange> formats = textDocument.firstBlock().layout()->formats();
+    int underlinedCharacters = 0;
+    int underlinedRanges = 0;
+
+    for (const QTextLayout::FormatRange &formatRange : formats) {
+        if (formatRange.format.underlineStyle() == QTextCharFormat::WaveUnderline) {
+            underlinedCharacters += formatRange.length;
+            underlinedRanges++;
+            QVERIFY(formatRange.start >= 9);
+            QVERIFY(formatRange.start + formatRange.length <= 19);
+
+            // the formats of the tokens are kept
+            if (formatRange.start >= 14) {
+                QCOMPARE(formatRange.format.fontWeight(), static_cast<int>(QFont::Bold));
+            }
+        }
+    }
+
+    QCOMPARE(underlinedCharacters, 10);
+    // one range per format run instead of one per character
+    QVERIFY(underlinedRanges <= 3);
+}
+
 QTEST_MAIN(TestHighlightInfo)
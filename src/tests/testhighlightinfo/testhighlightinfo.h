@@ -11,9 +11,16 @@ class TestHighlightInfo : public QObject
         void canHoldTokens();
         void canHoldTokensFromCommonJ();
         void canHoldTokensFromBlizzardJ();
+        void canSplitMultiLineTokens();
+        void canBuildFormatRunsFromBlizzardJ();
+        void canLookupFormatRunsFromBlizzardJ();
+        void canCreateTextDocumentFromCommonJ();
         //void canOrderCodeElementsFromCommonJ();
 
         void canHoldAst();
+        void canIndexDiagnostics();
+        void canIndexManyDiagnostics();
+        void canUnderlineDiagnostics();
 };
 
 #endif // TESTHIGHLIGHTINFO_H
@@ -0,0 +1,364 @@
+#include <QtTest>
+
+#include "../../app/vjassscanner.h"
+#include "../../app/vjassparser.h"
+#include "../../app/completionindex.h"
+#include "../../app/completioncontext.h"
+#include "../../app/symbolindex.h"
+#include "../../app/crossreferenceindex.h"
+#include "../../app/callgraph.h"
+#include "../../app/signatureindex.h"
+#include "../../app/vjasssymboltable.h"
+#include "testindices.h"
+
+namespace {
+
+VJassSymbolTable::Units resolveUnits(const QString &input) {
+    VJassScanner scanner;
+    VJassParser parser;
+    VJassSymbolTable symbolTable;
+    const QList<VJassToken> tokens = scanner.scan(input);
+    delete parser.parse(tokens, nullptr, &symbolTable);
+    symbolTable.resolveTokens(tokens);
+
+    return symbolTable.getUnits();
+}
+
+}
+
+void TestIndices::canCompleteFromIndex() {
+    const QString text = "globals\n"
+                         "    integer myCounter = 0\n"
+                         "endglobals\n"
+                         "function MyFunction takes integer myParameter returns nothing\n"
+                         "    local unit myUnit = null\n"
+                         "endfunction";
+
+    VJassScanner scanner;
+    VJassParser parser;
+    VJassAst *ast = parser.parse(scanner.scan(text));
+    CompletionIndex completionIndex;
+
+    QCOMPARE(completionIndex.setUnits(CompletionIndex::unitsFromAst(ast)), 2);
+    QCOMPARE(completionIndex.getUserEntriesCount(), 4);
+
+    // the declarations of the user and the standard scripts are merged and the case is ignored
+    CompletionIndex::Entries entries = completionIndex.find("my", 10);
+
+    QCOMPARE(entries.size(), 4);
+    QCOMPARE(entries.at(0).name, QString("myCounter"));
+    QCOMPARE(entries.at(1).name, QString("MyFunction"));
+    QCOMPARE(entries.at(1).kind, CompletionIndex::Function);
+    QCOMPARE(entries.at(2).kind, CompletionIndex::Parameter);
+    QCOMPARE(entries.at(3).scope, QString("MyFunction"));
+
+    entries = completionIndex.find("CreateUnit", 3);
+
+    QCOMPARE(entries.size(), 3);
+    QCOMPARE(entries.at(0).name, QString("CreateUnit"));
+
+    for (const CompletionIndex::Entry &entry : entries) {
+        QVERIFY(entry.name.startsWith("CreateUnit"));
+    }
+
+    // the number of entries is limited
+    QCOMPARE(completionIndex.find("Get", 100).size(), 100);
+
+    // only the changed function is replaced
+    CompletionIndex::Units units = CompletionIndex::unitsFromAst(ast);
+    units["function MyFunction"].removeLast();
+
+    QCOMPARE(completionIndex.setUnits(units), 1);
+    QCOMPARE(completionIndex.getUserEntriesCount(), 3);
+    QCOMPARE(completionIndex.find("myUnit", 10).size(), 0);
+
+    delete ast;
+}
+
+void TestIndices::canCreateCompletionContext() {
+    // the context only depends on the line in front of the cursor
+    CompletionContext context("    call Get", 12);
+
+    QVERIFY(context.isEnabled());
+    QCOMPARE(context.getPrefix(), QString("Get"));
+    QVERIFY(context.acceptsKind(CompletionIndex::Function));
+    QVERIFY(context.acceptsKind(CompletionIndex::Native));
+    QVERIFY(!context.acceptsKind(CompletionIndex::Global));
+
+    context = CompletionContext("    set x = y", 13);
+
+    QVERIFY(context.acceptsKind(CompletionIndex::Local));
+    QCOMPARE(context.getAssignedVariable(), QString("x"));
+
+    context = CompletionContext("    local unit u = Get", 22);
+
+    QCOMPARE(context.getExpectedType(), QString("unit"));
+
+    QVERIFY(CompletionContext("    local un", 12).acceptsKind(CompletionIndex::Type));
+    QVERIFY(!CompletionContext("    local unit u", 16).isEnabled());
+    QVERIFY(!CompletionContext("    // call Get", 15).isEnabled());
+    QVERIFY(!CompletionContext("    call BJDebugMsg(\"Get", 24).isEnabled());
+    QVERIFY(CompletionContext("Get", 3).isStatementStart());
+}
+
+void TestIndices::canFindSymbols() {
+    // the trigrams of the names skip to the starts of words
+    SymbolIndex symbolIndex;
+    SymbolIndex::Symbols symbols;
+    symbols.push_back(SymbolIndex::Symbol("CreateUnit", CompletionIndex::Native, "takes player id, integer unitid, real x, real y, real face returns unit", 10));
+    symbols.push_back(SymbolIndex::Symbol("CreateUnitAtLoc", CompletionIndex::Native, "takes player id, integer unitid, location whichLocation, real face returns unit", 11));
+    symbols.push_back(SymbolIndex::Symbol("RemoveUnit", CompletionIndex::Native, "takes unit whichUnit returns nothing", 12));
+    symbols.push_back(SymbolIndex::Symbol("GetTriggerUnit", CompletionIndex::Native, "takes nothing returns unit", 13));
+
+    QCOMPARE(symbolIndex.setSymbols("common.j", symbols), 4);
+    QCOMPARE(symbolIndex.size(), 4);
+
+    SymbolIndex::Matches matches = symbolIndex.find("crun", 10);
+
+    QCOMPARE(matches.size(), 2);
+    QCOMPARE(symbolIndex.getSymbol(matches.at(0).id).name, QString("CreateUnit"));
+    QCOMPARE(symbolIndex.getSymbol(matches.at(1).id).name, QString("CreateUnitAtLoc"));
+    QCOMPARE(symbolIndex.find("unit", 10).size(), 4);
+
+    // every subsequence is found even if the name does not contain the trigrams of the query
+    QVERIFY(SymbolIndex::fuzzyScore("CreateUnit", "cut") >= 0);
+    QCOMPARE(symbolIndex.find("cu", 10).size(), 2);
+    QCOMPARE(symbolIndex.find("cut", 10).size(), 2);
+    QCOMPARE(symbolIndex.getSymbol(symbolIndex.find("cut", 10).at(0).id).name, QString("CreateUnit"));
+
+    // the names with the trigrams of the query are ranked first
+    const QVector<int> candidates = symbolIndex.candidates("unitat");
+
+    QCOMPARE(candidates.size(), 2);
+    QCOMPARE(symbolIndex.getSymbol(candidates.at(0)).name, QString("CreateUnitAtLoc"));
+    QCOMPARE(symbolIndex.getSymbol(candidates.at(1)).name, QString("CreateUnit"));
+    QVERIFY(SymbolIndex::fuzzyScore("GetTriggerUnit", "gtu") > SymbolIndex::fuzzyScore("GetTriggerUnit", "etr"));
+    QCOMPARE(SymbolIndex::fuzzyScore("RemoveUnit", "crun"), -1);
+
+    // moved symbols keep their trigrams
+    symbols[0].line = 20;
+
+    QCOMPARE(symbolIndex.setSymbols("common.j", symbols), 0);
+    QCOMPARE(symbolIndex.getSymbol(symbolIndex.find("CreateUnit", 1).at(0).id).line, 20);
+
+    symbols.removeLast();
+
+    QCOMPARE(symbolIndex.setSymbols("common.j", symbols), 1);
+    QVERIFY(symbolIndex.find("gettr", 10).isEmpty());
+
+    symbolIndex.removeSource("common.j");
+
+    QCOMPARE(symbolIndex.size(), 0);
+    QCOMPARE(symbolIndex.getTrigramsCount(), 0);
+
+    // the best match is found among as many symbols as the standard scripts have
+    symbols.clear();
+
+    for (int i = 0; i < 15000; i++) {
+        symbols.push_back(SymbolIndex::Symbol(QString("Function%1Unit%2").arg(i).arg(i % 7), CompletionIndex::Function, "takes nothing returns nothing", i));
+    }
+
+    QCOMPARE(symbolIndex.setSymbols("generated.j", symbols), 15000);
+
+    matches = symbolIndex.find("fun123u", 100);
+
+    QVERIFY(!matches.isEmpty());
+    QCOMPARE(symbolIndex.getSymbol(matches.at(0).id).name, QString("Function123Unit4"));
+}
+
+void TestIndices::canFindReferences() {
+    // a map script with many functions which all refer to the same global
+    QString input = "globals\n    integer counter = 0\nendglobals\n";
+
+    for (int i = 0; i < 5000; i++) {
+        input += QString("function Function%1 takes integer counter returns nothing\n    local integer i = counter\n    set i = i + 1\nendfunction\n").arg(i);
+        input += QString("function Caller%1 takes nothing returns nothing\n    set counter = counter + 1\n    call Function%1(counter)\nendfunction\n").arg(i);
+    }
+
+    CrossReferenceIndex crossReferenceIndex;
+
+    QCOMPARE(crossReferenceIndex.setUnits("map.j", resolveUnits(input)), 10001);
+
+    // the parameters hide the global
+    CrossReferenceIndex::Location location;
+
+    QVERIFY(crossReferenceIndex.findDeclaration("map.j", 4, "counter", location));
+    QCOMPARE(location.line, 3);
+    QCOMPARE(location.column, 33);
+    QVERIFY(crossReferenceIndex.findDeclaration("map.j", 8, "counter", location));
+    QCOMPARE(location.line, 1);
+    QCOMPARE(location.column, 12);
+    QVERIFY(crossReferenceIndex.findDeclaration("map.j", 9, "Function0", location));
+    QCOMPARE(location.line, 3);
+    QVERIFY(!crossReferenceIndex.findDeclaration("map.j", 9, "Unknown", location));
+
+    QVERIFY(crossReferenceIndex.findDeclaration("map.j", 40000, "counter", location));
+    QCOMPARE(location.line, 1);
+    QCOMPARE(crossReferenceIndex.findReferences("map.j", 4, "counter").size(), 2);
+    QCOMPARE(crossReferenceIndex.findReferences("map.j", 8, "counter").size(), 15001);
+
+    // moving the functions down only changes their lines, only the top level lines with the comment and the changed function are replaced
+    input.prepend("// comment\n");
+    input.replace("call Function4999(counter)", "call Function4999(0)");
+
+    QCOMPARE(crossReferenceIndex.setUnits("map.j", resolveUnits(input)), 4);
+    QCOMPARE(crossReferenceIndex.findReferences("map.j", 9, "counter").size(), 15000);
+    QVERIFY(crossReferenceIndex.findDeclaration("map.j", 9, "counter", location));
+    QCOMPARE(location.line, 2);
+
+    crossReferenceIndex.removeSource("map.j");
+
+    QCOMPARE(crossReferenceIndex.getUnitsCount(), 0);
+    QCOMPARE(crossReferenceIndex.getReferencesCount(), 0);
+
+    // a name declared by multiple sources is found in the querying source first and in the standard scripts last
+    const QString declaration = "globals\n    integer shared = 0\nendglobals\nfunction Use takes nothing returns nothing\n    set shared = 1\nendfunction";
+    crossReferenceIndex.setSecondarySources(QStringList() << "common.j");
+    crossReferenceIndex.setUnits("common.j", resolveUnits(declaration));
+    crossReferenceIndex.setUnits("a.j", resolveUnits(declaration));
+    crossReferenceIndex.setUnits("b.j", resolveUnits(declaration));
+
+    QVERIFY(crossReferenceIndex.findDeclaration("b.j", 4, "shared", location));
+    QCOMPARE(location.source, QString("b.j"));
+    QVERIFY(crossReferenceIndex.findDeclaration("common.j", 4, "shared", location));
+    QCOMPARE(location.source, QString("common.j"));
+    QVERIFY(crossReferenceIndex.findDeclaration("other.j", 0, "shared", location));
+    QCOMPARE(location.source, QString("a.j"));
+
+    // editing a declaration does not change the order
+    crossReferenceIndex.setUnits("a.j", resolveUnits(QString(declaration).replace("integer shared = 0", "integer shared = 1")));
+
+    QVERIFY(crossReferenceIndex.findDeclaration("other.j", 0, "shared", location));
+    QCOMPARE(location.source, QString("a.j"));
+    QVERIFY(crossReferenceIndex.findDeclaration("b.j", 4, "shared", location));
+    QCOMPARE(location.source, QString("b.j"));
+}
+
+void TestIndices::canBuildCallGraph() {
+    const QString input = "function A takes nothing returns nothing\n"
+                          "    call B()\n"
+                          "endfunction\n"
+                          "function B takes nothing returns nothing\n"
+                          "    call A()\n"
+                          "    call TimerStart(CreateTimer(), 1.0, false, function C)\n"
+                          "endfunction\n"
+                          "function C takes nothing returns integer\n"
+                          "    return C()\n"
+                          "endfunction\n"
+                          "function D takes nothing returns nothing\n"
+                          "endfunction\n"
+                          "function main takes nothing returns nothing\n"
+                          "    call A()\n"
+                          "endfunction";
+
+    CallGraph callGraph;
+
+    QCOMPARE(callGraph.setUnits(resolveUnits(input)), 5);
+    QCOMPARE(callGraph.getFunctionsCount(), 5);
+    QCOMPARE(callGraph.getEdgesCount(), 7);
+
+    const int a = callGraph.getId("A");
+    const int b = callGraph.getId("B");
+    const int c = callGraph.getId("C");
+    const int d = callGraph.getId("D");
+
+    QCOMPARE(callGraph.getCallees(a), QVector<int>() << b);
+    // code values count as calls
+    QCOMPARE(callGraph.getCallees(b).size(), 4);
+    QVERIFY(callGraph.getCallees(b).contains(c));
+    QVERIFY(!callGraph.isDeclared(callGraph.getId("TimerStart")));
+    QCOMPARE(callGraph.getCallers(c), QVector<int>() << b << c);
+    QCOMPARE(callGraph.getCallers(a), QVector<int>() << b << callGraph.getId("main"));
+    QCOMPARE(callGraph.getLine(d), 10);
+    QCOMPARE(callGraph.findUnreachable(), QVector<int>() << d);
+
+    const QVector<QVector<int>> recursions = callGraph.findRecursions();
+
+    QCOMPARE(recursions.size(), 2);
+    QVERIFY(recursions.contains(QVector<int>() << a << b));
+    QVERIFY(recursions.contains(QVector<int>() << c));
+
+    // moving the functions keeps their edges and changing one function only replaces its edges
+    QString changedInput = input;
+    changedInput.prepend("// comment\n");
+
+    QCOMPARE(callGraph.setUnits(resolveUnits(changedInput)), 0);
+    QCOMPARE(callGraph.getLine(d), 11);
+
+    changedInput.replace("function D takes nothing returns nothing\n", "function D takes nothing returns nothing\n    call A()\n");
+
+    QCOMPARE(callGraph.setUnits(resolveUnits(changedInput)), 1);
+    QCOMPARE(callGraph.getCallers(a), QVector<int>() << b << d << callGraph.getId("main"));
+
+    changedInput.replace("function D takes nothing returns nothing\n    call A()\nendfunction\n", "");
+
+    QCOMPARE(callGraph.setUnits(resolveUnits(changedInput)), 1);
+    QVERIFY(!callGraph.isDeclared(d));
+    QVERIFY(callGraph.findUnreachable().isEmpty());
+    QCOMPARE(callGraph.getEdgesCount(), 7);
+}
+
+void TestIndices::canFindSignatures() {
+    // the active parameter is the number of separators in front of the cursor in the innermost call
+    QString name;
+    int activeParameter = -1;
+
+    QVERIFY(SignatureIndex::findCall("    call CreateUnit(p, 'hfoo', ", 31, name, activeParameter));
+    QCOMPARE(name, QString("CreateUnit"));
+    QCOMPARE(activeParameter, 2);
+    QVERIFY(SignatureIndex::findCall("    call SetUnitX(u, GetUnitX(", 30, name, activeParameter));
+    QCOMPARE(name, QString("GetUnitX"));
+    QCOMPARE(activeParameter, 0);
+    QVERIFY(SignatureIndex::findCall("    call SetUnitX(u, GetUnitX(u) + (1.0 * 2)", 44, name, activeParameter));
+    QCOMPARE(name, QString("SetUnitX"));
+    QCOMPARE(activeParameter, 1);
+    // the text behind the cursor is ignored
+    QVERIFY(SignatureIndex::findCall("    call SetUnitX(u, 0.0)", 19, name, activeParameter));
+    QCOMPARE(activeParameter, 0);
+    QVERIFY(!SignatureIndex::findCall("    call SetUnitX(u, 0.0)", 26, name, activeParameter));
+    QVERIFY(!SignatureIndex::findCall("    call BJDebugMsg(\"a, b", 25, name, activeParameter));
+    QVERIFY(!SignatureIndex::findCall("    // call BJDebugMsg(", 23, name, activeParameter));
+
+    VJassScanner scanner;
+    VJassParser parser;
+    VJassAst *ast = parser.parse(scanner.scan("native GetUnitX takes unit whichUnit returns real\nfunction Move takes unit u, real x returns nothing\nendfunction\nfunction Stop takes nothing returns nothing\nendfunction"));
+    const SignatureIndex::Signatures signatures = SignatureIndex::signaturesFromAst(ast);
+    delete ast;
+
+    QCOMPARE(signatures.size(), 3);
+    QVERIFY(signatures.at(0).isNative);
+    QCOMPARE(signatures.at(1).toString(), QString("function Move takes unit u, real x returns nothing"));
+    QCOMPARE(signatures.at(1).line, 1);
+    QCOMPARE(signatures.at(2).toString(), QString("function Stop takes nothing returns nothing"));
+
+    // the querying source provides its own signature, the standard scripts come last
+    SignatureIndex signatureIndex;
+    signatureIndex.setSecondarySources(QStringList() << "common.j");
+
+    QCOMPARE(signatureIndex.setSignatures("common.j", signatures.mid(0, 1)), 1);
+    QCOMPARE(signatureIndex.setSignatures("map.j", signatures), 3);
+    QCOMPARE(signatureIndex.setSignatures("other.j", signatures.mid(1, 1)), 1);
+    QCOMPARE(signatureIndex.size(), 3);
+    QCOMPARE(signatureIndex.findSource("GetUnitX"), QString("map.j"));
+    QCOMPARE(signatureIndex.findSource("GetUnitX", "common.j"), QString("common.j"));
+    QCOMPARE(signatureIndex.findSource("Move", "other.j"), QString("other.j"));
+
+    // analyzing a source again does not change the order
+    QCOMPARE(signatureIndex.setSignatures("map.j", signatures), 6);
+    QCOMPARE(signatureIndex.findSource("Move", "other.j"), QString("other.j"));
+    QCOMPARE(signatureIndex.findSource("Move"), QString("map.j"));
+    QCOMPARE(signatureIndex.findSource("GetUnitX"), QString("map.j"));
+    QCOMPARE(signatureIndex.find(signatureIndex.getId("Move"))->parameters.size(), 2);
+
+    signatureIndex.removeSource("map.j");
+
+    QCOMPARE(signatureIndex.findSource("GetUnitX"), QString("common.j"));
+
+    signatureIndex.removeSource("common.j");
+    signatureIndex.removeSource("other.j");
+
+    QCOMPARE(signatureIndex.size(), 0);
+    QVERIFY(signatureIndex.find("Move") == nullptr);
+}
+
+QTEST_MAIN(TestIndices)
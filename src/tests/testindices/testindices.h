@@ -0,0 +1,19 @@
+#ifndef TESTINDICES_H
+#define TESTINDICES_H
+
+#include <QTest>
+
+class TestIndices : public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        void canCompleteFromIndex();
+        void canCreateCompletionContext();
+        void canFindSymbols();
+        void canFindReferences();
+        void canBuildCallGraph();
+        void canFindSignatures();
+};
+
+#endif // TESTINDICES_H
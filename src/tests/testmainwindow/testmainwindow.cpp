@@ -1,9 +1,26 @@
 #include <QtTest>
 
 #include "../../app/mainwindow.h"
+#include "ui_mainwindow.h"
 #include "../../app/vjassscanner.h"
 #include "../../app/vjassparser.h"
 #include "../../app/highlightinfo.h"
+#include "../../app/outlinermodel.h"
+#include "../../app/outlinerfiltermodel.h"
+#include "../../app/diagnosticsmodel.h"
+#include "../../app/linenumbers.h"
+#include "../../app/fileloader.h"
+#include "../../app/scriptviewer.h"
+#include "../../app/analysispool.h"
+#include "../../app/analysis.h"
+#include "../../app/finddialog.h"
+#include "../../app/findinfiles.h"
+#include "../../app/completionindex.h"
+#include "../../app/symbolindex.h"
+#include "../../app/symbolpalette.h"
+#include "../../app/crossreferenceindex.h"
+#include "../../app/callgraph.h"
+#include "../../app/signatureindex.h"
 #include "testmainwindow.h"
 
 void TestMainWindow::canHighlight() {
@@ -39,4 +56,1157 @@ void TestMainWindow::canHighlight() {
     ast = nullptr;
 }
 
+void TestMainWindow::canReuseBlockFormatCache() {
+    const QString text = QString("function test takes nothing returns nothing\n")
+            + "call DisplayTextToPlayer(GetLocalPlayer(), 0.0, 0.0, \"Hello\")\n"
+            + "endfunction"
+            ;
+
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic highlighting
+    mainWindow.ui->textEdit->setPlainText(text);
+
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(text, true);
+    HighLightInfo highLightInfo(text, tokens, nullptr);
+
+    mainWindow.currentResultsRevision = mainWindow.ui->textEdit->document()->revision();
+    mainWindow.highlightTokensAndAst(highLightInfo, true);
+
+    // the remaining blocks are highlighted in time slices
+    QTRY_COMPARE(mainWindow.timerIdApplyResults, 0);
+
+    // every block is highlighted from the results without scanning it again
+    QVERIFY(mainWindow.syntaxHighlighter->getBlockFormatCacheHits() >= 3);
+    QCOMPARE(mainWindow.syntaxHighlighter->getBlockFormatCacheMisses(), 0);
+
+    // the edited block is scanned locally
+    QTextCursor cursor(mainWindow.ui->textEdit->document()->findBlockByNumber(1));
+    cursor.insertText("    ");
+
+    QCOMPARE(mainWindow.syntaxHighlighter->getBlockFormatCacheMisses(), 1);
+
+    // rehighlighting an unchanged block does not scan it
+    const int hits = mainWindow.syntaxHighlighter->getBlockFormatCacheHits();
+    mainWindow.syntaxHighlighter->rehighlightBlock(mainWindow.ui->textEdit->document()->findBlockByNumber(2));
+
+    QCOMPARE(mainWindow.syntaxHighlighter->getBlockFormatCacheHits(), hits + 1);
+    QCOMPARE(mainWindow.syntaxHighlighter->getBlockFormatCacheMisses(), 1);
+}
+
+void TestMainWindow::canApplyResultsInTimeSlices() {
+    QFile f("wc3reforged/Blizzard.j");
+
+    QVERIFY(f.open(QFile::ReadOnly | QFile::Text));
+
+    QTextStream in(&f);
+    QString input = in.readAll();
+
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic highlighting
+    mainWindow.ui->textEdit->setPlainText(input);
+    mainWindow.ui->tabWidget->setCurrentIndex(1);
+
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(input, true);
+    VJassParser parser;
+    VJassAst *ast = parser.parse(tokens);
+
+    mainWindow.currentResults.reset(new HighLightInfo(input, tokens, ast, ast->getAllParseErrors()));
+    mainWindow.currentResultsRevision = mainWindow.ui->textEdit->document()->revision();
+    mainWindow.updateResultsTabTexts();
+    mainWindow.updateSyntaxErrorsList();
+    mainWindow.updateOutliner();
+    mainWindow.updateMemoryLeaks();
+    mainWindow.highlightVisibleBlocks();
+
+    // a single slice stops after its budget and leaves the remaining blocks to the following slices
+    const int blockCount = mainWindow.ui->textEdit->document()->blockCount();
+    mainWindow.applyResultsSlice();
+    QVERIFY(mainWindow.highlightingProgress > 0);
+    QVERIFY(mainWindow.highlightingProgress < blockCount);
+    QVERIFY(mainWindow.timerIdApplyResults != 0);
+
+    QTRY_COMPARE(mainWindow.highlightingProgress, -1);
+
+    // the outliner model is filled at once since it does not create any labels
+    QCOMPARE(mainWindow.outlinerModel->rowCount(), mainWindow.currentResults->getAstElements().size());
+
+    QCOMPARE(mainWindow.diagnosticsModel->getErrorsCount(), mainWindow.currentResults->getParseErrors().size());
+
+    // the hidden memory leaks are only filled when the tab is shown
+    QVERIFY(mainWindow.memoryLeaksProgress != -1);
+    QCOMPARE(mainWindow.timerIdApplyResults, 0);
+
+    mainWindow.ui->tabWidget->setCurrentIndex(2);
+
+    QTRY_COMPARE(mainWindow.memoryLeaksProgress, -1);
+}
+
+namespace {
+
+inline QSharedPointer<HighLightInfo> analyze(const QString &text) {
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(text, true);
+    VJassParser parser;
+    VJassAst *ast = parser.parse(tokens);
+
+    return QSharedPointer<HighLightInfo>(new HighLightInfo(text, tokens, ast, ast->getAllParseErrors()));
+}
+
+}
+
+void TestMainWindow::canUpdateOutlinerIncrementally() {
+    const QString text = QString("type unit extends handle\n")
+            + "globals\n"
+            + "constant integer A = 1\n"
+            + "integer b = 2\n"
+            + "endglobals\n"
+            + "native Foo takes nothing returns nothing\n"
+            + "function Bar takes nothing returns nothing\n"
+            + "endfunction\n"
+            + "function Baz takes nothing returns nothing\n"
+            + "endfunction"
+            ;
+
+    OutlinerModel outlinerModel;
+    QSignalSpy insertedSpy(&outlinerModel, &OutlinerModel::rowsInserted);
+    QSignalSpy removedSpy(&outlinerModel, &OutlinerModel::rowsRemoved);
+    QSignalSpy resetSpy(&outlinerModel, &OutlinerModel::modelReset);
+    QSignalSpy changedSpy(&outlinerModel, &OutlinerModel::dataChanged);
+
+    outlinerModel.setResults(analyze(text));
+
+    QCOMPARE(outlinerModel.rowCount(), 6);
+    QCOMPARE(insertedSpy.size(), 1);
+    QCOMPARE(outlinerModel.getKind(0), OutlinerModel::Type);
+    QCOMPARE(outlinerModel.getKind(1), OutlinerModel::Constant);
+    QCOMPARE(outlinerModel.getKind(2), OutlinerModel::Global);
+    QCOMPARE(outlinerModel.getKind(3), OutlinerModel::Native);
+    QCOMPARE(outlinerModel.getKind(4), OutlinerModel::Function);
+    QCOMPARE(outlinerModel.index(5).data(OutlinerModel::PositionRole).toPoint(), QPoint(8, 0));
+    QVERIFY(outlinerModel.index(4).data().toString().startsWith("function Bar"));
+
+    // renaming one function replaces only its row and a new line moves the following rows
+    insertedSpy.clear();
+    outlinerModel.setResults(analyze(QString(text).replace("function Bar", "\nfunction Qux")));
+
+    QCOMPARE(outlinerModel.rowCount(), 6);
+    QCOMPARE(insertedSpy.size(), 1);
+    QCOMPARE(removedSpy.size(), 1);
+    QCOMPARE(insertedSpy.at(0).at(1).toInt(), 4);
+    QCOMPARE(removedSpy.at(0).at(1).toInt(), 4);
+    QVERIFY(outlinerModel.index(4).data().toString().startsWith("function Qux"));
+    QCOMPARE(outlinerModel.index(5).data(OutlinerModel::PositionRole).toPoint(), QPoint(9, 0));
+    // only the moved declaration is reported as changed
+    QCOMPARE(changedSpy.size(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).toModelIndex().row(), 5);
+    QCOMPARE(changedSpy.at(0).at(1).toModelIndex().row(), 5);
+
+    // changing the declaration of a kept row reports only this row
+    changedSpy.clear();
+    outlinerModel.setResults(analyze(QString(text).replace("function Bar", "\nfunction Qux").replace("integer b = 2", "integer b = 3")));
+
+    QCOMPARE(changedSpy.size(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).toModelIndex().row(), 2);
+    QCOMPARE(changedSpy.at(0).at(1).toModelIndex().row(), 2);
+
+    // the same results do not change any rows
+    insertedSpy.clear();
+    removedSpy.clear();
+    changedSpy.clear();
+    outlinerModel.setResults(outlinerModel.getResults());
+
+    QCOMPARE(insertedSpy.size(), 0);
+    QCOMPARE(removedSpy.size(), 0);
+    QCOMPARE(changedSpy.size(), 0);
+    QCOMPARE(resetSpy.size(), 0);
+
+    OutlinerFilterModel outlinerFilterModel;
+    outlinerFilterModel.setSourceModel(&outlinerModel);
+    QCOMPARE(outlinerFilterModel.rowCount(), 6);
+
+    outlinerFilterModel.setKindVisible(OutlinerModel::Function, false);
+    outlinerFilterModel.setKindVisible(OutlinerModel::Global, false);
+    QCOMPARE(outlinerFilterModel.rowCount(), 3);
+
+    // removing all declarations clears the model
+    outlinerModel.setResults(QSharedPointer<HighLightInfo>());
+
+    QCOMPARE(outlinerModel.rowCount(), 0);
+    QCOMPARE(outlinerFilterModel.rowCount(), 0);
+
+    // the main window shows a placeholder if the filter does not accept any declaration
+    MainWindow mainWindow;
+    mainWindow.pauseParserThread();
+    QVERIFY(!mainWindow.ui->outlinerPlaceholderLabel->isHidden());
+
+    mainWindow.outlinerModel->setResults(analyze(text));
+    QVERIFY(mainWindow.ui->outlinerPlaceholderLabel->isHidden());
+
+    mainWindow.ui->checkBoxAll->click();
+    QVERIFY(!mainWindow.ui->outlinerPlaceholderLabel->isHidden());
+
+    mainWindow.ui->checkBoxFunctions->click();
+    QVERIFY(mainWindow.ui->outlinerPlaceholderLabel->isHidden());
+}
+
+void TestMainWindow::canUpdateDiagnosticsIncrementally() {
+    const QString text = QString("function Foo takes nothing returns nothing\n")
+            + "set = 10\n"
+            + "endfunction\n"
+            + "function Bar takes nothing returns nothing\n"
+            + "set = 10\n"
+            + "endfunction"
+            ;
+
+    DiagnosticsModel diagnosticsModel;
+    QSignalSpy insertedSpy(&diagnosticsModel, &DiagnosticsModel::rowsInserted);
+    QSignalSpy removedSpy(&diagnosticsModel, &DiagnosticsModel::rowsRemoved);
+    QSignalSpy changedSpy(&diagnosticsModel, &DiagnosticsModel::dataChanged);
+
+    QSharedPointer<HighLightInfo> results = analyze(text);
+    const int errorsCount = results->getParseErrors().size();
+    QVERIFY(errorsCount >= 2);
+
+    diagnosticsModel.setResults(results);
+
+    QCOMPARE(diagnosticsModel.rowCount(), errorsCount);
+    QCOMPARE(diagnosticsModel.getErrorsCount(), errorsCount);
+    QCOMPARE(insertedSpy.size(), 1);
+    QCOMPARE(diagnosticsModel.index(0, DiagnosticsModel::LineColumn).data().toInt(), 2);
+    QCOMPARE(diagnosticsModel.index(0, DiagnosticsModel::FunctionColumn).data().toString(), QString("Foo"));
+    QCOMPARE(diagnosticsModel.index(errorsCount - 1, DiagnosticsModel::FunctionColumn).data().toString(), QString("Bar"));
+
+    // inserting lines before a function keeps the identities of its errors and only changes their positions
+    insertedSpy.clear();
+    diagnosticsModel.setResults(analyze("\n\n" + text));
+
+    QCOMPARE(diagnosticsModel.rowCount(), errorsCount);
+    QCOMPARE(insertedSpy.size(), 0);
+    QCOMPARE(removedSpy.size(), 0);
+    QCOMPARE(changedSpy.size(), 1);
+    QCOMPARE(diagnosticsModel.index(0, DiagnosticsModel::LineColumn).data().toInt(), 4);
+
+    // fixing the error of one function removes only its rows
+    changedSpy.clear();
+    diagnosticsModel.setResults(analyze("\n\n" + QString(text).replace("set = 10\nendfunction\nfunction Bar", "set x = 10\nendfunction\nfunction Bar")));
+
+    QVERIFY(diagnosticsModel.rowCount() < errorsCount);
+    QCOMPARE(insertedSpy.size(), 0);
+    QCOMPARE(removedSpy.size(), 1);
+    QCOMPARE(changedSpy.size(), 0);
+    QCOMPARE(diagnosticsModel.index(0, DiagnosticsModel::FunctionColumn).data().toString(), QString("Bar"));
+
+    // grouping by function creates one group per function with errors
+    diagnosticsModel.setResults(results);
+    diagnosticsModel.setGrouping(DiagnosticsModel::GroupByFunction);
+
+    QCOMPARE(diagnosticsModel.rowCount(), 2);
+    QVERIFY(diagnosticsModel.index(0, 0).data().toString().startsWith("function Foo"));
+
+    const QModelIndex barGroup = diagnosticsModel.index(1, 0);
+    QVERIFY(diagnosticsModel.rowCount(barGroup) > 0);
+    QCOMPARE(diagnosticsModel.parent(diagnosticsModel.index(0, 0, barGroup)), barGroup);
+
+    // the group of the fixed function is removed and the other group keeps its errors
+    insertedSpy.clear();
+    removedSpy.clear();
+    diagnosticsModel.setResults(analyze(QString(text).replace("set = 10\nendfunction\nfunction Bar", "set x = 10\nendfunction\nfunction Bar")));
+
+    QCOMPARE(diagnosticsModel.rowCount(), 1);
+    QCOMPARE(insertedSpy.size(), 0);
+    QCOMPARE(removedSpy.size(), 1);
+    QVERIFY(diagnosticsModel.index(0, 0).data().toString().startsWith("function Bar"));
+
+    diagnosticsModel.setGrouping(DiagnosticsModel::GroupBySeverity);
+
+    QCOMPARE(diagnosticsModel.rowCount(), 1);
+    QCOMPARE(diagnosticsModel.rowCount(diagnosticsModel.index(0, 0)), diagnosticsModel.getErrorsCount());
+}
+
+void TestMainWindow::canUpdateManyDiagnostics() {
+    // every line is broken
+    QString text;
+
+    for (int i = 0; i < 20000; i++) {
+        text += "set = 10\n";
+    }
+
+    DiagnosticsModel diagnosticsModel;
+    QSharedPointer<HighLightInfo> results = analyze(text);
+
+    QBENCHMARK {
+        diagnosticsModel.setResults(results);
+    }
+
+    QVERIFY(diagnosticsModel.rowCount() >= 20000);
+
+    // the same errors do not change any rows
+    QSignalSpy insertedSpy(&diagnosticsModel, &DiagnosticsModel::rowsInserted);
+    QSignalSpy removedSpy(&diagnosticsModel, &DiagnosticsModel::rowsRemoved);
+    diagnosticsModel.setResults(analyze(text));
+
+    QCOMPARE(insertedSpy.size(), 0);
+    QCOMPARE(removedSpy.size(), 0);
+}
+
+void TestMainWindow::canPaintVisibleLineNumbers() {
+    QString text;
+
+    for (int i = 0; i < 20000; i++) {
+        text += "set = 10\n";
+    }
+
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic highlighting
+    mainWindow.ui->textEdit->setPlainText(text);
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWindow));
+
+    LineNumbers *lineNumbers = mainWindow.ui->lineNumbersWidget;
+    QCOMPARE(lineNumbers->getTextEdit(), mainWindow.ui->textEdit);
+
+    // scrolling invalidates the visible lines which are painted starting with the first visible block
+    mainWindow.ui->textEdit->verticalScrollBar()->setValue(10000);
+    lineNumbers->repaint();
+
+    const int firstVisibleLine = mainWindow.ui->textEdit->getFirstVisibleBlock().blockNumber();
+    QVERIFY(firstVisibleLine > 0);
+    QVERIFY(lineNumbers->getVisibleLinesCount() > 0);
+    QVERIFY(lineNumbers->getVisibleLinesCount() < 1000);
+    QCOMPARE(lineNumbers->lineAt(mainWindow.ui->textEdit->viewport()->mapTo(lineNumbers->window(), QPoint(0, 0)).y() - lineNumbers->mapTo(lineNumbers->window(), QPoint(0, 0)).y()), firstVisibleLine);
+
+    int value = 0;
+
+    QBENCHMARK {
+        value = (value + 37) % 20000;
+        mainWindow.ui->textEdit->verticalScrollBar()->setValue(value);
+        lineNumbers->repaint();
+    }
+
+    QVERIFY(lineNumbers->getVisibleLinesCount() < 1000);
+}
+
+void TestMainWindow::canHighlightCurrentLineWithoutRehighlighting() {
+    QString text;
+
+    for (int i = 0; i < 2000; i++) {
+        text += "call DisplayTextToPlayer(GetLocalPlayer(), 0.0, 0.0, \"Hello\")\n";
+    }
+
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic highlighting
+    mainWindow.ui->textEdit->setPlainText(text);
+
+    const int hits = mainWindow.syntaxHighlighter->getBlockFormatCacheHits();
+    const int misses = mainWindow.syntaxHighlighter->getBlockFormatCacheMisses();
+
+    // moving the cursor line by line
+    for (int i = 0; i < 100; i++) {
+        mainWindow.ui->textEdit->moveCursor(QTextCursor::Down);
+    }
+
+    QCOMPARE(mainWindow.currentLineStart, 100);
+    QCOMPARE(mainWindow.currentLineEnd, 100);
+
+    // selecting many lines
+    QTextCursor cursor = mainWindow.ui->textEdit->textCursor();
+    cursor.movePosition(QTextCursor::Down, QTextCursor::KeepAnchor, 1000);
+    mainWindow.ui->textEdit->setTextCursor(cursor);
+
+    QCOMPARE(mainWindow.currentLineStart, 100);
+    QCOMPARE(mainWindow.currentLineEnd, 1100);
+
+    // no block has been highlighted again
+    QCOMPARE(mainWindow.syntaxHighlighter->getBlockFormatCacheHits(), hits);
+    QCOMPARE(mainWindow.syntaxHighlighter->getBlockFormatCacheMisses(), misses);
+
+    // the lines are painted as one extra selection
+    const QList<QTextEdit::ExtraSelection> extraSelections = mainWindow.ui->textEdit->extraSelections();
+    QVERIFY(extraSelections.size() >= 1);
+    QVERIFY(extraSelections.at(0).format.boolProperty(QTextFormat::FullWidthSelection));
+    QCOMPARE(mainWindow.ui->textEdit->document()->findBlock(extraSelections.at(0).cursor.selectionStart()).blockNumber(), 100);
+    QCOMPARE(mainWindow.ui->textEdit->document()->findBlock(extraSelections.at(0).cursor.selectionEnd()).blockNumber(), 1100);
+}
+
+void TestMainWindow::canLoadFileProgressively() {
+    QFile f("wc3reforged/Blizzard.j");
+
+    QVERIFY(f.open(QFile::ReadOnly));
+    const QString input = QString::fromUtf8(f.readAll());
+
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic highlighting
+
+    QSignalSpy chunkSpy(mainWindow.fileLoader, &FileLoader::chunkLoaded);
+    QSignalSpy finishedSpy(mainWindow.fileLoader, &FileLoader::finished);
+    qint64 lastChunkNs = -1;
+    // the main window has inserted the chunk before
+    connect(mainWindow.fileLoader, &FileLoader::chunkLoaded, this, [&mainWindow, &lastChunkNs]() { lastChunkNs = mainWindow.loadingTimer.nsecsElapsed(); });
+
+    QVERIFY(!mainWindow.loadFile("wc3reforged/doesnotexist.j"));
+    QVERIFY(mainWindow.loadFile("wc3reforged/Blizzard.j"));
+    QVERIFY(mainWindow.fileLoader->isLoading());
+    QVERIFY(mainWindow.ui->textEdit->isReadOnly());
+
+    QTRY_COMPARE(finishedSpy.size(), 1);
+    QCOMPARE(finishedSpy.at(0).at(0).toBool(), true);
+
+    // the file is larger than one chunk and every chunk ends with a complete line
+    QVERIFY(chunkSpy.size() > 1);
+
+    for (const QList<QVariant> &arguments : chunkSpy) {
+        QVERIFY(arguments.at(0).toString().endsWith('\n'));
+    }
+
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText(), input);
+    QVERIFY(!mainWindow.ui->textEdit->isReadOnly());
+    QVERIFY(!mainWindow.documentHasChanged);
+    QVERIFY(!mainWindow.ui->textEdit->document()->isUndoAvailable());
+    // the first screen has been highlighted before the rest of the file has been inserted
+    QVERIFY(mainWindow.loadingFirstScreenNs > 0);
+    QVERIFY(mainWindow.loadingFirstScreenNs < lastChunkNs);
+
+    // a cancelled file does not stay bound to its truncated text
+    QVERIFY(mainWindow.openDocument("wc3reforged/common.j"));
+    QCOMPARE(mainWindow.documents.size(), 2);
+    QVERIFY(mainWindow.fileLoader->isLoading());
+
+    mainWindow.newFile();
+
+    QCOMPARE(mainWindow.documents.size(), 2);
+
+    for (const MainWindow::Document *document : mainWindow.documents) {
+        QVERIFY(document->filePath.isEmpty());
+    }
+
+    QVERIFY(mainWindow.closeFile());
+    QVERIFY(mainWindow.openDocument("wc3reforged/common.j"));
+    QVERIFY(mainWindow.closeFile());
+
+    QCOMPARE(mainWindow.documents.size(), 1);
+    QVERIFY(!mainWindow.fileLoader->isLoading());
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText(), input);
+}
+
+void TestMainWindow::canViewMappedScript() {
+    QFile f("wc3reforged/Blizzard.j");
+
+    QVERIFY(f.open(QFile::ReadOnly));
+    const QStringList lines = QString::fromUtf8(f.readAll()).split('\n');
+
+    ScriptViewer scriptViewer;
+    scriptViewer.resize(800, 600);
+    scriptViewer.show();
+
+    QVERIFY(!scriptViewer.open("wc3reforged/doesnotexist.j"));
+    QVERIFY(scriptViewer.open("wc3reforged/Blizzard.j"));
+
+    MappedScript *script = scriptViewer.getScript();
+    QTRY_VERIFY(!script->isIndexing());
+    QCOMPARE(script->getLineCount(), lines.size());
+    QCOMPARE(script->getLine(0), lines.at(0));
+    QCOMPARE(script->getLine(1000), lines.at(1000));
+    QCOMPARE(script->getLine(lines.size() - 1), lines.last());
+    QCOMPARE(script->getLine(lines.size()), QString());
+
+    // only the visible lines are scanned
+    scriptViewer.scrollToLine(5000);
+    scriptViewer.viewport()->repaint();
+
+    QCOMPARE(scriptViewer.getFirstVisibleLine(), 5000);
+    QVERIFY(scriptViewer.getScannedLinesCount() > 0);
+    QVERIFY(scriptViewer.getScannedLinesCount() <= 2 * scriptViewer.getVisibleLinesCount());
+
+    // painting the same lines again uses the cached format runs
+    const int scannedLinesCount = scriptViewer.getScannedLinesCount();
+    scriptViewer.viewport()->repaint();
+
+    QCOMPARE(scriptViewer.getScannedLinesCount(), scannedLinesCount);
+}
+
+void TestMainWindow::canPrioritizeAnalysisJobs() {
+    AnalysisPool analysisPool(1);
+    QSemaphore started;
+    QSemaphore blocked;
+    QMutex mutex;
+    QList<quintptr> order;
+
+    // keeps the only thread busy until all jobs have been enqueued
+    analysisPool.enqueue(1, [&started, &blocked]() {
+        started.release();
+        blocked.acquire();
+    });
+    started.acquire();
+
+    for (quintptr queueId = 1; queueId <= 3; queueId++) {
+        analysisPool.enqueue(queueId, [&mutex, &order, queueId]() {
+            QMutexLocker locker(&mutex);
+            order.push_back(queueId);
+        });
+    }
+
+    analysisPool.setPriorityQueue(3);
+
+    QCOMPARE(analysisPool.getPendingJobsCount(), 3);
+    QCOMPARE(analysisPool.getPendingJobsCount(3), 1);
+    QCOMPARE(analysisPool.getRunningJobsCount(), 1);
+
+    blocked.release();
+
+    QVERIFY(analysisPool.waitForDone(5000));
+    QCOMPARE(order, QList<quintptr>() << 3 << 1 << 2);
+
+    // many documents do not require more threads
+    QAtomicInt finishedJobs;
+    AnalysisPool boundedAnalysisPool(2);
+
+    for (quintptr queueId = 1; queueId <= 30; queueId++) {
+        boundedAnalysisPool.enqueue(queueId, [&finishedJobs]() {
+            QThread::msleep(1);
+            finishedJobs.ref();
+        });
+    }
+
+    QVERIFY(boundedAnalysisPool.getThreadCount() <= 2);
+    QVERIFY(boundedAnalysisPool.waitForDone(5000));
+    QCOMPARE(finishedJobs.loadAcquire(), 30);
+}
+
+void TestMainWindow::canSwitchDocumentTabs() {
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic highlighting
+    mainWindow.ui->textEdit->setPlainText("function a takes nothing returns nothing\nendfunction");
+
+    QTextDocument *firstDocument = mainWindow.ui->textEdit->document();
+
+    mainWindow.newFile();
+
+    QCOMPARE(mainWindow.documents.size(), 2);
+    QCOMPARE(mainWindow.documentTabBar->currentIndex(), 1);
+    QVERIFY(mainWindow.ui->textEdit->document() != firstDocument);
+    QVERIFY(mainWindow.ui->textEdit->toPlainText().isEmpty());
+    QVERIFY(!mainWindow.documentHasChanged);
+    QCOMPARE(mainWindow.analysisPool->getPriorityQueue(), static_cast<quintptr>(mainWindow.documents.at(1)->id));
+
+    mainWindow.ui->textEdit->setPlainText("globals\nendglobals");
+
+    // every document keeps its own state
+    mainWindow.documentTabBar->setCurrentIndex(0);
+
+    QCOMPARE(mainWindow.ui->textEdit->document(), firstDocument);
+    QVERIFY(mainWindow.documentHasChanged);
+    QVERIFY(mainWindow.documents.at(1)->hasChanged);
+    QCOMPARE(mainWindow.analysisPool->getPriorityQueue(), static_cast<quintptr>(mainWindow.documents.at(0)->id));
+
+    // opening a file which is already open shows its tab
+    QVERIFY(mainWindow.openDocument("wc3reforged/common.j"));
+    QTRY_VERIFY(!mainWindow.fileLoader->isLoading());
+    QCOMPARE(mainWindow.documents.size(), 3);
+    QCOMPARE(mainWindow.documentTabBar->tabText(2), QString("common.j"));
+
+    mainWindow.documentTabBar->setCurrentIndex(0);
+    QVERIFY(mainWindow.openDocument("wc3reforged/common.j"));
+    QCOMPARE(mainWindow.documents.size(), 3);
+    QCOMPARE(mainWindow.documentTabBar->currentIndex(), 2);
+
+    // removing the active document shows another one
+    const int removedId = mainWindow.documents.at(2)->id;
+    mainWindow.removeDocument(2);
+
+    QCOMPARE(mainWindow.documents.size(), 2);
+    QVERIFY(mainWindow.activeDocument != nullptr);
+    QCOMPARE(mainWindow.ui->textEdit->document(), mainWindow.activeDocument->textDocument);
+
+    // late results of the removed document are never applied to a new one
+    mainWindow.newFile();
+
+    QVERIFY(mainWindow.activeDocument->id > removedId);
+    QVERIFY(mainWindow.findDocument(removedId) == nullptr);
+}
+
+void TestMainWindow::canFindInBackground() {
+    const QString text = "function Foo takes nothing returns nothing\n"
+                         "    // call Foo\n"
+                         "    call BJDebugMsg(\"Foo\")\n"
+                         "    call Foo()\n"
+                         "endfunction";
+
+    // comments and strings are skipped for identifiers only
+    QCOMPARE(FindEngine::findMatches(text, "foo", FindEngine::NoOptions).size(), 4);
+    QCOMPARE(FindEngine::findMatches(text, "foo", FindEngine::CaseSensitive).size(), 0);
+    QCOMPARE(FindEngine::findMatches(text, "F[o]+", FindEngine::RegularExpression | FindEngine::CaseSensitive).size(), 4);
+    QCOMPARE(FindEngine::findMatches(text, "F[o", FindEngine::RegularExpression).size(), 0);
+    QCOMPARE(FindEngine::findMatches(text, "Foo", FindEngine::IdentifiersOnly).size(), 2);
+
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic highlighting
+    mainWindow.ui->textEdit->setPlainText(text);
+
+    FindDialog *findDialog = mainWindow.findDialog;
+    QSignalSpy finishedSpy(findDialog->getFindEngine(), &FindEngine::finished);
+    findDialog->setCaseSensitive(true);
+    findDialog->setSearchExpression("Foo");
+
+    QVERIFY(finishedSpy.wait());
+    QVERIFY(findDialog->hasCurrentMatches());
+    QCOMPARE(findDialog->getMatches().size(), 4);
+
+    // jumping wraps around without any message box
+    QVERIFY(findDialog->findPrevious());
+    QCOMPARE(findDialog->getCurrentMatchIndex(), 3);
+    QVERIFY(findDialog->findNext());
+    QCOMPARE(findDialog->getCurrentMatchIndex(), 0);
+    QCOMPARE(mainWindow.ui->textEdit->textCursor().selectedText(), QString("Foo"));
+
+    // replacing all matches can be undone at once
+    findDialog->setIdentifiersOnly(true);
+    findDialog->setReplacementText("Bar");
+
+    QCOMPARE(findDialog->replaceAll(), 2);
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText(), QString(text).replace("function Foo", "function Bar").replace("call Foo()", "call Bar()"));
+
+    mainWindow.ui->textEdit->undo();
+
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText(), text);
+}
+
+void TestMainWindow::canFindInFiles() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkdir("sub"));
+
+    QFile script(dir.filePath("sub/war3map.j"));
+    QVERIFY(script.open(QIODevice::WriteOnly));
+    script.write("globals\r\n    // Foo\r\nendglobals\r\nfunction Foo takes nothing returns nothing\r\nendfunction\r\n");
+    script.close();
+
+    QFile ai(dir.filePath("test.ai"));
+    QVERIFY(ai.open(QIODevice::WriteOnly));
+    ai.write("call Foo()");
+    ai.close();
+
+    QFile other(dir.filePath("readme.txt"));
+    QVERIFY(other.open(QIODevice::WriteOnly));
+    other.write("Foo");
+    other.close();
+
+    QCOMPARE(FindInFiles::scriptFiles(dir.path()).size(), 2);
+
+    const FindInFiles::Results results = FindInFiles::findInFile(dir.filePath("sub/war3map.j"), "Foo", FindEngine::CaseSensitive | FindEngine::IdentifiersOnly);
+
+    QCOMPARE(results.size(), 1);
+    QCOMPARE(results.at(0).line, 3);
+    QCOMPARE(results.at(0).column, 9);
+    QCOMPARE(results.at(0).lineText, QString("function Foo takes nothing returns nothing"));
+
+    // the results are streamed file by file
+    FindInFiles findInFiles(2);
+    QSignalSpy resultsSpy(&findInFiles, &FindInFiles::resultsFound);
+    QSignalSpy finishedSpy(&findInFiles, &FindInFiles::finished);
+    findInFiles.find(QStringList() << dir.path(), "foo", FindEngine::NoOptions);
+
+    QVERIFY(findInFiles.isSearching());
+    QVERIFY(finishedSpy.wait());
+    QCOMPARE(finishedSpy.first().first().toBool(), true);
+    QCOMPARE(resultsSpy.size(), 2);
+    QCOMPARE(findInFiles.getSearchedFilesCount(), 2);
+    QCOMPARE(findInFiles.getResultsCount(), 3);
+
+    // cancelling discards all further results
+    finishedSpy.clear();
+    resultsSpy.clear();
+    findInFiles.find(QStringList() << "wc3reforged", "Unit", FindEngine::NoOptions);
+    findInFiles.cancel();
+
+    QCOMPARE(finishedSpy.size(), 1);
+    QCOMPARE(finishedSpy.first().first().toBool(), false);
+    QVERIFY(!findInFiles.isSearching());
+
+    // a result which has been queued by the cancelled search is ignored
+    const int searchedFilesCount = findInFiles.getSearchedFilesCount();
+    const int cancelledGeneration = findInFiles.generation - 1;
+    QMetaObject::invokeMethod(&findInFiles, [&findInFiles, cancelledGeneration]() {
+        findInFiles.receiveResults(cancelledGeneration, FindInFiles::Results() << FindInFiles::Result("common.j", 0, 0, 4, "Unit"));
+    }, Qt::QueuedConnection);
+    QCoreApplication::sendPostedEvents(&findInFiles, QEvent::MetaCall);
+
+    QCOMPARE(resultsSpy.size(), 0);
+    QCOMPARE(findInFiles.getSearchedFilesCount(), searchedFilesCount);
+}
+
+void TestMainWindow::canFoldBlocks() {
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic analysis
+    mainWindow.ui->textEdit->setPlainText("function a takes nothing returns nothing\n"
+                                          "    loop\n"
+                                          "        exitwhen true\n"
+                                          "    endloop\n"
+                                          "endfunction\n"
+                                          "function b takes nothing returns nothing\n"
+                                          "endfunction");
+    applyAnalysis(mainWindow);
+
+    QCOMPARE(mainWindow.currentResults->getFoldRangeIndex().size(), 3);
+
+    QTextDocument *document = mainWindow.ui->textEdit->document();
+    const int visibleLinesCount = mainWindow.ui->lineNumbersWidget->getVisibleLinesCount();
+
+    mainWindow.toggleFold(0);
+
+    QVERIFY(mainWindow.ui->textEdit->isFolded(0));
+    QVERIFY(document->findBlockByNumber(0).isVisible());
+    QVERIFY(!document->findBlockByNumber(1).isVisible());
+    QVERIFY(!document->findBlockByNumber(4).isVisible());
+    QVERIFY(document->findBlockByNumber(5).isVisible());
+    // the gutter skips the hidden lines
+    QTRY_COMPARE(mainWindow.ui->lineNumbersWidget->getVisibleLinesCount(), visibleLinesCount - 4);
+
+    // moving the cursor into a folded block shows it
+    mainWindow.moveCursorToLine(2);
+
+    QVERIFY(!mainWindow.ui->textEdit->isFolded(0));
+    QVERIFY(document->findBlockByNumber(2).isVisible());
+
+    mainWindow.moveCursorToLine(0);
+    mainWindow.foldAll();
+
+    QVERIFY(mainWindow.ui->textEdit->isFolded(0));
+    QVERIFY(mainWindow.ui->textEdit->isFolded(5));
+
+    mainWindow.unfoldAll();
+
+    for (QTextBlock block = document->firstBlock(); block.isValid(); block = block.next()) {
+        QVERIFY(block.isVisible());
+    }
+}
+
+void TestMainWindow::canCompleteFromIndex() {
+    const QString text = "globals\n"
+                         "    integer myCounter = 0\n"
+                         "endglobals\n"
+                         "function MyFunction takes integer myParameter returns nothing\n"
+                         "    local unit myUnit = null\n"
+                         "endfunction";
+
+    // the popup is filled from the index of the document
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic analysis
+    mainWindow.ui->textEdit->setPlainText(text + "\nfunction b takes nothing returns nothing\n    call MyF");
+    applyAnalysis(mainWindow);
+
+    QVERIFY(mainWindow.activeDocument->completionIndex.getUserEntriesCount() > 0);
+
+    QTextCursor cursor = mainWindow.ui->textEdit->textCursor();
+    cursor.movePosition(QTextCursor::End);
+    mainWindow.ui->textEdit->setTextCursor(cursor);
+
+    QCOMPARE(mainWindow.completionPrefix(), QString("MyF"));
+
+    mainWindow.showCompletionPopup();
+
+    QVERIFY(mainWindow.popup->isVisible());
+    QCOMPARE(mainWindow.popup->getCompletionModel()->rowCount(), 1);
+
+    // typing filters the popup
+    mainWindow.ui->textEdit->insertPlainText("x");
+
+    QVERIFY(!mainWindow.popup->isVisible());
+}
+
+void TestMainWindow::canCompleteWithinOneFrame() {
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic analysis
+    mainWindow.ui->textEdit->setPlainText("globals\n    unit myGlobal = null\n    integer myCounter = 0\nendglobals\nfunction MyFunction takes integer myParameter returns nothing\n    local unit myUnit = null\nendfunction\nfunction b takes nothing returns nothing\n    local integer myLocal = 0\n    set myLocal = my\nendfunction");
+    applyAnalysis(mainWindow);
+
+    QVERIFY(mainWindow.activeDocument->completionIndex.getUserEntriesCount() > 0);
+
+    QTextCursor cursor = mainWindow.ui->textEdit->textCursor();
+    cursor.movePosition(QTextCursor::End);
+    cursor.movePosition(QTextCursor::Up);
+    cursor.movePosition(QTextCursor::EndOfBlock);
+    mainWindow.ui->textEdit->setTextCursor(cursor);
+
+    // the entries of the expected type come first and locals of other functions are hidden
+    CompletionContext context = mainWindow.completionContext();
+
+    QCOMPARE(context.getFunction(), QString("b"));
+    QCOMPARE(context.getExpectedType(), QString("integer"));
+
+    CompletionIndex::Entries entries = mainWindow.activeDocument->completionIndex.find(context, 100);
+
+    QCOMPARE(entries.size(), 4);
+    QCOMPARE(entries.at(0).name, QString("myCounter"));
+    QCOMPARE(entries.at(1).name, QString("myLocal"));
+    QCOMPARE(entries.at(2).name, QString("MyFunction"));
+    QCOMPARE(entries.at(3).name, QString("myGlobal"));
+
+    // the popup is shown from the current line before the changed text has been analyzed
+    mainWindow.ui->textEdit->insertPlainText("C");
+    context = mainWindow.completionContext();
+    entries = mainWindow.activeDocument->completionIndex.find(context, 100);
+
+    QVERIFY(mainWindow.activeDocument->indexedRevision != mainWindow.ui->textEdit->document()->revision());
+    QCOMPARE(entries.size(), 1);
+
+    mainWindow.ui->actionComplete->trigger();
+
+    QVERIFY(mainWindow.popup->isVisible());
+    QCOMPARE(mainWindow.popup->getCompletionModel()->rowCount(), 1);
+}
+
+void TestMainWindow::canGoToSymbol() {
+    // the palette finds the symbols of the open documents and the standard scripts
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic analysis
+    mainWindow.ui->textEdit->setPlainText("function MyFunction takes nothing returns nothing\nendfunction\nglobals\n    integer myGlobal = 0\nendglobals");
+    applyAnalysis(mainWindow);
+    applyStandardScript(mainWindow, "native CreateUnit takes player id, integer unitid, real x, real y, real face returns unit");
+
+    QVERIFY(mainWindow.symbolIndex.hasSource(mainWindow.documentSymbolSource(mainWindow.activeDocument)));
+
+    mainWindow.ui->actionGoToSymbol->trigger();
+
+    QVERIFY(mainWindow.symbolPalette->isVisible());
+
+    mainWindow.symbolPalette->getLineEdit()->setText("CreateUnit");
+
+    QTRY_VERIFY(!mainWindow.symbolPalette->isRanking());
+    QCOMPARE(mainWindow.symbolPalette->getTreeWidget()->topLevelItem(0)->text(0), QString("CreateUnit"));
+
+    mainWindow.symbolPalette->getLineEdit()->setText("myglo");
+
+    QTRY_VERIFY(!mainWindow.symbolPalette->isRanking());
+    QCOMPARE(mainWindow.symbolPalette->getTreeWidget()->topLevelItem(0)->text(0), QString("myGlobal"));
+
+    // activating the symbol jumps to its declaration
+    QTest::keyClick(mainWindow.symbolPalette->getLineEdit(), Qt::Key_Return);
+
+    QVERIFY(!mainWindow.symbolPalette->isVisible());
+    QCOMPARE(mainWindow.ui->textEdit->textCursor().blockNumber(), 3);
+}
+
+namespace {
+
+QTextCursor cursorAt(QTextDocument *document, int line, int column) {
+    QTextCursor cursor(document->findBlockByNumber(line));
+    cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::MoveAnchor, column);
+
+    return cursor;
+}
+
+}
+
+void TestMainWindow::canFindReferences() {
+    // the references of the open document are found at the cursor
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic analysis
+    mainWindow.ui->textEdit->setPlainText("globals\n    integer myGlobal = 0\nendglobals\nfunction MyFunction takes nothing returns nothing\n    set myGlobal = myGlobal + 1\nendfunction");
+    applyAnalysis(mainWindow);
+
+    QVERIFY(mainWindow.crossReferenceIndex.hasSource(mainWindow.documentSymbolSource(mainWindow.activeDocument)));
+
+    mainWindow.ui->textEdit->setTextCursor(cursorAt(mainWindow.ui->textEdit->document(), 4, 10));
+    mainWindow.ui->actionFindReferences->trigger();
+
+    QTRY_COMPARE(mainWindow.timerIdFindReferences, 0);
+    QCOMPARE(mainWindow.ui->treeWidgetFindInFiles->topLevelItemCount(), 1);
+    QCOMPARE(mainWindow.ui->treeWidgetFindInFiles->topLevelItem(0)->childCount(), 3);
+
+    mainWindow.ui->actionGoToDeclaration->trigger();
+
+    QCOMPARE(mainWindow.ui->textEdit->textCursor().blockNumber(), 1);
+    QCOMPARE(mainWindow.ui->textEdit->textCursor().positionInBlock(), 12);
+}
+
+void TestMainWindow::applyAnalysis(MainWindow &mainWindow) {
+    const QString text = mainWindow.ui->textEdit->toPlainText();
+    const QSharedPointer<const VJassSymbolTable> previousSymbolTable = mainWindow.currentResults.isNull() ? QSharedPointer<const VJassSymbolTable>() : mainWindow.currentResults->getSymbolTable();
+    QSharedPointer<HighLightInfo> results(Analysis::scanAndParse(text, mainWindow.syntaxChecker.loadAcquire(), mainWindow.analyzeMemoryLeaks.loadAcquire() == 1, previousSymbolTable));
+
+    // the pending analysis of the input timer would analyze the same text again
+    if (mainWindow.timerId != 0) {
+        mainWindow.killTimer(mainWindow.timerId);
+        mainWindow.timerId = 0;
+    }
+
+    const int revision = mainWindow.ui->textEdit->document()->revision();
+    mainWindow.activeDocument->inputRevision = revision;
+    const bool paused = mainWindow.scanAndParsePaused.loadAcquire() != 0;
+    mainWindow.resumeParserThread();
+    mainWindow.receiveResults(mainWindow.activeDocument->id, revision, results);
+
+    if (paused) {
+        mainWindow.pauseParserThread();
+    }
+}
+
+void TestMainWindow::applyStandardScript(MainWindow &mainWindow, const QString &text) {
+    VJassScanner scanner;
+    VJassParser parser;
+    VJassSymbolTable symbolTable;
+    const QList<VJassToken> tokens = scanner.scan(text);
+    VJassAst *ast = parser.parse(tokens, nullptr, &symbolTable);
+    symbolTable.resolveTokens(tokens);
+
+    mainWindow.receiveStandardScriptSymbols(mainWindow.standardScripts.first(), SymbolIndex::symbolsFromAst(ast), symbolTable.getUnits(), SignatureIndex::signaturesFromAst(ast));
+
+    delete ast;
+}
+
+void TestMainWindow::canRenameSymbols() {
+    const QString input = "globals\n"
+                          "    integer counter = 0\n"
+                          "endglobals\n"
+                          "function Foo takes integer value returns nothing\n"
+                          "    local string s = \"counter\"\n"
+                          "    // counter\n"
+                          "    set counter = counter + value\n"
+                          "endfunction\n"
+                          "function Bar takes nothing returns nothing\n"
+                          "    local integer other = 0\n"
+                          "    call Foo(counter)\n"
+                          "endfunction";
+
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic analysis
+    mainWindow.ui->textEdit->setPlainText(input);
+    applyAnalysis(mainWindow);
+
+    mainWindow.ui->textEdit->setTextCursor(cursorAt(mainWindow.ui->textEdit->document(), 6, 9));
+
+    // the new names must not change the meaning of any reference
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("other"), -1);
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("value"), -1);
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("Bar"), -1);
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("endif"), -1);
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("CreateUnit"), -1);
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText(), input);
+
+    // the references are only renamed with the positions of an analysis of the current text
+    cursorAt(mainWindow.ui->textEdit->document(), 1, 0).insertText(" ");
+    mainWindow.ui->textEdit->setTextCursor(cursorAt(mainWindow.ui->textEdit->document(), 6, 9));
+
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("total"), -1);
+
+    mainWindow.ui->textEdit->undo();
+
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText(), input);
+
+    // a reference typed after the last analysis would keep the old name
+    QTextCursor endCursor(mainWindow.ui->textEdit->document());
+    endCursor.movePosition(QTextCursor::End);
+    endCursor.insertText("\nfunction Baz takes nothing returns nothing\n    set counter = 2\nendfunction");
+    mainWindow.ui->textEdit->setTextCursor(cursorAt(mainWindow.ui->textEdit->document(), 6, 9));
+
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("total"), -1);
+    QVERIFY(mainWindow.ui->textEdit->toPlainText().contains("    set counter = 2\n"));
+
+    applyAnalysis(mainWindow);
+
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("total"), 5);
+    QVERIFY(mainWindow.ui->textEdit->toPlainText().contains("    set total = 2\n"));
+
+    mainWindow.ui->textEdit->undo();
+    mainWindow.ui->textEdit->undo();
+
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText(), input);
+
+    applyAnalysis(mainWindow);
+
+    // strings and comments are not changed
+    mainWindow.ui->textEdit->setTextCursor(cursorAt(mainWindow.ui->textEdit->document(), 6, 9));
+
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("total"), 4);
+
+    QString expected = input;
+    expected.replace("integer counter", "integer total");
+    expected.replace("set counter = counter", "set total = total");
+    expected.replace("Foo(counter)", "Foo(total)");
+
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText(), expected);
+
+    // all edits are undone at once
+    mainWindow.ui->textEdit->undo();
+
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText(), input);
+
+    mainWindow.ui->textEdit->redo();
+
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText(), expected);
+
+    // parameters may get the names of globals which their function does not use
+    applyAnalysis(mainWindow);
+    mainWindow.ui->textEdit->setTextCursor(cursorAt(mainWindow.ui->textEdit->document(), 3, 30));
+
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("total"), -1);
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("other"), 2);
+    QVERIFY(mainWindow.ui->textEdit->toPlainText().contains("takes integer other returns nothing"));
+
+    // a symbol used thousands of times is renamed at once
+    QString largeInput = "globals\n    integer counter = 0\nendglobals\nfunction Foo takes nothing returns nothing\n";
+
+    for (int i = 0; i < 5000; i++) {
+        largeInput += "    set counter = 1\n";
+    }
+
+    largeInput += "endfunction";
+    mainWindow.ui->textEdit->setPlainText(largeInput);
+    applyAnalysis(mainWindow);
+
+    QCOMPARE(mainWindow.crossReferenceIndex.findReferences(mainWindow.documentSymbolSource(mainWindow.activeDocument), 1, "counter").size(), 5001);
+
+    mainWindow.ui->textEdit->setTextCursor(cursorAt(mainWindow.ui->textEdit->document(), 1, 14));
+
+    QCOMPARE(mainWindow.renameIdentifierAtCursor("total"), 5001);
+    QCOMPARE(mainWindow.ui->textEdit->toPlainText().count("total"), 5001);
+}
+
+void TestMainWindow::canBuildCallGraph() {
+    const QString input = "function A takes nothing returns nothing\n"
+                          "    call B()\n"
+                          "endfunction\n"
+                          "function B takes nothing returns nothing\n"
+                          "    call A()\n"
+                          "    call TimerStart(CreateTimer(), 1.0, false, function C)\n"
+                          "endfunction\n"
+                          "function C takes nothing returns integer\n"
+                          "    return C()\n"
+                          "endfunction\n"
+                          "function D takes nothing returns nothing\n"
+                          "endfunction\n"
+                          "function main takes nothing returns nothing\n"
+                          "    call A()\n"
+                          "endfunction";
+
+    // the hierarchy of the enclosing function is shown
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic analysis
+    mainWindow.ui->textEdit->setPlainText(input);
+    applyAnalysis(mainWindow);
+
+    QCOMPARE(mainWindow.activeDocument->callGraph.getFunctionsCount(), 5);
+
+    mainWindow.ui->textEdit->setTextCursor(cursorAt(mainWindow.ui->textEdit->document(), 2, 0));
+    mainWindow.ui->actionShowCallHierarchy->trigger();
+
+    QCOMPARE(mainWindow.ui->tabWidget->currentWidget(), mainWindow.ui->tabCallHierarchy);
+    QCOMPARE(mainWindow.ui->treeWidgetCallHierarchy->topLevelItemCount(), 1);
+
+    QTreeWidgetItem *rootItem = mainWindow.ui->treeWidgetCallHierarchy->topLevelItem(0);
+
+    QCOMPARE(rootItem->text(0), QString("A (recursive)"));
+
+    QTreeWidgetItem *callersItem = rootItem->child(1);
+    callersItem->setExpanded(true);
+
+    QCOMPARE(callersItem->childCount(), 2);
+    QCOMPARE(callersItem->child(1)->text(0), QString("main"));
+
+    // the callers of the callers are added on demand
+    callersItem->child(0)->setExpanded(true);
+
+    QCOMPARE(callersItem->child(0)->childCount(), 1);
+
+    mainWindow.callHierarchyItemActivated(callersItem->child(1));
+
+    QCOMPARE(mainWindow.ui->textEdit->textCursor().blockNumber(), 12);
+}
+
+void TestMainWindow::canShowSignatureHelp() {
+    // the popup follows the cursor before the changed text is analyzed
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic analysis
+    mainWindow.ui->textEdit->setPlainText("function Move takes unit u, real x returns nothing\nendfunction\nfunction Test takes nothing returns nothing\n    call \nendfunction");
+    applyAnalysis(mainWindow);
+
+    QVERIFY(mainWindow.signatureIndex.hasSource(mainWindow.documentSymbolSource(mainWindow.activeDocument)));
+
+    mainWindow.ui->textEdit->setTextCursor(cursorAt(mainWindow.ui->textEdit->document(), 3, 9));
+    QTest::keyClicks(mainWindow.ui->textEdit, "Move(u, ");
+
+    QVERIFY(mainWindow.signatureHelp->isVisible());
+    QCOMPARE(mainWindow.signatureHelp->text(), QString("function Move takes unit u, <b>real x</b> returns nothing"));
+
+    QTest::keyClicks(mainWindow.ui->textEdit, "0.0)");
+
+    QVERIFY(!mainWindow.signatureHelp->isVisible());
+
+    // the natives are shown as soon as the standard scripts have been parsed
+    mainWindow.ui->textEdit->insertPlainText("\n    call CreateUnit(Player(0), ");
+
+    applyStandardScript(mainWindow, "native CreateUnit takes player id, integer unitid, real x, real y, real face returns unit");
+
+    QVERIFY(mainWindow.signatureHelp->isVisible());
+    QVERIFY(mainWindow.signatureHelp->text().contains("<b>integer unitid</b>"));
+
+    mainWindow.ui->textEdit->insertPlainText("'hfoo', 0.0, 0.0, 0.0)");
+
+    QVERIFY(!mainWindow.signatureHelp->isVisible());
+
+    applyAnalysis(mainWindow);
+
+    QVERIFY(mainWindow.hoverText(4, 10).startsWith("native CreateUnit takes player id, integer unitid, real x, real y, real face returns unit\nDeclared in common.j"));
+}
+
+void TestMainWindow::canShowHoverText() {
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic analysis
+    mainWindow.ui->textEdit->setPlainText("globals\n"
+                                          "    integer x = 0\n"
+                                          "endglobals\n"
+                                          "function Foo takes integer x returns nothing\n"
+                                          "    local integer y = x\n"
+                                          "    set x = y\n"
+                                          "endfunction\n"
+                                          "function Bar takes nothing returns nothing\n"
+                                          "    call Foo(x)\n"
+                                          "endfunction");
+    applyAnalysis(mainWindow);
+
+    // the parameter hides the global with the same name
+    QCOMPARE(mainWindow.hoverText(4, 22), QString("integer x\nParameter of Foo declared at line 4"));
+    QCOMPARE(mainWindow.hoverText(5, 12), QString("local integer y\nDeclared at line 5"));
+    QVERIFY(mainWindow.hoverText(8, 13).endsWith("\nDeclared at line 2"));
+}
+
+void TestMainWindow::canReuseUnchangedFunctions() {
+    MainWindow mainWindow;
+    mainWindow.show();
+    mainWindow.pauseParserThread(); // no automatic analysis
+    mainWindow.ui->textEdit->setPlainText("function a takes integer x returns nothing\n"
+                                          "    local integer y = x\n"
+                                          "endfunction\n"
+                                          "function b takes nothing returns nothing\n"
+                                          "    call a(1)\n"
+                                          "endfunction");
+    applyAnalysis(mainWindow);
+
+    QCOMPARE(mainWindow.currentResults->getSymbolTable()->getReusedFunctionsCount(), 0);
+
+    // only the changed function is resolved again by the next analysis
+    mainWindow.ui->textEdit->setTextCursor(cursorAt(mainWindow.ui->textEdit->document(), 4, 12));
+    mainWindow.ui->textEdit->insertPlainText("2");
+    applyAnalysis(mainWindow);
+
+    QCOMPARE(mainWindow.currentResults->getSymbolTable()->getReusedFunctionsCount(), 1);
+}
+
 QTEST_MAIN(TestMainWindow)
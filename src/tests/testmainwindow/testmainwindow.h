@@ -3,12 +3,47 @@
 
 #include <QTest>
 
+class MainWindow;
+
 class TestMainWindow : public QObject
 {
     Q_OBJECT
 
     private slots:
         void canHighlight();
+        void canReuseBlockFormatCache();
+        void canApplyResultsInTimeSlices();
+        void canUpdateOutlinerIncrementally();
+        void canUpdateDiagnosticsIncrementally();
+        void canUpdateManyDiagnostics();
+        void canPaintVisibleLineNumbers();
+        void canHighlightCurrentLineWithoutRehighlighting();
+        void canLoadFileProgressively();
+        void canViewMappedScript();
+        void canPrioritizeAnalysisJobs();
+        void canSwitchDocumentTabs();
+        void canFindInBackground();
+        void canFindInFiles();
+        void canFoldBlocks();
+        void canCompleteFromIndex();
+        void canCompleteWithinOneFrame();
+        void canGoToSymbol();
+        void canFindReferences();
+        void canRenameSymbols();
+        void canBuildCallGraph();
+        void canShowSignatureHelp();
+        void canShowHoverText();
+        void canReuseUnchangedFunctions();
+
+    private:
+        /**
+         * @brief Analyzes the text of the active document with the analysis of the analysis pool and applies the results at once instead of waiting for the input timer.
+         */
+        void applyAnalysis(MainWindow &mainWindow);
+        /**
+         * @brief Indexes the declarations of the text as the first standard script instead of waiting for the thread which parses the standard scripts.
+         */
+        void applyStandardScript(MainWindow &mainWindow, const QString &text);
 };
 
 #endif // TESTMAINWINDOW_H
@@ -2,6 +2,11 @@
 
 #include "../../app/vjassscanner.h"
 #include "../../app/vjassparser.h"
+#include "../../app/vjassfunction.h"
+#include "../../app/vjassstatement.h"
+#include "../../app/vjassexpression.h"
+#include "../../app/astspanindex.h"
+#include "../../app/highlightinfo.h"
 #include "testparser.h"
 
 void TestParser::canParseCommonJ() {
@@ -222,4 +227,239 @@ void TestParser::canParseCallStatement() {
     ast = nullptr;
 }
 
+void TestParser::canIndexAstSpans() {
+    const QString input =
+            QString("function bla takes nothing returns nothing\n")
+            + "if true then\n"
+            + "call Bla(identifier)\n"
+            + "endif\n"
+            + "endfunction";
+
+    VJassScanner scanner;
+
+    QList<VJassToken> tokens;
+    tokens = scanner.scan(input, false);
+    VJassParser parser;
+    VJassAst *ast = parser.parse(tokens);
+
+    QVERIFY(ast != nullptr);
+    QCOMPARE(ast->getParseErrors().size(), 0);
+    QCOMPARE(ast->getChildren().size(), 1);
+
+    VJassAst *function = ast->getChildren().at(0);
+    QCOMPARE(function->getLine(), 0);
+    QCOMPARE(function->getColumn(), 0);
+    QCOMPARE(function->getEndLine(), 4);
+    QCOMPARE(function->getEndColumn(), 11);
+
+    AstSpanIndex index(ast);
+    QVERIFY(index.size() > 3);
+
+    VJassExpression *identifier = dynamic_cast<VJassExpression*>(index.getInnermost(2, 12));
+    QVERIFY(identifier != nullptr);
+    QCOMPARE(identifier->getType(), VJassExpression::Identifier);
+    QCOMPARE(identifier->getValue(), QString("identifier"));
+
+    const QList<VJassAst*> enclosing = index.getEnclosing(2, 12);
+    QVERIFY(enclosing.size() >= 4);
+    QCOMPARE(enclosing.first(), static_cast<VJassAst*>(identifier));
+    QCOMPARE(enclosing.last(), function);
+
+    bool containsIf = false;
+
+    for (VJassAst *a : enclosing) {
+        VJassStatement *statement = dynamic_cast<VJassStatement*>(a);
+
+        if (statement != nullptr && statement->getType() == VJassStatement::If) {
+            containsIf = true;
+        }
+    }
+
+    QVERIFY(containsIf);
+
+    // the keyword endfunction belongs to the function only
+    QCOMPARE(index.getInnermost(4, 3), function);
+    QCOMPARE(index.getEnclosing(4, 3).size(), 1);
+    // after the end of the function
+    QVERIFY(index.getInnermost(4, 20) == nullptr);
+    QVERIFY(index.getEnclosing(4, 20).isEmpty());
+
+    delete ast;
+    ast = nullptr;
+}
+
+void TestParser::canIndexAstSpansFromBlizzardJ() {
+    QFile f("wc3reforged/Blizzard.j");
+
+    QVERIFY(f.open(QFile::ReadOnly | QFile::Text));
+
+    QTextStream in(&f);
+    QString input = in.readAll();
+
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(input, true);
+    VJassParser parser;
+    VJassAst *ast = parser.parse(tokens);
+
+    QVERIFY(ast != nullptr);
+
+    AstSpanIndex index;
+
+    QBENCHMARK {
+        index = AstSpanIndex(ast);
+    }
+
+    QVERIFY(index.size() > ast->getChildren().size());
+
+    const int lines = input.count('\n') + 1;
+    int found = 0;
+
+    // one lookup per line has to be fast enough to be done on every cursor movement
+    QBENCHMARK {
+        found = 0;
+
+        for (int line = 0; line < lines; line++) {
+            if (index.getInnermost(line, 4) != nullptr) {
+                found++;
+            }
+        }
+    }
+
+    QVERIFY(found > 0);
+
+    // every top level element encloses its own start position
+    for (VJassAst *child : ast->getChildren()) {
+        const QList<VJassAst*> enclosing = index.getEnclosing(child->getLine(), child->getColumn());
+        QVERIFY(!enclosing.isEmpty());
+        QCOMPARE(enclosing.last(), child);
+    }
+
+    delete ast;
+    ast = nullptr;
+}
+
+void TestParser::canCollectFoldRanges() {
+    const QString input = "globals\n"
+                          "    integer a = 0\n"
+                          "endglobals\n"
+                          "function Foo takes nothing returns nothing\n"
+                          "    loop\n"
+                          "        exitwhen true\n"
+                          "        if true then\n"
+                          "            call Foo()\n"
+                          "        endif\n"
+                          "    endloop\n"
+                          "    if true then\n"
+                          "    endif\n"
+                          "endfunction\n";
+
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(input);
+    VJassParser parser;
+    FoldRangeIndex foldRangeIndex;
+    VJassAst *ast = parser.parse(tokens, &foldRangeIndex);
+
+    QVERIFY(ast != nullptr);
+    QCOMPARE(foldRangeIndex.size(), 5);
+
+    // sorted by the start lines
+    QCOMPARE(foldRangeIndex.at(0).startLine, 0);
+    QCOMPARE(foldRangeIndex.at(0).endLine, 2);
+    QCOMPARE(foldRangeIndex.endLineOf(3), 12);
+    QCOMPARE(foldRangeIndex.endLineOf(4), 9);
+    QCOMPARE(foldRangeIndex.endLineOf(6), 8);
+    QCOMPARE(foldRangeIndex.endLineOf(10), 11);
+    QCOMPARE(foldRangeIndex.endLineOf(1), -1);
+
+    const QBitArray foldableLines = foldRangeIndex.toFoldableLines(13);
+    QCOMPARE(foldableLines.count(true), 5);
+    QVERIFY(foldableLines.testBit(3));
+
+    delete ast;
+    ast = nullptr;
+}
+
+namespace {
+
+VJassSymbolTable::Kind semanticKind(const VJassSymbolTable &symbolTable, const QString &input, int line, const QString &name) {
+    const int column = input.split('\n').at(line).indexOf(QRegularExpression("\\b" + name + "\\b"));
+
+    for (const VJassSymbolTable::SemanticRun &semanticRun : symbolTable.getSemanticRuns(line)) {
+        if (semanticRun.column == column && semanticRun.length == name.length()) {
+            return semanticRun.kind;
+        }
+    }
+
+    return VJassSymbolTable::NoKind;
+}
+
+}
+
+void TestParser::canResolveSymbols() {
+    const QString input = "globals\n"
+                          "    constant integer MAX = 10\n"
+                          "    integer counter = 0\n"
+                          "endglobals\n"
+                          "function Foo takes integer a returns integer\n"
+                          "    local integer b = a\n"
+                          "    set counter = b + MAX\n"
+                          "    return b\n"
+                          "endfunction\n"
+                          "function Bar takes nothing returns nothing\n"
+                          "    call Foo(counter)\n"
+                          "endfunction\n";
+
+    VJassScanner scanner;
+    QList<VJassToken> tokens = scanner.scan(input);
+    VJassParser parser;
+    VJassSymbolTable symbolTable;
+    VJassAst *ast = parser.parse(tokens, nullptr, &symbolTable);
+
+    QVERIFY(ast != nullptr);
+    QCOMPARE(symbolTable.getFunctionsCount(), 2);
+    QCOMPARE(symbolTable.functionAt(6), 0);
+    QCOMPARE(symbolTable.functionAt(10), 1);
+    QCOMPARE(symbolTable.functionAt(2), -1);
+    QCOMPARE(symbolTable.resolve("b", 0), VJassSymbolTable::Local);
+    QCOMPARE(symbolTable.resolve("b", 1), VJassSymbolTable::NoKind);
+    QCOMPARE(symbolTable.resolveTokens(tokens), 2);
+
+    QCOMPARE(semanticKind(symbolTable, input, 1, "MAX"), VJassSymbolTable::Constant);
+    QCOMPARE(semanticKind(symbolTable, input, 2, "counter"), VJassSymbolTable::Global);
+    QCOMPARE(semanticKind(symbolTable, input, 4, "Foo"), VJassSymbolTable::Function);
+    QCOMPARE(semanticKind(symbolTable, input, 4, "a"), VJassSymbolTable::Parameter);
+    QCOMPARE(semanticKind(symbolTable, input, 5, "b"), VJassSymbolTable::Local);
+    QCOMPARE(semanticKind(symbolTable, input, 6, "counter"), VJassSymbolTable::Global);
+    QCOMPARE(semanticKind(symbolTable, input, 6, "MAX"), VJassSymbolTable::Constant);
+    QCOMPARE(semanticKind(symbolTable, input, 10, "Foo"), VJassSymbolTable::Function);
+    // builtin types keep their lexical highlighting
+    QCOMPARE(semanticKind(symbolTable, input, 4, "integer"), VJassSymbolTable::NoKind);
+
+    delete ast;
+    ast = nullptr;
+
+    // inserting a line moves both functions but only the changed one is resolved again
+    QString changedInput = input;
+    changedInput.prepend("// counter\n");
+    changedInput.replace("call Foo(counter)", "call Foo(counter + MAX)");
+    tokens = scanner.scan(changedInput);
+    VJassSymbolTable changedSymbolTable;
+    ast = parser.parse(tokens, nullptr, &changedSymbolTable);
+
+    QCOMPARE(changedSymbolTable.resolveTokens(tokens, &symbolTable), 1);
+    QCOMPARE(changedSymbolTable.getReusedFunctionsCount(), 1);
+    QCOMPARE(semanticKind(changedSymbolTable, changedInput, 6, "b"), VJassSymbolTable::Local);
+    QCOMPARE(semanticKind(changedSymbolTable, changedInput, 11, "MAX"), VJassSymbolTable::Constant);
+
+    // the hashes of the lines find the same unchanged function without hashing its tokens
+    const QList<VJassToken> inputTokens = scanner.scan(input);
+    QCOMPARE(symbolTable.resolveTokens(inputTokens, nullptr, HighLightInfo(input, inputTokens, nullptr).getLineHashes()), 2);
+    QCOMPARE(changedSymbolTable.resolveTokens(tokens, &symbolTable, HighLightInfo(changedInput, tokens, nullptr).getLineHashes()), 1);
+    QCOMPARE(changedSymbolTable.getReusedFunctionsCount(), 1);
+    QCOMPARE(semanticKind(changedSymbolTable, changedInput, 6, "b"), VJassSymbolTable::Local);
+
+    delete ast;
+    ast = nullptr;
+}
+
 QTEST_MAIN(TestParser)
@@ -15,6 +15,10 @@ class TestParser : public QObject
         void canParseSetStatement();
         void canParseIfStatement();
         void canParseCallStatement();
+        void canIndexAstSpans();
+        void canIndexAstSpansFromBlizzardJ();
+        void canCollectFoldRanges();
+        void canResolveSymbols();
 };
 
 #endif // TESTPARSER_H
@@ -6,6 +6,7 @@ SUBDIRS = \
           testparser \
           testscanner \
           testhighlightinfo \
+          testindices \
           testmainwindow
 
 # where to find the sub projects - give the folders
@@ -14,4 +15,5 @@ testpjass.subdir = testpjass
 testparser.subdir = testparser
 testscanner.subdir = testscanner # relative paths
 testhighlightinfo.subdir = testhighlightinfo
+testindices.subdir = testindices
 testmainwindow.subdir = testmainwindow
@@ -1,6 +1,7 @@
 #include <QtTest>
 
 #include "../../app/vjassscanner.h"
+#include "../../app/bracketpairindex.h"
 #include "testscanner.h"
 
 void TestScanner::canScanFunction()
@@ -148,4 +149,76 @@ void TestScanner::canScanBlizzardJ() {
     QCOMPARE(input.size(), 471054);
 }
 
+void TestScanner::canPairBrackets() {
+    const QString input =
+            QString("set x[Bla(\n")
+            + "10, (20))] = 10\n"
+            + "call Bla(\"(\") // (\n"
+            + "call Bla(])";
+
+    VJassScanner scanner;
+    BracketPairIndex bracketPairIndex;
+    QList<VJassToken> tokens = scanner.scan(input, true, &bracketPairIndex);
+
+    QVERIFY(!tokens.isEmpty());
+    // brackets in strings and comments are ignored
+    QCOMPARE(bracketPairIndex.size(), 12);
+
+    // pairs spanning multiple lines
+    QCOMPARE(bracketPairIndex.at(bracketPairIndex.matchOf(0, 5)).line, 1);
+    QCOMPARE(bracketPairIndex.at(bracketPairIndex.matchOf(0, 5)).column, 9);
+    QCOMPARE(bracketPairIndex.at(bracketPairIndex.matchOf(1, 9)).column, 5);
+    QCOMPARE(bracketPairIndex.at(bracketPairIndex.matchOf(0, 9)).line, 1);
+    QCOMPARE(bracketPairIndex.at(bracketPairIndex.matchOf(0, 9)).column, 8);
+    QCOMPARE(bracketPairIndex.at(bracketPairIndex.matchOf(1, 4)).column, 7);
+    QCOMPARE(bracketPairIndex.at(bracketPairIndex.matchOf(2, 8)).column, 12);
+
+    // no bracket at the position
+    QCOMPARE(bracketPairIndex.indexOf(0, 0), -1);
+    QCOMPARE(bracketPairIndex.matchOf(0, 0), -1);
+
+    // "(]" does not match
+    QVERIFY(bracketPairIndex.indexOf(3, 8) != -1);
+    QCOMPARE(bracketPairIndex.matchOf(3, 9), -1);
+    QCOMPARE(bracketPairIndex.at(bracketPairIndex.matchOf(3, 8)).column, 10);
+    QCOMPARE(bracketPairIndex.getUnmatchedCount(), 1);
+
+    const QList<VJassParseError> parseErrors = bracketPairIndex.toParseErrors();
+    QCOMPARE(parseErrors.size(), 1);
+    QCOMPARE(parseErrors.at(0).getLine(), 3);
+    QCOMPARE(parseErrors.at(0).getColumn(), 9);
+
+    // scanning again replaces all brackets
+    scanner.scan("()", true, &bracketPairIndex);
+    QCOMPARE(bracketPairIndex.size(), 2);
+    QCOMPARE(bracketPairIndex.getUnmatchedCount(), 0);
+}
+
+void TestScanner::canPairBracketsFromBlizzardJ() {
+    QFile f("wc3reforged/Blizzard.j");
+
+    QVERIFY(f.open(QFile::ReadOnly | QFile::Text));
+
+    QTextStream in(&f);
+    QString input = in.readAll();
+
+    VJassScanner scanner;
+    BracketPairIndex bracketPairIndex;
+
+    QBENCHMARK {
+        scanner.scan(input, true, &bracketPairIndex);
+    }
+
+    QVERIFY(bracketPairIndex.size() > 0);
+    QCOMPARE(bracketPairIndex.getUnmatchedCount(), 0);
+
+    // every match is symmetric and can be looked up by the position of the bracket
+    for (int i = 0; i < bracketPairIndex.size(); i++) {
+        const BracketPairIndex::Bracket &bracket = bracketPairIndex.at(i);
+
+        QCOMPARE(bracketPairIndex.indexOf(bracket.line, bracket.column), i);
+        QCOMPARE(bracketPairIndex.at(bracket.matchIndex).matchIndex, i);
+    }
+}
+
 QTEST_MAIN(TestScanner)
@@ -15,6 +15,8 @@ class TestScanner : public QObject
         void canScanCommonJ();
         void canScanCommonAI();
         void canScanBlizzardJ();
+        void canPairBrackets();
+        void canPairBracketsFromBlizzardJ();
 };
 
 #endif // TESTSCANNER_H